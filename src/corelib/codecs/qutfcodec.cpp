@@ -370,6 +370,274 @@ static inline const uchar *simdFindNonAscii(const uchar *src, const uchar *end,
 }
 #endif
 
+/*
+    The functions below deal with the text that the ASCII paths above stop
+    at: text in scripts other than Latin takes two or three bytes per
+    character in UTF-8 and rarely has runs of ASCII long enough for them.
+    They only handle the one to three byte sequences of the Basic
+    Multilingual Plane and leave everything else, including all errors, to
+    the scalar code, for which they set nextAscii past the block they gave
+    up on.
+*/
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+namespace {
+struct ShuffleTable
+{
+    uchar shuffle[256][16];
+};
+
+// Gathers the UTF-16 code units in the eight 16-bit lanes selected by the index
+constexpr ShuffleTable makeCompressUtf16Table()
+{
+    ShuffleTable table = {};
+    for (int mask = 0; mask < 256; ++mask) {
+        int out = 0;
+        for (int lane = 0; lane < 8; ++lane) {
+            if (mask & (1 << lane)) {
+                table.shuffle[mask][out++] = uchar(2 * lane);
+                table.shuffle[mask][out++] = uchar(2 * lane + 1);
+            }
+        }
+        while (out < 16)
+            table.shuffle[mask][out++] = 0x80;
+    }
+    return table;
+}
+
+// Gathers the UTF-8 sequences in the four 32-bit lanes; the index holds the
+// length of each, minus one, in two bits per lane
+constexpr ShuffleTable makeCompressUtf8Table()
+{
+    ShuffleTable table = {};
+    for (int lengths = 0; lengths < 256; ++lengths) {
+        int out = 0;
+        for (int lane = 0; lane < 4; ++lane) {
+            const int length = ((lengths >> (2 * lane)) & 3) + 1;
+            for (int i = 0; i < length && out < 16; ++i)
+                table.shuffle[lengths][out++] = uchar(4 * lane + i);
+        }
+        while (out < 16)
+            table.shuffle[lengths][out++] = 0x80;
+    }
+    return table;
+}
+} // unnamed namespace
+
+alignas(16) static constexpr ShuffleTable compressUtf16Table = makeCompressUtf16Table();
+alignas(16) static constexpr ShuffleTable compressUtf8Table = makeCompressUtf8Table();
+
+/*
+    Decodes the complete sequences at the start of the sixteen bytes in
+    \a data and returns their length in bytes, or 0 if the block needs the
+    scalar code. \a ends gets one bit
+    set for the last byte of each character and \a values the code point of
+    each character in the 16-bit lane of its last byte.
+*/
+QT_FUNCTION_TARGET(AVX2)
+static inline uint decodeUtf8Block_avx2(__m128i data, uint &ends, __m256i &values)
+{
+    // Seen as signed, continuation bytes are -128 to -65, two byte leads -64 to -33
+    // (of which -64 and -63 only start overlong sequences), three byte leads -32 to -17
+    // and anything from -16 up starts a four byte sequence or is invalid
+    const uint nonAscii = uint(_mm_movemask_epi8(data));
+    const uint continuation = uint(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-64), data)));
+    const uint lead3OrMore = uint(_mm_movemask_epi8(_mm_cmpgt_epi8(data, _mm_set1_epi8(-33)))) & nonAscii;
+    const uint lead4OrMore = uint(_mm_movemask_epi8(_mm_cmpgt_epi8(data, _mm_set1_epi8(-17)))) & nonAscii;
+    const uint overlongLead = uint(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-62), data)))
+            & nonAscii & ~continuation;
+    const uint starts = ~continuation & 0xffff;
+
+    // Text that is mostly ASCII, like most text in languages written in the
+    // Latin script, is faster to go through with the ASCII code and the scalar
+    // code for the odd character in between, and so is text with four byte
+    // sequences, which are usually emoji in otherwise ASCII text.
+    if (qPopulationCount(nonAscii) < 6 || lead4OrMore)
+        return 0;
+
+    // stop before anything that is not for us and at the last start before that,
+    // so that only complete sequences are decoded
+    uint candidates = starts & ~1U;
+    if (overlongLead)
+        candidates &= (2U << qCountTrailingZeroBits(overlongLead)) - 1;
+    if (!candidates)
+        return 0;
+    const uint length = 31 - qCountLeadingZeroBits(candidates);
+
+    // each lead must be followed by exactly as many continuation bytes as it announces
+    const uint lead2 = nonAscii & starts & ~lead3OrMore;
+    const uint lead3 = lead3OrMore & ~lead4OrMore;
+    const uint expectedContinuation = ((lead2 | lead3) << 1) | (lead3 << 2);
+    if ((expectedContinuation ^ continuation) & ((2U << length) - 1))
+        return 0;
+    ends = (starts >> 1) & ((1U << length) - 1);
+
+    const __m256i byte0 = _mm256_cvtepu8_epi16(data);
+    const __m256i byte1 = _mm256_cvtepu8_epi16(_mm_slli_si128(data, 1)); // the byte before
+    const __m256i byte2 = _mm256_cvtepu8_epi16(_mm_slli_si128(data, 2)); // and the one before that
+    const __m256i low6 = _mm256_set1_epi16(0x3f);
+    const __m256i last = _mm256_and_si256(byte0, low6);
+    const __m256i value2 = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(byte1, _mm256_set1_epi16(0x1f)), 6), last);
+    const __m256i value3 = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(byte2, 12),
+                                                           _mm256_slli_epi16(_mm256_and_si256(byte1, low6), 6)),
+                                           last);
+    const __m256i isAscii = _mm256_cmpgt_epi16(_mm256_set1_epi16(0x80), byte0);
+    const __m256i afterLead = _mm256_cmpgt_epi16(byte1, _mm256_set1_epi16(0xbf));
+    values = _mm256_blendv_epi8(_mm256_blendv_epi8(value3, value2, afterLead), byte0, isAscii);
+
+    // three byte sequences must not be overlong nor encode surrogates
+    const __m256i top5 = _mm256_and_si256(values, _mm256_set1_epi16(short(0xf800)));
+    const __m256i invalid = _mm256_or_si256(_mm256_cmpeq_epi16(top5, _mm256_setzero_si256()),
+                                            _mm256_cmpeq_epi16(top5, _mm256_set1_epi16(short(0xd800))));
+    const uint invalidMask = uint(_mm_movemask_epi8(_mm_packs_epi16(_mm256_castsi256_si128(invalid),
+                                                                    _mm256_extracti128_si256(invalid, 1))));
+    if (invalidMask & ends & (lead3 << 2))
+        return 0;
+
+    return length;
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static void simdDecodeNonAscii_avx2(ushort *&dst, const uchar *&nextAscii, const uchar *&src, const uchar *end)
+{
+    while (end - src >= 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        uint ends;
+        __m256i values;
+        const uint length = decodeUtf8Block_avx2(data, ends, values);
+        if (!length)
+            return;
+
+        // there are never more characters than bytes, so both stores stay
+        // within the sixteen characters the caller has room for
+        const uint lowEnds = ends & 0xff;
+        const uint highEnds = ends >> 8;
+        const __m128i low = _mm_shuffle_epi8(_mm256_castsi256_si128(values),
+                _mm_load_si128(reinterpret_cast<const __m128i *>(compressUtf16Table.shuffle[lowEnds])));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), low);
+        dst += qPopulationCount(quint8(lowEnds));
+        const __m128i high = _mm_shuffle_epi8(_mm256_extracti128_si256(values, 1),
+                _mm_load_si128(reinterpret_cast<const __m128i *>(compressUtf16Table.shuffle[highEnds])));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), high);
+        dst += qPopulationCount(quint8(highEnds));
+        src += length;
+    }
+    nextAscii = end;
+}
+
+// Returns true if it skipped any non-ASCII character
+QT_FUNCTION_TARGET(AVX2)
+static bool simdValidateNonAscii_avx2(const uchar *&src, const uchar *end, const uchar *&nextAscii)
+{
+    const uchar *start = src;
+    while (end - src >= 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        uint ends;
+        __m256i values;
+        const uint length = decodeUtf8Block_avx2(data, ends, values);
+        if (!length)
+            return src != start;
+        src += length;
+    }
+    nextAscii = end;
+    return src != start;
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static void simdEncodeNonAscii_avx2(uchar *&dst, const ushort *&nextAscii, const ushort *&src, const ushort *end)
+{
+    // eight characters at a time, but keep eight more in reserve: the stores can
+    // write up to sixteen bytes past the last character, for which the caller
+    // has only made room if there are that many bytes (three per character) left
+    for ( ; end - src >= 16; src += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i asciiMask = _mm_cmpeq_epi16(_mm_and_si128(data, _mm_set1_epi16(short(0xff80))),
+                                                  _mm_setzero_si128());
+        if (qPopulationCount(uint(_mm_movemask_epi8(asciiMask))) > 2 * 5)
+            return;
+        const __m128i surrogates = _mm_cmpeq_epi16(_mm_and_si128(data, _mm_set1_epi16(short(0xf800))),
+                                                   _mm_set1_epi16(short(0xd800)));
+        if (!_mm_testz_si128(surrogates, surrogates)) {
+            nextAscii = src + 8;
+            return;
+        }
+
+        const __m256i u = _mm256_cvtepu16_epi32(data);
+        const __m256i low6 = _mm256_set1_epi32(0x3f);
+        const __m256i continuation = _mm256_set1_epi32(0x80);
+        const __m256i last = _mm256_or_si256(_mm256_and_si256(u, low6), continuation);
+        const __m256i middle = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(u, 6), low6), continuation);
+        const __m256i two = _mm256_or_si256(_mm256_or_si256(_mm256_srli_epi32(u, 6), _mm256_set1_epi32(0xc0)),
+                                            _mm256_slli_epi32(last, 8));
+        const __m256i three = _mm256_or_si256(_mm256_or_si256(_mm256_srli_epi32(u, 12), _mm256_set1_epi32(0xe0)),
+                                              _mm256_or_si256(_mm256_slli_epi32(middle, 8),
+                                                              _mm256_slli_epi32(last, 16)));
+        const __m256i isAscii = _mm256_cmpgt_epi32(_mm256_set1_epi32(0x80), u);
+        const __m256i isTwo = _mm256_cmpgt_epi32(_mm256_set1_epi32(0x800), u);
+        const __m256i bytes = _mm256_blendv_epi8(_mm256_blendv_epi8(three, two, isTwo), u, isAscii);
+
+        // the length of each sequence, minus one, is the sum of these two bits
+        const uint twoOrMoreBytes = ~uint(_mm256_movemask_ps(_mm256_castsi256_ps(isAscii))) & 0xff;
+        const uint threeBytes = ~uint(_mm256_movemask_ps(_mm256_castsi256_ps(isTwo))) & 0xff;
+        auto spread = [](uint bits) {
+            return (bits & 1) | ((bits & 2) << 1) | ((bits & 4) << 2) | ((bits & 8) << 3);
+        };
+        const uint lowLengths = spread(twoOrMoreBytes & 0xf) + spread(threeBytes & 0xf);
+        const uint highLengths = spread(twoOrMoreBytes >> 4) + spread(threeBytes >> 4);
+
+        const __m128i low = _mm_shuffle_epi8(_mm256_castsi256_si128(bytes),
+                _mm_load_si128(reinterpret_cast<const __m128i *>(compressUtf8Table.shuffle[lowLengths])));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), low);
+        dst += 4 + qPopulationCount(quint8(twoOrMoreBytes & 0xf)) + qPopulationCount(quint8(threeBytes & 0xf));
+        const __m128i high = _mm_shuffle_epi8(_mm256_extracti128_si256(bytes, 1),
+                _mm_load_si128(reinterpret_cast<const __m128i *>(compressUtf8Table.shuffle[highLengths])));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), high);
+        dst += 4 + qPopulationCount(quint8(twoOrMoreBytes >> 4)) + qPopulationCount(quint8(threeBytes >> 4));
+    }
+    nextAscii = end;
+}
+#endif
+
+static inline void simdDecodeNonAscii(ushort *&dst, const uchar *&nextAscii, const uchar *&src, const uchar *end)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    // skip the call if the ASCII code found no more than an odd character or two
+    // in its last block, as is usual in text in languages written in the Latin script
+    if (nextAscii - src >= 6 && qCpuHasFeature(AVX2))
+        simdDecodeNonAscii_avx2(dst, nextAscii, src, end);
+#else
+    Q_UNUSED(dst);
+    Q_UNUSED(nextAscii);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+#endif
+}
+
+static inline bool simdValidateNonAscii(const uchar *&src, const uchar *end, const uchar *&nextAscii)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2))
+        return simdValidateNonAscii_avx2(src, end, nextAscii);
+#else
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+    Q_UNUSED(nextAscii);
+#endif
+    return false;
+}
+
+static inline void simdEncodeNonAscii(uchar *&dst, const ushort *&nextAscii, const ushort *&src, const ushort *end)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2))
+        simdEncodeNonAscii_avx2(dst, nextAscii, src, end);
+#else
+    Q_UNUSED(dst);
+    Q_UNUSED(nextAscii);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+#endif
+}
+
 QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
 {
     // create a QByteArray with the worst case scenario size
@@ -382,6 +650,7 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
         const ushort *nextAscii = end;
         if (simdEncodeAscii(dst, nextAscii, src, end))
             break;
+        simdEncodeNonAscii(dst, nextAscii, src, end);
 
         do {
             ushort uc = *src++;
@@ -434,8 +703,11 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len, QTextCodec::Conve
             surrogate_high = -1;
             res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, cursor, src, end);
         } else {
-            if (src >= nextAscii && simdEncodeAscii(cursor, nextAscii, src, end))
-                break;
+            if (src >= nextAscii) {
+                if (simdEncodeAscii(cursor, nextAscii, src, end))
+                    break;
+                simdEncodeNonAscii(cursor, nextAscii, src, end);
+            }
 
             uc = *src++;
             res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, cursor, src, end);
@@ -525,6 +797,7 @@ QChar *QUtf8::convertToUnicode(QChar *buffer, const char *chars, int len) noexce
             nextAscii = end;
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
+            simdDecodeNonAscii(dst, nextAscii, src, end);
 
             do {
                 uchar b = *src++;
@@ -613,8 +886,13 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
     const uchar *nextAscii = src;
     const uchar *start = src;
     while (res >= 0 && src < end) {
-        if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
-            break;
+        if (src >= nextAscii) {
+            if (simdDecodeAscii(dst, nextAscii, src, end))
+                break;
+            // the scalar code below deals with the byte order mark
+            if (headerdone)
+                simdDecodeNonAscii(dst, nextAscii, src, end);
+        }
 
         ch = *src++;
         res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(ch, dst, src, end);
@@ -671,8 +949,11 @@ QUtf8::ValidUtf8Result QUtf8::isValidUtf8(const char *chars, qsizetype len)
     bool isValidAscii = true;
 
     while (src < end) {
-        if (src >= nextAscii)
+        if (src >= nextAscii) {
             src = simdFindNonAscii(src, end, nextAscii);
+            if (src != end && simdValidateNonAscii(src, end, nextAscii))
+                isValidAscii = false;
+        }
         if (src == end)
             break;
 
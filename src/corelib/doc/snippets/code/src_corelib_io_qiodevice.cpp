@@ -107,3 +107,16 @@ bool isExeFile(QFile *file)
     return file->peek(2) == "MZ";
 }
 //! [5]
+
+
+//! [6]
+void Proxy::forwardData()
+{
+    while (client->bytesAvailable() > 0) {
+        const QByteArray block = client->readChunk();
+        if (block.isEmpty())
+            break;
+        server->write(block);
+    }
+}
+//! [6]
@@ -364,4 +364,16 @@ QString wildcard = QRegularExpression::wildcardToRegularExpression("*.jpeg");
     ("", "day", "month", "year", "", "name")
 //! [33]
 
+{
+//! [34]
+// counts the lines of a log that mention an error, and finds the longest one
+QString log = QString::fromUtf8(file.readAll());
+QRegularExpression re("^.*error.*$", QRegularExpression::MultilineOption);
+qsizetype longest = 0;
+qsizetype errors = re.forEachMatch(log, [&](qsizetype start, qsizetype end) {
+    longest = qMax(longest, end - start);
+});
+//! [34]
+}
+
 }
@@ -1244,6 +1244,73 @@ QByteArray QIODevice::read(qint64 maxSize)
     return result;
 }
 
+/*!
+    \since 6.0
+
+    Reads the next block of data from the device and returns it, or an
+    empty QByteArray if no data is available. If \a maxSize is 0, the
+    block can have any size; otherwise it is at most \a maxSize bytes.
+
+    Unlike read(), this function does not copy the data if it can avoid
+    it. On a buffered device, the internal read buffer is made of blocks
+    (typically a few kilobytes each, or whatever a socket received in one
+    go), and readChunk() hands out the next block itself instead of
+    copying its contents into a new QByteArray. This makes it the
+    preferred way of forwarding data from one device to another, for
+    instance from one QTcpSocket to another:
+
+    \snippet code/src_corelib_io_qiodevice.cpp 6
+
+    If the device is unbuffered, open in Text mode, or a transaction is in
+    progress, or if \a maxSize is smaller than the next block, the data is
+    copied as with read().
+
+    Like the QByteArray overload of read(), this function has no way of
+    reporting errors.
+
+    \sa read(), readAll(), bytesAvailable()
+*/
+QByteArray QIODevice::readChunk(qint64 maxSize)
+{
+    Q_D(QIODevice);
+
+#if defined QIODEVICE_DEBUG
+    printf("%p QIODevice::readChunk(%lld), d->pos = %lld, d->buffer.size() = %lld\n",
+           this, maxSize, d->pos, d->buffer.size());
+#endif
+
+    CHECK_MAXLEN(readChunk, QByteArray());
+    CHECK_READABLE(readChunk, QByteArray());
+
+    const bool canShareBlocks = !d->transactionStarted
+            && (d->openMode & (QIODevice::Unbuffered | QIODevice::Text)) == 0;
+
+    // Fill the buffer with a single device read, like QIODevicePrivate::read()
+    // does, so that the block can be handed out below.
+    if (canShareBlocks && d->buffer.isEmpty() && d->readBufferChunkSize > 0
+        && (d->isSequential() || d->pos == d->devicePos || seek(d->pos))) {
+        const qint64 bytesToBuffer = d->readBufferChunkSize;
+        const qint64 readFromDevice = readData(d->buffer.reserve(bytesToBuffer), bytesToBuffer);
+        d->buffer.chop(bytesToBuffer - qMax(Q_INT64_C(0), readFromDevice));
+        if (readFromDevice > 0 && !d->isSequential())
+            d->devicePos += readFromDevice;
+    }
+
+    const qint64 blockSize = d->buffer.nextDataBlockSize();
+    if (canShareBlocks && blockSize > 0 && (maxSize == 0 || maxSize >= blockSize)) {
+        QByteArray result = d->buffer.read();
+        if (!d->isSequential())
+            d->pos += result.size();
+        if (d->buffer.isEmpty())
+            readData(nullptr, 0);
+        return result;
+    }
+
+    if (maxSize == 0)
+        maxSize = blockSize > 0 ? blockSize : qint64(QIODEVICE_BUFFERSIZE);
+    return read(maxSize);
+}
+
 /*!
     Reads all remaining data from the device, and returns it as a
     byte array.
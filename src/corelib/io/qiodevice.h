@@ -122,6 +122,7 @@ public:
     qint64 read(char *data, qint64 maxlen);
     QByteArray read(qint64 maxlen);
     QByteArray readAll();
+    QByteArray readChunk(qint64 maxlen = 0);
     qint64 readLine(char *data, qint64 maxlen);
     QByteArray readLine(qint64 maxlen = 0);
     virtual bool canReadLine() const;
@@ -27,6 +27,7 @@ HEADERS += \
         kernel/qvariant.h \
         kernel/qabstracteventdispatcher_p.h \
         kernel/qcoreapplication_p.h \
+        kernel/qcoreevent_p.h \
         kernel/qobjectcleanuphandler.h \
         kernel/qvariant_p.h \
         kernel/qmetaobject_p.h \
@@ -351,7 +351,8 @@ bool QCoreApplicationPrivate::is_app_closing = false;
 Q_CORE_EXPORT uint qGlobalPostedEventsCount()
 {
     QThreadData *currentThreadData = QThreadData::current();
-    return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
+    return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset
+            + (currentThreadData->postedMetaCalls.loadAcquire() ? 1 : 0);
 }
 
 QAbstractEventDispatcher *QCoreApplicationPrivate::eventDispatcher = nullptr;
@@ -502,6 +503,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         const auto locker = qt_scoped_lock(thisThreadData->postEventList.mutex);
+        thisThreadData->takePostedMetaCalls();
         for (int i = 0; i < thisThreadData->postEventList.size(); ++i) {
             const QPostEvent &pe = thisThreadData->postEventList.at(i);
             if (pe.event) {
@@ -1477,6 +1479,7 @@ QCoreApplicationPrivate::QPostEventListLocker QCoreApplicationPrivate::lockThrea
     if (!object) {
         locker.threadData = QThreadData::current();
         locker.locker = qt_unique_lock(locker.threadData->postEventList.mutex);
+        locker.threadData->takePostedMetaCalls();
         return locker;
     }
 
@@ -1499,9 +1502,57 @@ QCoreApplicationPrivate::QPostEventListLocker QCoreApplicationPrivate::lockThrea
     }
 
     Q_ASSERT(locker.threadData);
+    // keep the order in which the events were posted
+    locker.threadData->takePostedMetaCalls();
     return locker;
 }
 
+/*!
+    \internal
+
+    Posts \a event like QCoreApplication::postEvent() does with the normal
+    priority, but without locking the list of posted events of the thread of
+    \a receiver: the event is added to a lock-free stack, which the thread
+    moves to the list the next time it locks it. Only the first of a burst
+    of events posted before the thread gets to them wakes it up.
+
+    This is how queued connections post their calls, which is what pipelines
+    of objects in different threads do most.
+*/
+void QCoreApplicationPrivate::postMetaCallEvent(QObject *receiver, QAbstractMetaCallEvent *event)
+{
+    auto &threadData = QObjectPrivate::get(receiver)->threadData;
+    QThreadData *data = threadData.loadAcquire();
+    if (Q_UNLIKELY(!data)) {
+        // posting during destruction? just delete the event to prevent a leak
+        delete event;
+        return;
+    }
+
+    // QObject::moveToThread() waits for the posters after moving the receiver,
+    // so either we see the thread it moved to, or it takes our event with it
+    data->metaCallPosters.ref();
+    if (Q_UNLIKELY(threadData.loadAcquire() != data)) {
+        data->metaCallPosters.deref();
+        QCoreApplication::postEvent(receiver, event);
+        return;
+    }
+
+    Q_TRACE(QCoreApplication_postEvent_event_posted, receiver, event, event->type());
+    event->postedTo_ = receiver;
+    QAbstractMetaCallEvent *head = data->postedMetaCalls.loadRelaxed();
+    do {
+        event->nextPosted_ = head;
+    } while (!data->postedMetaCalls.testAndSetOrdered(head, event, head));
+
+    if (!head) {
+        if (QAbstractEventDispatcher *dispatcher = data->eventDispatcher.loadAcquire())
+            dispatcher->wakeUp();
+    }
+    // only now may a moveToThread() that waits for us release data
+    data->metaCallPosters.deref();
+}
+
 /*!
     \since 4.3
 
@@ -1691,6 +1742,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     auto locker = qt_unique_lock(data->postEventList.mutex);
+    data->takePostedMetaCalls();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
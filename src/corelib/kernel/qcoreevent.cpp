@@ -39,10 +39,13 @@
 ****************************************************************************/
 
 #include "qcoreevent.h"
+#include "qcoreevent_p.h"
 #include "qcoreapplication.h"
 #include "qcoreapplication_p.h"
 
 #include "qbasicatomic.h"
+#include "qmutex.h"
+#include <private/qfreelist_p.h>
 
 #include <qtcore_tracepoints_p.h>
 
@@ -528,6 +531,24 @@ QTimerEvent::~QTimerEvent()
 {
 }
 
+/*!
+    \internal
+
+    Timer events are allocated from QEventPool.
+*/
+void *QTimerEvent::operator new(std::size_t size)
+{
+    return QEventPool::allocate(size);
+}
+
+/*!
+    \internal
+*/
+void QTimerEvent::operator delete(void *ptr) noexcept
+{
+    QEventPool::deallocate(ptr);
+}
+
 /*!
     \fn int QTimerEvent::timerId() const
 
@@ -655,6 +676,24 @@ QDeferredDeleteEvent::QDeferredDeleteEvent()
 QDeferredDeleteEvent::~QDeferredDeleteEvent()
 { }
 
+/*!
+    \internal
+
+    Deferred delete events are allocated from QEventPool.
+*/
+void *QDeferredDeleteEvent::operator new(std::size_t size)
+{
+    return QEventPool::allocate(size);
+}
+
+/*!
+    \internal
+*/
+void QDeferredDeleteEvent::operator delete(void *ptr) noexcept
+{
+    QEventPool::deallocate(ptr);
+}
+
 /*! \fn int QDeferredDeleteEvent::loopLevel() const
 
     Returns the loop-level in which the event was posted. The
@@ -663,6 +702,322 @@ QDeferredDeleteEvent::~QDeferredDeleteEvent()
     \sa QObject::deleteLater()
 */
 
+/*!
+    \internal
+    \class QEventPool
+    \inmodule QtCore
+
+    \brief The QEventPool class recycles the memory of frequently posted
+    events.
+
+    Every queued signal emission, deleteLater() call and (on some
+    platforms) timer expiry allocates an event that is deleted by the
+    thread that receives it. QEventPool serves those allocations from
+    fixed-size slots of SlotSize bytes, so that busy threads do not
+    contend in the global allocator.
+
+    Each thread keeps a small cache of free slots. When it runs empty, a
+    slot is taken from a lock-free QFreeList shared by all threads; when it
+    is full, freed slots are given back to that list. The shared list only
+    ever grows, up to EventPoolConstants::MaxIndex slots, and is released
+    when QtCore is unloaded. Allocations larger than a slot, or made while
+    the shared list is exhausted, go to the global allocator.
+
+    Classes opt in by forwarding their operator new and operator delete to
+    allocate() and deallocate().
+
+    When building with AddressSanitizer all allocations go to the global
+    allocator, so that use-after-free of events can still be detected; they
+    are all counted as heap allocations.
+*/
+
+/*!
+    \internal
+    \class QEventPool::Statistics
+    \inmodule QtCore
+
+    Counts the allocations made through QEventPool, for diagnostics.
+
+    \sa QEventPool::statistics()
+*/
+
+#if defined(__SANITIZE_ADDRESS__) || QT_HAS_FEATURE(address_sanitizer)
+#  define QT_NO_EVENT_POOL
+#endif
+
+#ifndef QT_NO_EVENT_POOL
+namespace {
+struct EventSlot
+{
+    // index in the shared free list, or -1 for an allocation from the heap
+    int id;
+    alignas(std::max_align_t) char storage[QEventPool::SlotSize];
+
+    EventSlot *&nextFree() { return *reinterpret_cast<EventSlot **>(storage); }
+
+    static EventSlot *fromStorage(void *ptr)
+    { return reinterpret_cast<EventSlot *>(static_cast<char *>(ptr) - offsetof(EventSlot, storage)); }
+};
+
+struct EventPoolConstants : QFreeListDefaultConstants
+{
+    enum { BlockCount = 4, MaxIndex = 0xffff };
+    static const int Sizes[BlockCount];
+};
+const int EventPoolConstants::Sizes[EventPoolConstants::BlockCount] = {
+    256,
+    2048,
+    8192,
+    EventPoolConstants::MaxIndex - (256 + 2048 + 8192)
+};
+
+struct EventPoolCache;
+
+struct EventPoolData
+{
+    QFreeList<EventSlot, EventPoolConstants> freeList;
+    QAtomicInt taken;
+
+    // the caches of the running threads, and the sum of those that are gone
+    QBasicMutex mutex;
+    EventPoolCache *caches = nullptr;
+    QEventPool::Statistics finished;
+
+    EventSlot *take()
+    {
+        if (taken.fetchAndAddRelaxed(1) >= EventPoolConstants::MaxIndex) {
+            taken.fetchAndSubRelaxed(1);
+            return nullptr;
+        }
+        const int id = freeList.next();
+        EventSlot *slot = &freeList[id];
+        slot->id = id;
+        return slot;
+    }
+
+    void release(EventSlot *slot)
+    {
+        freeList.release(slot->id);
+        taken.fetchAndSubRelaxed(1);
+    }
+};
+Q_GLOBAL_STATIC(EventPoolData, eventPool)
+
+struct EventPoolCounter
+{
+    // only written by the owning thread, but read by statistics()
+    QAtomicInteger<quint64> value;
+
+    void increment() { value.storeRelaxed(value.loadRelaxed() + 1); }
+    operator quint64() const { return value.loadRelaxed(); }
+};
+
+// Set when the cache of the current thread has been destroyed. Events can
+// still be allocated and deleted by the destructors of other thread_local
+// objects after that, and must then bypass the cache. This is trivially
+// destructible, so that it stays valid until the thread is gone.
+static thread_local bool eventPoolCacheDestroyed = false;
+
+struct EventPoolCache
+{
+    enum { Capacity = 64 };
+
+    EventSlot *free = nullptr;
+    int count = 0;
+    EventPoolCache *next = nullptr;
+    EventPoolCache *previous = nullptr;
+
+    EventPoolCounter allocations;
+    EventPoolCounter heapAllocations;
+    EventPoolCounter sharedAllocations;
+    EventPoolCounter sharedReleases;
+
+    EventPoolCache()
+    {
+        if (EventPoolData *pool = eventPool()) {
+            QMutexLocker locker(&pool->mutex);
+            next = pool->caches;
+            if (next)
+                next->previous = this;
+            pool->caches = this;
+        }
+    }
+
+    ~EventPoolCache()
+    {
+        EventPoolData *pool = eventPool();
+        for (EventSlot *slot = free; slot; ) {
+            EventSlot *nextSlot = slot->nextFree();
+            if (pool) {
+                pool->release(slot);
+                sharedReleases.increment();
+            }
+            slot = nextSlot;
+        }
+        free = nullptr;
+        count = 0;
+        eventPoolCacheDestroyed = true;
+
+        if (pool) {
+            QMutexLocker locker(&pool->mutex);
+            addTo(pool->finished);
+            if (previous)
+                previous->next = next;
+            else if (pool->caches == this)
+                pool->caches = next;
+            if (next)
+                next->previous = previous;
+        }
+    }
+
+    void addTo(QEventPool::Statistics &statistics) const
+    {
+        statistics.allocations += allocations;
+        statistics.heapAllocations += heapAllocations;
+        statistics.sharedAllocations += sharedAllocations;
+        statistics.sharedReleases += sharedReleases;
+    }
+};
+static thread_local EventPoolCache eventPoolCache;
+
+// Used once the cache of the current thread is gone. The counters go
+// straight to the totals of the finished threads.
+static void *allocateUncached(size_t size)
+{
+    EventPoolData *pool = eventPool();
+    EventSlot *slot = (pool && size <= QEventPool::SlotSize) ? pool->take() : nullptr;
+    if (!slot) {
+        slot = static_cast<EventSlot *>(::operator new(offsetof(EventSlot, storage) + size));
+        slot->id = -1;
+    }
+    if (pool) {
+        QMutexLocker locker(&pool->mutex);
+        if (slot->id < 0) {
+            ++pool->finished.heapAllocations;
+        } else {
+            ++pool->finished.allocations;
+            ++pool->finished.sharedAllocations;
+        }
+    }
+    return slot->storage;
+}
+
+static void deallocateUncached(EventSlot *slot)
+{
+    if (EventPoolData *pool = eventPool()) {
+        pool->release(slot);
+        QMutexLocker locker(&pool->mutex);
+        ++pool->finished.sharedReleases;
+    }
+    // else QtCore is being unloaded and the slot is already gone
+}
+} // unnamed namespace
+#else
+// every event goes to the global allocator, but is still counted
+static QBasicAtomicInteger<quint64> heapAllocationCount = Q_BASIC_ATOMIC_INITIALIZER(0);
+#endif // QT_NO_EVENT_POOL
+
+/*!
+    \internal
+
+    Returns storage for an event of \a size bytes, suitably aligned for any
+    event class.
+*/
+void *QEventPool::allocate(size_t size)
+{
+#ifdef QT_NO_EVENT_POOL
+    heapAllocationCount.fetchAndAddRelaxed(1);
+    return ::operator new(size);
+#else
+    if (eventPoolCacheDestroyed)
+        return allocateUncached(size);
+
+    EventPoolCache &cache = eventPoolCache;
+    EventSlot *slot = nullptr;
+    if (size <= SlotSize) {
+        if (cache.free) {
+            slot = cache.free;
+            cache.free = slot->nextFree();
+            --cache.count;
+        } else if (EventPoolData *pool = eventPool()) {
+            slot = pool->take();
+            if (slot)
+                cache.sharedAllocations.increment();
+        }
+    }
+
+    if (slot) {
+        cache.allocations.increment();
+    } else {
+        slot = static_cast<EventSlot *>(::operator new(offsetof(EventSlot, storage) + size));
+        slot->id = -1;
+        cache.heapAllocations.increment();
+    }
+    return slot->storage;
+#endif
+}
+
+/*!
+    \internal
+
+    Releases the storage at \a ptr, which was returned by allocate(). This
+    can be called from any thread.
+*/
+void QEventPool::deallocate(void *ptr) noexcept
+{
+#ifdef QT_NO_EVENT_POOL
+    ::operator delete(ptr);
+#else
+    if (!ptr)
+        return;
+
+    EventSlot *slot = EventSlot::fromStorage(ptr);
+    if (slot->id < 0) {
+        ::operator delete(slot);
+        return;
+    }
+
+    if (eventPoolCacheDestroyed) {
+        deallocateUncached(slot);
+        return;
+    }
+
+    EventPoolCache &cache = eventPoolCache;
+    if (cache.count < EventPoolCache::Capacity) {
+        slot->nextFree() = cache.free;
+        cache.free = slot;
+        ++cache.count;
+    } else if (EventPoolData *pool = eventPool()) {
+        pool->release(slot);
+        cache.sharedReleases.increment();
+    }
+    // else QtCore is being unloaded and the slot is already gone
+#endif
+}
+
+/*!
+    \internal
+
+    Returns the allocation counters summed over all threads, including
+    those that have finished. The counters of running threads are read
+    while they may still change.
+*/
+QEventPool::Statistics QEventPool::statistics()
+{
+    Statistics result;
+#ifdef QT_NO_EVENT_POOL
+    result.heapAllocations = heapAllocationCount.loadRelaxed();
+#else
+    if (EventPoolData *pool = eventPool()) {
+        QMutexLocker locker(&pool->mutex);
+        result = pool->finished;
+        for (const EventPoolCache *cache = pool->caches; cache; cache = cache->next)
+            cache->addTo(result);
+    }
+#endif
+    return result;
+}
+
 QT_END_NAMESPACE
 
 #include "moc_qcoreevent.cpp"
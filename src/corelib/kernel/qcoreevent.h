@@ -340,6 +340,11 @@ public:
     explicit QTimerEvent( int timerId );
     ~QTimerEvent();
     int timerId() const { return id; }
+
+    static void *operator new(std::size_t size);
+    static void *operator new(std::size_t, void *where) noexcept { return where; }
+    static void operator delete(void *ptr) noexcept;
+    static void operator delete(void *, void *) noexcept {}
 protected:
     int id;
 };
@@ -377,6 +382,11 @@ public:
     explicit QDeferredDeleteEvent();
     ~QDeferredDeleteEvent();
     int loopLevel() const { return level; }
+
+    static void *operator new(std::size_t size);
+    static void *operator new(std::size_t, void *where) noexcept { return where; }
+    static void operator delete(void *ptr) noexcept;
+    static void operator delete(void *, void *) noexcept {}
 private:
     int level;
     friend class QCoreApplication;
@@ -59,6 +59,10 @@
 #  include <sys/eventfd.h>
 #endif
 
+#if QT_CONFIG(epoll)
+#  include <sys/epoll.h>
+#endif
+
 // VxWorks doesn't correctly set the _POSIX_... options
 #if defined(Q_OS_VXWORKS)
 #  if defined(_POSIX_MONOTONIC_CLOCK) && (_POSIX_MONOTONIC_CLOCK <= 0)
@@ -226,10 +230,23 @@ QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
 {
     if (Q_UNLIKELY(threadPipe.init() == false))
         qFatal("QEventDispatcherUNIXPrivate(): Cannot continue without a thread pipe");
+
+#if QT_CONFIG(epoll)
+    if (qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL") > 0) {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd == -1)
+            perror("QEventDispatcherUNIXPrivate: Unable to create epoll set, falling back to poll()");
+    }
+#endif
 }
 
 QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
 {
+#if QT_CONFIG(epoll)
+    if (epollFd >= 0)
+        qt_safe_close(epollFd);
+#endif
+
     // cleanup timers
     qDeleteAll(timerList);
 }
@@ -289,6 +306,110 @@ void QEventDispatcherUNIXPrivate::markPendingSocketNotifiers()
     pollfds.clear();
 }
 
+#if QT_CONFIG(epoll)
+static uint32_t toEpollEvents(short events)
+{
+    uint32_t result = 0;
+    if (events & POLLIN)
+        result |= EPOLLIN;
+    if (events & POLLOUT)
+        result |= EPOLLOUT;
+    if (events & POLLPRI)
+        result |= EPOLLPRI;
+    return result;
+}
+
+static short fromEpollEvents(uint32_t events)
+{
+    short result = 0;
+    if (events & EPOLLIN)
+        result |= POLLIN;
+    if (events & EPOLLOUT)
+        result |= POLLOUT;
+    if (events & EPOLLPRI)
+        result |= POLLPRI;
+    if (events & EPOLLERR)
+        result |= POLLERR;
+    if (events & EPOLLHUP)
+        result |= POLLHUP;
+    return result;
+}
+
+/*
+    Brings the kernel-side registration of \a fd in line with \a events (the
+    union of its notifier types); \a added is true if \a fd had no notifiers
+    before. An \a events of 0 removes the descriptor from the set.
+*/
+void QEventDispatcherUNIXPrivate::updateEpollSet(int fd, short events, bool added)
+{
+    Q_ASSERT(epollFd >= 0);
+
+    if (epollFallbackFds.contains(fd)) {
+        if (!events)
+            epollFallbackFds.removeOne(fd);
+        return;
+    }
+
+    if (!events) {
+        // fails harmlessly if fd was closed already, which drops it from the set
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        return;
+    }
+
+    epoll_event ev = {};
+    ev.events = toEpollEvents(events);
+    ev.data.fd = fd;
+
+    int ret = epoll_ctl(epollFd, added ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &ev);
+    if (ret == -1 && errno == ENOENT) // closed and reopened behind our back
+        ret = epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    else if (ret == -1 && errno == EEXIST)
+        ret = epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+
+    // epoll rejects regular files (EPERM) and invalid descriptors (EBADF);
+    // poll() those instead, so they keep their usual always-ready or
+    // POLLNVAL behavior
+    if (ret == -1)
+        epollFallbackFds.append(fd);
+}
+
+/*
+    Called after \a pfd, the poll entry for the epoll set itself, was polled.
+    Appends one pollfd per ready socket to pollfds so that
+    markPendingSocketNotifiers() can handle both backends alike.
+*/
+void QEventDispatcherUNIXPrivate::collectEpollEvents(const pollfd &pfd)
+{
+    Q_ASSERT(pfd.fd == epollFd);
+
+    if (!(pfd.revents & POLLIN))
+        return;
+
+    // the set is level-triggered, so anything beyond one batch is
+    // simply reported again on the next call
+    epoll_event events[256];
+    int n;
+    EINTR_LOOP(n, epoll_wait(epollFd, events, int(sizeof(events) / sizeof(events[0])), 0));
+    if (n == -1) {
+        perror("epoll_wait");
+        return;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        const int fd = events[i].data.fd;
+
+        // a descriptor that was closed while another duplicate kept its file
+        // open cannot be removed from the set anymore; ignore its events
+        if (Q_UNLIKELY(!socketNotifiers.contains(fd)))
+            continue;
+
+        pollfd ready = qt_make_pollfd(fd, 0);
+        ready.revents = fromEpollEvents(events[i].events);
+        pollfds.append(ready);
+    }
+}
+#endif // QT_CONFIG(epoll)
+
 int QEventDispatcherUNIXPrivate::activateSocketNotifiers()
 {
     markPendingSocketNotifiers();
@@ -406,12 +527,20 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
 
     Q_D(QEventDispatcherUNIX);
     QSocketNotifierSetUNIX &sn_set = d->socketNotifiers[sockfd];
+#if QT_CONFIG(epoll)
+    const short oldEvents = sn_set.events();
+#endif
 
     if (sn_set.notifiers[type] && sn_set.notifiers[type] != notifier)
         qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
                  Q_FUNC_INFO, sockfd, socketType(type));
 
     sn_set.notifiers[type] = notifier;
+
+#if QT_CONFIG(epoll)
+    if (d->epollFd >= 0 && sn_set.events() != oldEvents)
+        d->updateEpollSet(sockfd, sn_set.events(), oldEvents == 0);
+#endif
 }
 
 void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
@@ -452,6 +581,11 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
 
     sn_set.notifiers[type] = nullptr;
 
+#if QT_CONFIG(epoll)
+    if (d->epollFd >= 0)
+        d->updateEpollSet(sockfd, sn_set.events(), false);
+#endif
+
     if (sn_set.isEmpty())
         d->socketNotifiers.erase(i);
 }
@@ -488,11 +622,25 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
         tm = &wait_tm;
 
     d->pollfds.clear();
-    d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
 
-    if (include_notifiers)
-        for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
-            d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
+#if QT_CONFIG(epoll)
+    // With epoll, only the set itself (plus anything epoll refused) needs
+    // polling, independently of the number of socket notifiers
+    const bool use_epoll = include_notifiers && d->epollFd >= 0;
+    if (use_epoll) {
+        d->pollfds.reserve(2 + d->epollFallbackFds.size());
+        for (int fd : qAsConst(d->epollFallbackFds))
+            d->pollfds.append(qt_make_pollfd(fd, d->socketNotifiers.value(fd).events()));
+        d->pollfds.append(qt_make_pollfd(d->epollFd, POLLIN));
+    } else
+#endif
+    {
+        d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
+
+        if (include_notifiers)
+            for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
+                d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
+    }
 
     // This must be last, as it's popped off the end below
     d->pollfds.append(d->threadPipe.prepare());
@@ -507,6 +655,10 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
         break;
     default:
         nevents += d->threadPipe.check(d->pollfds.takeLast());
+#if QT_CONFIG(epoll)
+        if (use_epoll)
+            d->collectEpollEvents(d->pollfds.takeLast());
+#endif
         if (include_notifiers)
             nevents += d->activateSocketNotifiers();
         break;
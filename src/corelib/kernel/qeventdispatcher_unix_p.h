@@ -140,6 +140,11 @@ public:
     int activateSocketNotifiers();
     void setSocketNotifierPending(QSocketNotifier *notifier);
 
+#if QT_CONFIG(epoll)
+    void updateEpollSet(int fd, short events, bool added);
+    void collectEpollEvents(const pollfd &pfd);
+#endif
+
     QThreadPipe threadPipe;
     QVector<pollfd> pollfds;
 
@@ -148,6 +153,14 @@ public:
 
     QTimerInfoList timerList;
     QAtomicInt interrupt; // bool
+
+#if QT_CONFIG(epoll)
+    // if valid, socket notifiers stay registered in this epoll(7) set instead
+    // of being copied into pollfds on every call to processEvents()
+    int epollFd = -1;
+    // descriptors epoll refuses (e.g. regular files); these are still polled
+    QVector<int> epollFallbackFds;
+#endif
 };
 
 inline QSocketNotifierSetUNIX::QSocketNotifierSetUNIX() noexcept
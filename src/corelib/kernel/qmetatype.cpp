@@ -44,7 +44,7 @@
 #include "qobjectdefs.h"
 #include "qdatetime.h"
 #include "qbytearray.h"
-#include "qreadwritelock.h"
+#include "qmutex.h"
 #include "qstring.h"
 #include "qstringlist.h"
 #include "qvector.h"
@@ -565,47 +565,192 @@ public:
     int alias;
 };
 
+/*
+    The registries below are read on every construction, destruction,
+    conversion or streaming of a value of a custom type, from any number of
+    threads at once, but only written to when a type or function is
+    registered. So their readers don't take any lock: what they read is
+    never modified once published, but replaced by the writers, which are
+    serialized by a mutex. The replaced data may still be in use by a
+    reader, so it is only deleted with the registry.
+*/
+class QCustomTypeRegistry
+{
+public:
+    ~QCustomTypeRegistry()
+    {
+        const int n = size.loadRelaxed();
+        for (int i = 0; i < n; ++i)
+            delete slot(i).loadRelaxed();
+        for (Slot *segment : segments)
+            delete[] segment;
+        qDeleteAll(retired);
+    }
+
+    int count() const { return size.loadAcquire(); }
+
+    // Returns the type with the given index or nullptr if there is none
+    const QCustomTypeInfo *at(int index) const
+    {
+        if (Q_UNLIKELY(uint(index) >= uint(count())))
+            return nullptr;
+        return slot(index).loadAcquire();
+    }
+
+    // Only to be called with the mutex locked
+    int append(const QCustomTypeInfo &info)
+    {
+        const int index = size.loadRelaxed();
+        Slot *&segment = segments[segmentOf(index)];
+        if (!segment)
+            segment = new Slot[FirstSegmentSize << segmentOf(index)];
+        slot(index).storeRelaxed(new QCustomTypeInfo(info));
+        size.storeRelease(index + 1);
+        return index;
+    }
+
+    // Only to be called with the mutex locked
+    void replace(int index, const QCustomTypeInfo &info)
+    {
+        Slot &s = slot(index);
+        retired.append(s.loadRelaxed());
+        s.storeRelease(new QCustomTypeInfo(info));
+    }
+
+    QMutex mutex;
+
+private:
+    typedef QAtomicPointer<const QCustomTypeInfo> Slot;
+
+    // Each segment is twice as large as the one before, so that the slots
+    // never move and there is no limit on the number of types to speak of
+    enum { FirstSegmentBits = 6, FirstSegmentSize = 1 << FirstSegmentBits,
+           SegmentCount = 32 - FirstSegmentBits };
+
+    static int segmentOf(int index)
+    {
+        return 31 - qCountLeadingZeroBits(uint(index) / FirstSegmentSize + 1);
+    }
+
+    Slot &slot(int index) const
+    {
+        const int segment = segmentOf(index);
+        return segments[segment][uint(index) + FirstSegmentSize - (FirstSegmentSize << segment)];
+    }
+
+    Slot *segments[SegmentCount] = {};
+    QAtomicInt size;
+    QVector<const QCustomTypeInfo *> retired;
+};
+
 template<typename T, typename Key>
 class QMetaTypeFunctionRegistry
 {
 public:
     ~QMetaTypeFunctionRegistry()
     {
-        const QWriteLocker locker(&lock);
-        map.clear();
+        delete table.loadRelaxed();
+        qDeleteAll(retired);
     }
 
     bool contains(Key k) const
     {
-        const QReadLocker locker(&lock);
-        return map.contains(k);
+        return function(k) != nullptr;
     }
 
     bool insertIfNotContains(Key k, const T *f)
     {
-        const QWriteLocker locker(&lock);
-        const T* &fun = map[k];
-        if (fun)
-            return false;
-        fun = f;
+        const QMutexLocker locker(&mutex);
+        Table *t = table.loadRelaxed();
+        if (Entry *e = t ? t->find(k) : nullptr) {
+            if (e->function.loadRelaxed())
+                return false;
+            e->function.storeRelease(f);
+            return true;
+        }
+
+        if (!t || 2 * (t->used + 1) > t->capacity) {
+            Table *grown = new Table(t ? 2 * t->capacity : 16);
+            if (t) {
+                for (int i = 0; i < t->capacity; ++i) {
+                    const Entry &e = t->entries[i];
+                    if (e.occupied.loadRelaxed() && e.function.loadRelaxed())
+                        grown->insert(e.key, e.function.loadRelaxed());
+                }
+                retired.append(t);
+            }
+            t = grown;
+            t->insert(k, f);
+            table.storeRelease(t);
+        } else {
+            t->insert(k, f);
+        }
         return true;
     }
 
     const T *function(Key k) const
     {
-        const QReadLocker locker(&lock);
-        return map.value(k, nullptr);
+        const Table *t = table.loadAcquire();
+        const Entry *e = t ? t->find(k) : nullptr;
+        return e ? e->function.loadAcquire() : nullptr;
     }
 
     void remove(int from, int to)
     {
         const Key k(from, to);
-        const QWriteLocker locker(&lock);
-        map.remove(k);
+        const QMutexLocker locker(&mutex);
+        Table *t = table.loadRelaxed();
+        if (Entry *e = t ? t->find(k) : nullptr)
+            e->function.storeRelease(nullptr);
     }
 private:
-    mutable QReadWriteLock lock;
-    QHash<Key, const T *> map;
+    // An open addressing hash table that only ever gets entries added: the
+    // removed ones keep their key, so that they can be reused by the same one
+    struct Entry
+    {
+        QAtomicInt occupied;
+        Key key;
+        QAtomicPointer<const T> function;
+    };
+
+    struct Table
+    {
+        explicit Table(int capacity)
+            : entries(new Entry[capacity]), capacity(capacity), used(0)
+        {}
+        ~Table() { delete[] entries; }
+
+        Entry *find(const Key &k) const
+        {
+            for (uint i = qHash(k) & (capacity - 1); ; i = (i + 1) & (capacity - 1)) {
+                Entry &e = entries[i];
+                if (!e.occupied.loadAcquire())
+                    return nullptr;
+                if (e.key == k)
+                    return &e;
+            }
+        }
+
+        void insert(const Key &k, const T *f)
+        {
+            uint i = qHash(k) & (capacity - 1);
+            while (entries[i].occupied.loadRelaxed())
+                i = (i + 1) & (capacity - 1);
+            Entry &e = entries[i];
+            e.key = k;
+            e.function.storeRelaxed(f);
+            e.occupied.storeRelease(1);
+            ++used;
+        }
+
+        Entry *entries;
+        const int capacity;
+        int used;
+    };
+
+    QAtomicPointer<Table> table;
+    QMutex mutex;
+    QVector<Table *> retired;
 };
 
 typedef QMetaTypeFunctionRegistry<QtPrivate::AbstractConverterFunction,QPair<int,int> >
@@ -617,9 +762,7 @@ QMetaTypeDebugStreamRegistry;
 
 Q_STATIC_ASSERT(std::is_pod<QMetaTypeInterface>::value);
 
-Q_DECLARE_TYPEINFO(QCustomTypeInfo, Q_MOVABLE_TYPE);
-Q_GLOBAL_STATIC(QVector<QCustomTypeInfo>, customTypes)
-Q_GLOBAL_STATIC(QReadWriteLock, customTypesLock)
+Q_GLOBAL_STATIC(QCustomTypeRegistry, customTypes)
 Q_GLOBAL_STATIC(QMetaTypeConverterRegistry, customTypesConversionRegistry)
 Q_GLOBAL_STATIC(QMetaTypeComparatorRegistry, customTypesComparatorRegistry)
 Q_GLOBAL_STATIC(QMetaTypeDebugStreamRegistry, customTypesDebugStreamRegistry)
@@ -862,13 +1005,14 @@ void QMetaType::registerStreamOperators(int idx, SaveOperator saveOp,
 {
     if (idx < User)
         return; //builtin types should not be registered;
-    QVector<QCustomTypeInfo> *ct = customTypes();
+    QCustomTypeRegistry *ct = customTypes();
     if (!ct)
         return;
-    QWriteLocker locker(customTypesLock());
-    QCustomTypeInfo &inf = (*ct)[idx - User];
+    const QMutexLocker locker(&ct->mutex);
+    QCustomTypeInfo inf = *ct->at(idx - User);
     inf.saveOp = saveOp;
     inf.loadOp = loadOp;
+    ct->replace(idx - User, inf);
 }
 #endif // QT_NO_DATASTREAM
 
@@ -967,11 +1111,9 @@ const char *QMetaType::typeName(int typeId)
         return nullptr; // It can happen when someone cast int to QVariant::Type, we should not crash...
     }
 
-    const QVector<QCustomTypeInfo> * const ct = customTypes();
-    QReadLocker locker(customTypesLock());
-    return ct && uint(ct->count()) > type - QMetaType::User && !ct->at(type - QMetaType::User).typeName.isEmpty()
-            ? ct->at(type - QMetaType::User).typeName.constData()
-            : nullptr;
+    const QCustomTypeRegistry * const ct = customTypes();
+    const QCustomTypeInfo * const info = ct ? ct->at(type - QMetaType::User) : nullptr;
+    return info && !info->typeName.isEmpty() ? info->typeName.constData() : nullptr;
 
 #undef QT_METATYPE_TYPEID_TYPENAME_CONVERTER
 }
@@ -1011,14 +1153,15 @@ static inline int qMetaTypeStaticType(const char *typeName, int length)
 */
 static int qMetaTypeCustomType_unlocked(const char *typeName, int length, int *firstInvalidIndex = nullptr)
 {
-    const QVector<QCustomTypeInfo> * const ct = customTypes();
+    const QCustomTypeRegistry * const ct = customTypes();
     if (!ct)
         return QMetaType::UnknownType;
 
     if (firstInvalidIndex)
         *firstInvalidIndex = -1;
-    for (int v = 0; v < ct->count(); ++v) {
-        const QCustomTypeInfo &customInfo = ct->at(v);
+    const int count = ct->count();
+    for (int v = 0; v < count; ++v) {
+        const QCustomTypeInfo &customInfo = *ct->at(v);
         if ((length == customInfo.typeName.size())
             && !memcmp(typeName, customInfo.typeName.constData(), length)) {
             if (customInfo.alias >= 0)
@@ -1058,21 +1201,26 @@ int QMetaType::registerType(const char *typeName, Deleter deleter,
  */
 bool QMetaType::unregisterType(int type)
 {
-    QWriteLocker locker(customTypesLock());
-    QVector<QCustomTypeInfo> *ct = customTypes();
+    QCustomTypeRegistry *ct = customTypes();
+    if (!ct)
+        return false;
+    const QMutexLocker locker(&ct->mutex);
 
     // check if user type
-    if ((type < User) || ((type - User) >= ct->size()))
+    if ((type < User) || ((type - User) >= ct->count()))
         return false;
 
     // only types without Q_DECLARE_METATYPE can be unregistered
-    if (ct->data()[type - User].flags & WasDeclaredAsMetaType)
+    if (ct->at(type - User)->flags & WasDeclaredAsMetaType)
         return false;
 
     // invalidate type and all its alias entries
     for (int v = 0; v < ct->count(); ++v) {
-        if (((v + User) == type) || (ct->at(v).alias == type))
-            ct->data()[v].typeName.clear();
+        if (((v + User) == type) || (ct->at(v)->alias == type)) {
+            QCustomTypeInfo inf = *ct->at(v);
+            inf.typeName.clear();
+            ct->replace(v, inf);
+        }
     }
     return true;
 }
@@ -1134,7 +1282,7 @@ static int registerNormalizedType(const NS(QByteArray) &normalizedTypeName,
                                   QMetaType::TypedConstructor typedConstructor,
                                   int size, QMetaType::TypeFlags flags, const QMetaObject *metaObject)
 {
-    QVector<QCustomTypeInfo> *ct = customTypes();
+    QCustomTypeRegistry *ct = customTypes();
     if (!ct || normalizedTypeName.isEmpty() || (!destructor && !typedDestructor) || (!constructor && !typedConstructor))
         return -1;
 
@@ -1144,7 +1292,7 @@ static int registerNormalizedType(const NS(QByteArray) &normalizedTypeName,
     int previousSize = 0;
     QMetaType::TypeFlags::Int previousFlags = 0;
     if (idx == QMetaType::UnknownType) {
-        QWriteLocker locker(customTypesLock());
+        const QMutexLocker locker(&ct->mutex);
         int posInVector = -1;
         idx = qMetaTypeCustomType_unlocked(normalizedTypeName.constData(),
                                            normalizedTypeName.size(),
@@ -1165,27 +1313,27 @@ static int registerNormalizedType(const NS(QByteArray) &normalizedTypeName,
             inf.flags = flags;
             inf.metaObject = metaObject;
             if (posInVector == -1) {
-                idx = ct->size() + QMetaType::User;
-                ct->append(inf);
+                idx = ct->append(inf) + QMetaType::User;
             } else {
                 idx = posInVector + QMetaType::User;
-                ct->data()[posInVector] = inf;
+                ct->replace(posInVector, inf);
             }
             return idx;
         }
 
         if (idx >= QMetaType::User) {
-            previousSize = ct->at(idx - QMetaType::User).size;
-            previousFlags = ct->at(idx - QMetaType::User).flags;
+            previousSize = ct->at(idx - QMetaType::User)->size;
+            previousFlags = ct->at(idx - QMetaType::User)->flags;
 
             // Set new/additional flags in case of old library/app.
             // Ensures that older code works in conjunction with new Qt releases
             // requiring the new flags.
             if (flags != previousFlags) {
-                QCustomTypeInfo &inf = ct->data()[idx - QMetaType::User];
+                QCustomTypeInfo inf = *ct->at(idx - QMetaType::User);
                 inf.flags |= flags;
                 if (metaObject)
                     inf.metaObject = metaObject;
+                ct->replace(idx - QMetaType::User, inf);
             }
         }
     }
@@ -1304,7 +1452,7 @@ int QMetaType::registerTypedef(const char* typeName, int aliasId)
 */
 int QMetaType::registerNormalizedTypedef(const NS(QByteArray) &normalizedTypeName, int aliasId)
 {
-    QVector<QCustomTypeInfo> *ct = customTypes();
+    QCustomTypeRegistry *ct = customTypes();
     if (!ct || normalizedTypeName.isEmpty())
         return -1;
 
@@ -1312,7 +1460,7 @@ int QMetaType::registerNormalizedTypedef(const NS(QByteArray) &normalizedTypeNam
                                   normalizedTypeName.size());
 
     if (idx == UnknownType) {
-        QWriteLocker locker(customTypesLock());
+        const QMutexLocker locker(&ct->mutex);
         int posInVector = -1;
         idx = qMetaTypeCustomType_unlocked(normalizedTypeName.constData(),
                                                normalizedTypeName.size(),
@@ -1325,7 +1473,7 @@ int QMetaType::registerNormalizedTypedef(const NS(QByteArray) &normalizedTypeNam
             if (posInVector == -1)
                 ct->append(inf);
             else
-                ct->data()[posInVector] = inf;
+                ct->replace(posInVector, inf);
             return aliasId;
         }
     }
@@ -1355,9 +1503,9 @@ bool QMetaType::isRegistered(int type)
         return true;
     }
 
-    QReadLocker locker(customTypesLock());
-    const QVector<QCustomTypeInfo> * const ct = customTypes();
-    return ((type >= User) && (ct && ct->count() > type - User) && !ct->at(type - User).typeName.isEmpty());
+    const QCustomTypeRegistry * const ct = customTypes();
+    const QCustomTypeInfo * const info = ct && type >= User ? ct->at(type - User) : nullptr;
+    return info && !info->typeName.isEmpty();
 }
 
 template <bool tryNormalizedType>
@@ -1367,7 +1515,6 @@ static inline int qMetaTypeTypeImpl(const char *typeName, int length)
         return QMetaType::UnknownType;
     int type = qMetaTypeStaticType(typeName, length);
     if (type == QMetaType::UnknownType) {
-        QReadLocker locker(customTypesLock());
         type = qMetaTypeCustomType_unlocked(typeName, length);
 #ifndef QT_NO_QOBJECT
         if ((type == QMetaType::UnknownType) && tryNormalizedType) {
@@ -1524,14 +1671,11 @@ public:
     }
     bool delegate(const QMetaTypeSwitcher::NotBuiltinType *data)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        if (!ct)
+        const QCustomTypeRegistry * const ct = customTypes();
+        const QCustomTypeInfo * const info = ct ? ct->at(m_type - QMetaType::User) : nullptr;
+        if (!info)
             return false;
-        QMetaType::SaveOperator saveOp = nullptr;
-        {
-            QReadLocker locker(customTypesLock());
-            saveOp = ct->at(m_type - QMetaType::User).saveOp;
-        }
+        const QMetaType::SaveOperator saveOp = info->saveOp;
         if (!saveOp)
             return false;
         saveOp(stream, data);
@@ -1575,14 +1719,11 @@ public:
     }
     bool delegate(const QMetaTypeSwitcher::NotBuiltinType *data)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        if (!ct)
+        const QCustomTypeRegistry * const ct = customTypes();
+        const QCustomTypeInfo * const info = ct ? ct->at(m_type - QMetaType::User) : nullptr;
+        if (!info)
             return false;
-        QMetaType::LoadOperator loadOp = nullptr;
-        {
-            QReadLocker locker(customTypesLock());
-            loadOp = ct->at(m_type - QMetaType::User).loadOp;
-        }
+        const QMetaType::LoadOperator loadOp = info->loadOp;
         if (!loadOp)
             return false;
         loadOp(stream, const_cast<QMetaTypeSwitcher::NotBuiltinType*>(data));
@@ -1704,17 +1845,12 @@ public:
 private:
     static void *customTypeConstructor(const int type, void *where, const void *copy)
     {
-        QMetaType::Constructor ctor;
-        QMetaType::TypedConstructor tctor;
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        {
-            QReadLocker locker(customTypesLock());
-            if (Q_UNLIKELY(type < QMetaType::User || !ct || ct->count() <= type - QMetaType::User))
-                return nullptr;
-            const auto &typeInfo = ct->at(type - QMetaType::User);
-            ctor = typeInfo.constructor;
-            tctor = typeInfo.typedConstructor;
-        }
+        const QCustomTypeRegistry * const ct = customTypes();
+        const QCustomTypeInfo * const typeInfo = ct && type >= QMetaType::User ? ct->at(type - QMetaType::User) : nullptr;
+        if (Q_UNLIKELY(!typeInfo))
+            return nullptr;
+        const QMetaType::Constructor ctor = typeInfo->constructor;
+        const QMetaType::TypedConstructor tctor = typeInfo->typedConstructor;
         Q_ASSERT_X((ctor || tctor) , "void *QMetaType::construct(int type, void *where, const void *copy)", "The type was not properly registered");
         if (Q_UNLIKELY(tctor))
             return tctor(type, where, copy);
@@ -1802,17 +1938,12 @@ public:
 private:
     static void customTypeDestructor(const int type, void *where)
     {
-        QMetaType::Destructor dtor;
-        QMetaType::TypedDestructor tdtor;
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        {
-            QReadLocker locker(customTypesLock());
-            if (Q_UNLIKELY(type < QMetaType::User || !ct || ct->count() <= type - QMetaType::User))
-                return;
-            const auto &typeInfo = ct->at(type - QMetaType::User);
-            dtor = typeInfo.destructor;
-            tdtor = typeInfo.typedDestructor;
-        }
+        const QCustomTypeRegistry * const ct = customTypes();
+        const QCustomTypeInfo * const typeInfo = ct && type >= QMetaType::User ? ct->at(type - QMetaType::User) : nullptr;
+        if (Q_UNLIKELY(!typeInfo))
+            return;
+        const QMetaType::Destructor dtor = typeInfo->destructor;
+        const QMetaType::TypedDestructor tdtor = typeInfo->typedDestructor;
         Q_ASSERT_X((dtor || tdtor), "void QMetaType::destruct(int type, void *where)", "The type was not properly registered");
         if (Q_UNLIKELY(tdtor))
             return tdtor(type, where);
@@ -1876,11 +2007,11 @@ public:
 private:
     static int customTypeSizeOf(const int type)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        QReadLocker locker(customTypesLock());
-        if (Q_UNLIKELY(type < QMetaType::User || !ct || ct->count() <= type - QMetaType::User))
+        const QCustomTypeRegistry * const ct = customTypes();
+        const QCustomTypeInfo * const typeInfo = ct && type >= QMetaType::User ? ct->at(type - QMetaType::User) : nullptr;
+        if (Q_UNLIKELY(!typeInfo))
             return 0;
-        return ct->at(type - QMetaType::User).size;
+        return typeInfo->size;
     }
 
     const int m_type;
@@ -1944,13 +2075,13 @@ private:
     const int m_type;
     static quint32 customTypeFlags(const int type)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
+        const QCustomTypeRegistry * const ct = customTypes();
         if (Q_UNLIKELY(!ct || type < QMetaType::User))
             return 0;
-        QReadLocker locker(customTypesLock());
-        if (Q_UNLIKELY(ct->count() <= type - QMetaType::User))
+        const QCustomTypeInfo * const typeInfo = ct->at(type - QMetaType::User);
+        if (Q_UNLIKELY(!typeInfo))
             return 0;
-        return ct->at(type - QMetaType::User).flags;
+        return typeInfo->flags;
     }
 };
 }  // namespace
@@ -2008,13 +2139,13 @@ private:
     const int m_type;
     static const QMetaObject *customMetaObject(const int type)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
+        const QCustomTypeRegistry * const ct = customTypes();
         if (Q_UNLIKELY(!ct || type < QMetaType::User))
             return nullptr;
-        QReadLocker locker(customTypesLock());
-        if (Q_UNLIKELY(ct->count() <= type - QMetaType::User))
+        const QCustomTypeInfo * const typeInfo = ct->at(type - QMetaType::User);
+        if (Q_UNLIKELY(!typeInfo))
             return nullptr;
-        return ct->at(type - QMetaType::User).metaObject;
+        return typeInfo->metaObject;
     }
 };
 }  // namespace
@@ -2212,12 +2343,11 @@ public:
 private:
     void customTypeInfo(const uint type)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
+        const QCustomTypeRegistry * const ct = customTypes();
         if (Q_UNLIKELY(!ct))
             return;
-        QReadLocker locker(customTypesLock());
-        if (Q_LIKELY(uint(ct->count()) > type - QMetaType::User))
-            info = ct->at(type - QMetaType::User);
+        if (const QCustomTypeInfo * const typeInfo = ct->at(type - QMetaType::User))
+            info = *typeInfo;
     }
 
     const uint m_type;
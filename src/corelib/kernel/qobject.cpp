@@ -226,7 +226,7 @@ QObjectPrivate::~QObjectPrivate()
         }
     }
 
-    if (postedEvents)
+    if (postedEvents || thisThreadData->postedMetaCalls.loadAcquire())
         QCoreApplication::removePostedEvents(q_ptr, 0);
 
     thisThreadData->deref();
@@ -504,6 +504,8 @@ QAbstractMetaCallEvent::~QAbstractMetaCallEvent()
 #endif
 }
 
+Q_STATIC_ASSERT(sizeof(QMetaCallEvent) <= QEventPool::SlotSize);
+
 /*!
     \internal
  */
@@ -1576,6 +1578,13 @@ void QObject::moveToThread(QThread *targetThread)
     // move the object
     d_func()->setThreadData_helper(currentData, targetData);
 
+#if QT_CONFIG(thread)
+    // queued calls posted without the lock may still have gone to currentData
+    while (currentData->metaCallPosters.fetchAndAddOrdered(0))
+        QThread::yieldCurrentThread();
+#endif
+    currentData->takePostedMetaCalls();
+
     locker.unlock();
 
     // now currentData can commit suicide if it wants to
@@ -3719,7 +3728,7 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
         return;
     }
 
-    QCoreApplication::postEvent(c->receiver.loadRelaxed(), ev);
+    QCoreApplicationPrivate::postMetaCallEvent(c->receiver.loadRelaxed(), ev);
 }
 
 template <bool callbacks_enabled>
@@ -53,6 +53,7 @@
 //
 
 #include <QtCore/private/qglobal_p.h>
+#include <QtCore/private/qcoreevent_p.h>
 #include "QtCore/qobject.h"
 #include "QtCore/qpointer.h"
 #include "QtCore/qsharedpointer.h"
@@ -491,12 +492,23 @@ public:
     inline const QObject *sender() const { return sender_; }
     inline int signalId() const { return signalId_; }
 
+    static void *operator new(std::size_t size) { return QEventPool::allocate(size); }
+    static void *operator new(std::size_t, void *where) noexcept { return where; }
+    static void operator delete(void *ptr) noexcept { QEventPool::deallocate(ptr); }
+    static void operator delete(void *, void *) noexcept {}
+
 private:
+    friend class QCoreApplicationPrivate;
+    friend class QThreadData;
+
     int signalId_;
     const QObject *sender_;
 #if QT_CONFIG(thread)
     QSemaphore *semaphore_;
 #endif
+    // set by QCoreApplicationPrivate::postMetaCallEvent()
+    QObject *postedTo_ = nullptr;
+    QAbstractMetaCallEvent *nextPosted_ = nullptr;
 };
 
 class Q_CORE_EXPORT QMetaCallEvent : public QAbstractMetaCallEvent
@@ -40,6 +40,7 @@
 
 #include <qelapsedtimer.h>
 #include <qcoreapplication.h>
+#include <qvarlengtharray.h>
 
 #include "private/qcore_unix_p.h"
 #include "private/qtimerinfo_unix_p.h"
@@ -53,6 +54,8 @@
 
 #include <sys/times.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 Q_CORE_EXPORT bool qt_disable_lowpriority_timers=false;
@@ -84,6 +87,7 @@ QTimerInfoList::QTimerInfoList()
 #endif
 
     firstTimerInfo = nullptr;
+    nextInsertionOrder = 0;
 }
 
 timespec QTimerInfoList::updateCurrentTime()
@@ -174,18 +178,127 @@ void QTimerInfoList::repairTimersIfNeeded()
 
 #endif
 
+/*
+  Heap order: earliest timeout first. Timers with the same timeout are taken
+  in the order they were inserted, like the sorted list this used to be.
+*/
+static inline bool timerLessThan(const QTimerInfo *t1, const QTimerInfo *t2)
+{
+    if (t1->timeout < t2->timeout)
+        return true;
+    if (t2->timeout < t1->timeout)
+        return false;
+    return t1->insertionOrder < t2->insertionOrder;
+}
+
+void QTimerInfoList::heapSiftUp(int index)
+{
+    QTimerInfo **heap = data();
+    QTimerInfo *ti = heap[index];
+    while (index > 0) {
+        const int parent = (index - 1) / 2;
+        if (!timerLessThan(ti, heap[parent]))
+            break;
+        heap[index] = heap[parent];
+        heap[index]->heapIndex = index;
+        index = parent;
+    }
+    heap[index] = ti;
+    ti->heapIndex = index;
+}
+
+void QTimerInfoList::heapSiftDown(int index)
+{
+    QTimerInfo **heap = data();
+    const int n = size();
+    QTimerInfo *ti = heap[index];
+    for (;;) {
+        int child = 2 * index + 1;
+        if (child >= n)
+            break;
+        if (child + 1 < n && timerLessThan(heap[child + 1], heap[child]))
+            ++child;
+        if (!timerLessThan(heap[child], ti))
+            break;
+        heap[index] = heap[child];
+        heap[index]->heapIndex = index;
+        index = child;
+    }
+    heap[index] = ti;
+    ti->heapIndex = index;
+}
+
+void QTimerInfoList::heapify()
+{
+    for (int i = 0; i < size(); ++i)
+        at(i)->heapIndex = i;
+    for (int i = size() / 2 - 1; i >= 0; --i)
+        heapSiftDown(i);
+}
+
 /*
   insert timer info into list
 */
 void QTimerInfoList::timerInsert(QTimerInfo *ti)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
-            break;
+    ti->insertionOrder = nextInsertionOrder++;
+    append(ti);
+    heapSiftUp(size() - 1);
+}
+
+/*
+  remove timer info from list, without deleting it
+*/
+void QTimerInfoList::timerRemove(QTimerInfo *ti)
+{
+    const int index = ti->heapIndex;
+    Q_ASSERT(at(index) == ti);
+
+    QTimerInfo *last = takeLast();
+    if (last == ti)
+        return;
+
+    data()[index] = last;
+    last->heapIndex = index;
+    if (index > 0 && timerLessThan(last, at((index - 1) / 2)))
+        heapSiftUp(index);
+    else
+        heapSiftDown(index);
+}
+
+/*
+  Returns the earliest timer that is not being activated right now, if any.
+  Timers are only active while activateTimers() delivers their event, so
+  this only looks beyond the first entry in nested event loops.
+*/
+QTimerInfo *QTimerInfoList::firstWaitingTimer() const
+{
+    if (isEmpty())
+        return nullptr;
+    if (!constFirst()->activateRef)
+        return constFirst();
+
+    // Visit the heap in timeout order. Every entry we pass is active, and each
+    // one adds at most one candidate, so this stays small.
+    QVarLengthArray<int, 16> candidates;
+    candidates.append(0);
+    while (!candidates.isEmpty()) {
+        int best = 0;
+        for (int i = 1; i < candidates.size(); ++i) {
+            if (timerLessThan(at(candidates.at(i)), at(candidates.at(best))))
+                best = i;
+        }
+        const int index = candidates.at(best);
+        QTimerInfo *t = at(index);
+        if (!t->activateRef)
+            return t;
+
+        candidates[best] = candidates.last();
+        candidates.removeLast();
+        for (int child = 2 * index + 1; child <= 2 * index + 2 && child < size(); ++child)
+            candidates.append(child);
     }
-    insert(index+1, ti);
+    return nullptr;
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -389,14 +502,7 @@ bool QTimerInfoList::timerWait(timespec &tm)
     repairTimersIfNeeded();
 
     // Find first waiting timer not already active
-    QTimerInfo *t = nullptr;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
-            break;
-        }
-    }
-
+    QTimerInfo *t = firstWaitingTimer();
     if (!t)
       return false;
 
@@ -423,16 +529,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (const QTimerInfo *t = timersById.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -494,6 +597,7 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
     }
 
     timerInsert(t);
+    timersById.insert(timerId, t);
 
 #ifdef QTIMERINFO_DEBUG
     t->expected = expected;
@@ -507,41 +611,43 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
 
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
-    // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = nullptr;
-            if (t->activateRef)
-                *(t->activateRef) = nullptr;
-            delete t;
-            return true;
-        }
+    QTimerInfo *t = timersById.take(timerId);
+    if (!t) {
+        // id not found
+        return false;
     }
-    // id not found
-    return false;
+
+    // set timer inactive
+    timerRemove(t);
+    if (t == firstTimerInfo)
+        firstTimerInfo = nullptr;
+    if (t->activateRef)
+        *(t->activateRef) = nullptr;
+    delete t;
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->obj == object) {
-            // object found
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = nullptr;
-            if (t->activateRef)
-                *(t->activateRef) = nullptr;
-            delete t;
-            // move back one so that we don't skip the new current item
-            --i;
-        }
+
+    // drop all of the object's timers in one pass, then restore the heap
+    const auto isObjectTimer = [this, object](QTimerInfo *t) {
+        if (t->obj != object)
+            return false;
+        timersById.remove(t->id);
+        if (t == firstTimerInfo)
+            firstTimerInfo = nullptr;
+        if (t->activateRef)
+            *(t->activateRef) = nullptr;
+        delete t;
+        return true;
+    };
+    const auto newEnd = std::remove_if(begin(), end(), isObjectTimer);
+    if (newEnd != end()) {
+        erase(newEnd, end());
+        heapify();
     }
     return true;
 }
@@ -578,11 +684,18 @@ int QTimerInfoList::activateTimers()
     repairTimersIfNeeded();
 
 
-    // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
-            break;
+    // Find out how many timer have expired; the children of a timer in the
+    // heap never expire before it does
+    QVarLengthArray<int, 64> pending;
+    pending.append(0);
+    while (!pending.isEmpty()) {
+        const int index = pending.last();
+        pending.removeLast();
+        if (currentTime < at(index)->timeout)
+            continue;
         maxCount++;
+        for (int child = 2 * index + 1; child <= 2 * index + 2 && child < size(); ++child)
+            pending.append(child);
     }
 
     //fire the timers.
@@ -605,7 +718,7 @@ int QTimerInfoList::activateTimers()
         }
 
         // remove from list
-        removeFirst();
+        timerRemove(currentTimerInfo);
 
 #ifdef QTIMERINFO_DEBUG
         float diff;
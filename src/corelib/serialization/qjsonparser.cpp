@@ -47,6 +47,7 @@
 #include "private/qutfcodec_p.h"
 #include "private/qcborvalue_p.h"
 #include "private/qnumeric_p.h"
+#include "private/qsimd_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -283,8 +284,123 @@ void Parser::eatBOM()
         json += 3;
 }
 
+static inline bool isWhitespace(char c)
+{
+    return c == Space || c == Tab || c == LineFeed || c == Return;
+}
+
+/*
+    The scanners below process the input in blocks of 16 (SSE2) or 32 (AVX2)
+    bytes and stop at the first byte that needs a closer look. They are what
+    makes indentation and plain ASCII string content cheap to skip; the rest
+    of the parser only deals with the bytes they stop at.
+*/
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+QT_FUNCTION_TARGET(AVX2)
+static const char *skipWhitespace_avx2(const char *ptr, const char *end)
+{
+    const __m256i space = _mm256_set1_epi8(Space);
+    const __m256i tab = _mm256_set1_epi8(Tab);
+    const __m256i lineFeed = _mm256_set1_epi8(LineFeed);
+    const __m256i ret = _mm256_set1_epi8(Return);
+    for ( ; end - ptr >= 32; ptr += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+        const __m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(data, space),
+                                                           _mm256_cmpeq_epi8(data, tab)),
+                                           _mm256_or_si256(_mm256_cmpeq_epi8(data, lineFeed),
+                                                           _mm256_cmpeq_epi8(data, ret)));
+        const uint mask = ~uint(_mm256_movemask_epi8(ws));
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+    return ptr;
+}
+
+// Returns the first quote, backslash or non-ASCII byte
+QT_FUNCTION_TARGET(AVX2)
+static const char *skipPlainAscii_avx2(const char *ptr, const char *end)
+{
+    const __m256i quote = _mm256_set1_epi8(Quote);
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    for ( ; end - ptr >= 32; ptr += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+        const __m256i special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(data, quote),
+                                                                _mm256_cmpeq_epi8(data, backslash)),
+                                                data);
+        // the sign bit is set for the matches and for non-ASCII bytes
+        const uint mask = uint(_mm256_movemask_epi8(special));
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+    return ptr;
+}
+#endif
+
+static const char *skipWhitespace(const char *ptr, const char *end)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2)) {
+        ptr = skipWhitespace_avx2(ptr, end);
+        if (end - ptr >= 32)
+            return ptr;
+    }
+#endif
+#ifdef __SSE2__
+    const __m128i space = _mm_set1_epi8(Space);
+    const __m128i tab = _mm_set1_epi8(Tab);
+    const __m128i lineFeed = _mm_set1_epi8(LineFeed);
+    const __m128i ret = _mm_set1_epi8(Return);
+    for ( ; end - ptr >= 16; ptr += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        const __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, space),
+                                                     _mm_cmpeq_epi8(data, tab)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(data, lineFeed),
+                                                     _mm_cmpeq_epi8(data, ret)));
+        const uint mask = ~uint(_mm_movemask_epi8(ws)) & 0xffff;
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+#endif
+    while (ptr < end && isWhitespace(*ptr))
+        ++ptr;
+    return ptr;
+}
+
+static const char *skipPlainAscii(const char *ptr, const char *end)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2)) {
+        ptr = skipPlainAscii_avx2(ptr, end);
+        if (end - ptr >= 32)
+            return ptr;
+    }
+#endif
+#ifdef __SSE2__
+    const __m128i quote = _mm_set1_epi8(Quote);
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for ( ; end - ptr >= 16; ptr += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        const __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, quote),
+                                                          _mm_cmpeq_epi8(data, backslash)),
+                                             data);
+        const uint mask = uint(_mm_movemask_epi8(special));
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+#endif
+    while (ptr < end && *ptr != Quote && *ptr != '\\' && uchar(*ptr) < 0x80)
+        ++ptr;
+    return ptr;
+}
+
 bool Parser::eatSpace()
 {
+    // most tokens are not preceded by whitespace at all, or by a single
+    // space; only call out for longer runs such as indentation
+    if (json < end && *json > Space)
+        return true;
+    if (end - json > 1 && isWhitespace(*json) && isWhitespace(json[1]))
+        json = skipWhitespace(json, end);
     while (json < end) {
         if (*json > Space)
             break;
@@ -867,6 +983,9 @@ bool Parser::parseString()
     bool isAscii = true;
     while (json < end) {
         uint ch = 0;
+        json = skipPlainAscii(json, end);
+        if (json >= end)
+            break;
         if (*json == '"')
             break;
         if (*json == '\\') {
@@ -909,6 +1028,12 @@ bool Parser::parseString()
     QString ucs4;
     while (json < end) {
         uint ch = 0;
+        const char *plain = json;
+        json = skipPlainAscii(json, end);
+        if (json != plain)
+            ucs4.append(QLatin1String(plain, int(json - plain)));
+        if (json >= end)
+            break;
         if (*json == '"')
             break;
         else if (*json == '\\') {
@@ -942,4 +1067,44 @@ bool Parser::parseString()
     return true;
 }
 
+QJsonParseError::ParseError QJsonPrivate::decodeString(const char *begin, const char *end,
+                                                       QString *result)
+{
+    const char *json = begin;
+    if (!memchr(json, '\\', end - json)) {
+        const auto validity = QUtf8::isValidUtf8(json, end - json);
+        if (!validity.isValidUtf8)
+            return QJsonParseError::IllegalUTF8String;
+        *result = validity.isValidAscii ? QString::fromLatin1(json, int(end - json))
+                                        : QString::fromUtf8(json, int(end - json));
+        return QJsonParseError::NoError;
+    }
+
+    QString ucs4;
+    ucs4.reserve(int(end - json));
+    while (json < end) {
+        uint ch = 0;
+        const char *plain = json;
+        json = skipPlainAscii(json, end);
+        if (json != plain)
+            ucs4.append(QLatin1String(plain, int(json - plain)));
+        if (json >= end)
+            break;
+        if (*json == '\\') {
+            if (!scanEscapeSequence(json, end, &ch))
+                return QJsonParseError::IllegalEscapeSequence;
+        } else if (!scanUtf8Char(json, end, &ch)) {
+            return QJsonParseError::IllegalUTF8String;
+        }
+        if (QChar::requiresSurrogates(ch)) {
+            ucs4.append(QChar::highSurrogate(ch));
+            ucs4.append(QChar::lowSurrogate(ch));
+        } else {
+            ucs4.append(QChar(ushort(ch)));
+        }
+    }
+    *result = std::move(ucs4);
+    return QJsonParseError::NoError;
+}
+
 QT_END_NAMESPACE
@@ -86,6 +86,9 @@ private:
     QExplicitlySharedDataPointer<QCborContainerPrivate> container;
 };
 
+// Decodes the contents of a JSON string, without the quotes, to UTF-16
+QJsonParseError::ParseError decodeString(const char *begin, const char *end, QString *result);
+
 }
 
 QT_END_NAMESPACE
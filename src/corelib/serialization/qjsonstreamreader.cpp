@@ -0,0 +1,819 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qjsonstreamreader.h"
+
+#include "qjsonarray.h"
+#include "qjsonobject.h"
+#include "qjsonparser_p.h"
+#include "private/qnumeric_p.h"
+
+#include <qiodevice.h>
+#include <qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+static const int nestingLimit = 1024;
+static const qsizetype ReadChunkSize = 64 * 1024;
+
+class QJsonStreamReaderPrivate
+{
+public:
+    enum State : quint8 {
+        TopLevel,               // between top-level values
+        ValueExpected,          // after a name separator, or a value separator in an array
+        ArrayStart,             // after '[': a value or ']'
+        ObjectStart,            // after '{': a name or '}'
+        NameExpected,           // after a value separator in an object
+        NameSeparatorExpected,  // after a name
+        ValueEnded              // after a value in a container: ',' or the closing bracket
+    };
+
+    // Outcome of trying to read one token from the buffered data
+    enum ScanResult { Done, NeedMoreData, Failed };
+
+    // A container that readValue() is still assembling
+    struct PartialValue
+    {
+        QJsonArray array;
+        QJsonObject object;
+        QString name;
+        bool isObject;
+    };
+
+    QIODevice *device = nullptr;
+    QByteArray buffer;
+    qsizetype pos = 0;              // first unconsumed byte in buffer
+    qint64 bufferOffset = 0;        // offset of buffer[0] in the stream
+    qsizetype stringScanned = 0;    // bytes of an incomplete string that were already scanned
+    QByteArray containers;          // '[' or '{' for every open container
+    State state = TopLevel;
+    bool dataIsComplete = false;
+
+    QJsonStreamReader::TokenType token = QJsonStreamReader::NoToken;
+    qint64 tokenOffset = 0;
+    QString text;
+    double number = 0;
+    qint64 integer = 0;
+    bool numberIsInteger = false;
+    bool boolean = false;
+
+    QJsonParseError::ParseError error = QJsonParseError::NoError;
+    bool atEnd = false;
+
+    QVector<PartialValue> partialValues;
+    int skipToDepth = -1;
+
+    bool isInputFinished() const;
+    bool fillBuffer();
+    void compact();
+
+    QJsonStreamReader::TokenType readNext();
+    QJsonStreamReader::TokenType fail(QJsonParseError::ParseError e)
+    {
+        error = e;
+        partialValues.clear();
+        skipToDepth = -1;
+        return token = QJsonStreamReader::Invalid;
+    }
+    void valueEnded() { state = containers.isEmpty() ? TopLevel : ValueEnded; }
+
+    ScanResult scanToken(bool final);
+    ScanResult scanValue(bool final);
+    ScanResult scanString(bool final);
+    ScanResult scanNumber(bool final);
+    ScanResult scanLiteral(const char *literal, qsizetype len, bool final);
+};
+
+static inline bool isWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/*
+    Returns true if no more data will arrive: the reader was given complete
+    data, or the device is at its end and cannot grow, or it was closed.
+    For sequential devices that are still open, more data may always follow.
+*/
+bool QJsonStreamReaderPrivate::isInputFinished() const
+{
+    if (!device)
+        return dataIsComplete;
+    if (!device->isOpen())
+        return true;
+    return !device->isSequential() && device->atEnd();
+}
+
+void QJsonStreamReaderPrivate::compact()
+{
+    if (pos == 0)
+        return;
+    buffer.remove(0, int(pos));
+    bufferOffset += pos;
+    pos = 0;
+}
+
+bool QJsonStreamReaderPrivate::fillBuffer()
+{
+    if (!device || !device->isOpen())
+        return false;
+
+    // only keep the unconsumed part, which is at most one incomplete token
+    compact();
+    const qsizetype oldSize = buffer.size();
+    buffer.resize(int(oldSize + ReadChunkSize));
+    const qint64 n = device->read(buffer.data() + oldSize, ReadChunkSize);
+    buffer.resize(int(oldSize + qMax(n, qint64(0))));
+    return n > 0;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readNext()
+{
+    if (error != QJsonParseError::NoError)
+        return token = QJsonStreamReader::Invalid;
+
+    atEnd = false;
+    for (;;) {
+        const char *data = buffer.constData();
+        while (pos < buffer.size() && isWhitespace(data[pos]))
+            ++pos;
+        if (pos == buffer.size()) {
+            if (fillBuffer())
+                continue;
+            tokenOffset = bufferOffset + pos;
+            if (state != TopLevel && isInputFinished()) {
+                return fail(containers.endsWith('{') ? QJsonParseError::UnterminatedObject
+                                                     : QJsonParseError::UnterminatedArray);
+            }
+            atEnd = true;
+            return token = QJsonStreamReader::NoToken;
+        }
+
+        tokenOffset = bufferOffset + pos;
+        const char c = data[pos];
+        const bool inArray = containers.endsWith('[');
+
+        // separators are not reported as tokens
+        if (state == NameSeparatorExpected) {
+            if (c != ':')
+                return fail(QJsonParseError::MissingNameSeparator);
+            ++pos;
+            state = ValueExpected;
+            continue;
+        }
+        if (state == ValueEnded && c == ',') {
+            ++pos;
+            state = inArray ? ValueExpected : NameExpected;
+            continue;
+        }
+
+        if ((c == ']' || c == '}')
+                && (state == ValueEnded || state == ArrayStart || state == ObjectStart)) {
+            if (c != (inArray ? ']' : '}')) {
+                return fail(inArray ? QJsonParseError::UnterminatedArray
+                                    : QJsonParseError::UnterminatedObject);
+            }
+            ++pos;
+            containers.chop(1);
+            valueEnded();
+            return token = inArray ? QJsonStreamReader::EndArray : QJsonStreamReader::EndObject;
+        }
+        if (state == ValueEnded) {
+            return fail(inArray ? QJsonParseError::MissingValueSeparator
+                                : QJsonParseError::UnterminatedObject);
+        }
+
+        ScanResult result = scanToken(false);
+        while (result == NeedMoreData) {
+            if (fillBuffer()) {
+                result = scanToken(false);
+            } else if (isInputFinished()) {
+                // a final scan either completes the token or fails
+                result = scanToken(true);
+            } else {
+                atEnd = true;
+                return token = QJsonStreamReader::NoToken;
+            }
+        }
+        return token;
+    }
+}
+
+QJsonStreamReaderPrivate::ScanResult QJsonStreamReaderPrivate::scanToken(bool final)
+{
+    if (state == ObjectStart || state == NameExpected) {
+        if (buffer.at(int(pos)) != '"') {
+            fail(QJsonParseError::UnterminatedObject);
+            return Failed;
+        }
+        const ScanResult result = scanString(final);
+        if (result == Done) {
+            state = NameSeparatorExpected;
+            token = QJsonStreamReader::Name;
+        }
+        return result;
+    }
+    return scanValue(final);
+}
+
+QJsonStreamReaderPrivate::ScanResult QJsonStreamReaderPrivate::scanValue(bool final)
+{
+    const char c = buffer.at(int(pos));
+    switch (c) {
+    case '[':
+    case '{':
+        if (containers.size() >= nestingLimit) {
+            fail(QJsonParseError::DeepNesting);
+            return Failed;
+        }
+        ++pos;
+        containers.append(c);
+        state = c == '[' ? ArrayStart : ObjectStart;
+        token = c == '[' ? QJsonStreamReader::StartArray : QJsonStreamReader::StartObject;
+        return Done;
+    case '"': {
+        const ScanResult result = scanString(final);
+        if (result == Done) {
+            token = QJsonStreamReader::String;
+            valueEnded();
+        }
+        return result;
+    }
+    case 't':
+    case 'f':
+    case 'n': {
+        const char *literal = c == 't' ? "true" : c == 'f' ? "false" : "null";
+        const ScanResult result = scanLiteral(literal, qsizetype(strlen(literal)), final);
+        if (result == Done) {
+            token = c == 'n' ? QJsonStreamReader::Null : QJsonStreamReader::Bool;
+            boolean = c == 't';
+            valueEnded();
+        }
+        return result;
+    }
+    default:
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            const ScanResult result = scanNumber(final);
+            if (result == Done) {
+                token = QJsonStreamReader::Number;
+                valueEnded();
+            }
+            return result;
+        }
+        fail(QJsonParseError::IllegalValue);
+        return Failed;
+    }
+}
+
+QJsonStreamReaderPrivate::ScanResult QJsonStreamReaderPrivate::scanString(bool final)
+{
+    const char *data = buffer.constData();
+    const char *const begin = data + pos + 1;
+    const char *const end = data + buffer.size();
+
+    // find the closing quote, skipping escaped characters
+    const char *p = begin + stringScanned;
+    const char *quote = nullptr;
+    while (p < end) {
+        const char *q = static_cast<const char *>(memchr(p, '"', end - p));
+        const char *escape = static_cast<const char *>(memchr(p, '\\', (q ? q : end) - p));
+        if (!escape) {
+            quote = q;
+            p = q ? q : end;
+            break;
+        }
+        if (escape + 1 >= end) {
+            p = escape;
+            break;
+        }
+        p = escape + 2;
+    }
+
+    if (!quote) {
+        if (final) {
+            fail(QJsonParseError::UnterminatedString);
+            return Failed;
+        }
+        stringScanned = p - begin;
+        return NeedMoreData;
+    }
+
+    stringScanned = 0;
+    const QJsonParseError::ParseError e = QJsonPrivate::decodeString(begin, quote, &text);
+    if (e != QJsonParseError::NoError) {
+        fail(e);
+        return Failed;
+    }
+    pos = quote + 1 - data;
+    return Done;
+}
+
+QJsonStreamReaderPrivate::ScanResult QJsonStreamReaderPrivate::scanNumber(bool final)
+{
+    // the same grammar as QJsonPrivate::Parser::parseNumber()
+    const char *data = buffer.constData();
+    const char *const start = data + pos;
+    const char *const end = data + buffer.size();
+    const char *json = start;
+    bool isInt = true;
+
+    if (json < end && *json == '-')
+        ++json;
+    if (json < end && *json == '0') {
+        ++json;
+    } else {
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+    if (json < end && *json == '.') {
+        ++json;
+        while (json < end && *json >= '0' && *json <= '9') {
+            isInt = isInt && *json == '0';
+            ++json;
+        }
+    }
+    if (json < end && (*json == 'e' || *json == 'E')) {
+        isInt = false;
+        ++json;
+        if (json < end && (*json == '-' || *json == '+'))
+            ++json;
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+
+    // the number might continue in data that has not arrived yet
+    if (json >= end && !final)
+        return NeedMoreData;
+
+    const QByteArray numberText = QByteArray::fromRawData(start, int(json - start));
+    bool ok = false;
+    if (isInt) {
+        integer = numberText.toLongLong(&ok);
+        if (ok)
+            number = double(integer);
+    }
+    if (!ok) {
+        number = numberText.toDouble(&ok);
+        if (!ok) {
+            fail(QJsonParseError::IllegalNumber);
+            return Failed;
+        }
+        isInt = convertDoubleTo(number, &integer);
+    }
+    numberIsInteger = isInt;
+    pos = json - data;
+    return Done;
+}
+
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::scanLiteral(const char *literal, qsizetype len, bool final)
+{
+    const qsizetype available = qMin(len, qsizetype(buffer.size()) - pos);
+    if (memcmp(buffer.constData() + pos, literal, size_t(available)) != 0) {
+        fail(QJsonParseError::IllegalValue);
+        return Failed;
+    }
+    if (available < len) {
+        if (final) {
+            fail(QJsonParseError::IllegalValue);
+            return Failed;
+        }
+        return NeedMoreData;
+    }
+    pos += len;
+    return Done;
+}
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 6.0
+
+    \brief The QJsonStreamReader class is a simple streaming JSON parser.
+
+    QJsonStreamReader reads JSON one token at a time from a QIODevice or from
+    data added with addData(). Unlike QJsonDocument::fromJson(), it never needs
+    the whole input in memory: it only buffers the data of the token that is
+    being read. That makes it suitable for very large documents, for streams of
+    many top-level values such as newline-delimited JSON logs, and for data
+    that arrives over the network in pieces.
+
+    The basic concept is the same as in QXmlStreamReader: call readNext() to
+    advance to the next token, then inspect it with tokenType() and the
+    accessor functions. Object members are reported as a \l Name token
+    followed by the tokens of the value.
+
+    \snippet code/src_corelib_serialization_qjsonstreamreader.cpp 0
+
+    Whitespace-separated top-level values are read one after the other. Use
+    readValue() to turn the value that starts at the current token into a
+    QJsonValue, for instance one record of a log, and skipValue() to ignore
+    it.
+
+    \section1 Incremental parsing
+
+    If readNext() needs more data than is currently available, it returns
+    \l NoToken and atEnd() becomes \c true. When more data is available, for
+    instance after the readyRead() signal of the device, or after calling
+    addData(), call readNext() again to continue where the reader left off.
+    readValue() and skipValue() can be resumed in the same way.
+
+    For devices that are not sequential, the reader knows that the input is
+    complete once the device is at its end. The same applies to closed
+    devices and to a reader constructed from a QByteArray. For other input,
+    more data might always follow, so a truncated document is not reported
+    as an error; check depth() once the input is known to be complete.
+
+    Syntax errors are reported by returning \l Invalid. The error is sticky:
+    error() and errorString() describe it and all further calls to
+    readNext() return \l Invalid until the reader is cleared.
+
+    \sa QJsonStreamWriter, QJsonDocument, QCborStreamReader
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum specifies the type of token the reader just read.
+
+    \value NoToken      No token has been read yet, or the available data
+                        has been consumed. See atEnd().
+    \value Invalid      An error occurred, see error().
+    \value StartArray   The beginning of an array.
+    \value EndArray     The end of an array.
+    \value StartObject  The beginning of an object.
+    \value EndObject    The end of an object.
+    \value Name         The name of an object member, available with text().
+                        The tokens of the member's value follow.
+    \value String       A string, available with text().
+    \value Number       A number, available with toDouble() and, if
+                        isInteger() returns \c true, toInteger().
+    \value Bool         \c true or \c false, available with toBool().
+    \value Null         \c null.
+*/
+
+/*!
+    Constructs a stream reader without a device or data. Use setDevice() or
+    addData() to give it input.
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+    Constructs a stream reader that reads from \a data. The data is treated
+    as complete, unless more is added with addData().
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : d(new QJsonStreamReaderPrivate)
+{
+    d->buffer = data;
+    d->dataIsComplete = true;
+}
+
+/*!
+    Constructs a stream reader that reads from \a device.
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : d(new QJsonStreamReaderPrivate)
+{
+    d->device = device;
+}
+
+/*!
+    Destroys the stream reader.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Sets the current device to \a device and resets the reader to its
+    initial state. The reader does not take ownership of the device.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    clear();
+    d->device = device;
+}
+
+/*!
+    Returns the device the reader reads from, or \nullptr.
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    return d->device;
+}
+
+/*!
+    Adds \a data for the reader to read. This function does nothing if the
+    reader has a device.
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    addData(data.constData(), data.size());
+}
+
+/*!
+    \overload
+
+    Adds \a len bytes from \a data for the reader to read.
+*/
+void QJsonStreamReader::addData(const char *data, qsizetype len)
+{
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with a device set is not supported");
+        return;
+    }
+    d->compact();
+    d->buffer.append(data, int(len));
+    d->dataIsComplete = false;
+    d->atEnd = false;
+}
+
+/*!
+    Removes any device or data from the reader and resets it to its initial
+    state, including the error state.
+*/
+void QJsonStreamReader::clear()
+{
+    d.reset(new QJsonStreamReaderPrivate);
+}
+
+/*!
+    Reads the next token and returns its type.
+
+    Returns \l NoToken if there is not enough data to complete the next token;
+    call it again once more data is available. Returns \l Invalid if the input
+    is not valid JSON.
+
+    \sa tokenType(), atEnd()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    return d->readNext();
+}
+
+/*!
+    Returns the type of the current token.
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    return d->token;
+}
+
+/*!
+    Returns \c true if the reader has consumed all currently available data,
+    or has stopped because of an error; otherwise returns \c false.
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    return d->atEnd || d->error != QJsonParseError::NoError;
+}
+
+/*!
+    Returns the number of arrays and objects that are open at the current
+    position. After \l StartArray or \l StartObject, this includes the
+    container that was just started.
+*/
+int QJsonStreamReader::depth() const
+{
+    return d->containers.size();
+}
+
+/*!
+    Returns the offset in the input of the current token, or of the error.
+    After \l NoToken, this is the offset up to which the input was consumed.
+*/
+qint64 QJsonStreamReader::currentOffset() const
+{
+    return d->tokenOffset;
+}
+
+/*!
+    Returns \c true if an error occurred.
+*/
+bool QJsonStreamReader::hasError() const
+{
+    return d->error != QJsonParseError::NoError;
+}
+
+/*!
+    Returns the error that occurred, or QJsonParseError::NoError.
+
+    \sa errorString(), currentOffset()
+*/
+QJsonParseError::ParseError QJsonStreamReader::error() const
+{
+    return d->error;
+}
+
+/*!
+    Returns a human readable description of the error.
+*/
+QString QJsonStreamReader::errorString() const
+{
+    QJsonParseError error;
+    error.offset = int(d->tokenOffset);
+    error.error = d->error;
+    return error.errorString();
+}
+
+/*!
+    Returns the text of the current \l Name or \l String token, or a null
+    string for other tokens.
+*/
+QString QJsonStreamReader::text() const
+{
+    if (d->token == Name || d->token == String)
+        return d->text;
+    return QString();
+}
+
+/*!
+    Returns \c true if the current token is a \l Number that is an integer
+    that fits into a qint64.
+*/
+bool QJsonStreamReader::isInteger() const
+{
+    return d->token == Number && d->numberIsInteger;
+}
+
+/*!
+    Returns the value of the current \l Number token as an integer. The
+    result is only meaningful if isInteger() returns \c true.
+*/
+qint64 QJsonStreamReader::toInteger() const
+{
+    return d->token == Number ? d->integer : 0;
+}
+
+/*!
+    Returns the value of the current \l Number token.
+*/
+double QJsonStreamReader::toDouble() const
+{
+    return d->token == Number ? d->number : 0;
+}
+
+/*!
+    Returns the value of the current \l Bool token.
+*/
+bool QJsonStreamReader::toBool() const
+{
+    return d->token == Bool && d->boolean;
+}
+
+static QJsonValue scalarValue(const QJsonStreamReader &reader)
+{
+    switch (reader.tokenType()) {
+    case QJsonStreamReader::String:
+        return reader.text();
+    case QJsonStreamReader::Number:
+        if (reader.isInteger())
+            return reader.toInteger();
+        return reader.toDouble();
+    case QJsonStreamReader::Bool:
+        return reader.toBool();
+    case QJsonStreamReader::Null:
+        return QJsonValue(QJsonValue::Null);
+    default:
+        return QJsonValue(QJsonValue::Undefined);
+    }
+}
+
+/*!
+    Reads the value that starts at the current token and returns it. For
+    \l StartArray and \l StartObject, this reads up to and including the
+    matching end token.
+
+    Returns an undefined QJsonValue if the current token does not start a
+    value, if an error occurs, or if the data runs out before the value is
+    complete. In the last case, calling readValue() again once more data is
+    available continues reading the same value; do not call readNext() in
+    between.
+
+    \sa skipValue()
+*/
+QJsonValue QJsonStreamReader::readValue()
+{
+    using PartialValue = QJsonStreamReaderPrivate::PartialValue;
+    if (d->partialValues.isEmpty()) {
+        if (d->token == StartArray)
+            d->partialValues.append(PartialValue{ {}, {}, {}, false });
+        else if (d->token == StartObject)
+            d->partialValues.append(PartialValue{ {}, {}, {}, true });
+        else
+            return scalarValue(*this);
+    }
+
+    for (;;) {
+        QJsonValue value;
+        switch (readNext()) {
+        case NoToken:
+        case Invalid:
+            return QJsonValue(QJsonValue::Undefined);
+        case Name:
+            d->partialValues.last().name = d->text;
+            continue;
+        case StartArray:
+            d->partialValues.append(PartialValue{ {}, {}, {}, false });
+            continue;
+        case StartObject:
+            d->partialValues.append(PartialValue{ {}, {}, {}, true });
+            continue;
+        case EndArray:
+        case EndObject: {
+            PartialValue finished = d->partialValues.takeLast();
+            if (finished.isObject)
+                value = std::move(finished.object);
+            else
+                value = std::move(finished.array);
+            break;
+        }
+        default:
+            value = scalarValue(*this);
+            break;
+        }
+
+        if (d->partialValues.isEmpty())
+            return value;
+        PartialValue &parent = d->partialValues.last();
+        if (parent.isObject)
+            parent.object.insert(parent.name, value);
+        else
+            parent.array.append(value);
+    }
+}
+
+/*!
+    Skips the value that starts at the current token. For \l StartArray and
+    \l StartObject, this reads up to and including the matching end token.
+
+    Returns \c true on success. Returns \c false if an error occurs, or if
+    the data runs out before the value ends; in the latter case, call
+    skipValue() again once more data is available.
+
+    \sa readValue()
+*/
+bool QJsonStreamReader::skipValue()
+{
+    if (d->skipToDepth < 0) {
+        if (d->token != StartArray && d->token != StartObject)
+            return d->token != NoToken && d->token != Invalid;
+        d->skipToDepth = depth() - 1;
+    }
+    while (depth() > d->skipToDepth) {
+        const TokenType t = readNext();
+        if (t == NoToken || t == Invalid)
+            return false;
+    }
+    d->skipToDepth = -1;
+    return true;
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qjsonstreamreader.cpp"
@@ -0,0 +1,398 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qjsonstreamwriter.h"
+
+#include "qjsonwriter_p.h"
+
+#include <qcborvalue.h>
+#include <qiodevice.h>
+#include <qvarlengtharray.h>
+
+QT_BEGIN_NAMESPACE
+
+// pending output is handed to the device once it grows beyond this
+static const int FlushThreshold = 16 * 1024;
+
+class QJsonStreamWriterPrivate
+{
+public:
+    struct Level
+    {
+        bool isObject;
+        bool hasElements;
+    };
+
+    QIODevice *device = nullptr;
+    QByteArray *data = nullptr;
+    QByteArray pending;
+    QVarLengthArray<Level, 16> levels;
+    QJsonDocument::JsonFormat format = QJsonDocument::Compact;
+    bool nameWritten = false;
+    bool error = false;
+
+    QByteArray &out() { return data ? *data : pending; }
+    bool isIndented() const { return format == QJsonDocument::Indented; }
+
+    void newLine(int indent)
+    {
+        QByteArray &o = out();
+        o += '\n';
+        o.append(4 * indent, ' ');
+    }
+    void beginElement();
+    void beginValue();
+    void endValue();
+    bool flush();
+};
+
+// Writes the separator and indentation that go before an array element or
+// an object member
+void QJsonStreamWriterPrivate::beginElement()
+{
+    Level &level = levels.last();
+    if (level.hasElements)
+        out() += ',';
+    level.hasElements = true;
+    if (isIndented())
+        newLine(levels.size());
+}
+
+void QJsonStreamWriterPrivate::beginValue()
+{
+    if (levels.isEmpty())
+        return;
+    if (levels.last().isObject) {
+        if (!nameWritten)
+            qWarning("QJsonStreamWriter: writing a value in an object without a name");
+        nameWritten = false;
+        return;
+    }
+    beginElement();
+}
+
+void QJsonStreamWriterPrivate::endValue()
+{
+    if (levels.isEmpty()) {
+        // top-level values are written one per line
+        out() += '\n';
+        flush();
+    } else if (pending.size() > FlushThreshold) {
+        flush();
+    }
+}
+
+bool QJsonStreamWriterPrivate::flush()
+{
+    if (!device || pending.isEmpty())
+        return !error;
+    const qint64 written = device->write(pending);
+    if (written != pending.size())
+        error = true;
+    pending.clear();
+    return !error;
+}
+
+/*!
+    \class QJsonStreamWriter
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 6.0
+
+    \brief The QJsonStreamWriter class is a simple JSON serializer.
+
+    QJsonStreamWriter writes JSON to a QIODevice or a QByteArray as it is
+    produced, without building a QJsonDocument first. It is the counterpart
+    of QJsonStreamReader.
+
+    Call writeStartArray() or writeStartObject() to begin a container and the
+    matching end function to close it. Inside objects, every value must be
+    preceded by a call to writeName(). writeValue() writes a whole QJsonValue,
+    including nested arrays and objects.
+
+    \snippet code/src_corelib_serialization_qjsonstreamwriter.cpp 0
+
+    Several top-level values can be written one after the other. Each one is
+    followed by a newline, so the output is newline-delimited JSON when the
+    format is QJsonDocument::Compact, which is the default. Output for a
+    device is collected in a small buffer that is written to the device after
+    each top-level value, whenever it grows beyond a few kilobytes, and when
+    flush() is called or the writer is destroyed.
+
+    QJsonStreamWriter does not check that its input produces valid JSON; for
+    instance, it does not verify that containers are closed.
+
+    \sa QJsonStreamReader, QJsonDocument::toJson(), QCborStreamWriter
+*/
+
+/*!
+    Constructs a writer that writes to \a device.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QIODevice *device)
+    : d(new QJsonStreamWriterPrivate)
+{
+    d->device = device;
+}
+
+/*!
+    Constructs a writer that appends to \a data.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QByteArray *data)
+    : d(new QJsonStreamWriterPrivate)
+{
+    d->data = data;
+}
+
+/*!
+    Flushes pending output and destroys the writer.
+*/
+QJsonStreamWriter::~QJsonStreamWriter()
+{
+    d->flush();
+}
+
+/*!
+    Flushes pending output to the current device, then makes the writer write
+    to \a device. The writer does not take ownership of the device.
+*/
+void QJsonStreamWriter::setDevice(QIODevice *device)
+{
+    d->flush();
+    d->data = nullptr;
+    d->device = device;
+}
+
+/*!
+    Returns the device the writer writes to, or \nullptr if it writes to a
+    QByteArray.
+*/
+QIODevice *QJsonStreamWriter::device() const
+{
+    return d->device;
+}
+
+/*!
+    Sets the output format to \a format. The default is
+    QJsonDocument::Compact. Changing the format while a value is being written
+    is not supported.
+*/
+void QJsonStreamWriter::setFormat(QJsonDocument::JsonFormat format)
+{
+    d->format = format;
+}
+
+/*!
+    Returns the output format.
+*/
+QJsonDocument::JsonFormat QJsonStreamWriter::format() const
+{
+    return d->format;
+}
+
+/*!
+    Starts an array. Until the matching writeEndArray(), written values are
+    elements of the array.
+*/
+void QJsonStreamWriter::writeStartArray()
+{
+    d->beginValue();
+    d->out() += '[';
+    d->levels.append({ false, false });
+}
+
+/*!
+    Ends the array started with writeStartArray().
+*/
+void QJsonStreamWriter::writeEndArray()
+{
+    Q_ASSERT(!d->levels.isEmpty() && !d->levels.last().isObject);
+    const bool hasElements = d->levels.last().hasElements;
+    d->levels.removeLast();
+    if (hasElements && d->isIndented())
+        d->newLine(d->levels.size());
+    d->out() += ']';
+    d->endValue();
+}
+
+/*!
+    Starts an object. Until the matching writeEndObject(), every value must
+    be preceded by writeName().
+*/
+void QJsonStreamWriter::writeStartObject()
+{
+    d->beginValue();
+    d->out() += '{';
+    d->levels.append({ true, false });
+}
+
+/*!
+    Ends the object started with writeStartObject().
+*/
+void QJsonStreamWriter::writeEndObject()
+{
+    Q_ASSERT(!d->levels.isEmpty() && d->levels.last().isObject);
+    const bool hasElements = d->levels.last().hasElements;
+    d->levels.removeLast();
+    if (hasElements && d->isIndented())
+        d->newLine(d->levels.size());
+    d->out() += '}';
+    d->endValue();
+}
+
+/*!
+    Writes \a name as the name of the next member of the current object.
+*/
+void QJsonStreamWriter::writeName(QStringView name)
+{
+    Q_ASSERT(!d->levels.isEmpty() && d->levels.last().isObject);
+    d->beginElement();
+    QJsonPrivate::Writer::stringToJson(name, d->out());
+    d->out() += d->isIndented() ? ": " : ":";
+    d->nameWritten = true;
+}
+
+/*!
+    \overload
+*/
+void QJsonStreamWriter::writeName(QLatin1String name)
+{
+    writeName(QStringView(QString(name)));
+}
+
+/*!
+    Writes the string \a value.
+*/
+void QJsonStreamWriter::writeString(QStringView value)
+{
+    d->beginValue();
+    QJsonPrivate::Writer::stringToJson(value, d->out());
+    d->endValue();
+}
+
+/*!
+    \overload
+*/
+void QJsonStreamWriter::writeString(QLatin1String value)
+{
+    writeString(QStringView(QString(value)));
+}
+
+/*!
+    Writes the integer \a value.
+*/
+void QJsonStreamWriter::writeInteger(qint64 value)
+{
+    d->beginValue();
+    d->out() += QByteArray::number(value);
+    d->endValue();
+}
+
+/*!
+    Writes the number \a value. Infinities and NaN cannot be represented in
+    JSON and are written as \c null, like QJsonDocument does.
+*/
+void QJsonStreamWriter::writeDouble(double value)
+{
+    d->beginValue();
+    QJsonPrivate::Writer::valueToJson(QCborValue(value), d->out(), 0, true);
+    d->endValue();
+}
+
+/*!
+    Writes the boolean \a value.
+*/
+void QJsonStreamWriter::writeBool(bool value)
+{
+    d->beginValue();
+    d->out() += value ? "true" : "false";
+    d->endValue();
+}
+
+/*!
+    Writes \c null.
+*/
+void QJsonStreamWriter::writeNull()
+{
+    d->beginValue();
+    d->out() += "null";
+    d->endValue();
+}
+
+/*!
+    Writes \a value, including the contents of arrays and objects. Undefined
+    values are written as \c null.
+*/
+void QJsonStreamWriter::writeValue(const QJsonValue &value)
+{
+    d->beginValue();
+    QJsonPrivate::Writer::valueToJson(QCborValue::fromJsonValue(value), d->out(),
+                                      d->levels.size(), !d->isIndented());
+    d->endValue();
+}
+
+/*!
+    Returns the number of arrays and objects that are currently open.
+*/
+int QJsonStreamWriter::depth() const
+{
+    return d->levels.size();
+}
+
+/*!
+    Writes pending output to the device. Returns \c false if writing to the
+    device failed at any point; otherwise returns \c true.
+
+    \sa hasError()
+*/
+bool QJsonStreamWriter::flush()
+{
+    return d->flush();
+}
+
+/*!
+    Returns \c true if writing to the device failed.
+*/
+bool QJsonStreamWriter::hasError() const
+{
+    return d->error;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QJSONSTREAMWRITER_H
+#define QJSONSTREAMWRITER_H
+
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonvalue.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qstringview.h>
+
+QT_REQUIRE_CONFIG(jsonstreamwriter);
+
+QT_BEGIN_NAMESPACE
+
+class QIODevice;
+
+class QJsonStreamWriterPrivate;
+class Q_CORE_EXPORT QJsonStreamWriter
+{
+public:
+    explicit QJsonStreamWriter(QIODevice *device);
+    explicit QJsonStreamWriter(QByteArray *data);
+    ~QJsonStreamWriter();
+    Q_DISABLE_COPY(QJsonStreamWriter)
+
+    void setDevice(QIODevice *device);
+    QIODevice *device() const;
+
+    void setFormat(QJsonDocument::JsonFormat format);
+    QJsonDocument::JsonFormat format() const;
+
+    void writeStartArray();
+    void writeEndArray();
+    void writeStartObject();
+    void writeEndObject();
+
+    void writeName(QStringView name);
+    void writeName(QLatin1String name);
+    void writeString(QStringView value);
+    void writeString(QLatin1String value);
+    void writeInteger(qint64 value);
+    void writeDouble(double value);
+    void writeBool(bool value);
+    void writeNull();
+    void writeValue(const QJsonValue &value);
+
+    int depth() const;
+    bool flush();
+    bool hasError() const;
+
+private:
+    QScopedPointer<QJsonStreamWriterPrivate> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QJSONSTREAMWRITER_H
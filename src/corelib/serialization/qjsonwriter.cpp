@@ -58,15 +58,15 @@ static inline uchar hexdig(uint u)
     return (u < 0xa ? '0' + u : 'a' + u - 0xa);
 }
 
-static QByteArray escapedString(const QString &s)
+static QByteArray escapedString(QStringView s)
 {
     // give it a minimum size to ensure the resize() below always adds enough space
-    QByteArray ba(qMax(s.length(), 16), Qt::Uninitialized);
+    QByteArray ba(qMax(int(s.size()), 16), Qt::Uninitialized);
 
     uchar *cursor = reinterpret_cast<uchar *>(const_cast<char *>(ba.constData()));
     const uchar *ba_end = cursor + ba.length();
-    const ushort *src = reinterpret_cast<const ushort *>(s.constBegin());
-    const ushort *const end = reinterpret_cast<const ushort *>(s.constEnd());
+    const ushort *src = reinterpret_cast<const ushort *>(s.utf16());
+    const ushort *const end = src + s.size();
 
     while (src != end) {
         if (cursor >= ba_end - 6) {
@@ -241,4 +241,16 @@ void Writer::arrayToJson(const QCborContainerPrivate *a, QByteArray &json, int i
     json += compact ? "]" : "]\n";
 }
 
+void Writer::valueToJson(const QCborValue &v, QByteArray &json, int indent, bool compact)
+{
+    QT_PREPEND_NAMESPACE(valueToJson)(v, json, indent, compact);
+}
+
+void Writer::stringToJson(QStringView s, QByteArray &json)
+{
+    json += '"';
+    json += escapedString(s);
+    json += '"';
+}
+
 QT_END_NAMESPACE
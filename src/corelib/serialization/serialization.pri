@@ -55,6 +55,22 @@ qtConfig(cborstreamwriter): {
         serialization/qcborstreamwriter.h
 }
 
+qtConfig(jsonstreamreader): {
+    SOURCES += \
+        serialization/qjsonstreamreader.cpp
+
+    HEADERS += \
+        serialization/qjsonstreamreader.h
+}
+
+qtConfig(jsonstreamwriter): {
+    SOURCES += \
+        serialization/qjsonstreamwriter.cpp
+
+    HEADERS += \
+        serialization/qjsonstreamwriter.h
+}
+
 qtConfig(binaryjson): {
     HEADERS += \
         serialization/qbinaryjson_p.h \
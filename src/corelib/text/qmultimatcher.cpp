@@ -0,0 +1,597 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qmultimatcher.h"
+
+#include <QtCore/qhash.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+/*
+    Aho-Corasick automaton shared by the byte array and string matchers.
+
+    The input is mapped to symbol classes first: every distinct (folded)
+    code unit occurring in a pattern gets its own class, all other input
+    falls into class 0. The goto and failure functions are then compiled
+    into a dense transition table, so that the search itself performs a
+    single table lookup per input code unit, however many patterns there
+    are. Every state also records the longest pattern that is a suffix of
+    its path, which is all that is needed to report the leftmost-longest
+    match.
+*/
+class QMultiMatcherAutomaton
+{
+public:
+    void reset(int classes)
+    {
+        classCount = classes;
+        maxLength = 0;
+        emptyPattern = -1;
+        transitions.clear();
+        matchLength.clear();
+        matchPattern.clear();
+        addState();
+    }
+
+    int child(int state, int symbolClass)
+    {
+        int next = transitions.at(state * classCount + symbolClass);
+        if (next < 0) {
+            next = addState();
+            transitions[state * classCount + symbolClass] = next;
+        }
+        return next;
+    }
+
+    void setOutput(int state, int length, int pattern)
+    {
+        if (length == 0) {
+            if (emptyPattern < 0)
+                emptyPattern = pattern;
+        } else if (matchLength.at(state) == 0) {
+            // duplicated patterns report the first occurrence
+            matchLength[state] = length;
+            matchPattern[state] = pattern;
+            maxLength = qMax(maxLength, length);
+        }
+    }
+
+    void finish()
+    {
+        // Breadth-first traversal: the failure target of a state is always
+        // shallower than the state itself and so is complete when needed.
+        const int stateCount = matchLength.size();
+        QVector<int> failure(stateCount, 0);
+        QVector<int> queue;
+        queue.reserve(stateCount);
+
+        int *table = transitions.data();
+        for (int c = 0; c < classCount; ++c) {
+            if (table[c] < 0)
+                table[c] = 0;
+            else
+                queue.append(table[c]);
+        }
+
+        for (int head = 0; head < queue.size(); ++head) {
+            const int state = queue.at(head);
+            const int fail = failure.at(state);
+            if (matchLength.at(state) == 0) {
+                matchLength[state] = matchLength.at(fail);
+                matchPattern[state] = matchPattern.at(fail);
+            }
+            int *row = table + state * classCount;
+            const int *failRow = table + fail * classCount;
+            for (int c = 0; c < classCount; ++c) {
+                if (row[c] < 0) {
+                    row[c] = failRow[c];
+                } else {
+                    failure[row[c]] = failRow[c];
+                    queue.append(row[c]);
+                }
+            }
+        }
+    }
+
+    template <typename ClassOf>
+    qsizetype indexIn(qsizetype length, qsizetype from, ClassOf classOf, int *patternIndex) const
+    {
+        if (from < 0)
+            from = 0;
+
+        qsizetype bestStart = -1;
+        int bestPattern = -1;
+        if (from <= length) {
+            if (emptyPattern >= 0) {
+                bestStart = from;
+                bestPattern = emptyPattern;
+            }
+            if (maxLength > 0) {
+                const int *table = transitions.constData();
+                int state = 0;
+                for (qsizetype i = from; i < length; ++i) {
+                    // no match ending here or later can start before bestStart
+                    if (bestStart >= 0 && i - maxLength >= bestStart)
+                        break;
+                    state = table[state * classCount + classOf(i)];
+                    const int matched = matchLength.at(state);
+                    if (matched) {
+                        const qsizetype start = i + 1 - matched;
+                        if (bestStart < 0 || start <= bestStart) {
+                            bestStart = start;
+                            bestPattern = matchPattern.at(state);
+                        }
+                    }
+                }
+            }
+        }
+
+        if (patternIndex)
+            *patternIndex = bestPattern;
+        return bestStart;
+    }
+
+private:
+    int addState()
+    {
+        const int state = matchLength.size();
+        transitions.insert(transitions.size(), classCount, -1);
+        matchLength.append(0);
+        matchPattern.append(-1);
+        return state;
+    }
+
+    int classCount = 1;
+    int maxLength = 0;
+    int emptyPattern = -1;
+    QVector<int> transitions;
+    QVector<int> matchLength;
+    QVector<int> matchPattern;
+};
+
+static inline uchar asciiFold(uchar c) noexcept
+{
+    return c >= 'A' && c <= 'Z' ? c | 0x20 : c;
+}
+
+// Folds the UTF-16 code unit at position i, keeping surrogate pairs intact.
+static inline char16_t foldedUnit(const char16_t *s, qsizetype i, qsizetype length) noexcept
+{
+    const char16_t c = s[i];
+    if (QChar::isHighSurrogate(c)) {
+        if (i + 1 < length && QChar::isLowSurrogate(s[i + 1]))
+            return QChar::highSurrogate(QChar::toCaseFolded(QChar::surrogateToUcs4(c, s[i + 1])));
+    } else if (QChar::isLowSurrogate(c)) {
+        if (i > 0 && QChar::isHighSurrogate(s[i - 1]))
+            return QChar::lowSurrogate(QChar::toCaseFolded(QChar::surrogateToUcs4(s[i - 1], c)));
+    } else {
+        return char16_t(QChar::toCaseFolded(uint(c)));
+    }
+    return c;
+}
+
+} // unnamed namespace
+
+class QMultiByteArrayMatcherPrivate : public QSharedData
+{
+public:
+    void rebuild();
+
+    QList<QByteArray> patterns;
+    Qt::CaseSensitivity cs = Qt::CaseSensitive;
+    quint16 classes[256];
+    QMultiMatcherAutomaton automaton;
+};
+
+void QMultiByteArrayMatcherPrivate::rebuild()
+{
+    const bool fold = cs == Qt::CaseInsensitive;
+
+    std::fill_n(classes, 256, quint16(0));
+    int classCount = 1;
+    for (const QByteArray &pattern : qAsConst(patterns)) {
+        for (char ch : pattern) {
+            const uchar c = fold ? asciiFold(uchar(ch)) : uchar(ch);
+            if (!classes[c])
+                classes[c] = quint16(classCount++);
+        }
+    }
+    if (fold) {
+        for (uchar c = 'A'; c <= 'Z'; ++c)
+            classes[c] = classes[c | 0x20];
+    }
+
+    automaton.reset(classCount);
+    for (int i = 0; i < patterns.size(); ++i) {
+        const QByteArray &pattern = patterns.at(i);
+        int state = 0;
+        for (char ch : pattern)
+            state = automaton.child(state, classes[uchar(ch)]);
+        automaton.setOutput(state, pattern.size(), i);
+    }
+    automaton.finish();
+}
+
+/*! \class QMultiByteArrayMatcher
+    \inmodule QtCore
+    \since 6.0
+    \brief The QMultiByteArrayMatcher class holds a set of byte
+    sequences that can be quickly searched for in a byte array.
+
+    \ingroup tools
+    \ingroup string-processing
+
+    This class is useful when you want to find the first occurrence of
+    any of several byte sequences, for instance a list of keywords, in
+    byte arrays. Rather than searching the byte array once per pattern,
+    as a loop over QByteArrayMatcher objects would, the matcher
+    compiles all patterns into a single automaton (using the
+    Aho-Corasick algorithm) and examines every byte of the searched data
+    only once, regardless of the number of patterns.
+
+    Create the QMultiByteArrayMatcher with the list of patterns you want
+    to search for. Then call indexIn() on the byte arrays that you want
+    to search. Building the automaton takes time proportional to the
+    total length of the patterns, so the matcher pays off when it is
+    reused for many searches.
+
+    When several patterns match, indexIn() reports the one that starts
+    first; if more than one pattern starts at that position, the longest
+    one wins.
+
+    Case-insensitive matching only folds the ASCII letters, all other
+    bytes have to match exactly. This makes it safe to use with UTF-8
+    encoded data.
+
+    \sa QByteArrayMatcher, QMultiStringMatcher
+*/
+
+/*!
+    Constructs an empty multi-pattern matcher that won't match anything.
+    Call setPatterns() to give it a set of patterns to match.
+*/
+QMultiByteArrayMatcher::QMultiByteArrayMatcher()
+    : d(new QMultiByteArrayMatcherPrivate)
+{
+    d->rebuild();
+}
+
+/*!
+    Constructs a matcher that will search for any of the given
+    \a patterns, using the case sensitivity \a cs.
+
+    Call indexIn() to perform a search.
+*/
+QMultiByteArrayMatcher::QMultiByteArrayMatcher(const QList<QByteArray> &patterns,
+                                               Qt::CaseSensitivity cs)
+    : d(new QMultiByteArrayMatcherPrivate)
+{
+    d->patterns = patterns;
+    d->cs = cs;
+    d->rebuild();
+}
+
+/*!
+    Copies the \a other matcher to this matcher.
+*/
+QMultiByteArrayMatcher::QMultiByteArrayMatcher(const QMultiByteArrayMatcher &other) = default;
+
+/*!
+    Destroys the matcher.
+*/
+QMultiByteArrayMatcher::~QMultiByteArrayMatcher() = default;
+
+/*!
+    Assigns the \a other matcher to this matcher.
+*/
+QMultiByteArrayMatcher &QMultiByteArrayMatcher::operator=(const QMultiByteArrayMatcher &other) = default;
+
+/*!
+    Sets the list of byte sequences to search for to \a patterns.
+
+    \sa patterns(), indexIn()
+*/
+void QMultiByteArrayMatcher::setPatterns(const QList<QByteArray> &patterns)
+{
+    d->patterns = patterns;
+    d->rebuild();
+}
+
+/*!
+    Returns the list of byte sequences that this matcher searches for.
+
+    \sa setPatterns()
+*/
+QList<QByteArray> QMultiByteArrayMatcher::patterns() const
+{
+    return d->patterns;
+}
+
+/*!
+    Sets the case sensitivity setting of this matcher to \a cs.
+
+    \sa caseSensitivity()
+*/
+void QMultiByteArrayMatcher::setCaseSensitivity(Qt::CaseSensitivity cs)
+{
+    if (d->cs == cs)
+        return;
+    d->cs = cs;
+    d->rebuild();
+}
+
+/*!
+    Returns the case sensitivity setting for this matcher.
+
+    \sa setCaseSensitivity()
+*/
+Qt::CaseSensitivity QMultiByteArrayMatcher::caseSensitivity() const
+{
+    return d->cs;
+}
+
+/*!
+    Searches the byte array \a ba, from byte position \a from (default
+    0, i.e. from the first byte), for the first occurrence of any of the
+    patterns. Returns the position where the match starts, or -1 if no
+    pattern matches.
+
+    If \a patternIndex is not \nullptr, the index of the matching
+    pattern in patterns() is stored there, or -1 if there is no match.
+*/
+int QMultiByteArrayMatcher::indexIn(const QByteArray &ba, int from, int *patternIndex) const
+{
+    return indexIn(ba.constData(), ba.size(), from, patternIndex);
+}
+
+/*!
+    \overload
+
+    Searches the char string \a str, which has length \a len, from
+    byte position \a from (default 0, i.e. from the first byte), for
+    the first occurrence of any of the patterns. Returns the position
+    where the match starts, or -1 if no pattern matches.
+
+    If \a patternIndex is not \nullptr, the index of the matching
+    pattern in patterns() is stored there, or -1 if there is no match.
+*/
+int QMultiByteArrayMatcher::indexIn(const char *str, int len, int from, int *patternIndex) const
+{
+    const uchar *data = reinterpret_cast<const uchar *>(str);
+    const quint16 *classes = d->classes;
+    return int(d->automaton.indexIn(len, from, [=](qsizetype i) { return classes[data[i]]; },
+                                    patternIndex));
+}
+
+class QMultiStringMatcherPrivate : public QSharedData
+{
+public:
+    void rebuild();
+    int classOf(const char16_t *s, qsizetype i, qsizetype length) const
+    {
+        char16_t c = s[i];
+        if (c < 256)
+            return latin1Classes[c];
+        if (cs == Qt::CaseInsensitive) {
+            c = foldedUnit(s, i, length);
+            if (c < 256)
+                return latin1Classes[c];
+        }
+        return otherClasses.isEmpty() ? 0 : otherClasses.value(c);
+    }
+
+    QStringList patterns;
+    Qt::CaseSensitivity cs = Qt::CaseSensitive;
+    int latin1Classes[256];
+    QHash<ushort, int> otherClasses;
+    QMultiMatcherAutomaton automaton;
+};
+
+void QMultiStringMatcherPrivate::rebuild()
+{
+    const bool fold = cs == Qt::CaseInsensitive;
+
+    // assign classes to the folded code units of all patterns
+    QHash<ushort, int> classes;
+    for (const QString &pattern : qAsConst(patterns)) {
+        const char16_t *s = reinterpret_cast<const char16_t *>(pattern.constData());
+        for (qsizetype i = 0; i < pattern.size(); ++i) {
+            const char16_t c = fold ? foldedUnit(s, i, pattern.size()) : s[i];
+            if (!classes.contains(c))
+                classes.insert(c, classes.size() + 1);
+        }
+    }
+
+    for (int c = 0; c < 256; ++c)
+        latin1Classes[c] = classes.value(fold ? char16_t(QChar::toCaseFolded(uint(c))) : c);
+    otherClasses.clear();
+    for (auto it = classes.cbegin(), end = classes.cend(); it != end; ++it) {
+        if (it.key() >= 256)
+            otherClasses.insert(it.key(), it.value());
+    }
+
+    automaton.reset(classes.size() + 1);
+    for (int i = 0; i < patterns.size(); ++i) {
+        const QString &pattern = patterns.at(i);
+        const char16_t *s = reinterpret_cast<const char16_t *>(pattern.constData());
+        int state = 0;
+        for (qsizetype j = 0; j < pattern.size(); ++j)
+            state = automaton.child(state, classOf(s, j, pattern.size()));
+        automaton.setOutput(state, pattern.size(), i);
+    }
+    automaton.finish();
+}
+
+/*! \class QMultiStringMatcher
+    \inmodule QtCore
+    \since 6.0
+    \brief The QMultiStringMatcher class holds a set of strings that
+    can be quickly searched for in Unicode strings.
+
+    \ingroup tools
+    \ingroup string-processing
+
+    This class is useful when you want to find the first occurrence of
+    any of several strings, for instance a list of keywords, in other
+    strings. Rather than searching the text once per pattern, as a loop
+    over QStringMatcher objects would, the matcher compiles all patterns
+    into a single automaton (using the Aho-Corasick algorithm) and
+    examines every character of the searched text only once, regardless
+    of the number of patterns.
+
+    Create the QMultiStringMatcher with the list of patterns you want to
+    search for. Then call indexIn() on the strings that you want to
+    search.
+
+    When several patterns match, indexIn() reports the one that starts
+    first; if more than one pattern starts at that position, the longest
+    one wins. Case-insensitive matching uses the same case folding as
+    QStringMatcher.
+
+    \sa QStringMatcher, QMultiByteArrayMatcher
+*/
+
+/*!
+    Constructs an empty multi-pattern matcher that won't match anything.
+    Call setPatterns() to give it a set of patterns to match.
+*/
+QMultiStringMatcher::QMultiStringMatcher()
+    : d(new QMultiStringMatcherPrivate)
+{
+    d->rebuild();
+}
+
+/*!
+    Constructs a matcher that will search for any of the given
+    \a patterns, using the case sensitivity \a cs.
+
+    Call indexIn() to perform a search.
+*/
+QMultiStringMatcher::QMultiStringMatcher(const QStringList &patterns, Qt::CaseSensitivity cs)
+    : d(new QMultiStringMatcherPrivate)
+{
+    d->patterns = patterns;
+    d->cs = cs;
+    d->rebuild();
+}
+
+/*!
+    Copies the \a other matcher to this matcher.
+*/
+QMultiStringMatcher::QMultiStringMatcher(const QMultiStringMatcher &other) = default;
+
+/*!
+    Destroys the matcher.
+*/
+QMultiStringMatcher::~QMultiStringMatcher() = default;
+
+/*!
+    Assigns the \a other matcher to this matcher.
+*/
+QMultiStringMatcher &QMultiStringMatcher::operator=(const QMultiStringMatcher &other) = default;
+
+/*!
+    Sets the list of strings to search for to \a patterns.
+
+    \sa patterns(), indexIn()
+*/
+void QMultiStringMatcher::setPatterns(const QStringList &patterns)
+{
+    d->patterns = patterns;
+    d->rebuild();
+}
+
+/*!
+    Returns the list of strings that this matcher searches for.
+
+    \sa setPatterns()
+*/
+QStringList QMultiStringMatcher::patterns() const
+{
+    return d->patterns;
+}
+
+/*!
+    Sets the case sensitivity setting of this matcher to \a cs.
+
+    \sa caseSensitivity()
+*/
+void QMultiStringMatcher::setCaseSensitivity(Qt::CaseSensitivity cs)
+{
+    if (d->cs == cs)
+        return;
+    d->cs = cs;
+    d->rebuild();
+}
+
+/*!
+    Returns the case sensitivity setting for this matcher.
+
+    \sa setCaseSensitivity()
+*/
+Qt::CaseSensitivity QMultiStringMatcher::caseSensitivity() const
+{
+    return d->cs;
+}
+
+/*!
+    Searches the string \a str, from character position \a from
+    (default 0, i.e. from the first character), for the first occurrence
+    of any of the patterns. Returns the position where the match starts,
+    or -1 if no pattern matches.
+
+    If \a patternIndex is not \nullptr, the index of the matching
+    pattern in patterns() is stored there, or -1 if there is no match.
+*/
+qsizetype QMultiStringMatcher::indexIn(QStringView str, qsizetype from, int *patternIndex) const
+{
+    const char16_t *data = str.utf16();
+    const qsizetype length = str.size();
+    const QMultiStringMatcherPrivate *p = d.constData();
+    return p->automaton.indexIn(length, from,
+                                [=](qsizetype i) { return p->classOf(data, i, length); },
+                                patternIndex);
+}
+
+QT_END_NAMESPACE
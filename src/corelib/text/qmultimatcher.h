@@ -0,0 +1,104 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QMULTIMATCHER_H
+#define QMULTIMATCHER_H
+
+#include <QtCore/qbytearraylist.h>
+#include <QtCore/qshareddata.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qstringview.h>
+
+QT_BEGIN_NAMESPACE
+
+
+class QMultiByteArrayMatcherPrivate;
+
+class Q_CORE_EXPORT QMultiByteArrayMatcher
+{
+public:
+    QMultiByteArrayMatcher();
+    explicit QMultiByteArrayMatcher(const QList<QByteArray> &patterns,
+                                    Qt::CaseSensitivity cs = Qt::CaseSensitive);
+    QMultiByteArrayMatcher(const QMultiByteArrayMatcher &other);
+    ~QMultiByteArrayMatcher();
+
+    QMultiByteArrayMatcher &operator=(const QMultiByteArrayMatcher &other);
+
+    void setPatterns(const QList<QByteArray> &patterns);
+    QList<QByteArray> patterns() const;
+
+    void setCaseSensitivity(Qt::CaseSensitivity cs);
+    Qt::CaseSensitivity caseSensitivity() const;
+
+    int indexIn(const QByteArray &ba, int from = 0, int *patternIndex = nullptr) const;
+    int indexIn(const char *str, int len, int from = 0, int *patternIndex = nullptr) const;
+
+private:
+    QSharedDataPointer<QMultiByteArrayMatcherPrivate> d;
+};
+
+class QMultiStringMatcherPrivate;
+
+class Q_CORE_EXPORT QMultiStringMatcher
+{
+public:
+    QMultiStringMatcher();
+    explicit QMultiStringMatcher(const QStringList &patterns,
+                                 Qt::CaseSensitivity cs = Qt::CaseSensitive);
+    QMultiStringMatcher(const QMultiStringMatcher &other);
+    ~QMultiStringMatcher();
+
+    QMultiStringMatcher &operator=(const QMultiStringMatcher &other);
+
+    void setPatterns(const QStringList &patterns);
+    QStringList patterns() const;
+
+    void setCaseSensitivity(Qt::CaseSensitivity cs);
+    Qt::CaseSensitivity caseSensitivity() const;
+
+    qsizetype indexIn(QStringView str, qsizetype from = 0, int *patternIndex = nullptr) const;
+
+private:
+    QSharedDataPointer<QMultiStringMatcherPrivate> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMULTIMATCHER_H
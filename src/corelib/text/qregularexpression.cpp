@@ -40,7 +40,9 @@
 ****************************************************************************/
 
 #include "qregularexpression.h"
+#include "qregularexpression_p.h"
 
+#include <QtCore/qcache.h>
 #include <QtCore/qcoreapplication.h>
 #include <QtCore/qhashfunctions.h>
 #include <QtCore/qmutex.h>
@@ -840,6 +842,29 @@ static int convertToPcreOptions(QRegularExpression::MatchOptions matchOptions)
     return options;
 }
 
+/*
+    The result of compiling a pattern with some pattern options. PCRE2
+    allows compiled (and JIT compiled) code to be used by several threads at
+    once, so one object is shared, through the pattern cache, by all the
+    QRegularExpressionPrivate objects having the same pattern and options.
+*/
+struct QRegularExpressionCompiledPattern : QSharedData
+{
+    QRegularExpressionCompiledPattern(const QString &pattern,
+                                      QRegularExpression::PatternOptions patternOptions);
+    ~QRegularExpressionCompiledPattern();
+
+    void getPatternInfo();
+    void optimizePattern();
+
+    pcre2_code_16 *code = nullptr;
+    int errorCode = 0;
+    int errorOffset = -1;
+    int capturingCount = 0;
+    bool usingCrLfNewlines = false;
+    bool usingJOption = false;
+};
+
 struct QRegularExpressionPrivate : QSharedData
 {
     QRegularExpressionPrivate();
@@ -848,8 +873,6 @@ struct QRegularExpressionPrivate : QSharedData
 
     void cleanCompiledPattern();
     void compilePattern();
-    void getPatternInfo();
-    void optimizePattern();
 
     enum CheckSubjectStringOption {
         CheckSubjectString,
@@ -876,9 +899,11 @@ struct QRegularExpressionPrivate : QSharedData
     // (right after a detach happened).
     mutable QMutex mutex;
 
-    // The PCRE code pointer is reference-counted by the QRegularExpressionPrivate
-    // objects themselves; when the private is copied (i.e. a detach happened)
-    // it is set to nullptr
+    // The compiled pattern is shared with the pattern cache and with the other
+    // QRegularExpressionPrivate objects using the same pattern and options;
+    // when the private is copied (i.e. a detach happened) it is reset.
+    // compiledPattern and the following members are copied from it.
+    QExplicitlySharedDataPointer<QRegularExpressionCompiledPattern> compiled;
     pcre2_code_16 *compiledPattern;
     int errorCode;
     int errorOffset;
@@ -992,7 +1017,7 @@ QRegularExpressionPrivate::QRegularExpressionPrivate(const QRegularExpressionPri
 */
 void QRegularExpressionPrivate::cleanCompiledPattern()
 {
-    pcre2_code_free_16(compiledPattern);
+    compiled.reset();
     compiledPattern = nullptr;
     errorCode = 0;
     errorOffset = -1;
@@ -1003,28 +1028,21 @@ void QRegularExpressionPrivate::cleanCompiledPattern()
 /*!
     \internal
 */
-void QRegularExpressionPrivate::compilePattern()
+QRegularExpressionCompiledPattern::QRegularExpressionCompiledPattern(const QString &pattern,
+                                                                     QRegularExpression::PatternOptions patternOptions)
 {
-    const QMutexLocker lock(&mutex);
-
-    if (!isDirty)
-        return;
-
-    isDirty = false;
-    cleanCompiledPattern();
-
     int options = convertToPcreOptions(patternOptions);
     options |= PCRE2_UTF;
 
     PCRE2_SIZE patternErrorOffset;
-    compiledPattern = pcre2_compile_16(pattern.utf16(),
-                                       pattern.length(),
-                                       options,
-                                       &errorCode,
-                                       &patternErrorOffset,
-                                       nullptr);
-
-    if (!compiledPattern) {
+    code = pcre2_compile_16(pattern.utf16(),
+                            pattern.length(),
+                            options,
+                            &errorCode,
+                            &patternErrorOffset,
+                            nullptr);
+
+    if (!code) {
         errorOffset = static_cast<int>(patternErrorOffset);
         return;
     } else {
@@ -1039,15 +1057,172 @@ void QRegularExpressionPrivate::compilePattern()
 /*!
     \internal
 */
-void QRegularExpressionPrivate::getPatternInfo()
+QRegularExpressionCompiledPattern::~QRegularExpressionCompiledPattern()
+{
+    pcre2_code_free_16(code);
+}
+
+namespace {
+struct QRegularExpressionCacheKey
+{
+    QString pattern;
+    QRegularExpression::PatternOptions patternOptions;
+
+    bool operator==(const QRegularExpressionCacheKey &other) const
+    {
+        return patternOptions == other.patternOptions && pattern == other.pattern;
+    }
+};
+
+inline uint qHash(const QRegularExpressionCacheKey &key, uint seed = 0) noexcept
+{
+    using QT_PREPEND_NAMESPACE(qHash);
+    return qHash(key.pattern, qHash(int(key.patternOptions), seed));
+}
+
+typedef QExplicitlySharedDataPointer<QRegularExpressionCompiledPattern> QRegularExpressionCompiledPatternPointer;
+
+struct QRegularExpressionCacheData
+{
+    QMutex mutex;
+    QCache<QRegularExpressionCacheKey, QRegularExpressionCompiledPatternPointer> cache { 256 };
+    qint64 hits = 0;
+    qint64 misses = 0;
+};
+} // unnamed namespace
+
+Q_GLOBAL_STATIC(QRegularExpressionCacheData, compiledPatternCache)
+
+/*!
+    \internal
+
+    Returns the compiled form of \a pattern with \a patternOptions, from the
+    pattern cache if possible. Compiling happens outside of the cache's lock,
+    so that threads compiling different patterns don't wait for each other.
+*/
+static QRegularExpressionCompiledPatternPointer compiledPatternFor(const QString &pattern,
+                                                                   QRegularExpression::PatternOptions patternOptions)
+{
+    QRegularExpressionCacheData *data = compiledPatternCache();
+    const QRegularExpressionCacheKey key = { pattern, patternOptions };
+    if (data) {
+        QMutexLocker locker(&data->mutex);
+        if (const QRegularExpressionCompiledPatternPointer *cached = data->cache.object(key)) {
+            ++data->hits;
+            return *cached;
+        }
+        ++data->misses;
+    }
+
+    QRegularExpressionCompiledPatternPointer compiled(new QRegularExpressionCompiledPattern(pattern, patternOptions));
+
+    if (data) {
+        QMutexLocker locker(&data->mutex);
+        if (data->cache.maxCost() > 0) {
+            // another thread may have compiled the same pattern meanwhile
+            if (const QRegularExpressionCompiledPatternPointer *cached = data->cache.object(key))
+                return *cached;
+            data->cache.insert(key, new QRegularExpressionCompiledPatternPointer(compiled));
+        }
+    }
+    return compiled;
+}
+
+/*!
+    \class QRegularExpressionCache
+    \internal
+
+    Process-wide cache of compiled patterns, so that temporary
+    QRegularExpression objects, and copies that have been modified and
+    reverted, don't compile and JIT compile the same pattern again. Patterns
+    are keyed by their pattern string and pattern options, and evicted in
+    least recently used order. The cache is bounded by maxCost(), in
+    patterns; a maximum cost of 0 disables it.
+*/
+
+int QRegularExpressionCache::maxCost()
+{
+    QRegularExpressionCacheData *data = compiledPatternCache();
+    if (!data)
+        return 0;
+    QMutexLocker locker(&data->mutex);
+    return data->cache.maxCost();
+}
+
+void QRegularExpressionCache::setMaxCost(int patterns)
+{
+    if (QRegularExpressionCacheData *data = compiledPatternCache()) {
+        QMutexLocker locker(&data->mutex);
+        data->cache.setMaxCost(patterns);
+    }
+}
+
+void QRegularExpressionCache::clear()
+{
+    if (QRegularExpressionCacheData *data = compiledPatternCache()) {
+        QMutexLocker locker(&data->mutex);
+        data->cache.clear();
+        data->hits = 0;
+        data->misses = 0;
+    }
+}
+
+qint64 QRegularExpressionCache::hits()
+{
+    QRegularExpressionCacheData *data = compiledPatternCache();
+    if (!data)
+        return 0;
+    QMutexLocker locker(&data->mutex);
+    return data->hits;
+}
+
+qint64 QRegularExpressionCache::misses()
+{
+    QRegularExpressionCacheData *data = compiledPatternCache();
+    if (!data)
+        return 0;
+    QMutexLocker locker(&data->mutex);
+    return data->misses;
+}
+
+/*!
+    \internal
+*/
+void QRegularExpressionPrivate::compilePattern()
+{
+    const QMutexLocker lock(&mutex);
+
+    if (!isDirty)
+        return;
+
+    isDirty = false;
+    cleanCompiledPattern();
+
+    compiled = compiledPatternFor(pattern, patternOptions);
+    compiledPattern = compiled->code;
+    errorCode = compiled->errorCode;
+    errorOffset = compiled->errorOffset;
+    capturingCount = compiled->capturingCount;
+    usingCrLfNewlines = compiled->usingCrLfNewlines;
+
+    if (Q_UNLIKELY(compiled->usingJOption)) {
+        qWarning("QRegularExpressionPrivate::getPatternInfo(): the pattern '%ls'\n    is using the (?J) option; duplicate capturing group names are not supported by Qt",
+                 qUtf16Printable(pattern));
+    }
+}
+
+/*!
+    \internal
+*/
+void QRegularExpressionCompiledPattern::getPatternInfo()
 {
-    Q_ASSERT(compiledPattern);
+    Q_ASSERT(code);
 
-    pcre2_pattern_info_16(compiledPattern, PCRE2_INFO_CAPTURECOUNT, &capturingCount);
+    pcre2_pattern_info_16(code, PCRE2_INFO_CAPTURECOUNT, &capturingCount);
 
     // detect the settings for the newline
     unsigned int patternNewlineSetting;
-    if (pcre2_pattern_info_16(compiledPattern, PCRE2_INFO_NEWLINE, &patternNewlineSetting) != 0) {
+    if (pcre2_pattern_info_16(code, PCRE2_INFO_NEWLINE, &patternNewlineSetting) != 0) {
         // no option was specified in the regexp, grab PCRE build defaults
         pcre2_config_16(PCRE2_CONFIG_NEWLINE, &patternNewlineSetting);
     }
@@ -1056,15 +1231,21 @@ void QRegularExpressionPrivate::getPatternInfo()
             (patternNewlineSetting == PCRE2_NEWLINE_ANY) ||
             (patternNewlineSetting == PCRE2_NEWLINE_ANYCRLF);
 
+    // warned about by QRegularExpressionPrivate::compilePattern()
     unsigned int hasJOptionChanged;
-    pcre2_pattern_info_16(compiledPattern, PCRE2_INFO_JCHANGED, &hasJOptionChanged);
-    if (Q_UNLIKELY(hasJOptionChanged)) {
-        qWarning("QRegularExpressionPrivate::getPatternInfo(): the pattern '%ls'\n    is using the (?J) option; duplicate capturing group names are not supported by Qt",
-                 qUtf16Printable(pattern));
-    }
+    pcre2_pattern_info_16(code, PCRE2_INFO_JCHANGED, &hasJOptionChanged);
+    usingJOption = hasJOptionChanged;
 }
 
 
+// The default JIT stack size in PCRE is 32K,
+// by default we allocate from 32K up to 512K.
+static QBasicAtomicInt jitStackStartSize = Q_BASIC_ATOMIC_INITIALIZER(32 * 1024);
+static QBasicAtomicInt jitStackMaxSize = Q_BASIC_ATOMIC_INITIALIZER(512 * 1024);
+// incremented by QRegularExpressionJitStack::setSize(), so that the
+// threads replace their stacks
+static QBasicAtomicInt jitStackGeneration = Q_BASIC_ATOMIC_INITIALIZER(0);
+
 /*
     Simple "smartpointer" wrapper around a pcre2_jit_stack_16, to be used with
     QThreadStorage.
@@ -1078,10 +1259,11 @@ public:
         \internal
     */
     QPcreJitStackPointer()
+        : generation(jitStackGeneration.loadAcquire())
     {
-        // The default JIT stack size in PCRE is 32K,
-        // we allocate from 32K up to 512K.
-        stack = pcre2_jit_stack_create_16(32 * 1024, 512 * 1024, nullptr);
+        stack = pcre2_jit_stack_create_16(jitStackStartSize.loadRelaxed(),
+                                          jitStackMaxSize.loadRelaxed(),
+                                          nullptr);
     }
     /*!
         \internal
@@ -1093,10 +1275,40 @@ public:
     }
 
     pcre2_jit_stack_16 *stack;
+    int generation;
 };
 
 Q_GLOBAL_STATIC(QThreadStorage<QPcreJitStackPointer *>, jitStacks)
 
+/*!
+    \class QRegularExpressionJitStack
+    \internal
+
+    Configures the stacks used by JIT compiled patterns. A thread gets its
+    own stack the first time that a match runs out of the small stack
+    provided by PCRE; the stack starts at startSize() bytes and grows up to
+    maxSize() bytes. Changing the sizes makes the threads replace their
+    stacks the next time they need one.
+*/
+
+int QRegularExpressionJitStack::startSize()
+{
+    return jitStackStartSize.loadRelaxed();
+}
+
+int QRegularExpressionJitStack::maxSize()
+{
+    return jitStackMaxSize.loadRelaxed();
+}
+
+void QRegularExpressionJitStack::setSize(int startSize, int maxSize)
+{
+    Q_ASSERT(startSize > 0 && startSize <= maxSize);
+    jitStackStartSize.storeRelaxed(startSize);
+    jitStackMaxSize.storeRelaxed(maxSize);
+    jitStackGeneration.fetchAndAddRelease(1);
+}
+
 /*!
     \internal
 */
@@ -1133,19 +1345,19 @@ static bool isJitEnabled()
     The purpose of the function is to call pcre2_jit_compile_16, which
     JIT-compiles the pattern.
 
-    It gets called when a pattern is recompiled by us (in compilePattern()),
-    under mutex protection.
+    It gets called when a pattern is compiled by us, before the compiled
+    pattern is shared with other threads.
 */
-void QRegularExpressionPrivate::optimizePattern()
+void QRegularExpressionCompiledPattern::optimizePattern()
 {
-    Q_ASSERT(compiledPattern);
+    Q_ASSERT(code);
 
     static const bool enableJit = isJitEnabled();
 
     if (!enableJit)
         return;
 
-    pcre2_jit_compile_16(compiledPattern, PCRE2_JIT_COMPLETE | PCRE2_JIT_PARTIAL_SOFT | PCRE2_JIT_PARTIAL_HARD);
+    pcre2_jit_compile_16(code, PCRE2_JIT_COMPLETE | PCRE2_JIT_PARTIAL_SOFT | PCRE2_JIT_PARTIAL_HARD);
 }
 
 /*!
@@ -1173,6 +1385,7 @@ int QRegularExpressionPrivate::captureIndexForName(QStringView name) const
 
     This is a simple wrapper for pcre2_match_16 for handling the case in which the
     JIT runs out of memory. In that case, we allocate a thread-local JIT stack
+    (or replace it, if its size has been changed since it was allocated)
     and re-run pcre2_match_16.
 */
 static int safe_pcre2_match_16(const pcre2_code_16 *code,
@@ -1184,17 +1397,46 @@ static int safe_pcre2_match_16(const pcre2_code_16 *code,
     int result = pcre2_match_16(code, subject, length,
                                 startOffset, options, matchData, matchContext);
 
-    if (result == PCRE2_ERROR_JIT_STACKLIMIT && !jitStacks()->hasLocalData()) {
-        QPcreJitStackPointer *p = new QPcreJitStackPointer;
-        jitStacks()->setLocalData(p);
+    if (result == PCRE2_ERROR_JIT_STACKLIMIT) {
+        QThreadStorage<QPcreJitStackPointer *> *stacks = jitStacks();
+        if (!stacks->hasLocalData()
+                || stacks->localData()->generation != jitStackGeneration.loadAcquire()) {
+            QPcreJitStackPointer *p = new QPcreJitStackPointer;
+            stacks->setLocalData(p);
 
-        result = pcre2_match_16(code, subject, length,
-                                startOffset, options, matchData, matchContext);
+            result = pcre2_match_16(code, subject, length,
+                                    startOffset, options, matchData, matchContext);
+        }
     }
 
     return result;
 }
 
+/*!
+    \internal
+
+    Returns the offset of the character following the one at \a offset in
+    \a subject, which has \a length code units. A CRLF newline (if such
+    newlines are in use) and a surrogate pair are stepped over as a whole.
+*/
+static int nextCharacterOffset(const unsigned short *subject, int length, int offset,
+                               bool usingCrLfNewlines)
+{
+    ++offset;
+
+    if (usingCrLfNewlines
+            && offset < length
+            && subject[offset - 1] == QLatin1Char('\r')
+            && subject[offset] == QLatin1Char('\n')) {
+        ++offset;
+    } else if (offset < length
+               && QChar::isLowSurrogate(subject[offset])) {
+        ++offset;
+    }
+
+    return offset;
+}
+
 /*!
     \internal
 
@@ -1292,17 +1534,7 @@ QRegularExpressionMatchPrivate *QRegularExpressionPrivate::doMatch(const QString
                                      matchData, matchContext);
 
         if (result == PCRE2_ERROR_NOMATCH) {
-            ++offset;
-
-            if (usingCrLfNewlines
-                    && offset < subjectLength
-                    && subjectUtf16[offset - 1] == QLatin1Char('\r')
-                    && subjectUtf16[offset] == QLatin1Char('\n')) {
-                ++offset;
-            } else if (offset < subjectLength
-                       && QChar::isLowSurrogate(subjectUtf16[offset])) {
-                ++offset;
-            }
+            offset = nextCharacterOffset(subjectUtf16, subjectLength, offset, usingCrLfNewlines);
 
             result = safe_pcre2_match_16(compiledPattern,
                                          subjectUtf16, subjectLength,
@@ -1772,6 +2004,105 @@ QRegularExpressionMatchIterator QRegularExpression::globalMatch(const QStringRef
     return QRegularExpressionMatchIterator(*priv);
 }
 
+/*!
+    \fn template <typename Callback> qsizetype QRegularExpression::forEachMatch(QStringView subject, Callback &&callback, MatchOptions matchOptions) const
+    \since 6.0
+
+    Finds all the matches of the regular expression in \a subject, honoring
+    the given \a matchOptions, and calls \a callback for each of them with
+    the start and end offsets of the captured substring (that is, of the
+    implicit capturing group 0), as two qsizetype arguments. The matches
+    are found in the same way as with globalMatch() and a NormalMatch
+    match type.
+
+    Returns the number of matches.
+
+    Unlike globalMatch(), this function doesn't create a
+    QRegularExpressionMatch object for every match, and checks the
+    subject for invalid UTF-16 sequences only once. This makes it
+    considerably faster for scanning large buffers; use match() on a
+    match's range if its capturing groups are needed.
+
+    \snippet code/src_corelib_tools_qregularexpression.cpp 34
+
+    \sa globalMatch(), {global matching}
+*/
+
+/*!
+    \internal
+*/
+qsizetype QRegularExpression::forEachMatchImpl(QStringView subject, MatchOptions matchOptions,
+                                               void (*callback)(void *, qsizetype, qsizetype),
+                                               void *callbackData) const
+{
+    d.data()->compilePattern();
+
+    if (Q_UNLIKELY(!d->compiledPattern)) {
+        qWarning("QRegularExpression::forEachMatch(): called on an invalid QRegularExpression object");
+        return 0;
+    }
+
+    const pcre2_code_16 *code = d->compiledPattern;
+    const unsigned short * const subjectUtf16 = reinterpret_cast<const unsigned short *>(subject.utf16());
+    const int subjectLength = int(subject.size());
+    int pcreOptions = convertToPcreOptions(matchOptions);
+
+    pcre2_match_context_16 *matchContext = pcre2_match_context_create_16(nullptr);
+    pcre2_jit_stack_assign_16(matchContext, &qtPcreCallback, nullptr);
+    pcre2_match_data_16 *matchData = pcre2_match_data_create_from_pattern_16(code, nullptr);
+    const PCRE2_SIZE *ovector = pcre2_get_ovector_pointer_16(matchData);
+
+    qsizetype count = 0;
+    int offset = 0;
+    bool previousMatchWasEmpty = false;
+
+    forever {
+        int result;
+        if (!previousMatchWasEmpty) {
+            result = safe_pcre2_match_16(code,
+                                         subjectUtf16, subjectLength,
+                                         offset, pcreOptions,
+                                         matchData, matchContext);
+        } else {
+            // see QRegularExpressionPrivate::doMatch()
+            result = safe_pcre2_match_16(code,
+                                         subjectUtf16, subjectLength,
+                                         offset, pcreOptions | PCRE2_NOTEMPTY_ATSTART | PCRE2_ANCHORED,
+                                         matchData, matchContext);
+
+            if (result == PCRE2_ERROR_NOMATCH) {
+                offset = nextCharacterOffset(subjectUtf16, subjectLength, offset, d->usingCrLfNewlines);
+                if (offset > subjectLength)
+                    break;
+
+                result = safe_pcre2_match_16(code,
+                                             subjectUtf16, subjectLength,
+                                             offset, pcreOptions,
+                                             matchData, matchContext);
+            }
+        }
+
+        // no match, or an error (such as an invalid subject)
+        if (result <= 0)
+            break;
+
+        const int capturedStart = static_cast<int>(ovector[0]);
+        const int capturedEnd = static_cast<int>(ovector[1]);
+        callback(callbackData, capturedStart, capturedEnd);
+        ++count;
+
+        previousMatchWasEmpty = (capturedStart == capturedEnd);
+        offset = capturedEnd;
+        // the subject has been checked by the first match
+        pcreOptions |= PCRE2_NO_UTF_CHECK;
+    }
+
+    pcre2_match_data_free_16(matchData);
+    pcre2_match_context_free_16(matchContext);
+
+    return count;
+}
+
 /*!
     \since 5.4
 
@@ -135,6 +135,18 @@ public:
                                                 MatchType matchType       = NormalMatch,
                                                 MatchOptions matchOptions = NoMatchOption) const;
 
+    template <typename Callback>
+    qsizetype forEachMatch(QStringView subject, Callback &&callback,
+                           MatchOptions matchOptions = NoMatchOption) const
+    {
+        using Functor = typename std::remove_reference<Callback>::type;
+        return forEachMatchImpl(subject, matchOptions,
+                                [](void *f, qsizetype capturedStart, qsizetype capturedEnd) {
+                                    (*static_cast<Functor *>(f))(capturedStart, capturedEnd);
+                                },
+                                const_cast<void *>(static_cast<const void *>(&callback)));
+    }
+
     void optimize() const;
 
 #if QT_STRINGVIEW_LEVEL < 2
@@ -161,6 +173,9 @@ private:
     friend Q_CORE_EXPORT uint qHash(const QRegularExpression &key, uint seed) noexcept;
 
     QRegularExpression(QRegularExpressionPrivate &dd);
+    qsizetype forEachMatchImpl(QStringView subject, MatchOptions matchOptions,
+                               void (*callback)(void *, qsizetype, qsizetype),
+                               void *callbackData) const;
     QExplicitlySharedDataPointer<QRegularExpressionPrivate> d;
 };
 
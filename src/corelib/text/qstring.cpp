@@ -606,6 +606,54 @@ bool QtPrivate::isValidUtf16(QStringView s) noexcept
 }
 
 // conversion between Latin 1 and UTF-16
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(__AVX2__)
+// Used when the CPU turns out to have AVX2 even though the build does not assume it.
+// These return how many characters they converted, which is a multiple of 32.
+QT_FUNCTION_TARGET(AVX2)
+static qptrdiff qt_from_latin1_avx2(ushort *dst, const char *str, qptrdiff size) noexcept
+{
+    qptrdiff offset = 0;
+    for ( ; offset + 32 <= size; offset += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + offset));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + offset),
+                            _mm256_cvtepu8_epi16(_mm256_castsi256_si128(chunk)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + offset + 16),
+                            _mm256_cvtepu8_epi16(_mm256_extracti128_si256(chunk, 1)));
+    }
+    return offset;
+}
+
+template <bool Checked>
+QT_FUNCTION_TARGET(AVX2)
+static inline __m256i qt_load_latin1_avx2(const ushort *ptr) noexcept
+{
+    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+    if (Checked) {
+        // See mergeQuestionMarks in qt_to_latin1_internal() for details
+        const __m256i outOfRange = _mm256_set1_epi16(0x100);
+        chunk = _mm256_min_epu16(chunk, outOfRange);
+        const __m256i offLimitMask = _mm256_cmpeq_epi16(chunk, outOfRange);
+        chunk = _mm256_blendv_epi8(chunk, _mm256_set1_epi16('?'), offLimitMask);
+    }
+    return chunk;
+}
+
+template <bool Checked>
+QT_FUNCTION_TARGET(AVX2)
+static qptrdiff qt_to_latin1_avx2(uchar *dst, const ushort *src, qptrdiff length) noexcept
+{
+    qptrdiff offset = 0;
+    for ( ; offset + 32 <= length; offset += 32) {
+        // packing works within each 128-bit lane, so put the quarters back in order after
+        const __m256i packed = _mm256_packus_epi16(qt_load_latin1_avx2<Checked>(src + offset),
+                                                   qt_load_latin1_avx2<Checked>(src + offset + 16));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + offset),
+                            _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    return offset;
+}
+#endif
+
 void qt_from_latin1(ushort *dst, const char *str, size_t size) noexcept
 {
     /* SIMD:
@@ -617,6 +665,11 @@ void qt_from_latin1(ushort *dst, const char *str, size_t size) noexcept
     const char *e = str + size;
     qptrdiff offset = 0;
 
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(__AVX2__)
+    if (qCpuHasFeature(AVX2))
+        offset = qt_from_latin1_avx2(dst, str, qptrdiff(size));
+#  endif
+
     // we're going to read str[offset..offset+15] (16 bytes)
     for ( ; str + offset + 15 < e; offset += 16) {
         const __m128i chunk = _mm_loadu_si128((const __m128i*)(str + offset)); // load
@@ -712,6 +765,11 @@ static void qt_to_latin1_internal(uchar *dst, const ushort *src, qsizetype lengt
         return chunk;
     };
 
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(__AVX2__)
+    if (qCpuHasFeature(AVX2))
+        offset = qt_to_latin1_avx2<Checked>(dst, src, length);
+#  endif
+
     // we're going to write to dst[offset..offset+15] (16 bytes)
     for ( ; dst + offset + 15 < e; offset += 16) {
 #  if defined(__AVX2__)
@@ -14,6 +14,7 @@ HEADERS +=  \
         text/qlocale_p.h \
         text/qlocale_tools_p.h \
         text/qlocale_data_p.h \
+        text/qmultimatcher.h \
         text/qregexp.h \
         text/qstring.h \
         text/qstringalgorithms.h \
@@ -36,6 +37,7 @@ SOURCES += \
         text/qcollator.cpp \
         text/qlocale.cpp \
         text/qlocale_tools.cpp \
+        text/qmultimatcher.cpp \
         text/qregexp.cpp \
         text/qstring.cpp \
         text/qstringbuilder.cpp \
@@ -77,7 +79,8 @@ qtConfig(regularexpression) {
     QMAKE_USE_PRIVATE += pcre2
 
     HEADERS += \
-        text/qregularexpression.h
+        text/qregularexpression.h \
+        text/qregularexpression_p.h
     SOURCES += text/qregularexpression.cpp
 }
 
@@ -41,12 +41,15 @@
 #define QRUNNABLE_H
 
 #include <QtCore/qglobal.h>
+#include <QtCore/qatomic.h>
 
 QT_BEGIN_NAMESPACE
 
 class Q_CORE_EXPORT QRunnable
 {
-    int ref;
+    // -1 if auto-deletion is disabled, otherwise the number of pending runs;
+    // atomic because work-stealing pools update it without a common lock
+    QAtomicInt ref;
 
     friend class QThreadPool;
     friend class QThreadPoolPrivate;
@@ -60,8 +63,8 @@ public:
     QRunnable() : ref(0) { }
     virtual ~QRunnable();
 
-    bool autoDelete() const { return ref != -1; }
-    void setAutoDelete(bool _autoDelete) { ref = _autoDelete ? 0 : -1; }
+    bool autoDelete() const { return ref.loadRelaxed() != -1; }
+    void setAutoDelete(bool _autoDelete) { ref.storeRelaxed(_autoDelete ? 0 : -1); }
 };
 
 QT_END_NAMESPACE
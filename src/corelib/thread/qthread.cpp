@@ -91,6 +91,12 @@ QThreadData::~QThreadData()
     thread.storeRelease(nullptr);
     delete t;
 
+    for (QAbstractMetaCallEvent *event = postedMetaCalls.fetchAndStoreAcquire(nullptr); event; ) {
+        QAbstractMetaCallEvent *next = event->nextPosted_;
+        delete event;
+        event = next;
+    }
+
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
@@ -103,6 +109,49 @@ QThreadData::~QThreadData()
     // fprintf(stderr, "QThreadData %p destroyed\n", this);
 }
 
+/*
+    Moves the queued calls posted by QCoreApplicationPrivate::postMetaCallEvent()
+    to the postEventList of the thread of their receivers, whose mutex must be
+    locked. That is this thread, except while QObject::moveToThread() moves
+    receivers to another one.
+*/
+void QThreadData::takePostedMetaCalls()
+{
+    QAbstractMetaCallEvent *event = postedMetaCalls.fetchAndStoreAcquire(nullptr);
+    if (Q_LIKELY(!event))
+        return;
+
+    // put them back into the order they were posted in
+    QAbstractMetaCallEvent *first = nullptr;
+    while (event) {
+        QAbstractMetaCallEvent *next = event->nextPosted_;
+        event->nextPosted_ = first;
+        first = event;
+        event = next;
+    }
+
+    QThreadData *movedTo = nullptr;
+    for (event = first; event; ) {
+        QAbstractMetaCallEvent *next = event->nextPosted_;
+        event->nextPosted_ = nullptr;
+        QObjectPrivate *receiver = QObjectPrivate::get(event->postedTo_);
+        QThreadData *data = receiver->threadData.loadRelaxed();
+        if (data != this)
+            movedTo = data;
+        data->postEventList.addEvent(QPostEvent(event->postedTo_, event, Qt::NormalEventPriority));
+        event->posted = true;
+        ++receiver->postedEvents;
+        event = next;
+    }
+    canWait = false;
+
+    if (movedTo) {
+        movedTo->canWait = false;
+        if (QAbstractEventDispatcher *dispatcher = movedTo->eventDispatcher.loadRelaxed())
+            dispatcher->wakeUp();
+    }
+}
+
 void QThreadData::ref()
 {
 #if QT_CONFIG(thread)
@@ -80,6 +80,7 @@ namespace ABI {
 QT_BEGIN_NAMESPACE
 
 class QAbstractEventDispatcher;
+class QAbstractMetaCallEvent;
 class QEventLoop;
 
 class QPostEvent
@@ -270,9 +271,11 @@ public:
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
-        return canWait;
+        return canWait && !postedMetaCalls.loadAcquire();
     }
 
+    void takePostedMetaCalls();
+
     // This class provides per-thread (by way of being a QThreadData
     // member) storage for qFlagLocation()
     class FlaggedDebugSignatures
@@ -302,6 +305,10 @@ public:
 
     QStack<QEventLoop *> eventLoops;
     QPostEventList postEventList;
+    // queued calls posted without locking postEventList.mutex, newest first;
+    // see QCoreApplicationPrivate::postMetaCallEvent()
+    QAtomicPointer<QAbstractMetaCallEvent> postedMetaCalls;
+    QAtomicInt metaCallPosters;
     QAtomicPointer<QThread> thread;
     QAtomicPointer<void> threadId;
     QAtomicPointer<QAbstractEventDispatcher> eventDispatcher;
@@ -42,6 +42,7 @@
 #include "qdeadlinetimer.h"
 
 #include <algorithm>
+#include <deque>
 
 QT_BEGIN_NAMESPACE
 
@@ -56,12 +57,20 @@ public:
     QThreadPoolThread(QThreadPoolPrivate *manager);
     void run() override;
     void registerThreadInactive();
+    QRunnable *takeLocalTask();
 
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // Runnables started from this thread in work-stealing mode. Only this
+    // thread pushes and pops at the back; idle threads steal from the front.
+    QMutex localQueueMutex;
+    std::deque<QRunnable *> localQueue;
 };
 
+static thread_local QThreadPoolThread *currentPoolThread = nullptr;
+
 /*
     QThreadPool private class.
 */
@@ -81,6 +90,7 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+    currentPoolThread = this;
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -102,14 +112,26 @@ void QThreadPoolThread::run()
                     qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
                              "This is not supported, exceptions thrown in worker threads must be\n"
                              "caught before control returns to Qt Concurrent.");
+                    locker.relock();
+                    // don't lose the runnables this thread had queued for itself
+                    while (QRunnable *local = takeLocalTask()) {
+                        manager->enqueueTask(local);
+                        if (local->autoDelete())
+                            --local->ref; // enqueueTask() took its own reference
+                    }
                     registerThreadInactive();
                     throw;
                 }
 #endif
-                locker.relock();
-
                 if (autoDelete && !--r->ref)
                     delete r;
+
+                // runnables this thread started itself don't need the pool's mutex
+                r = takeLocalTask();
+                if (r)
+                    continue;
+
+                locker.relock();
             }
 
             // if too many threads are active, expire this thread
@@ -117,8 +139,10 @@ void QThreadPoolThread::run()
                 break;
 
             if (manager->queue.isEmpty()) {
-                r = nullptr;
-                break;
+                r = manager->stealTask(this);
+                if (!r)
+                    break;
+                continue;
             }
 
             QueuePage *page = manager->queue.first();
@@ -136,14 +160,26 @@ void QThreadPoolThread::run()
             manager->waitingThreads.enqueue(this);
             registerThreadInactive();
             // wait for work, exiting after the expiry timeout is reached
-            runnableReady.wait(locker.mutex(), QDeadlineTimer(manager->expiryTimeout));
+            manager->waitingThreadCount.ref();
+            // A pool thread that queued a runnable locally before it could
+            // see this thread waiting won't wake it, so look once more.
+            QRunnable *stolen = manager->stealTask(this);
+            if (!stolen)
+                runnableReady.wait(locker.mutex(), QDeadlineTimer(manager->expiryTimeout));
+            manager->waitingThreadCount.deref();
             ++manager->activeThreads;
-            if (manager->waitingThreads.removeOne(this))
+            if (manager->waitingThreads.removeOne(this) && !stolen)
                 expired = true;
             if (!manager->allThreads.contains(this)) {
+                if (stolen) {
+                    manager->enqueueTask(stolen);
+                    if (stolen->autoDelete())
+                        --stolen->ref; // enqueueTask() took its own reference
+                }
                 registerThreadInactive();
                 break;
             }
+            runnable = stolen;
         }
         if (expired) {
             manager->expiredThreads.enqueue(this);
@@ -155,10 +191,26 @@ void QThreadPoolThread::run()
 
 void QThreadPoolThread::registerThreadInactive()
 {
+    manager->noSpareThreads.storeRelaxed(0);
     if (--manager->activeThreads == 0)
         manager->noActiveThreads.wakeAll();
 }
 
+/*
+    \internal
+    Returns the runnable this thread queued most recently, or \nullptr.
+    Only called by the thread itself, so the pool's mutex need not be held.
+*/
+QRunnable *QThreadPoolThread::takeLocalTask()
+{
+    QMutexLocker locker(&localQueueMutex);
+    if (localQueue.empty())
+        return nullptr;
+    QRunnable *r = localQueue.back();
+    localQueue.pop_back();
+    return r;
+}
+
 
 /*
     \internal
@@ -226,6 +278,89 @@ void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
     queue.insert(std::distance(queue.constBegin(), it), new QueuePage(runnable, priority));
 }
 
+/*
+    \internal
+    Queues \a runnable on the calling thread's own queue if it is one of this
+    pool's worker threads. The pool's mutex is only taken if another thread
+    could pick up the work.
+*/
+bool QThreadPoolPrivate::tryEnqueueLocalTask(QRunnable *runnable)
+{
+    Q_ASSERT(runnable != nullptr);
+    QThreadPoolThread *thread = currentPoolThread;
+    if (!thread || thread->manager != this)
+        return false;
+
+    if (runnable->autoDelete())
+        ++runnable->ref;
+
+    bool wasEmpty;
+    {
+        QMutexLocker locker(&thread->localQueueMutex);
+        wasEmpty = thread->localQueue.empty();
+        thread->localQueue.push_back(runnable);
+    }
+
+    // A sleeping thread only looks for work to steal when woken, so this must
+    // not give up if the mutex is busy. A thread that starts waiting after the
+    // check below steals before it sleeps.
+    if (waitingThreadCount.loadRelaxed() > 0) {
+        QMutexLocker poolLocker(&mutex);
+        if (!waitingThreads.isEmpty()) {
+            waitingThreads.takeFirst()->runnableReady.wakeOne();
+            return true;
+        }
+    }
+
+    // If the pool has spare capacity, hand the oldest local runnable to a new
+    // thread. Once there is none, the mutex isn't taken for this again until
+    // a thread stops being active.
+    if (wasEmpty && !noSpareThreads.loadRelaxed()) {
+        QMutexLocker poolLocker(&mutex);
+        if (activeThreadCount() < maxThreadCount) {
+            QRunnable *oldest = nullptr;
+            {
+                QMutexLocker locker(&thread->localQueueMutex);
+                if (!thread->localQueue.empty()) {
+                    oldest = thread->localQueue.front();
+                    thread->localQueue.pop_front();
+                }
+            }
+            if (oldest) {
+                const bool autoDelete = oldest->autoDelete();
+                if (!tryStart(oldest))
+                    enqueueTask(oldest);
+                // both take their own reference; drop the local queue's one
+                if (autoDelete && !--oldest->ref)
+                    delete oldest;
+            }
+        } else {
+            noSpareThreads.storeRelaxed(1);
+        }
+    }
+    return true;
+}
+
+/*
+    \internal
+    Takes the oldest runnable from another thread's local queue, or returns
+    \nullptr if there is none. Must be called with the mutex locked.
+*/
+QRunnable *QThreadPoolPrivate::stealTask(QThreadPoolThread *thief)
+{
+    for (QThreadPoolThread *victim : qAsConst(allThreads)) {
+        if (victim == thief)
+            continue;
+        QMutexLocker locker(&victim->localQueueMutex);
+        if (!victim->localQueue.empty()) {
+            QRunnable *r = victim->localQueue.front();
+            victim->localQueue.pop_front();
+            return r;
+        }
+    }
+    return nullptr;
+}
+
 int QThreadPoolPrivate::activeThreadCount() const
 {
     return (allThreads.count()
@@ -340,6 +475,15 @@ void QThreadPoolPrivate::clear()
     }
     qDeleteAll(queue);
     queue.clear();
+
+    for (QThreadPoolThread *thread : qAsConst(allThreads)) {
+        QMutexLocker localLocker(&thread->localQueueMutex);
+        for (QRunnable *r : thread->localQueue) {
+            if (r->autoDelete() && !--r->ref)
+                delete r;
+        }
+        thread->localQueue.clear();
+    }
 }
 
 /*!
@@ -379,6 +523,17 @@ bool QThreadPool::tryTake(QRunnable *runnable)
                 return true;
             }
         }
+
+        for (QThreadPoolThread *thread : qAsConst(d->allThreads)) {
+            QMutexLocker localLocker(&thread->localQueueMutex);
+            auto it = std::find(thread->localQueue.begin(), thread->localQueue.end(), runnable);
+            if (it != thread->localQueue.end()) {
+                thread->localQueue.erase(it);
+                if (runnable->autoDelete())
+                    --runnable->ref; // undo ++ref in start()
+                return true;
+            }
+        }
     }
 
     return false;
@@ -502,6 +657,9 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (priority == 0 && d->workStealing.loadRelaxed() && d->tryEnqueueLocalTask(runnable))
+        return;
+
     QMutexLocker locker(&d->mutex);
     if (!d->tryStart(runnable)) {
         d->enqueueTask(runnable, priority);
@@ -596,6 +754,7 @@ void QThreadPool::setMaxThreadCount(int maxThreadCount)
         return;
 
     d->maxThreadCount = maxThreadCount;
+    d->noSpareThreads.storeRelaxed(0);
     d->tryToStartMoreThreads();
 }
 
@@ -661,6 +820,43 @@ uint QThreadPool::stackSize() const
     return d->stackSize;
 }
 
+/*! \property QThreadPool::workStealingEnabled
+
+    This property holds whether runnables started from the pool's own worker
+    threads are queued on a per-thread queue.
+
+    By default, all runnables that cannot be started right away go through a
+    single queue shared by all threads of the pool. When work stealing is
+    enabled, a runnable that a worker thread passes to start() is instead
+    appended to that thread's own queue, which the thread works through once
+    the current runnable returns, without contending for the pool's shared
+    state. Idle threads take ("steal") the oldest runnables from the queues
+    of busy threads. This reduces lock contention when a lot of small
+    runnables are created from within other runnables.
+
+    Runnables started with a non-zero priority, or from threads that do not
+    belong to this pool, always go through the shared, priority-ordered queue.
+    The shared queue is served before other threads' queues are stolen from,
+    but a thread finishes its own queue before looking at the shared one.
+
+    The default value is \c false. Changing it only affects subsequent calls
+    to start().
+
+    \since 6.0
+    \sa start()
+*/
+void QThreadPool::setWorkStealingEnabled(bool enabled)
+{
+    Q_D(QThreadPool);
+    d->workStealing.storeRelaxed(enabled);
+}
+
+bool QThreadPool::isWorkStealingEnabled() const
+{
+    Q_D(const QThreadPool);
+    return d->workStealing.loadRelaxed();
+}
+
 /*!
     Releases a thread previously reserved by a call to reserveThread().
 
@@ -678,6 +874,7 @@ void QThreadPool::releaseThread()
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
     --d->reservedThreads;
+    d->noSpareThreads.storeRelaxed(0);
     d->tryToStartMoreThreads();
 }
 
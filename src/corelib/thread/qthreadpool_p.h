@@ -157,6 +157,8 @@ public:
 
     bool tryStart(QRunnable *task);
     void enqueueTask(QRunnable *task, int priority = 0);
+    bool tryEnqueueLocalTask(QRunnable *task);
+    QRunnable *stealTask(QThreadPoolThread *thief);
     int activeThreadCount() const;
 
     void tryToStartMoreThreads();
@@ -182,6 +184,10 @@ public:
     int reservedThreads = 0;
     int activeThreads = 0;
     uint stackSize = 0;
+
+    QAtomicInt workStealing; // bool
+    QAtomicInt waitingThreadCount; // threads blocked waiting for a runnable
+    QAtomicInt noSpareThreads; // bool, no thread can be started for local runnables
 };
 
 QT_END_NAMESPACE
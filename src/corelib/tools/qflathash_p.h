@@ -0,0 +1,480 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFLATHASH_P_H
+#define QFLATHASH_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of a number of Qt sources files.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qhashfunctions.h"
+#include "qvector.h"
+#include <private/qsimd_p.h>
+
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+/*
+  QFlatHash provides an unordered associative container using open
+  addressing.
+
+  The entries (key, value and the cached hash) are stored densely, in
+  insertion order, in a single QVector. A separate index table maps hash
+  buckets to positions in that vector. Each bucket has a one byte control
+  tag holding seven bits of the hash of the entry stored in it, or a marker
+  for empty and deleted buckets. Buckets are probed in groups of sixteen, so
+  that with SSE2 all tags of a group can be compared against the tag being
+  looked for in a single instruction. Only buckets whose tag matches require
+  touching the entry itself.
+
+  Compared to QHash this avoids one heap allocation per node and makes
+  iteration a linear walk over contiguous memory. In exchange, inserting and
+  removing entries invalidates iterators and references, and remove() moves
+  the last entry into the place of the removed one, which changes the
+  iteration order.
+
+  Like QHash, keys need operator==() and a qHash() overload.
+*/
+
+namespace QFlatHashPrivate {
+
+enum : quint8 {
+    Empty = 0x80,
+    Deleted = 0xfe
+};
+
+struct Group
+{
+    enum { Width = 16 };
+
+    // Returns a bitmask with bit i set if the tag at ctrl[i] equals tag
+    static uint match(const quint8 *ctrl, quint8 tag) noexcept
+    {
+#ifdef __SSE2__
+        const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+        return uint(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(char(tag)))));
+#else
+        uint mask = 0;
+        for (int i = 0; i < Width; ++i)
+            mask |= uint(ctrl[i] == tag) << i;
+        return mask;
+#endif
+    }
+
+    static uint matchEmpty(const quint8 *ctrl) noexcept
+    {
+        return match(ctrl, Empty);
+    }
+
+    // Empty and Deleted are the only tags with the high bit set
+    static uint matchEmptyOrDeleted(const quint8 *ctrl) noexcept
+    {
+#ifdef __SSE2__
+        const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+        return uint(_mm_movemask_epi8(group));
+#else
+        uint mask = 0;
+        for (int i = 0; i < Width; ++i)
+            mask |= uint(ctrl[i] >> 7) << i;
+        return mask;
+#endif
+    }
+};
+
+} // namespace QFlatHashPrivate
+
+template <class Key, class T>
+class QFlatHash
+{
+    struct Node
+    {
+        Key key;
+        T value;
+        size_t hash;
+    };
+    using Group = QFlatHashPrivate::Group;
+
+    static constexpr quint8 tagForHash(size_t hash) noexcept { return quint8(hash & 0x7f); }
+    static constexpr size_t groupForHash(size_t hash) noexcept { return hash >> 7; }
+
+    QVector<Node> entries;
+    QVector<quint8> ctrl;               // one tag per bucket
+    QVector<qsizetype> bucketEntries;   // index into entries, valid if the bucket is full
+    qsizetype growthLeft = 0;           // insertions possible before the next rehash
+    uint seed = uint(qGlobalQHashSeed());
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using size_type = qsizetype;
+
+    class const_iterator;
+
+    class iterator
+    {
+        friend class QFlatHash;
+        friend class const_iterator;
+        Node *n = nullptr;
+        explicit iterator(Node *node) : n(node) {}
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = qptrdiff;
+        using value_type = T;
+        using pointer = T *;
+        using reference = T &;
+
+        iterator() = default;
+
+        const Key &key() const { return n->key; }
+        T &value() const { return n->value; }
+        T &operator*() const { return n->value; }
+        T *operator->() const { return &n->value; }
+        bool operator==(const iterator &o) const { return n == o.n; }
+        bool operator!=(const iterator &o) const { return n != o.n; }
+        iterator &operator++() { ++n; return *this; }
+        iterator operator++(int) { iterator r = *this; ++n; return r; }
+        iterator &operator--() { --n; return *this; }
+        iterator operator--(int) { iterator r = *this; --n; return r; }
+    };
+
+    class const_iterator
+    {
+        friend class QFlatHash;
+        const Node *n = nullptr;
+        explicit const_iterator(const Node *node) : n(node) {}
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = qptrdiff;
+        using value_type = T;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() = default;
+        const_iterator(const iterator &o) : n(o.n) {}
+
+        const Key &key() const { return n->key; }
+        const T &value() const { return n->value; }
+        const T &operator*() const { return n->value; }
+        const T *operator->() const { return &n->value; }
+        bool operator==(const const_iterator &o) const { return n == o.n; }
+        bool operator!=(const const_iterator &o) const { return n != o.n; }
+        const_iterator &operator++() { ++n; return *this; }
+        const_iterator operator++(int) { const_iterator r = *this; ++n; return r; }
+        const_iterator &operator--() { --n; return *this; }
+        const_iterator operator--(int) { const_iterator r = *this; --n; return r; }
+    };
+
+    QFlatHash() = default;
+
+    QFlatHash(std::initializer_list<std::pair<Key, T>> list)
+    {
+        reserve(qsizetype(list.size()));
+        for (const auto &p : list)
+            insert(p.first, p.second);
+    }
+
+    qsizetype size() const noexcept { return entries.size(); }
+    qsizetype count() const noexcept { return entries.size(); }
+    bool isEmpty() const noexcept { return entries.isEmpty(); }
+    bool empty() const noexcept { return entries.isEmpty(); }
+    qsizetype bucketCount() const noexcept { return ctrl.size(); }
+
+    void clear()
+    {
+        entries.clear();
+        ctrl.clear();
+        bucketEntries.clear();
+        growthLeft = 0;
+    }
+
+    void reserve(qsizetype size)
+    {
+        entries.reserve(size);
+        if (size > this->size() + growthLeft)
+            rehash(bucketsForSize(size));
+    }
+
+    bool contains(const Key &key) const
+    {
+        return findSlot(key, hashOf(key)) >= 0;
+    }
+
+    T value(const Key &key, const T &defaultValue = T()) const
+    {
+        const qsizetype bucket = findSlot(key, hashOf(key));
+        return bucket >= 0 ? entries.at(bucketEntries.at(bucket)).value : defaultValue;
+    }
+
+    T &operator[](const Key &key)
+    {
+        return tryEmplace(key).first->value;
+    }
+
+    const T operator[](const Key &key) const
+    {
+        return value(key);
+    }
+
+    iterator insert(const Key &key, const T &value)
+    {
+        Node *n = tryEmplace(key).first;
+        n->value = value;
+        return iterator(n);
+    }
+
+    bool remove(const Key &key)
+    {
+        const qsizetype bucket = findSlot(key, hashOf(key));
+        if (bucket < 0)
+            return false;
+        eraseBucket(bucket);
+        return true;
+    }
+
+    T take(const Key &key)
+    {
+        const qsizetype bucket = findSlot(key, hashOf(key));
+        if (bucket < 0)
+            return T();
+        T result = std::move(entries[bucketEntries.at(bucket)].value);
+        eraseBucket(bucket);
+        return result;
+    }
+
+    // Returns an iterator to the entry that took the place of the erased one.
+    iterator erase(const_iterator it)
+    {
+        const qsizetype index = it.n - entries.constData();
+        eraseBucket(findSlotForIndex(index));
+        return iterator(entries.data() + index);
+    }
+
+    iterator find(const Key &key)
+    {
+        const qsizetype bucket = findSlot(key, hashOf(key));
+        return bucket >= 0 ? iterator(entries.data() + bucketEntries.at(bucket)) : end();
+    }
+
+    const_iterator find(const Key &key) const { return constFind(key); }
+
+    const_iterator constFind(const Key &key) const
+    {
+        const qsizetype bucket = findSlot(key, hashOf(key));
+        return bucket >= 0 ? const_iterator(entries.constData() + bucketEntries.at(bucket)) : constEnd();
+    }
+
+    QVector<Key> keys() const
+    {
+        QVector<Key> result;
+        result.reserve(size());
+        for (const Node &n : entries)
+            result.append(n.key);
+        return result;
+    }
+
+    QVector<T> values() const
+    {
+        QVector<T> result;
+        result.reserve(size());
+        for (const Node &n : entries)
+            result.append(n.value);
+        return result;
+    }
+
+    iterator begin() { return iterator(entries.data()); }
+    const_iterator begin() const { return constBegin(); }
+    const_iterator cbegin() const { return constBegin(); }
+    const_iterator constBegin() const { return const_iterator(entries.constData()); }
+    iterator end() { return iterator(entries.data() + entries.size()); }
+    const_iterator end() const { return constEnd(); }
+    const_iterator cend() const { return constEnd(); }
+    const_iterator constEnd() const { return const_iterator(entries.constData() + entries.size()); }
+
+private:
+    // qHash() of small integers is the identity, which would put all of them
+    // into the first groups; mix the bits so that they spread over the table.
+    size_t hashOf(const Key &key) const
+    {
+        size_t hash = qHash(key, seed);
+        hash ^= hash >> 16;
+        hash *= size_t(0x45d9f3b);
+        hash ^= hash >> 16;
+        return hash;
+    }
+
+    static qsizetype bucketsForSize(qsizetype size)
+    {
+        // keep the load factor at or below 7/8
+        qsizetype buckets = Group::Width;
+        while (buckets - buckets / 8 < size)
+            buckets *= 2;
+        return buckets;
+    }
+
+    // Groups are probed quadratically: g, g + 1, g + 3, g + 6, ...
+    // With a power of two number of groups this visits every group.
+    qsizetype findSlot(const Key &key, size_t hash) const
+    {
+        if (ctrl.isEmpty())
+            return -1;
+        const quint8 *c = ctrl.constData();
+        const qsizetype *s = bucketEntries.constData();
+        const Node *e = entries.constData();
+        const size_t groupMask = size_t(ctrl.size() / Group::Width) - 1;
+        const quint8 tag = tagForHash(hash);
+        size_t group = groupForHash(hash) & groupMask;
+        for (size_t step = 1; ; ++step) {
+            const quint8 *g = c + group * Group::Width;
+            for (uint m = Group::match(g, tag); m; m &= m - 1) {
+                const qsizetype bucket = qsizetype(group * Group::Width) + qCountTrailingZeroBits(m);
+                const Node &n = e[s[bucket]];
+                if (n.hash == hash && n.key == key)
+                    return bucket;
+            }
+            if (Group::matchEmpty(g))
+                return -1;
+            group = (group + step) & groupMask;
+        }
+    }
+
+    qsizetype findSlotForIndex(qsizetype index) const
+    {
+        const size_t hash = entries.at(index).hash;
+        const quint8 *c = ctrl.constData();
+        const size_t groupMask = size_t(ctrl.size() / Group::Width) - 1;
+        const quint8 tag = tagForHash(hash);
+        size_t group = groupForHash(hash) & groupMask;
+        for (size_t step = 1; ; ++step) {
+            for (uint m = Group::match(c + group * Group::Width, tag); m; m &= m - 1) {
+                const qsizetype bucket = qsizetype(group * Group::Width) + qCountTrailingZeroBits(m);
+                if (bucketEntries.at(bucket) == index)
+                    return bucket;
+            }
+            group = (group + step) & groupMask;
+        }
+    }
+
+    // Returns the first empty or deleted bucket on the probe sequence of hash.
+    qsizetype findInsertSlot(size_t hash) const
+    {
+        const quint8 *c = ctrl.constData();
+        const size_t groupMask = size_t(ctrl.size() / Group::Width) - 1;
+        size_t group = groupForHash(hash) & groupMask;
+        for (size_t step = 1; ; ++step) {
+            if (uint m = Group::matchEmptyOrDeleted(c + group * Group::Width))
+                return qsizetype(group * Group::Width) + qCountTrailingZeroBits(m);
+            group = (group + step) & groupMask;
+        }
+    }
+
+    std::pair<Node *, bool> tryEmplace(const Key &key)
+    {
+        const size_t hash = hashOf(key);
+        const qsizetype found = findSlot(key, hash);
+        if (found >= 0)
+            return { entries.data() + bucketEntries.at(found), false };
+
+        if (growthLeft == 0 || ctrl.isEmpty())
+            rehash(bucketsForSize(size() + 1));
+
+        qsizetype bucket = findInsertSlot(hash);
+        quint8 *c = ctrl.data();
+        if (c[bucket] == QFlatHashPrivate::Empty)
+            --growthLeft;
+        c[bucket] = tagForHash(hash);
+        bucketEntries[bucket] = entries.size();
+        entries.append(Node{ key, T(), hash });
+        return { entries.data() + entries.size() - 1, true };
+    }
+
+    void eraseBucket(qsizetype bucket)
+    {
+        quint8 *c = ctrl.data();
+        const qsizetype groupStart = bucket & ~qsizetype(Group::Width - 1);
+        // If the group still has an empty bucket, no probe sequence ever
+        // continued past it, so the bucket can become empty again.
+        if (Group::matchEmpty(c + groupStart)) {
+            c[bucket] = QFlatHashPrivate::Empty;
+            ++growthLeft;
+        } else {
+            c[bucket] = QFlatHashPrivate::Deleted;
+        }
+
+        // keep the entries dense by moving the last one into the hole
+        const qsizetype index = bucketEntries.at(bucket);
+        const qsizetype last = entries.size() - 1;
+        if (index != last) {
+            bucketEntries[findSlotForIndex(last)] = index;
+            entries[index] = std::move(entries[last]);
+        }
+        entries.removeLast();
+    }
+
+    void rehash(qsizetype buckets)
+    {
+        if (buckets < bucketsForSize(size() + 1))
+            buckets = bucketsForSize(size() + 1);
+        ctrl.fill(QFlatHashPrivate::Empty, buckets);
+        bucketEntries.resize(buckets);
+        growthLeft = buckets - buckets / 8 - size();
+        quint8 *c = ctrl.data();
+        qsizetype *s = bucketEntries.data();
+        const Node *e = entries.constData();
+        for (qsizetype i = 0; i < entries.size(); ++i) {
+            const qsizetype bucket = findInsertSlot(e[i].hash);
+            c[bucket] = tagForHash(e[i].hash);
+            s[bucket] = i;
+        }
+    }
+};
+
+QT_END_NAMESPACE
+
+#endif // QFLATHASH_P_H
@@ -74,3 +74,18 @@ QImageReader reader(":/image.png");
 if (reader.supportsOption(QImageIOHandler::Size))
     qDebug() << "Size:" << reader.size();
 //! [3]
+
+
+//! [4]
+void ImageLoader::onReadyRead()
+{
+    // reader was constructed on the socket with the "jpeg" format
+    const int lines = reader.readScanLines(&image);
+    if (lines < 0) {
+        qWarning() << reader.errorString();
+        return;
+    }
+    processScanLines(image, linesProcessed, lines);
+    linesProcessed = lines;
+}
+//! [4]
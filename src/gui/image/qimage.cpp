@@ -63,6 +63,9 @@
 #include <private/qsimd_p.h>
 
 #include <qhash.h>
+#if QT_CONFIG(thread)
+#include <qthreadpool.h>
+#endif
 
 #include <private/qpaintengine_raster_p.h>
 
@@ -577,6 +580,12 @@ bool QImageData::checkForAlphaPixels() const
     function returns the actual matrix used for transforming the
     image.
 
+    Large images are converted to other formats and smoothly scaled
+    using several threads of the global QThreadPool, so the number of
+    threads can be limited with QThreadPool::setMaxThreadCount(). Set
+    the \c QT_NO_PARALLEL_IMAGE_PROCESSING environment variable to do
+    this work on the calling thread only.
+
     There are also functions for changing attributes of an image
     in-place:
 
@@ -5400,6 +5409,30 @@ Q_GUI_EXPORT void qt_imageTransform(QImage &src, QImageIOHandler::Transformation
     }
 }
 
+#if QT_CONFIG(thread)
+static bool qt_parallelImageProcessingDisabled()
+{
+    static const bool disabled = qEnvironmentVariableIsSet("QT_NO_PARALLEL_IMAGE_PROCESSING");
+    return disabled;
+}
+#endif
+
+int qt_imageSegmentCount(qint64 pixelCount, int lineCount)
+{
+#if QT_CONFIG(thread)
+    const QThreadPool *threadPool = QThreadPool::globalInstance();
+    if (!threadPool || qt_parallelImageProcessingDisabled())
+        return 1;
+    // Not less than 64K pixels per segment, or the threads cost more than they save.
+    const qint64 segmentCount = qMin(pixelCount >> 16, qint64(threadPool->maxThreadCount()));
+    return qBound(1, int(segmentCount), qMax(lineCount, 1));
+#else
+    Q_UNUSED(pixelCount);
+    Q_UNUSED(lineCount);
+    return 1;
+#endif
+}
+
 QMap<QString, QString> qt_getImageText(const QImage &image, const QString &description)
 {
     QMap<QString, QString> text = qt_getImageTextFromDescription(description);
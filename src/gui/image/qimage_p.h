@@ -321,6 +321,12 @@ inline QImage::Format qt_alphaVersionForPainting(QImage::Format format)
     return toFormat;
 }
 
+// Returns how many segments per-line work over pixelCount pixels in total
+// should be split into, at most one per line and per thread of the global
+// thread pool. Small images are not split, and nothing is split if
+// QT_NO_PARALLEL_IMAGE_PROCESSING is set in the environment.
+Q_GUI_EXPORT int qt_imageSegmentCount(qint64 pixelCount, int lineCount);
+
 Q_GUI_EXPORT QMap<QString, QString> qt_getImageText(const QImage &image, const QString &description);
 Q_GUI_EXPORT QMap<QString, QString> qt_getImageTextFromDescription(const QString &description);
 
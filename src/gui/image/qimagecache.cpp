@@ -0,0 +1,424 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qimagecache.h"
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QImageCache
+    \inmodule QtGui
+    \since 6.0
+
+    \brief The QImageCache class provides a thread-safe cache for images.
+
+    QImageCache associates images with string keys, and keeps the total
+    size of the images it holds below maxBytes(). Unlike QPixmapCache, it
+    can be used from any thread, so worker threads that decode or scale
+    images can share results with each other and with the GUI thread.
+
+    \snippet code/src_gui_image_qimagecache.cpp 0
+
+    Use globalInstance() for an application-wide cache, or create a
+    QImageCache for each kind of image to give each of them a budget of
+    its own; for instance, one for thumbnails and one for full size
+    previews.
+
+    The cache is divided into shards that are locked independently, so
+    threads working with different keys rarely wait for each other. When
+    the cache is full, images that were only inserted are evicted before
+    images that have been found again since, and the least recently used
+    ones go first within each group. Repeatedly used images thereby
+    survive a burst of images that are used only once.
+
+    statistics() reports the hits, misses, insertions and evictions, and
+    the memory in use, which helps with choosing a good maxBytes().
+
+    \sa QPixmapCache, QCache
+*/
+
+/*!
+    \class QImageCache::Statistics
+    \inmodule QtGui
+    \since 6.0
+
+    \brief The Statistics class holds usage counters of a QImageCache.
+
+    \sa QImageCache::statistics()
+*/
+
+/*!
+    \variable QImageCache::Statistics::hits
+    The number of times find() found an image.
+*/
+
+/*!
+    \variable QImageCache::Statistics::misses
+    The number of times find() did not find an image.
+*/
+
+/*!
+    \variable QImageCache::Statistics::insertions
+    The number of images inserted with insert().
+*/
+
+/*!
+    \variable QImageCache::Statistics::evictions
+    The number of images removed to make room for others, or because
+    maxBytes() was lowered.
+*/
+
+/*!
+    \variable QImageCache::Statistics::bytes
+    The memory used by the images in the cache, in bytes.
+*/
+
+/*!
+    \variable QImageCache::Statistics::count
+    The number of images in the cache.
+*/
+
+namespace {
+
+struct QImageCacheNode
+{
+    QString key;
+    QImage image;
+    qint64 cost = 0;
+    QImageCacheNode *prev = nullptr;
+    QImageCacheNode *next = nullptr;
+    bool frequent = false;
+};
+
+// Most recently used first
+struct QImageCacheList
+{
+    QImageCacheNode *first = nullptr;
+    QImageCacheNode *last = nullptr;
+    qint64 bytes = 0;
+
+    void prepend(QImageCacheNode *node)
+    {
+        node->prev = nullptr;
+        node->next = first;
+        if (first)
+            first->prev = node;
+        else
+            last = node;
+        first = node;
+        bytes += node->cost;
+    }
+
+    void unlink(QImageCacheNode *node)
+    {
+        if (node->prev)
+            node->prev->next = node->next;
+        else
+            first = node->next;
+        if (node->next)
+            node->next->prev = node->prev;
+        else
+            last = node->prev;
+        node->prev = node->next = nullptr;
+        bytes -= node->cost;
+    }
+};
+
+struct alignas(64) QImageCacheShard
+{
+    QMutex mutex;
+    QHash<QString, QImageCacheNode *> nodes;
+    QImageCacheList probation;  // not found since insertion
+    QImageCacheList frequent;   // found at least once
+    qint64 hits = 0;
+    qint64 misses = 0;
+    qint64 insertions = 0;
+    qint64 evictions = 0;
+};
+
+} // unnamed namespace
+
+class QImageCachePrivate
+{
+public:
+    enum { ShardCount = 16 };
+
+    QImageCachePrivate(qint64 maxBytes) : maxBytes(maxBytes) {}
+
+    int shardIndex(const QString &key) const { return qHash(key) % ShardCount; }
+    bool overBudget() const { return totalBytes.loadRelaxed() > maxBytes.loadRelaxed(); }
+    void unlink(QImageCacheShard &shard, QImageCacheNode *node);
+    void removeNode(QImageCacheShard &shard, QImageCacheNode *node);
+    void touch(QImageCacheShard &shard, QImageCacheNode *node);
+    void trim(int firstShard, const QImageCacheNode *keep = nullptr);
+
+    QImageCacheShard shards[ShardCount];
+    QAtomicInteger<qint64> totalBytes;
+    QAtomicInteger<qint64> maxBytes;
+};
+
+void QImageCachePrivate::unlink(QImageCacheShard &shard, QImageCacheNode *node)
+{
+    (node->frequent ? shard.frequent : shard.probation).unlink(node);
+}
+
+// Must be called with the shard locked
+void QImageCachePrivate::removeNode(QImageCacheShard &shard, QImageCacheNode *node)
+{
+    unlink(shard, node);
+    shard.nodes.remove(node->key);
+    totalBytes.fetchAndSubRelaxed(node->cost);
+    delete node;
+}
+
+// Must be called with the shard locked
+void QImageCachePrivate::touch(QImageCacheShard &shard, QImageCacheNode *node)
+{
+    unlink(shard, node);
+    node->frequent = true;
+    shard.frequent.prepend(node);
+
+    // Keep some room for new images, so they get a chance to be found
+    // again before they are evicted.
+    const qint64 frequentBytes = maxBytes.loadRelaxed() * 3 / 4 / ShardCount;
+    while (shard.frequent.bytes > frequentBytes && shard.frequent.last != node) {
+        QImageCacheNode *demoted = shard.frequent.last;
+        shard.frequent.unlink(demoted);
+        demoted->frequent = false;
+        shard.probation.prepend(demoted);
+    }
+}
+
+void QImageCachePrivate::trim(int firstShard, const QImageCacheNode *keep)
+{
+    // Evict images that were never found again, in any shard, before
+    // those that were, starting with the shard that needs the room.
+    // The image just inserted, keep, is only compared and never
+    // dereferenced, as another thread may have removed it since.
+    for (bool frequent : {false, true}) {
+        for (int i = 0; i < ShardCount && overBudget(); ++i) {
+            QImageCacheShard &shard = shards[(firstShard + i) % ShardCount];
+            QMutexLocker locker(&shard.mutex);
+            QImageCacheList &list = frequent ? shard.frequent : shard.probation;
+            while (list.last && list.last != keep && overBudget()) {
+                removeNode(shard, list.last);
+                ++shard.evictions;
+            }
+        }
+    }
+}
+
+Q_GLOBAL_STATIC(QImageCache, theImageCache)
+
+/*!
+    Constructs an image cache that holds at most \a maxBytes bytes of
+    image data.
+*/
+QImageCache::QImageCache(qint64 maxBytes)
+    : d(new QImageCachePrivate(maxBytes))
+{
+}
+
+/*!
+    Destroys the cache and the images it holds.
+*/
+QImageCache::~QImageCache()
+{
+    clear();
+    delete d;
+}
+
+/*!
+    Returns the application-wide image cache.
+*/
+QImageCache *QImageCache::globalInstance()
+{
+    return theImageCache();
+}
+
+/*!
+    Returns the maximum number of bytes of image data the cache holds.
+    The default is 64 MB.
+
+    \sa setMaxBytes()
+*/
+qint64 QImageCache::maxBytes() const
+{
+    return d->maxBytes.loadRelaxed();
+}
+
+/*!
+    Sets the maximum number of bytes of image data the cache holds to
+    \a bytes, evicting images if the cache holds more than that.
+
+    \sa maxBytes(), QImage::sizeInBytes()
+*/
+void QImageCache::setMaxBytes(qint64 bytes)
+{
+    d->maxBytes.storeRelaxed(bytes);
+    d->trim(0);
+}
+
+/*!
+    Looks for the image associated with \a key. If it is found, the
+    function sets \a image to it and returns \c true; otherwise it leaves
+    \a image alone and returns \c false.
+*/
+bool QImageCache::find(const QString &key, QImage *image)
+{
+    QImageCacheShard &shard = d->shards[d->shardIndex(key)];
+    QMutexLocker locker(&shard.mutex);
+    QImageCacheNode *node = shard.nodes.value(key);
+    if (!node) {
+        ++shard.misses;
+        return false;
+    }
+    ++shard.hits;
+    d->touch(shard, node);
+    if (image)
+        *image = node->image;
+    return true;
+}
+
+/*!
+    Inserts \a image into the cache, associated with \a key, replacing
+    any image that was associated with it before. The least recently
+    used images are evicted if the cache would otherwise hold more than
+    maxBytes().
+
+    Returns \c true if the image was inserted; otherwise returns \c false,
+    which happens if the image alone is larger than maxBytes().
+*/
+bool QImageCache::insert(const QString &key, const QImage &image)
+{
+    const int index = d->shardIndex(key);
+    QImageCacheShard &shard = d->shards[index];
+    const qint64 cost = image.sizeInBytes();
+    QImageCacheNode *node = nullptr;
+    {
+        QMutexLocker locker(&shard.mutex);
+        if (QImageCacheNode *old = shard.nodes.value(key))
+            d->removeNode(shard, old);
+        if (cost > d->maxBytes.loadRelaxed())
+            return false;
+
+        node = new QImageCacheNode;
+        node->key = key;
+        node->image = image;
+        node->cost = cost;
+        shard.nodes.insert(key, node);
+        shard.probation.prepend(node);
+        ++shard.insertions;
+        d->totalBytes.fetchAndAddRelaxed(cost);
+    }
+    if (d->overBudget())
+        d->trim(index, node);
+    return true;
+}
+
+/*!
+    Removes the image associated with \a key. Returns \c true if there
+    was one; otherwise returns \c false.
+*/
+bool QImageCache::remove(const QString &key)
+{
+    QImageCacheShard &shard = d->shards[d->shardIndex(key)];
+    QMutexLocker locker(&shard.mutex);
+    QImageCacheNode *node = shard.nodes.value(key);
+    if (!node)
+        return false;
+    d->removeNode(shard, node);
+    return true;
+}
+
+/*!
+    Removes all images from the cache.
+*/
+void QImageCache::clear()
+{
+    for (QImageCacheShard &shard : d->shards) {
+        QMutexLocker locker(&shard.mutex);
+        for (QImageCacheNode *node : qAsConst(shard.nodes)) {
+            d->totalBytes.fetchAndSubRelaxed(node->cost);
+            delete node;
+        }
+        shard.nodes.clear();
+        shard.probation = QImageCacheList();
+        shard.frequent = QImageCacheList();
+    }
+}
+
+/*!
+    Returns the usage counters of the cache, and how much it holds.
+
+    \sa resetStatistics()
+*/
+QImageCache::Statistics QImageCache::statistics() const
+{
+    Statistics statistics;
+    for (QImageCacheShard &shard : d->shards) {
+        QMutexLocker locker(&shard.mutex);
+        statistics.hits += shard.hits;
+        statistics.misses += shard.misses;
+        statistics.insertions += shard.insertions;
+        statistics.evictions += shard.evictions;
+        statistics.bytes += shard.probation.bytes + shard.frequent.bytes;
+        statistics.count += shard.nodes.size();
+    }
+    return statistics;
+}
+
+/*!
+    Sets the hit, miss, insertion and eviction counters to zero.
+
+    \sa statistics()
+*/
+void QImageCache::resetStatistics()
+{
+    for (QImageCacheShard &shard : d->shards) {
+        QMutexLocker locker(&shard.mutex);
+        shard.hits = shard.misses = shard.insertions = shard.evictions = 0;
+    }
+}
+
+QT_END_NAMESPACE
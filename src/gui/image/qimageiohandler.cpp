@@ -170,6 +170,10 @@
     the transformation metadata of an image. A handler that supports this option
     should not apply the transformation itself.
 
+    \value ProgressiveReading. A handler which supports this option can decode
+    an image a few scanlines at a time with readScanLines(), and returns early
+    instead of failing when a sequential device runs out of data.
+
     \value TransformedByDefault. A handler that reports support for this feature
     will have image transformation metadata applied by default on read.
 */
@@ -439,6 +443,36 @@ bool QImageIOHandler::write(const QImage &image)
     return false;
 }
 
+/*!
+    \since 6.0
+
+    Decodes up to \a maxLines more scanlines of the current image into
+    \a image, and returns the number of scanlines of \a image that are
+    complete, or -1 if an error occurred. If \a maxLines is negative,
+    all the scanlines the available data allows are decoded.
+
+    The first call sets up \a image for the image that is about to be
+    read. Like with read(), the memory of \a image is reused if it already
+    has the size and format of the image; otherwise a new image is
+    assigned to it. Later calls must pass the same image. The image has
+    been read completely when the returned value equals its height; calls
+    after that should keep returning the height rather than an error.
+
+    A handler that supports the ProgressiveReading option returns early
+    when a sequential device runs out of data, and continues where it left
+    off in the next call.
+
+    The default implementation reads the whole image with read() and
+    returns its height.
+
+    \sa read(), supportsOption()
+*/
+int QImageIOHandler::readScanLines(QImage *image, int maxLines)
+{
+    Q_UNUSED(maxLines);
+    return read(image) ? image->height() : -1;
+}
+
 /*!
     Sets the option \a option with the value \a value.
 
@@ -76,6 +76,9 @@ public:
     virtual bool read(QImage *image) = 0;
     virtual bool write(const QImage &image);
 
+    // progressive decoding
+    virtual int readScanLines(QImage *image, int maxLines);
+
     enum ImageOption {
         Size,
         ClipRect,
@@ -95,7 +98,8 @@ public:
         SupportedSubTypes,
         OptimizedWrite,
         ProgressiveScanWrite,
-        ImageTransformation
+        ImageTransformation,
+        ProgressiveReading
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
         , TransformedByDefault
 #endif
@@ -487,11 +487,16 @@ public:
         DoNotApplyTransform
     } autoTransform;
 
+    // set once readScanLines() has returned the last scanline
+    bool scanLinesComplete;
+
     // error
     QImageReader::ImageReaderError imageReaderError;
     QString errorString;
 
     QImageReader *q;
+
+    void finishImage(QImage *image);
 };
 
 /*!
@@ -506,6 +511,7 @@ QImageReaderPrivate::QImageReaderPrivate(QImageReader *qq)
     quality = -1;
     imageReaderError = QImageReader::UnknownError;
     autoTransform = UsePluginDefault;
+    scanLinesComplete = false;
 
     q = qq;
 }
@@ -588,6 +594,26 @@ void QImageReaderPrivate::getText()
         text = qt_getImageTextFromDescription(handler->option(QImageIOHandler::Description).toString());
 }
 
+extern void qt_imageTransform(QImage &src, QImageIOHandler::Transformations orient);
+
+/*!
+    \internal
+
+    Applies the device pixel ratio and transformation to a completely read image.
+*/
+void QImageReaderPrivate::finishImage(QImage *image)
+{
+    // check for "@Nx" file name suffix and set device pixel ratio.
+    static bool disableNxImageLoading = !qEnvironmentVariableIsEmpty("QT_HIGHDPI_DISABLE_2X_IMAGE_LOADING");
+    if (!disableNxImageLoading) {
+        const QByteArray suffix = QFileInfo(q->fileName()).baseName().right(3).toLatin1();
+        if (suffix.length() == 3 && suffix[0] == '@' && suffix[1] >= '2' && suffix[1] <= '9' && suffix[2] == 'x')
+            image->setDevicePixelRatio(suffix[1] - '0');
+    }
+    if (q->autoTransform())
+        qt_imageTransform(*image, q->transformation());
+}
+
 /*!
     Constructs an empty QImageReader object. Before reading an image,
     call setDevice() or setFileName().
@@ -781,6 +807,7 @@ void QImageReader::setDevice(QIODevice *device)
     delete d->handler;
     d->handler = nullptr;
     d->text.clear();
+    d->scanLinesComplete = false;
 }
 
 /*!
@@ -1227,8 +1254,6 @@ QImage QImageReader::read()
     return read(&image) ? image : QImage();
 }
 
-extern void qt_imageTransform(QImage &src, QImageIOHandler::Transformations orient);
-
 /*!
     \overload
 
@@ -1240,6 +1265,8 @@ extern void qt_imageTransform(QImage &src, QImageIOHandler::Transformations orie
     reading. Because of this, it can be faster than the other read() overload,
     which always constructs a new image; especially when reading several
     images with the same format and size.
+    The image can also have been constructed on memory owned by the
+    application, which lets the application decode into pooled buffers.
 
     \snippet code/src_gui_image_qimagereader.cpp 2
 
@@ -1344,17 +1371,80 @@ bool QImageReader::read(QImage *image)
         }
     }
 
-    // successful read; check for "@Nx" file name suffix and set device pixel ratio.
-    static bool disableNxImageLoading = !qEnvironmentVariableIsEmpty("QT_HIGHDPI_DISABLE_2X_IMAGE_LOADING");
-    if (!disableNxImageLoading) {
-        const QByteArray suffix = QFileInfo(fileName()).baseName().right(3).toLatin1();
-        if (suffix.length() == 3 && suffix[0] == '@' && suffix[1] >= '2' && suffix[1] <= '9' && suffix[2] == 'x')
-            image->setDevicePixelRatio(suffix[1] - '0');
+    d->finishImage(image);
+    return true;
+}
+
+/*!
+    \since 6.0
+
+    Decodes up to \a maxLines more scanlines of the image into \a image,
+    and returns the number of scanlines of \a image that are complete so
+    far, or -1 if an error occurred. If \a maxLines is negative, all the
+    scanlines the available data allows are decoded.
+
+    This lets an application start processing the top of an image before
+    all of it has been decoded. If the image handler supports the
+    QImageIOHandler::ProgressiveReading option, the function also returns
+    early when a sequential device, such as a socket, runs out of data; call
+    it again when more data is available. The image is complete when the
+    returned value equals the height of \a image. Further calls, for
+    instance when the rest of the data arrives, keep returning the height
+    of the image; -1 always means that reading failed.
+
+    \snippet code/src_gui_image_qimagereader.cpp 4
+
+    Like with read(), \a image is reused if it already has the format and
+    size of the image being read. This includes images constructed on memory
+    owned by the application, so the image can be decoded straight into a
+    pooled buffer. Pass the same image to every call.
+
+    If the handler does not support progressive reading, or if a clip rect,
+    scaled size or scaled clip rect has been set, the first call reads the
+    whole image like read() does. If autoTransform() is enabled, the
+    transformation is applied when the last scanline has been decoded, so
+    the scanlines seen before that are in the orientation they are stored in.
+
+    \sa read(), supportsOption()
+*/
+int QImageReader::readScanLines(QImage *image, int maxLines)
+{
+    if (!image) {
+        qWarning("QImageReader::readScanLines: cannot read into null pointer");
+        return -1;
     }
-    if (autoTransform())
-        qt_imageTransform(*image, transformation());
 
-    return true;
+    if (!d->handler && !d->initHandler())
+        return -1;
+
+    // the device may still deliver data that follows the last scanline
+    if (d->scanLinesComplete)
+        return image->height();
+
+    if (!d->handler->supportsOption(QImageIOHandler::ProgressiveReading)
+        || !d->clipRect.isNull() || d->scaledSize.isValid() || !d->scaledClipRect.isNull()) {
+        if (!read(image))
+            return -1;
+        d->scanLinesComplete = true;
+        return image->height();
+    }
+
+    if (d->handler->supportsOption(QImageIOHandler::Quality))
+        d->handler->setOption(QImageIOHandler::Quality, d->quality);
+
+    const int lines = d->handler->readScanLines(image, maxLines);
+    if (lines < 0) {
+        d->imageReaderError = InvalidDataError;
+        d->errorString = QImageReader::tr("Unable to read image data");
+        return -1;
+    }
+
+    if (image->isNull() || lines < image->height())
+        return lines;
+
+    d->finishImage(image);
+    d->scanLinesComplete = true;
+    return image->height();
 }
 
 /*!
@@ -1372,6 +1462,7 @@ bool QImageReader::jumpToNextImage()
 {
     if (!d->initHandler())
         return false;
+    d->scanLinesComplete = false;
     return d->handler->jumpToNextImage();
 }
 
@@ -1388,6 +1479,7 @@ bool QImageReader::jumpToImage(int imageNumber)
 {
     if (!d->initHandler())
         return false;
+    d->scanLinesComplete = false;
     return d->handler->jumpToImage(imageNumber);
 }
 
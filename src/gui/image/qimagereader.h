@@ -126,6 +126,7 @@ public:
     bool canRead() const;
     QImage read();
     bool read(QImage *image);
+    int readScanLines(QImage *image, int maxLines = -1);
 
     bool jumpToNextImage();
     bool jumpToImage(int imageNumber);
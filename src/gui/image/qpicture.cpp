@@ -45,6 +45,9 @@
 #include <private/qfactoryloader_p.h>
 #include <private/qpaintengine_pic_p.h>
 #include <private/qfont_p.h>
+#include <private/qguiapplication_p.h>
+#include <private/qparallel_p.h>
+#include <qpa/qplatformintegration.h>
 #include <qguiapplication.h>
 
 #include "qdatastream.h"
@@ -56,6 +59,9 @@
 #include "qpixmap.h"
 #include "qregexp.h"
 #include "qregion.h"
+#if QT_CONFIG(thread)
+#include "qthreadpool.h"
+#endif
 #include "qdebug.h"
 #include <QtCore/private/qlocking_p.h>
 
@@ -377,9 +383,13 @@ bool QPicture::play(QPainter *painter)
     if (!d->formatOk && !d->checkFormat())
         return false;
 
-    d->pictb.open(QIODevice::ReadOnly);                // open buffer device
+    // Read through a buffer of our own rather than d->pictb, so that the
+    // picture can be played on several painters at the same time.
+    QBuffer buffer;
+    buffer.setData(d->pictb.buffer());
+    buffer.open(QIODevice::ReadOnly);
     QDataStream s;
-    s.setDevice(&d->pictb);                        // attach data stream to buffer
+    s.setDevice(&buffer);                        // attach data stream to buffer
     s.device()->seek(10);                        // go directly to the data
     s.setVersion(d->formatMajor == 4 ? 3 : d->formatMajor);
 
@@ -395,13 +405,89 @@ bool QPicture::play(QPainter *painter)
     s >> nrecords;
     if (!exec(painter, s, nrecords)) {
         qWarning("QPicture::play: Format error");
-        d->pictb.close();
         return false;
     }
-    d->pictb.close();
     return true;                                // no end-command
 }
 
+/*!
+    \since 6.0
+
+    Replays the picture on \a image, using several threads, and returns
+    \c true if successful; otherwise returns \c false.
+
+    The image is split into horizontal bands, one per thread of the
+    global QThreadPool, and the picture is painted into all bands at
+    once. The result is the same as painting the picture with play() and
+    a QPainter that is active on \a image, but large images are rendered
+    several times faster on a multi-core system. To use this, record the
+    painting commands for a large image into a QPicture, then play them
+    with this function instead of painting them directly.
+
+    Small images, and pictures containing pixmaps on platforms that cannot
+    use pixmaps outside of the GUI thread, are painted on the calling
+    thread.
+
+    \a image must not be painted on by another QPainter at the same time.
+
+    \sa play(), QPainter::drawPicture()
+*/
+
+bool QPicture::playParallel(QImage *image)
+{
+    Q_D(QPicture);
+
+    if (!image || image->isNull())
+        return false;
+    if (image->paintingActive()) {
+        qWarning("QPicture::playParallel: The image is already being painted on");
+        return false;
+    }
+
+    if (d->pictb.size() == 0)                        // nothing recorded
+        return true;
+
+    if (!d->formatOk && !d->checkFormat())
+        return false;
+
+    const bool threadSafePixmaps = (d->in_memory_only && d->pixmap_list.isEmpty())
+            || (QGuiApplicationPrivate::platformIntegration()
+                && QGuiApplicationPrivate::platformIntegration()->hasCapability(QPlatformIntegration::ThreadedPixmaps));
+#if QT_CONFIG(thread)
+    const int threadCount = QThreadPool::globalInstance()->maxThreadCount();
+#else
+    const int threadCount = 1;
+#endif
+    // Not less than 256K pixels per band, or the threads cost more than they save.
+    const int bandCount = qMin(threadCount, int((qint64(image->width()) * image->height()) >> 18));
+    if (bandCount <= 1 || !threadSafePixmaps) {
+        QPainter painter(image);
+        return play(&painter);
+    }
+
+    // Each band paints on an image of its own that shares the pixels of the
+    // target, clipped to its rows, so that the coordinates and the rounding
+    // are exactly the same as when painting the whole image at once.
+    uchar *bits = image->bits();
+    QAtomicInt failed;
+    const auto playBand = [&](int top, int bottom) {
+        QImage band(bits, image->width(), image->height(), image->bytesPerLine(),
+                    image->format());
+        band.setColorTable(image->colorTable());
+        band.setDotsPerMeterX(image->dotsPerMeterX());
+        band.setDotsPerMeterY(image->dotsPerMeterY());
+        band.setDevicePixelRatio(image->devicePixelRatio());
+        band.paintEngine()->setSystemClip(QRect(0, top, image->width(), bottom - top));
+
+        QPainter painter(&band);
+        if (!play(&painter))
+            failed.storeRelaxed(1);
+    };
+    qt_parallelForSegments(image->height(), bandCount, playBand);
+
+    return !failed.loadRelaxed();
+}
+
 
 //
 // QFakeDevice is used to create fonts with a custom DPI
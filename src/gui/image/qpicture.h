@@ -67,6 +67,7 @@ public:
     virtual void setData(const char* data, uint size);
 
     bool play(QPainter *p);
+    bool playParallel(QImage *image);
 
     bool load(QIODevice *dev);
     bool load(const QString &fileName);
@@ -86,9 +86,10 @@ QT_BEGIN_NAMESPACE
     applications by caching the results of painting.
 
     \note QPixmapCache is only usable from the application's main thread.
-    Access from other threads will be ignored and return failure.
+    Access from other threads will be ignored and return failure. Use
+    QImageCache to cache images that are produced in other threads.
 
-    \sa QCache, QPixmap
+    \sa QCache, QPixmap, QImageCache
 */
 
 static const int cache_limit_default = 10240; // 10 MB cache limit
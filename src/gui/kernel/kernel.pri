@@ -43,6 +43,7 @@ HEADERS += \
         kernel/qclipboard.h \
         kernel/qcursor.h \
         kernel/qcursor_p.h \
+        kernel/qparallel_p.h \
         kernel/qevent.h \
         kernel/qevent_p.h \
         kernel/qinputmethod.h \
@@ -99,6 +100,7 @@ SOURCES += \
         kernel/qwindow.cpp \
         kernel/qoffscreensurface.cpp \
         kernel/qplatformsurface.cpp \
+        kernel/qparallel.cpp \
         kernel/qsurface.cpp \
         kernel/qclipboard.cpp \
         kernel/qcursor.cpp \
@@ -0,0 +1,113 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qparallel_p.h"
+
+#if QT_CONFIG(thread)
+#include <qsemaphore.h>
+#include <qthreadpool.h>
+#endif
+
+#include <memory>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+#if QT_CONFIG(thread)
+namespace {
+class QSegmentRunnable : public QRunnable
+{
+public:
+    QSegmentRunnable(const std::function<void(int, int)> &function, int begin, int end,
+                     QSemaphore *done)
+        : function(function), begin(begin), end(end), done(done)
+    {
+        setAutoDelete(false);
+    }
+
+    void run() override
+    {
+        function(begin, end);
+        done->release();
+    }
+
+private:
+    const std::function<void(int, int)> &function;
+    const int begin;
+    const int end;
+    QSemaphore *done;
+};
+}
+#endif
+
+void qt_parallelForSegments(int count, int segmentCount,
+                            const std::function<void(int, int)> &function)
+{
+    segmentCount = qMin(segmentCount, count);
+#if QT_CONFIG(thread)
+    QThreadPool *threadPool = QThreadPool::globalInstance();
+    if (segmentCount > 1 && threadPool) {
+        QSemaphore done;
+        std::vector<std::unique_ptr<QSegmentRunnable>> segments;
+        segments.reserve(segmentCount);
+        int begin = 0;
+        for (int i = 0; i < segmentCount; ++i) {
+            const int end = begin + (count - begin) / (segmentCount - i);
+            segments.emplace_back(new QSegmentRunnable(function, begin, end, &done));
+            begin = end;
+        }
+
+        for (int i = 1; i < segmentCount; ++i)
+            threadPool->start(segments[i].get());
+        segments.front()->run();
+        // Do the segments no thread has picked up yet ourselves, rather
+        // than waiting for the pool, which may be busy or be running us.
+        for (int i = 1; i < segmentCount; ++i) {
+            if (threadPool->tryTake(segments[i].get()))
+                segments[i]->run();
+        }
+        done.acquire(segmentCount);
+        return;
+    }
+#endif
+    if (count > 0)
+        function(0, count);
+}
+
+QT_END_NAMESPACE
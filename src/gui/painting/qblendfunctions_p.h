@@ -78,6 +78,8 @@ void qt_scale_image_16bit(uchar *destPixels, int dbpl,
 //              << " - sx=" << sx << " sy=" << sy << " ix=" << ix << " iy=" << iy;
 
     QRect tr = targetRect.normalized().toRect();
+    const int tx0 = tr.left();
+    const int ty0 = tr.top();
     tr = tr.intersected(clip);
     if (tr.isEmpty())
         return;
@@ -89,20 +91,24 @@ void qt_scale_image_16bit(uchar *destPixels, int dbpl,
     quint32 basex;
     quint32 srcy;
 
+    // Find the source position for the unclipped target and step it to the
+    // clipped one, so a pixel maps to the same source pixel with any clip.
     if (sx < 0) {
-        int dstx = qFloor((tx1 + qreal(0.5) - targetRect.right()) * sx * 65536) + 1;
+        int dstx = qFloor((tx0 + qreal(0.5) - targetRect.right()) * sx * 65536) + 1;
         basex = quint32(srcRect.right() * 65536) + dstx;
     } else {
-        int dstx = qCeil((tx1 + qreal(0.5) - targetRect.left()) * sx * 65536) - 1;
+        int dstx = qCeil((tx0 + qreal(0.5) - targetRect.left()) * sx * 65536) - 1;
         basex = quint32(srcRect.left() * 65536) + dstx;
     }
     if (sy < 0) {
-        int dsty = qFloor((ty1 + qreal(0.5) - targetRect.bottom()) * sy * 65536) + 1;
+        int dsty = qFloor((ty0 + qreal(0.5) - targetRect.bottom()) * sy * 65536) + 1;
         srcy = quint32(srcRect.bottom() * 65536) + dsty;
     } else {
-        int dsty = qCeil((ty1 + qreal(0.5) - targetRect.top()) * sy * 65536) - 1;
+        int dsty = qCeil((ty0 + qreal(0.5) - targetRect.top()) * sy * 65536) - 1;
         srcy = quint32(srcRect.top() * 65536) + dsty;
     }
+    basex += quint32(ix) * quint32(tx1 - tx0);
+    srcy += quint32(iy) * quint32(ty1 - ty0);
 
     quint16 *dst = ((quint16 *) (destPixels + ty1 * dbpl)) + tx1;
 
@@ -169,6 +175,8 @@ template <typename T> void qt_scale_image_32bit(uchar *destPixels, int dbpl,
 //              << " - sx=" << sx << " sy=" << sy << " ix=" << ix << " iy=" << iy;
 
     QRect tr = targetRect.normalized().toRect();
+    const int tx0 = tr.left();
+    const int ty0 = tr.top();
     tr = tr.intersected(clip);
     if (tr.isEmpty())
         return;
@@ -180,20 +188,24 @@ template <typename T> void qt_scale_image_32bit(uchar *destPixels, int dbpl,
     quint32 basex;
     quint32 srcy;
 
+    // Find the source position for the unclipped target and step it to the
+    // clipped one, so a pixel maps to the same source pixel with any clip.
     if (sx < 0) {
-        int dstx = qFloor((tx1 + qreal(0.5) - targetRect.right()) * sx * 65536) + 1;
+        int dstx = qFloor((tx0 + qreal(0.5) - targetRect.right()) * sx * 65536) + 1;
         basex = quint32(srcRect.right() * 65536) + dstx;
     } else {
-        int dstx = qCeil((tx1 + qreal(0.5) - targetRect.left()) * sx * 65536) - 1;
+        int dstx = qCeil((tx0 + qreal(0.5) - targetRect.left()) * sx * 65536) - 1;
         basex = quint32(srcRect.left() * 65536) + dstx;
     }
     if (sy < 0) {
-        int dsty = qFloor((ty1 + qreal(0.5) - targetRect.bottom()) * sy * 65536) + 1;
+        int dsty = qFloor((ty0 + qreal(0.5) - targetRect.bottom()) * sy * 65536) + 1;
         srcy = quint32(srcRect.bottom() * 65536) + dsty;
     } else {
-        int dsty = qCeil((ty1 + qreal(0.5) - targetRect.top()) * sy * 65536) - 1;
+        int dsty = qCeil((ty0 + qreal(0.5) - targetRect.top()) * sy * 65536) - 1;
         srcy = quint32(srcRect.top() * 65536) + dsty;
     }
+    basex += quint32(ix) * quint32(tx1 - tx0);
+    srcy += quint32(iy) * quint32(ty1 - ty0);
 
     quint32 *dst = ((quint32 *) (destPixels + ty1 * dbpl)) + tx1;
 
@@ -246,7 +258,10 @@ void qt_transform_image_rasterize(DestT *destPixels, int dbpl,
                                   int dudx, int dvdx, int dudy, int dvdy, int u0, int v0,
                                   Blender blender)
 {
-    int fromY = qMax(qRound(topY), clip.top());
+    // The edges are set up at the first row of the unclipped area and stepped
+    // to the clipped one, so a row is rasterized the same with any clip.
+    const int startY = qMax(qRound(topY), qMin(clip.top(), 0));
+    int fromY = qMax(startY, clip.top());
     int toY = qMin(qRound(bottomY), clip.top() + clip.height());
     if (fromY >= toY)
         return;
@@ -255,8 +270,10 @@ void qt_transform_image_rasterize(DestT *destPixels, int dbpl,
     qreal rightSlope = (bottomRight.x - topRight.x) / (bottomRight.y - topRight.y);
     int dx_l = int(leftSlope * 0x10000);
     int dx_r = int(rightSlope * 0x10000);
-    int x_l = int((topLeft.x + (qreal(0.5) + fromY - topLeft.y) * leftSlope + qreal(0.5)) * 0x10000);
-    int x_r = int((topRight.x + (qreal(0.5) + fromY - topRight.y) * rightSlope + qreal(0.5)) * 0x10000);
+    int x_l = int((topLeft.x + (qreal(0.5) + startY - topLeft.y) * leftSlope + qreal(0.5)) * 0x10000);
+    int x_r = int((topRight.x + (qreal(0.5) + startY - topRight.y) * rightSlope + qreal(0.5)) * 0x10000);
+    x_l += int(quint32(dx_l) * quint32(fromY - startY));
+    x_r += int(quint32(dx_r) * quint32(fromY - startY));
 
     int fromX, toX, x1, x2, u, v, i, ii;
     DestT *line;
@@ -151,9 +151,20 @@ inline void drawPixel(QCosmeticStroker *stroker, int x, int y, int coverage)
         const int lastx = stroker->spans[stroker->current_span-1].x + stroker->spans[stroker->current_span-1].len ;
         const int lasty = stroker->spans[stroker->current_span-1].y;
 
-        if (stroker->current_span == QCosmeticStroker::NSPANS || y < lasty || (y == lasty && x < lastx)) {
+        if (y < lasty || (y == lasty && x < lastx)) {
             stroker->blend(stroker->current_span, stroker->spans, &stroker->state->penData);
             stroker->current_span = 0;
+        } else if (stroker->current_span == QCosmeticStroker::NSPANS) {
+            // keep the spans of line y together, as the blend functions fetch
+            // adjacent spans at once, or where they are split depends on the clip
+            int count = stroker->current_span;
+            while (count > 0 && stroker->spans[count - 1].y == y)
+                --count;
+            if (count == 0)
+                count = stroker->current_span;
+            stroker->blend(count, stroker->spans, &stroker->state->penData);
+            stroker->current_span -= count;
+            memmove(stroker->spans, stroker->spans + count, stroker->current_span * sizeof(QT_FT_Span));
         }
     }
 
@@ -525,6 +525,9 @@ void qt_scale_image_argb32_on_argb32_sse2(uchar *destPixels, int dbpl,
     if (ty2 < ty1)
         qSwap(ty2, ty1);
 
+    const int tx0 = tx1;
+    const int ty0 = ty1;
+
     if (tx1 < cx1)
         tx1 = cx1;
     if (tx2 >= cx2)
@@ -546,20 +549,24 @@ void qt_scale_image_argb32_on_argb32_sse2(uchar *destPixels, int dbpl,
     quint32 basex;
     quint32 srcy;
 
+    // Find the source position for the unclipped target and step it to the
+    // clipped one, so a pixel maps to the same source pixel with any clip.
     if (sx < 0) {
-        int dstx = qFloor((tx1 + qreal(0.5) - targetRect.right()) * ix) + 1;
+        int dstx = qFloor((tx0 + qreal(0.5) - targetRect.right()) * ix) + 1;
         basex = quint32(sourceRect.right() * 65536) + dstx;
     } else {
-        int dstx = qCeil((tx1 + qreal(0.5) - targetRect.left()) * ix) - 1;
+        int dstx = qCeil((tx0 + qreal(0.5) - targetRect.left()) * ix) - 1;
         basex = quint32(sourceRect.left() * 65536) + dstx;
     }
     if (sy < 0) {
-        int dsty = qFloor((ty1 + qreal(0.5) - targetRect.bottom()) * iy) + 1;
+        int dsty = qFloor((ty0 + qreal(0.5) - targetRect.bottom()) * iy) + 1;
         srcy = quint32(sourceRect.bottom() * 65536) + dsty;
     } else {
-        int dsty = qCeil((ty1 + qreal(0.5) - targetRect.top()) * iy) - 1;
+        int dsty = qCeil((ty0 + qreal(0.5) - targetRect.top()) * iy) - 1;
         srcy = quint32(sourceRect.top() * 65536) + dsty;
     }
+    basex += quint32(ix) * quint32(tx1 - tx0);
+    srcy += quint32(iy) * quint32(ty1 - ty0);
 
     quint32 *dst = ((quint32 *) (destPixels + ty1 * dbpl)) + tx1;
 
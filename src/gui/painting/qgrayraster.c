@@ -1282,15 +1282,26 @@ QT_FT_END_STMNT
 
       if ( count >= QT_FT_MAX_GRAY_SPANS )
       {
-        if ( ras.render_span && count > ras.skip_spans )
+        int  rows = count;
+
+
+        /* keep the spans of the current line together, as the span  */
+        /* callback fetches adjacent spans at once; otherwise where  */
+        /* they were split would depend on the top of the clip box   */
+        while ( rows > 0 && ras.gray_spans[rows - 1].y == y )
+          rows--;
+        if ( rows == 0 )
+          rows = count;
+
+        if ( ras.render_span && rows > ras.skip_spans )
         {
           skip = ras.skip_spans > 0 ? ras.skip_spans : 0;
-          ras.render_span( ras.num_gray_spans - skip,
+          ras.render_span( rows - skip,
                            ras.gray_spans + skip,
                            ras.render_span_data );
         }
 
-        ras.skip_spans -= ras.num_gray_spans;
+        ras.skip_spans -= rows;
 
         /* ras.render_span( span->y, ras.gray_spans, count ); */
 
@@ -1311,9 +1322,11 @@ QT_FT_END_STMNT
 
 #endif /* DEBUG_GRAYS */
 
-        ras.num_gray_spans = 0;
+        ras.num_gray_spans = count - rows;
+        memmove( ras.gray_spans, ras.gray_spans + rows,
+                 (size_t)ras.num_gray_spans * sizeof ( QT_FT_Span ) );
 
-        span  = ras.gray_spans;
+        span  = ras.gray_spans + ras.num_gray_spans;
       }
       else
         span++;
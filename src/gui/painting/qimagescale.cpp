@@ -38,6 +38,8 @@
 ****************************************************************************/
 #include <private/qimagescale_p.h>
 #include <private/qdrawhelper_p.h>
+#include <private/qimage_p.h>
+#include <private/qparallel_p.h>
 
 #include "qimage.h"
 #include "qcolor.h"
@@ -282,6 +284,18 @@ void qt_qimageScaleAARGBA_down_xy_sse4(QImageScaleInfo *isi, unsigned int *dest,
                                        int dw, int dh, int dow, int sow);
 #endif
 
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+template<bool RGB>
+void qt_qimageScaleAARGBA_up_x_down_y_avx2(QImageScaleInfo *isi, unsigned int *dest,
+                                           int dw, int dh, int dow, int sow);
+template<bool RGB>
+void qt_qimageScaleAARGBA_down_x_up_y_avx2(QImageScaleInfo *isi, unsigned int *dest,
+                                           int dw, int dh, int dow, int sow);
+template<bool RGB>
+void qt_qimageScaleAARGBA_down_xy_avx2(QImageScaleInfo *isi, unsigned int *dest,
+                                       int dw, int dh, int dow, int sow);
+#endif
+
 #if defined(__ARM_NEON__)
 template<bool RGB>
 void qt_qimageScaleAARGBA_up_x_down_y_neon(QImageScaleInfo *isi, unsigned int *dest,
@@ -342,6 +356,11 @@ static void qt_qimageScaleAARGBA(QImageScaleInfo *isi, unsigned int *dest,
     }
     /* if we're scaling down vertically */
     else if (isi->xup_yup == 1) {
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+        if (qCpuHasFeature(ArchHaswell))
+            qt_qimageScaleAARGBA_up_x_down_y_avx2<false>(isi, dest, dw, dh, dow, sow);
+        else
+#endif
 #ifdef QT_COMPILER_SUPPORTS_SSE4_1
         if (qCpuHasFeature(SSE4_1))
             qt_qimageScaleAARGBA_up_x_down_y_sse4<false>(isi, dest, dw, dh, dow, sow);
@@ -355,6 +374,11 @@ static void qt_qimageScaleAARGBA(QImageScaleInfo *isi, unsigned int *dest,
     }
     /* if we're scaling down horizontally */
     else if (isi->xup_yup == 2) {
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+        if (qCpuHasFeature(ArchHaswell))
+            qt_qimageScaleAARGBA_down_x_up_y_avx2<false>(isi, dest, dw, dh, dow, sow);
+        else
+#endif
 #ifdef QT_COMPILER_SUPPORTS_SSE4_1
         if (qCpuHasFeature(SSE4_1))
             qt_qimageScaleAARGBA_down_x_up_y_sse4<false>(isi, dest, dw, dh, dow, sow);
@@ -368,6 +392,11 @@ static void qt_qimageScaleAARGBA(QImageScaleInfo *isi, unsigned int *dest,
     }
     /* if we're scaling down horizontally & vertically */
     else {
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+        if (qCpuHasFeature(ArchHaswell))
+            qt_qimageScaleAARGBA_down_xy_avx2<false>(isi, dest, dw, dh, dow, sow);
+        else
+#endif
 #ifdef QT_COMPILER_SUPPORTS_SSE4_1
         if (qCpuHasFeature(SSE4_1))
             qt_qimageScaleAARGBA_down_xy_sse4<false>(isi, dest, dw, dh, dow, sow);
@@ -538,6 +567,15 @@ static void qt_qimageScaleRgba64_down_x_up_y(QImageScaleInfo *isi, QRgba64 *dest
 static void qt_qimageScaleRgba64_down_xy(QImageScaleInfo *isi, QRgba64 *dest,
                                          int dw, int dh, int dow, int sow);
 
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+void qt_qimageScaleRgba64_up_x_down_y_avx2(QImageScaleInfo *isi, QRgba64 *dest,
+                                           int dw, int dh, int dow, int sow);
+void qt_qimageScaleRgba64_down_x_up_y_avx2(QImageScaleInfo *isi, QRgba64 *dest,
+                                           int dw, int dh, int dow, int sow);
+void qt_qimageScaleRgba64_down_xy_avx2(QImageScaleInfo *isi, QRgba64 *dest,
+                                       int dw, int dh, int dow, int sow);
+#endif
+
 static void qt_qimageScaleRgba64_up_xy(QImageScaleInfo *isi, QRgba64 *dest,
                                        int dw, int dh, int dow, int sow)
 {
@@ -577,14 +615,30 @@ static void qt_qimageScaleRgba64_up_xy(QImageScaleInfo *isi, QRgba64 *dest,
 void qt_qimageScaleRgba64(QImageScaleInfo *isi, QRgba64 *dest,
                           int dw, int dh, int dow, int sow)
 {
-    if (isi->xup_yup == 3)
+    if (isi->xup_yup == 3) {
         qt_qimageScaleRgba64_up_xy(isi, dest, dw, dh, dow, sow);
-    else if (isi->xup_yup == 1)
+    } else if (isi->xup_yup == 1) {
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+        if (qCpuHasFeature(ArchHaswell))
+            qt_qimageScaleRgba64_up_x_down_y_avx2(isi, dest, dw, dh, dow, sow);
+        else
+#endif
         qt_qimageScaleRgba64_up_x_down_y(isi, dest, dw, dh, dow, sow);
-    else if (isi->xup_yup == 2)
+    } else if (isi->xup_yup == 2) {
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+        if (qCpuHasFeature(ArchHaswell))
+            qt_qimageScaleRgba64_down_x_up_y_avx2(isi, dest, dw, dh, dow, sow);
+        else
+#endif
         qt_qimageScaleRgba64_down_x_up_y(isi, dest, dw, dh, dow, sow);
-    else
+    } else {
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+        if (qCpuHasFeature(ArchHaswell))
+            qt_qimageScaleRgba64_down_xy_avx2(isi, dest, dw, dh, dow, sow);
+        else
+#endif
         qt_qimageScaleRgba64_down_xy(isi, dest, dw, dh, dow, sow);
+    }
 }
 
 inline static void qt_qimageScaleRgba64_helper(const QRgba64 *pix, int xyap, int Cxy, int step, qint64 &r, qint64 &g, qint64 &b, qint64 &a)
@@ -750,6 +804,11 @@ static void qt_qimageScaleAARGB(QImageScaleInfo *isi, unsigned int *dest,
     }
     /* if we're scaling down vertically */
     else if (isi->xup_yup == 1) {
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+        if (qCpuHasFeature(ArchHaswell))
+            qt_qimageScaleAARGBA_up_x_down_y_avx2<true>(isi, dest, dw, dh, dow, sow);
+        else
+#endif
 #ifdef QT_COMPILER_SUPPORTS_SSE4_1
         if (qCpuHasFeature(SSE4_1))
             qt_qimageScaleAARGBA_up_x_down_y_sse4<true>(isi, dest, dw, dh, dow, sow);
@@ -763,6 +822,11 @@ static void qt_qimageScaleAARGB(QImageScaleInfo *isi, unsigned int *dest,
     }
     /* if we're scaling down horizontally */
     else if (isi->xup_yup == 2) {
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+        if (qCpuHasFeature(ArchHaswell))
+            qt_qimageScaleAARGBA_down_x_up_y_avx2<true>(isi, dest, dw, dh, dow, sow);
+        else
+#endif
 #ifdef QT_COMPILER_SUPPORTS_SSE4_1
         if (qCpuHasFeature(SSE4_1))
             qt_qimageScaleAARGBA_down_x_up_y_sse4<true>(isi, dest, dw, dh, dow, sow);
@@ -776,6 +840,11 @@ static void qt_qimageScaleAARGB(QImageScaleInfo *isi, unsigned int *dest,
     }
     /* if we're scaling down horizontally & vertically */
     else {
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+        if (qCpuHasFeature(ArchHaswell))
+            qt_qimageScaleAARGBA_down_xy_avx2<true>(isi, dest, dw, dh, dow, sow);
+        else
+#endif
 #ifdef QT_COMPILER_SUPPORTS_SSE4_1
         if (qCpuHasFeature(SSE4_1))
             qt_qimageScaleAARGBA_down_xy_sse4<true>(isi, dest, dw, dh, dow, sow);
@@ -947,18 +1016,27 @@ QImage qSmoothScaleImage(const QImage &src, int dw, int dh)
         return QImage();
     }
 
+    // Each destination line is scaled on its own, so the lines can be split
+    // between threads, each with the scale info shifted to its first line.
+    auto scaleSegment = [&](int yStart, int yEnd) {
+        QImageScaleInfo segmentInfo = *scaleinfo;
+        segmentInfo.ypoints += yStart;
+        segmentInfo.yapoints += yStart;
 #if QT_CONFIG(raster_64bit)
-    if (src.depth() > 32)
-        qt_qimageScaleRgba64(scaleinfo, (QRgba64 *)buffer.scanLine(0),
-                             dw, dh, dw, src.bytesPerLine() / 8);
-    else
+        if (src.depth() > 32)
+            qt_qimageScaleRgba64(&segmentInfo, (QRgba64 *)buffer.scanLine(yStart),
+                                 dw, yEnd - yStart, dw, src.bytesPerLine() / 8);
+        else
 #endif
-    if (src.hasAlphaChannel())
-        qt_qimageScaleAARGBA(scaleinfo, (unsigned int *)buffer.scanLine(0),
-                             dw, dh, dw, src.bytesPerLine() / 4);
-    else
-        qt_qimageScaleAARGB(scaleinfo, (unsigned int *)buffer.scanLine(0),
-                            dw, dh, dw, src.bytesPerLine() / 4);
+        if (src.hasAlphaChannel())
+            qt_qimageScaleAARGBA(&segmentInfo, (unsigned int *)buffer.scanLine(yStart),
+                                 dw, yEnd - yStart, dw, src.bytesPerLine() / 4);
+        else
+            qt_qimageScaleAARGB(&segmentInfo, (unsigned int *)buffer.scanLine(yStart),
+                                dw, yEnd - yStart, dw, src.bytesPerLine() / 4);
+    };
+    const qint64 pixelCount = qMax(qint64(w) * h, qint64(dw) * dh);
+    qt_parallelForSegments(dh, qt_imageSegmentCount(pixelCount, dh), scaleSegment);
 
     qimageFreeScaleInfo(scaleinfo);
     return buffer;
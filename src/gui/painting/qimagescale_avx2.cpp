@@ -0,0 +1,460 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qimagescale_p.h"
+#include "qimage.h"
+#include "qrgba64.h"
+#include <private/qdrawhelper_x86_p.h>
+#include <private/qsimd_p.h>
+
+#if defined(QT_COMPILER_SUPPORTS_AVX2)
+
+QT_BEGIN_NAMESPACE
+
+using namespace QImageScale;
+
+// The helpers below handle two source pixels at once: the lower half of the
+// vector accumulates the pixels starting at pix[0], and the upper half the ones
+// starting at pix[pairOffset]. Depending on the path these are two horizontally
+// or two vertically neighbouring pixels, that are either interpolated or summed
+// up afterwards. Where there is only one pixel to sample, the 128-bit helpers
+// are used instead. The results are the same as with the SSE4.1 versions.
+
+inline static __m256i Q_DECL_VECTORCALL
+qt_qimageScaleAARGBA_loadPair_avx2(const unsigned int *pix, int pairOffset)
+{
+    return _mm256_cvtepu8_epi32(_mm_unpacklo_epi32(_mm_cvtsi32_si128(pix[0]),
+                                                   _mm_cvtsi32_si128(pix[pairOffset])));
+}
+
+inline static __m256i Q_DECL_VECTORCALL
+qt_qimageScaleAARGBA_helper_avx2(const unsigned int *pix, int pairOffset, int xyap, int Cxy, int step,
+                                 const __m256i vxyap, const __m256i vCxy)
+{
+    __m256i vpix = qt_qimageScaleAARGBA_loadPair_avx2(pix, pairOffset);
+    __m256i vx = _mm256_mullo_epi32(vpix, vxyap);
+    int i;
+    for (i = (1 << 14) - xyap; i > Cxy; i -= Cxy) {
+        pix += step;
+        vpix = qt_qimageScaleAARGBA_loadPair_avx2(pix, pairOffset);
+        vx = _mm256_add_epi32(vx, _mm256_mullo_epi32(vpix, vCxy));
+    }
+    pix += step;
+    vpix = qt_qimageScaleAARGBA_loadPair_avx2(pix, pairOffset);
+    vx = _mm256_add_epi32(vx, _mm256_mullo_epi32(vpix, _mm256_set1_epi32(i)));
+    return vx;
+}
+
+// Same as above for a single pixel, when there is nothing to interpolate with.
+inline static __m128i Q_DECL_VECTORCALL
+qt_qimageScaleAARGBA_helper_single_avx2(const unsigned int *pix, int xyap, int Cxy, int step,
+                                        const __m128i vxyap, const __m128i vCxy)
+{
+    __m128i vpix = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(*pix));
+    __m128i vx = _mm_mullo_epi32(vpix, vxyap);
+    int i;
+    for (i = (1 << 14) - xyap; i > Cxy; i -= Cxy) {
+        pix += step;
+        vpix = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(*pix));
+        vx = _mm_add_epi32(vx, _mm_mullo_epi32(vpix, vCxy));
+    }
+    pix += step;
+    vpix = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(*pix));
+    vx = _mm_add_epi32(vx, _mm_mullo_epi32(vpix, _mm_set1_epi32(i)));
+    return vx;
+}
+
+// Multiplies the lower half of vx by w0 and the upper half by w1, and returns the sum of both.
+inline static __m128i Q_DECL_VECTORCALL
+qt_qimageScaleAARGBA_weightedSum_avx2(__m256i vx, int w0, int w1)
+{
+    vx = _mm256_mullo_epi32(vx, _mm256_setr_epi32(w0, w0, w0, w0, w1, w1, w1, w1));
+    return _mm_add_epi32(_mm256_castsi256_si128(vx), _mm256_extracti128_si256(vx, 1));
+}
+
+inline static unsigned int Q_DECL_VECTORCALL
+qt_qimageScaleAARGBA_pack_avx2(__m128i vx)
+{
+    vx = _mm_packus_epi32(vx, vx);
+    vx = _mm_packus_epi16(vx, vx);
+    return _mm_cvtsi128_si32(vx);
+}
+
+template<bool RGB>
+void qt_qimageScaleAARGBA_up_x_down_y_avx2(QImageScaleInfo *isi, unsigned int *dest,
+                                           int dw, int dh, int dow, int sow)
+{
+    const unsigned int **ypoints = isi->ypoints;
+    int *xpoints = isi->xpoints;
+    int *xapoints = isi->xapoints;
+    int *yapoints = isi->yapoints;
+
+    /* go through every scanline in the output buffer */
+    for (int y = 0; y < dh; y++) {
+        int Cy = yapoints[y] >> 16;
+        int yap = yapoints[y] & 0xffff;
+        const __m256i vCy = _mm256_set1_epi32(Cy);
+        const __m256i vyap = _mm256_set1_epi32(yap);
+
+        unsigned int *dptr = dest + (y * dow);
+        for (int x = 0; x < dw; x++) {
+            const unsigned int *sptr = ypoints[y] + xpoints[x];
+            const int xap = xapoints[x];
+            __m128i vr;
+            if (xap > 0) {
+                const __m256i vx = qt_qimageScaleAARGBA_helper_avx2(sptr, 1, yap, Cy, sow, vyap, vCy);
+                vr = qt_qimageScaleAARGBA_weightedSum_avx2(vx, 256 - xap, xap);
+                vr = _mm_srli_epi32(vr, 8 + 14);
+            } else {
+                vr = qt_qimageScaleAARGBA_helper_single_avx2(sptr, yap, Cy, sow,
+                                                             _mm256_castsi256_si128(vyap),
+                                                             _mm256_castsi256_si128(vCy));
+                vr = _mm_srli_epi32(vr, 14);
+            }
+            *dptr = qt_qimageScaleAARGBA_pack_avx2(vr);
+            if (RGB)
+                *dptr |= 0xff000000;
+            dptr++;
+        }
+    }
+}
+
+template<bool RGB>
+void qt_qimageScaleAARGBA_down_x_up_y_avx2(QImageScaleInfo *isi, unsigned int *dest,
+                                           int dw, int dh, int dow, int sow)
+{
+    const unsigned int **ypoints = isi->ypoints;
+    int *xpoints = isi->xpoints;
+    int *xapoints = isi->xapoints;
+    int *yapoints = isi->yapoints;
+
+    /* go through every scanline in the output buffer */
+    for (int y = 0; y < dh; y++) {
+        unsigned int *dptr = dest + (y * dow);
+        const int yap = yapoints[y];
+        for (int x = 0; x < dw; x++) {
+            int Cx = xapoints[x] >> 16;
+            int xap = xapoints[x] & 0xffff;
+
+            const unsigned int *sptr = ypoints[y] + xpoints[x];
+            __m128i vr;
+            if (yap > 0) {
+                const __m256i vx = qt_qimageScaleAARGBA_helper_avx2(sptr, sow, xap, Cx, 1,
+                                                                    _mm256_set1_epi32(xap),
+                                                                    _mm256_set1_epi32(Cx));
+                vr = qt_qimageScaleAARGBA_weightedSum_avx2(vx, 256 - yap, yap);
+                vr = _mm_srli_epi32(vr, 8 + 14);
+            } else {
+                vr = qt_qimageScaleAARGBA_helper_single_avx2(sptr, xap, Cx, 1,
+                                                             _mm_set1_epi32(xap), _mm_set1_epi32(Cx));
+                vr = _mm_srli_epi32(vr, 14);
+            }
+            *dptr = qt_qimageScaleAARGBA_pack_avx2(vr);
+            if (RGB)
+                *dptr |= 0xff000000;
+            dptr++;
+        }
+    }
+}
+
+template<bool RGB>
+void qt_qimageScaleAARGBA_down_xy_avx2(QImageScaleInfo *isi, unsigned int *dest,
+                                       int dw, int dh, int dow, int sow)
+{
+    const unsigned int **ypoints = isi->ypoints;
+    int *xpoints = isi->xpoints;
+    int *xapoints = isi->xapoints;
+    int *yapoints = isi->yapoints;
+
+    for (int y = 0; y < dh; y++) {
+        int Cy = yapoints[y] >> 16;
+        int yap = yapoints[y] & 0xffff;
+
+        unsigned int *dptr = dest + (y * dow);
+        for (int x = 0; x < dw; x++) {
+            const int Cx = xapoints[x] >> 16;
+            const int xap = xapoints[x] & 0xffff;
+            const __m256i vCx = _mm256_set1_epi32(Cx);
+            const __m256i vxap = _mm256_set1_epi32(xap);
+
+            // Sum up the lines two by two, weighted by yap for the first line,
+            // by Cy for the lines in between, and by what remains for the last.
+            const unsigned int *sptr = ypoints[y] + xpoints[x];
+            __m128i vr = _mm_setzero_si128();
+            int w0 = yap;
+            int j = (1 << 14) - yap;
+            for (;;) {
+                const bool lastPair = j <= Cy;
+                const int w1 = lastPair ? j : Cy;
+                j -= w1;
+                __m256i vx = qt_qimageScaleAARGBA_helper_avx2(sptr, sow, xap, Cx, 1, vxap, vCx);
+                vx = _mm256_srli_epi32(vx, 4);
+                vr = _mm_add_epi32(vr, qt_qimageScaleAARGBA_weightedSum_avx2(vx, w0, w1));
+                sptr += 2 * sow;
+                if (lastPair)
+                    break;
+                if (j <= Cy) {
+                    // A single line is left.
+                    __m128i vx = qt_qimageScaleAARGBA_helper_single_avx2(sptr, xap, Cx, 1,
+                                                                         _mm256_castsi256_si128(vxap),
+                                                                         _mm256_castsi256_si128(vCx));
+                    vx = _mm_srli_epi32(vx, 4);
+                    vr = _mm_add_epi32(vr, _mm_mullo_epi32(vx, _mm_set1_epi32(j)));
+                    break;
+                }
+                w0 = Cy;
+                j -= Cy;
+            }
+
+            vr = _mm_srli_epi32(vr, 24);
+            *dptr = qt_qimageScaleAARGBA_pack_avx2(vr);
+            if (RGB)
+                *dptr |= 0xff000000;
+            dptr++;
+        }
+    }
+}
+
+template void qt_qimageScaleAARGBA_up_x_down_y_avx2<false>(QImageScaleInfo *isi, unsigned int *dest,
+                                                           int dw, int dh, int dow, int sow);
+
+template void qt_qimageScaleAARGBA_up_x_down_y_avx2<true>(QImageScaleInfo *isi, unsigned int *dest,
+                                                          int dw, int dh, int dow, int sow);
+
+template void qt_qimageScaleAARGBA_down_x_up_y_avx2<false>(QImageScaleInfo *isi, unsigned int *dest,
+                                                           int dw, int dh, int dow, int sow);
+
+template void qt_qimageScaleAARGBA_down_x_up_y_avx2<true>(QImageScaleInfo *isi, unsigned int *dest,
+                                                          int dw, int dh, int dow, int sow);
+
+template void qt_qimageScaleAARGBA_down_xy_avx2<false>(QImageScaleInfo *isi, unsigned int *dest,
+                                                       int dw, int dh, int dow, int sow);
+
+template void qt_qimageScaleAARGBA_down_xy_avx2<true>(QImageScaleInfo *isi, unsigned int *dest,
+                                                      int dw, int dh, int dow, int sow);
+
+#if QT_CONFIG(raster_64bit)
+// The 16-bit channels are summed up in 32 bits as well, but need 64 bits for
+// the final interpolation.
+
+inline static __m256i Q_DECL_VECTORCALL
+qt_qimageScaleRgba64_loadPair_avx2(const QRgba64 *pix, int pairOffset)
+{
+    return _mm256_cvtepu16_epi32(_mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pix)),
+                                                    _mm_loadl_epi64(reinterpret_cast<const __m128i *>(pix + pairOffset))));
+}
+
+inline static __m256i Q_DECL_VECTORCALL
+qt_qimageScaleRgba64_helper_avx2(const QRgba64 *pix, int pairOffset, int xyap, int Cxy, int step,
+                                 const __m256i vxyap, const __m256i vCxy)
+{
+    __m256i vpix = qt_qimageScaleRgba64_loadPair_avx2(pix, pairOffset);
+    __m256i vx = _mm256_mullo_epi32(vpix, vxyap);
+    int i;
+    for (i = (1 << 14) - xyap; i > Cxy; i -= Cxy) {
+        pix += step;
+        vpix = qt_qimageScaleRgba64_loadPair_avx2(pix, pairOffset);
+        vx = _mm256_add_epi32(vx, _mm256_mullo_epi32(vpix, vCxy));
+    }
+    pix += step;
+    vpix = qt_qimageScaleRgba64_loadPair_avx2(pix, pairOffset);
+    vx = _mm256_add_epi32(vx, _mm256_mullo_epi32(vpix, _mm256_set1_epi32(i)));
+    return vx;
+}
+
+inline static __m128i Q_DECL_VECTORCALL
+qt_qimageScaleRgba64_helper_single_avx2(const QRgba64 *pix, int xyap, int Cxy, int step,
+                                        const __m128i vxyap, const __m128i vCxy)
+{
+    __m128i vpix = _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pix)));
+    __m128i vx = _mm_mullo_epi32(vpix, vxyap);
+    int i;
+    for (i = (1 << 14) - xyap; i > Cxy; i -= Cxy) {
+        pix += step;
+        vpix = _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pix)));
+        vx = _mm_add_epi32(vx, _mm_mullo_epi32(vpix, vCxy));
+    }
+    pix += step;
+    vpix = _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pix)));
+    vx = _mm_add_epi32(vx, _mm_mullo_epi32(vpix, _mm_set1_epi32(i)));
+    return vx;
+}
+
+// Multiplies the lower half of vx by w0 and the upper half by w1, and returns the sum of both in 64 bits.
+inline static __m256i Q_DECL_VECTORCALL
+qt_qimageScaleRgba64_weightedSum_avx2(__m256i vx, int w0, int w1)
+{
+    const __m256i v0 = _mm256_mul_epu32(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(vx)),
+                                        _mm256_set1_epi64x(w0));
+    const __m256i v1 = _mm256_mul_epu32(_mm256_cvtepu32_epi64(_mm256_extracti128_si256(vx, 1)),
+                                        _mm256_set1_epi64x(w1));
+    return _mm256_add_epi64(v0, v1);
+}
+
+inline static void Q_DECL_VECTORCALL
+qt_qimageScaleRgba64_store_avx2(QRgba64 *dptr, __m128i vx)
+{
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dptr), _mm_packus_epi32(vx, vx));
+}
+
+inline static void Q_DECL_VECTORCALL
+qt_qimageScaleRgba64_store_avx2(QRgba64 *dptr, __m256i vx)
+{
+    vx = _mm256_permutevar8x32_epi32(vx, _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7));
+    qt_qimageScaleRgba64_store_avx2(dptr, _mm256_castsi256_si128(vx));
+}
+
+void qt_qimageScaleRgba64_up_x_down_y_avx2(QImageScaleInfo *isi, QRgba64 *dest,
+                                           int dw, int dh, int dow, int sow)
+{
+    const QRgba64 **ypoints = (const QRgba64 **)isi->ypoints;
+    int *xpoints = isi->xpoints;
+    int *xapoints = isi->xapoints;
+    int *yapoints = isi->yapoints;
+
+    for (int y = 0; y < dh; y++) {
+        int Cy = (yapoints[y]) >> 16;
+        int yap = (yapoints[y]) & 0xffff;
+        const __m256i vCy = _mm256_set1_epi32(Cy);
+        const __m256i vyap = _mm256_set1_epi32(yap);
+
+        QRgba64 *dptr = dest + (y * dow);
+        for (int x = 0; x < dw; x++) {
+            const QRgba64 *sptr = ypoints[y] + xpoints[x];
+            const int xap = xapoints[x];
+            if (xap > 0) {
+                const __m256i vx = qt_qimageScaleRgba64_helper_avx2(sptr, 1, yap, Cy, sow, vyap, vCy);
+                const __m256i vr = qt_qimageScaleRgba64_weightedSum_avx2(vx, 256 - xap, xap);
+                qt_qimageScaleRgba64_store_avx2(dptr++, _mm256_srli_epi64(vr, 8 + 14));
+            } else {
+                const __m128i vx = qt_qimageScaleRgba64_helper_single_avx2(sptr, yap, Cy, sow,
+                                                                           _mm256_castsi256_si128(vyap),
+                                                                           _mm256_castsi256_si128(vCy));
+                qt_qimageScaleRgba64_store_avx2(dptr++, _mm_srli_epi32(vx, 14));
+            }
+        }
+    }
+}
+
+void qt_qimageScaleRgba64_down_x_up_y_avx2(QImageScaleInfo *isi, QRgba64 *dest,
+                                           int dw, int dh, int dow, int sow)
+{
+    const QRgba64 **ypoints = (const QRgba64 **)isi->ypoints;
+    int *xpoints = isi->xpoints;
+    int *xapoints = isi->xapoints;
+    int *yapoints = isi->yapoints;
+
+    for (int y = 0; y < dh; y++) {
+        QRgba64 *dptr = dest + (y * dow);
+        const int yap = yapoints[y];
+        for (int x = 0; x < dw; x++) {
+            int Cx = xapoints[x] >> 16;
+            int xap = xapoints[x] & 0xffff;
+
+            const QRgba64 *sptr = ypoints[y] + xpoints[x];
+            if (yap > 0) {
+                const __m256i vx = qt_qimageScaleRgba64_helper_avx2(sptr, sow, xap, Cx, 1,
+                                                                    _mm256_set1_epi32(xap),
+                                                                    _mm256_set1_epi32(Cx));
+                const __m256i vr = qt_qimageScaleRgba64_weightedSum_avx2(vx, 256 - yap, yap);
+                qt_qimageScaleRgba64_store_avx2(dptr++, _mm256_srli_epi64(vr, 8 + 14));
+            } else {
+                const __m128i vx = qt_qimageScaleRgba64_helper_single_avx2(sptr, xap, Cx, 1,
+                                                                           _mm_set1_epi32(xap),
+                                                                           _mm_set1_epi32(Cx));
+                qt_qimageScaleRgba64_store_avx2(dptr++, _mm_srli_epi32(vx, 14));
+            }
+        }
+    }
+}
+
+void qt_qimageScaleRgba64_down_xy_avx2(QImageScaleInfo *isi, QRgba64 *dest,
+                                       int dw, int dh, int dow, int sow)
+{
+    const QRgba64 **ypoints = (const QRgba64 **)isi->ypoints;
+    int *xpoints = isi->xpoints;
+    int *xapoints = isi->xapoints;
+    int *yapoints = isi->yapoints;
+
+    for (int y = 0; y < dh; y++) {
+        int Cy = (yapoints[y]) >> 16;
+        int yap = (yapoints[y]) & 0xffff;
+
+        QRgba64 *dptr = dest + (y * dow);
+        for (int x = 0; x < dw; x++) {
+            int Cx = xapoints[x] >> 16;
+            int xap = xapoints[x] & 0xffff;
+            const __m256i vCx = _mm256_set1_epi32(Cx);
+            const __m256i vxap = _mm256_set1_epi32(xap);
+
+            const QRgba64 *sptr = ypoints[y] + xpoints[x];
+            __m256i vr = _mm256_setzero_si256();
+            int w0 = yap;
+            int j = (1 << 14) - yap;
+            for (;;) {
+                const bool lastPair = j <= Cy;
+                const int w1 = lastPair ? j : Cy;
+                j -= w1;
+                const __m256i vx = qt_qimageScaleRgba64_helper_avx2(sptr, sow, xap, Cx, 1, vxap, vCx);
+                vr = _mm256_add_epi64(vr, qt_qimageScaleRgba64_weightedSum_avx2(vx, w0, w1));
+                sptr += 2 * sow;
+                if (lastPair)
+                    break;
+                if (j <= Cy) {
+                    // A single line is left.
+                    const __m128i vx = qt_qimageScaleRgba64_helper_single_avx2(sptr, xap, Cx, 1,
+                                                                               _mm256_castsi256_si128(vxap),
+                                                                               _mm256_castsi256_si128(vCx));
+                    vr = _mm256_add_epi64(vr, _mm256_mul_epu32(_mm256_cvtepu32_epi64(vx),
+                                                               _mm256_set1_epi64x(j)));
+                    break;
+                }
+                w0 = Cy;
+                j -= Cy;
+            }
+
+            qt_qimageScaleRgba64_store_avx2(dptr++, _mm256_srli_epi64(vr, 28));
+        }
+    }
+}
+#endif // QT_CONFIG(raster_64bit)
+
+QT_END_NAMESPACE
+
+#endif
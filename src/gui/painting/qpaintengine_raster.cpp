@@ -4156,15 +4156,32 @@ static void qt_span_fill_clipped(int spanCount, const QSpan *spans, void *userDa
     const int NSPANS = 256;
     QSpan cspans[NSPANS];
     int currentClip = 0;
+    int kept = 0;
     const QSpan *end = spans + spanCount;
     while (spans < end) {
-        QSpan *clipped = cspans;
-        spans = qt_intersect_spans(fillData->clip, &currentClip, spans, end, &clipped, NSPANS);
+        QSpan *clipped = cspans + kept;
+        spans = qt_intersect_spans(fillData->clip, &currentClip, spans, end, &clipped, NSPANS - kept);
 //         qDebug() << "processed " << spanCount - (end - spans) << "clipped" << clipped-cspans
 //                  << "span:" << cspans->x << cspans->y << cspans->len << spans->coverage;
 
-        if (clipped - cspans)
-            fillData->unclipped_blend(clipped - cspans, cspans, fillData);
+        int count = clipped - cspans;
+        kept = 0;
+        if (count == NSPANS && spans < end) {
+            // keep the spans of the last line together, as the blend functions
+            // fetch adjacent spans at once, or where they are split depends on
+            // which lines the incoming spans start at
+            int n = count;
+            while (n > 0 && cspans[n - 1].y == cspans[count - 1].y)
+                --n;
+            if (n > 0) {
+                kept = count - n;
+                count = n;
+            }
+        }
+        if (count)
+            fillData->unclipped_blend(count, cspans, fillData);
+        if (kept)
+            memmove(cspans, cspans + count, kept * sizeof(QSpan));
     }
 }
 
@@ -45,6 +45,7 @@
 #include <private/qmath_p.h>
 #include <private/qdatabuffer_p.h>
 #include <private/qdrawhelper_p.h>
+#include <private/qoutlinemapper_p.h>
 
 #include <algorithm>
 
@@ -96,13 +97,14 @@ public:
         Q_ASSERT(x >= m_clipRect.left());
         Q_ASSERT(x + int(len) - 1 <= m_clipRect.right());
 
+        if (m_spanCount == SPAN_BUFFER_SIZE)
+            flushLinesBefore(y);
+
         m_spans[m_spanCount].x = x;
         m_spans[m_spanCount].len = len;
         m_spans[m_spanCount].y = y;
         m_spans[m_spanCount].coverage = coverage;
-
-        if (++m_spanCount == SPAN_BUFFER_SIZE)
-            flushSpans();
+        ++m_spanCount;
     }
 
 private:
@@ -112,6 +114,22 @@ private:
         m_spanCount = 0;
     }
 
+    // The blend functions fetch adjacent spans at once, so keep the spans of
+    // line y together, or where they are split would depend on the clip.
+    void flushLinesBefore(int y)
+    {
+        int count = m_spanCount;
+        while (count > 0 && m_spans[count - 1].y == y)
+            --count;
+        if (count == 0) {
+            flushSpans();
+            return;
+        }
+        m_blend(count, m_spans, m_data);
+        m_spanCount -= count;
+        memmove(m_spans, m_spans + count, m_spanCount * sizeof(QT_FT_Span));
+    }
+
     QT_FT_Span m_spans[SPAN_BUFFER_SIZE];
     int m_spanCount;
 
@@ -767,8 +785,15 @@ void QRasterizer::rasterizeLine(const QPointF &a, const QPointF &b, qreal width,
         pb += (0.5f * width) * delta;
     }
 
+    // The line geometry is only clipped to the coordinate range, the clip is
+    // applied when emitting spans. That way a pixel is rasterized the same no
+    // matter what else the clip covers.
+    const QPoint minP(qMin(d->clipRect.left(), 0), qMin(d->clipRect.top(), 0));
+    const QPoint maxP(qMax(d->clipRect.right() + 1, QT_RASTER_COORD_LIMIT),
+                      qMax(d->clipRect.bottom() + 1, QT_RASTER_COORD_LIMIT));
+
     QPointF offs = QPointF(qAbs(b.y() - a.y()), qAbs(b.x() - a.x())) * width * 0.5;
-    const QRectF clip(d->clipRect.topLeft() - offs, d->clipRect.bottomRight() + QPoint(1, 1) + offs);
+    const QRectF clip(minP - offs, maxP + offs);
 
     if (!clip.contains(pa) || !clip.contains(pb)) {
         qreal t1 = 0;
@@ -955,7 +980,10 @@ void QRasterizer::rasterizeLine(const QPointF &a, const QPointF &b, qreal width,
         left = snapTo26Dot6Grid(left);
         right = snapTo26Dot6Grid(right);
 
-        const qreal topBound = qBound(qreal(d->clipRect.top()), top.y(), qreal(d->clipRect.bottom()));
+        if (bottom.y() <= d->clipRect.top() || top.y() >= d->clipRect.bottom() + 1)
+            return;
+
+        const qreal topBound = qBound(qreal(minP.y()), top.y(), qreal(d->clipRect.bottom()));
         const qreal bottomBound = qBound(qreal(d->clipRect.top()), bottom.y(), qreal(d->clipRect.bottom()));
 
         const QPointF topLeftEdge = left - top;
@@ -986,6 +1014,7 @@ void QRasterizer::rasterizeLine(const QPointF &a, const QPointF &b, qreal width,
             const Q16Dot16 iLeftFP = IntToQ16Dot16(int(left.y()));
             const Q16Dot16 iRightFP = IntToQ16Dot16(int(right.y()));
             const Q16Dot16 iBottomFP = IntToQ16Dot16(int(bottomBound));
+            const Q16Dot16 iClipTopFP = IntToQ16Dot16(d->clipRect.top());
 
             Q16Dot16 leftIntersectAf = qSafeFloatToQ16Dot16(top.x() + (int(topBound) - top.y()) * topLeftSlope);
             Q16Dot16 rightIntersectAf = qSafeFloatToQ16Dot16(top.x() + (int(topBound) - top.y()) * topRightSlope);
@@ -1051,55 +1080,78 @@ void QRasterizer::rasterizeLine(const QPointF &a, const QPointF &b, qreal width,
                     bottomRightIntersectBf = rightIntersectBf + bottomRightSlopeFP;
                 }
 
-                if (yFP < iLeftFP) {
-                    leftMin = Q16Dot16ToInt(bottomLeftIntersectAf);
-                    leftMax = Q16Dot16ToInt(topLeftIntersectAf);
-                } else if (yFP == iLeftFP) {
-                    leftMin = Q16Dot16ToInt(qMax(bottomLeftIntersectAf, topLeftIntersectBf));
-                    leftMax = Q16Dot16ToInt(qMax(topLeftIntersectAf, bottomLeftIntersectBf));
-                } else {
-                    leftMin = Q16Dot16ToInt(topLeftIntersectBf);
-                    leftMax = Q16Dot16ToInt(bottomLeftIntersectBf);
-                }
-
-                leftMin = qBound(d->clipRect.left(), leftMin, d->clipRect.right());
-                leftMax = qBound(d->clipRect.left(), leftMax, d->clipRect.right());
-
-                if (yFP < iRightFP) {
-                    rightMin = Q16Dot16ToInt(topRightIntersectAf);
-                    rightMax = Q16Dot16ToInt(bottomRightIntersectAf);
-                } else if (yFP == iRightFP) {
-                    rightMin = Q16Dot16ToInt(qMin(topRightIntersectAf, bottomRightIntersectBf));
-                    rightMax = Q16Dot16ToInt(qMin(bottomRightIntersectAf, topRightIntersectBf));
-                } else {
-                    rightMin = Q16Dot16ToInt(bottomRightIntersectBf);
-                    rightMax = Q16Dot16ToInt(topRightIntersectBf);
-                }
-
-                rightMin = qBound(d->clipRect.left(), rightMin, d->clipRect.right());
-                rightMax = qBound(d->clipRect.left(), rightMax, d->clipRect.right());
-
-                if (leftMax > rightMax)
-                    leftMax = rightMax;
-                if (rightMin < leftMin)
-                    rightMin = leftMin;
-
-                Q16Dot16 rowHeight = rowBottom - rowTop;
-
-                int x = leftMin;
-                while (x <= leftMax) {
-                    Q16Dot16 excluded = 0;
+                if (yFP >= iClipTopFP) {
+                    if (yFP < iLeftFP) {
+                        leftMin = Q16Dot16ToInt(bottomLeftIntersectAf);
+                        leftMax = Q16Dot16ToInt(topLeftIntersectAf);
+                    } else if (yFP == iLeftFP) {
+                        leftMin = Q16Dot16ToInt(qMax(bottomLeftIntersectAf, topLeftIntersectBf));
+                        leftMax = Q16Dot16ToInt(qMax(topLeftIntersectAf, bottomLeftIntersectBf));
+                    } else {
+                        leftMin = Q16Dot16ToInt(topLeftIntersectBf);
+                        leftMax = Q16Dot16ToInt(bottomLeftIntersectBf);
+                    }
 
-                    if (yFP <= iLeftFP)
-                        excluded += intersectPixelFP(x, rowTop, rowBottomLeft,
-                                                     bottomLeftIntersectAf, topLeftIntersectAf,
-                                                     topLeftSlopeFP, invTopLeftSlopeFP);
-                    if (yFP >= iLeftFP)
-                        excluded += intersectPixelFP(x, rowTopLeft, rowBottom,
-                                                     topLeftIntersectBf, bottomLeftIntersectBf,
-                                                     bottomLeftSlopeFP, invBottomLeftSlopeFP);
+                    leftMin = qBound(d->clipRect.left(), leftMin, d->clipRect.right());
+                    leftMax = qBound(d->clipRect.left(), leftMax, d->clipRect.right());
+
+                    if (yFP < iRightFP) {
+                        rightMin = Q16Dot16ToInt(topRightIntersectAf);
+                        rightMax = Q16Dot16ToInt(bottomRightIntersectAf);
+                    } else if (yFP == iRightFP) {
+                        rightMin = Q16Dot16ToInt(qMin(topRightIntersectAf, bottomRightIntersectBf));
+                        rightMax = Q16Dot16ToInt(qMin(bottomRightIntersectAf, topRightIntersectBf));
+                    } else {
+                        rightMin = Q16Dot16ToInt(bottomRightIntersectBf);
+                        rightMax = Q16Dot16ToInt(topRightIntersectBf);
+                    }
 
-                    if (x >= rightMin) {
+                    rightMin = qBound(d->clipRect.left(), rightMin, d->clipRect.right());
+                    rightMax = qBound(d->clipRect.left(), rightMax, d->clipRect.right());
+
+                    if (leftMax > rightMax)
+                        leftMax = rightMax;
+                    if (rightMin < leftMin)
+                        rightMin = leftMin;
+
+                    Q16Dot16 rowHeight = rowBottom - rowTop;
+
+                    int x = leftMin;
+                    while (x <= leftMax) {
+                        Q16Dot16 excluded = 0;
+
+                        if (yFP <= iLeftFP)
+                            excluded += intersectPixelFP(x, rowTop, rowBottomLeft,
+                                                         bottomLeftIntersectAf, topLeftIntersectAf,
+                                                         topLeftSlopeFP, invTopLeftSlopeFP);
+                        if (yFP >= iLeftFP)
+                            excluded += intersectPixelFP(x, rowTopLeft, rowBottom,
+                                                         topLeftIntersectBf, bottomLeftIntersectBf,
+                                                         bottomLeftSlopeFP, invBottomLeftSlopeFP);
+
+                        if (x >= rightMin) {
+                            if (yFP <= iRightFP)
+                                excluded += (rowBottomRight - rowTop) - intersectPixelFP(x, rowTop, rowBottomRight,
+                                                                                         topRightIntersectAf, bottomRightIntersectAf,
+                                                                                         topRightSlopeFP, invTopRightSlopeFP);
+                            if (yFP >= iRightFP)
+                                excluded += (rowBottom - rowTopRight) - intersectPixelFP(x, rowTopRight, rowBottom,
+                                                                                         bottomRightIntersectBf, topRightIntersectBf,
+                                                                                         bottomRightSlopeFP, invBottomRightSlopeFP);
+                        }
+
+                        Q16Dot16 coverage = rowHeight - excluded;
+                        buffer.addSpan(x, 1, Q16Dot16ToInt(yFP),
+                                       Q16Dot16ToInt(255 * coverage));
+                        ++x;
+                    }
+                    if (x < rightMin) {
+                        buffer.addSpan(x, rightMin - x, Q16Dot16ToInt(yFP),
+                                       Q16Dot16ToInt(255 * rowHeight));
+                        x = rightMin;
+                    }
+                    while (x <= rightMax) {
+                        Q16Dot16 excluded = 0;
                         if (yFP <= iRightFP)
                             excluded += (rowBottomRight - rowTop) - intersectPixelFP(x, rowTop, rowBottomRight,
                                                                                      topRightIntersectAf, bottomRightIntersectAf,
@@ -1108,33 +1160,12 @@ void QRasterizer::rasterizeLine(const QPointF &a, const QPointF &b, qreal width,
                             excluded += (rowBottom - rowTopRight) - intersectPixelFP(x, rowTopRight, rowBottom,
                                                                                      bottomRightIntersectBf, topRightIntersectBf,
                                                                                      bottomRightSlopeFP, invBottomRightSlopeFP);
-                    }
 
-                    Q16Dot16 coverage = rowHeight - excluded;
-                    buffer.addSpan(x, 1, Q16Dot16ToInt(yFP),
-                                   Q16Dot16ToInt(255 * coverage));
-                    ++x;
-                }
-                if (x < rightMin) {
-                    buffer.addSpan(x, rightMin - x, Q16Dot16ToInt(yFP),
-                                   Q16Dot16ToInt(255 * rowHeight));
-                    x = rightMin;
-                }
-                while (x <= rightMax) {
-                    Q16Dot16 excluded = 0;
-                    if (yFP <= iRightFP)
-                        excluded += (rowBottomRight - rowTop) - intersectPixelFP(x, rowTop, rowBottomRight,
-                                                                                 topRightIntersectAf, bottomRightIntersectAf,
-                                                                                 topRightSlopeFP, invTopRightSlopeFP);
-                    if (yFP >= iRightFP)
-                        excluded += (rowBottom - rowTopRight) - intersectPixelFP(x, rowTopRight, rowBottom,
-                                                                                 bottomRightIntersectBf, topRightIntersectBf,
-                                                                                 bottomRightSlopeFP, invBottomRightSlopeFP);
-
-                    Q16Dot16 coverage = rowHeight - excluded;
-                    buffer.addSpan(x, 1, Q16Dot16ToInt(yFP),
-                                   Q16Dot16ToInt(255 * coverage));
-                    ++x;
+                        Q16Dot16 coverage = rowHeight - excluded;
+                        buffer.addSpan(x, 1, Q16Dot16ToInt(yFP),
+                                       Q16Dot16ToInt(255 * coverage));
+                        ++x;
+                    }
                 }
 
                 leftIntersectAf += topLeftSlopeFP;
@@ -244,8 +244,11 @@ Q_AUTOTEST_EXPORT QList<QFontEngine *> QFontEngine_stopCollectingEngines()
 
 #define kBearingNotInitialized std::numeric_limits<qreal>::max()
 
+static QBasicAtomicInteger<quint64> fontEngineSerialNumber = Q_BASIC_ATOMIC_INITIALIZER(0);
+
 QFontEngine::QFontEngine(Type type)
     : m_type(type), ref(0),
+      serialNumber(fontEngineSerialNumber.fetchAndAddRelaxed(1) + 1),
       font_(),
       face_(),
       m_minLeftBearing(kBearingNotInitialized),
@@ -294,6 +294,7 @@ private:
 
 public:
     QAtomicInt ref;
+    const quint64 serialNumber; // unlike the address, never reused by another engine
     QFontDef fontDef;
 
     class Holder { // replace by std::unique_ptr once available
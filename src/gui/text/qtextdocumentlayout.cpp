@@ -45,6 +45,7 @@
 #include "qtextengine_p.h"
 #include "private/qcssutil_p.h"
 #include "private/qguiapplication_p.h"
+#include "private/qparallel_p.h"
 
 #include "qabstracttextdocumentlayout_p.h"
 #include "qcssparser_p.h"
@@ -57,6 +58,9 @@
 #include <qvarlengtharray.h>
 #include <limits.h>
 #include <qbasictimer.h>
+#if QT_CONFIG(thread)
+#include <qthreadpool.h>
+#endif
 #include "private/qfunctions_p.h"
 #include <qloggingcategory.h>
 
@@ -519,6 +523,8 @@ public:
 
     int fixedColumnWidth;
     int cursorWidth;
+    bool parallelLayout;
+    bool onDemandLayout;
 
     QSizeF lastReportedSize;
     QRectF viewportRect;
@@ -577,14 +583,21 @@ public:
     QRectF layoutFrame(QTextFrame *f, int layoutFrom, int layoutTo, QFixed parentY = 0);
     QRectF layoutFrame(QTextFrame *f, int layoutFrom, int layoutTo, QFixed frameWidth, QFixed frameHeight, QFixed parentY = 0);
 
+    QTextOption blockTextOption(const QTextBlockFormat &blockFormat, Qt::LayoutDirection dir) const;
+    void blockMargins(const QTextBlock &bl, const QTextBlockFormat &blockFormat, Qt::LayoutDirection dir,
+                      QFixed *left, QFixed *right) const;
     void layoutBlock(const QTextBlock &bl, int blockPosition, const QTextBlockFormat &blockFormat,
                      QTextLayoutStruct *layoutStruct, int layoutFrom, int layoutTo, const QTextBlockFormat *previousBlockFormat);
+    void breakLinesInParallel(QTextFrame::Iterator it, const QTextLayoutStruct *layoutStruct, int layoutFrom, int layoutTo);
     void layoutFlow(QTextFrame::Iterator it, QTextLayoutStruct *layoutStruct, int layoutFrom, int layoutTo, QFixed width = 0);
 
     void floatMargins(const QFixed &y, const QTextLayoutStruct *layoutStruct, QFixed *left, QFixed *right) const;
     QFixed findY(QFixed yFrom, const QTextLayoutStruct *layoutStruct, QFixed requiredWidth) const;
 
     QVector<QCheckPoint> checkPoints;
+    // blocks whose lines breakLinesInParallel() has broken, but not positioned yet,
+    // with the width they were broken for
+    QHash<const QTextLayout *, QFixed> preparedLayouts;
 
     QTextFrame::Iterator frameIteratorForYPosition(QFixed y) const;
     QTextFrame::Iterator frameIteratorForTextPosition(int position) const;
@@ -604,6 +617,8 @@ public:
 QTextDocumentLayoutPrivate::QTextDocumentLayoutPrivate()
     : fixedColumnWidth(-1),
       cursorWidth(1),
+      parallelLayout(qEnvironmentVariableIntValue("QT_PARALLEL_TEXT_LAYOUT") != 0),
+      onDemandLayout(qEnvironmentVariableIntValue("QT_ON_DEMAND_TEXT_LAYOUT") != 0),
       currentLazyLayoutPosition(-1),
       lazyLayoutStepSize(1000),
       lastPageCount(-1)
@@ -3133,6 +3148,9 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
         }
     }
 
+    if (inRootFrame && parallelLayout)
+        breakLinesInParallel(it, layoutStruct, layoutFrom, layoutTo);
+
     QTextBlockFormat previousBlockFormat = previousIt.currentBlock().blockFormat();
 
     QFixed maximumBlockWidth = 0;
@@ -3389,6 +3407,7 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
         if (it.atEnd()) {
             //qDebug("layout done!");
             currentLazyLayoutPosition = -1;
+            preparedLayouts.clear();
             QCheckPoint cp;
             cp.y = layoutStruct->y;
             cp.positionInFrame = docPrivate->length();
@@ -3428,6 +3447,37 @@ static inline void getLineHeightParams(const QTextBlockFormat &blockFormat, cons
     }
 }
 
+QTextOption QTextDocumentLayoutPrivate::blockTextOption(const QTextBlockFormat &blockFormat, Qt::LayoutDirection dir) const
+{
+    QTextOption option = docPrivate->defaultTextOption;
+    option.setTextDirection(dir);
+    option.setTabs( blockFormat.tabPositions() );
+
+    Qt::Alignment align = docPrivate->defaultTextOption.alignment();
+    if (blockFormat.hasProperty(QTextFormat::BlockAlignment))
+        align = blockFormat.alignment();
+    option.setAlignment(QGuiApplicationPrivate::visualAlignment(dir, align)); // for paragraph that are RTL, alignment is auto-reversed;
+
+    if (blockFormat.nonBreakableLines() || document->pageSize().width() < 0) {
+        option.setWrapMode(QTextOption::ManualWrap);
+    }
+    return option;
+}
+
+void QTextDocumentLayoutPrivate::blockMargins(const QTextBlock &bl, const QTextBlockFormat &blockFormat, Qt::LayoutDirection dir,
+                                              QFixed *left, QFixed *right) const
+{
+    QFixed extraMargin;
+    if (docPrivate->defaultTextOption.flags() & QTextOption::AddSpaceForLineAndParagraphSeparators) {
+        QFontMetricsF fm(bl.charFormat().font());
+        extraMargin = QFixed::fromReal(fm.horizontalAdvance(QChar(QChar(0x21B5))));
+    }
+
+    const QFixed indent = this->blockIndent(blockFormat);
+    *left = QFixed::fromReal(blockFormat.leftMargin()) + (dir == Qt::RightToLeft ? extraMargin : indent);
+    *right = QFixed::fromReal(blockFormat.rightMargin()) + (dir == Qt::RightToLeft ? indent : extraMargin);
+}
+
 void QTextDocumentLayoutPrivate::layoutBlock(const QTextBlock &bl, int blockPosition, const QTextBlockFormat &blockFormat,
                                              QTextLayoutStruct *layoutStruct, int layoutFrom, int layoutTo, const QTextBlockFormat *previousBlockFormat)
 {
@@ -3453,15 +3503,8 @@ void QTextDocumentLayoutPrivate::layoutBlock(const QTextBlock &bl, int blockPosi
 
     Qt::LayoutDirection dir = bl.textDirection();
 
-    QFixed extraMargin;
-    if (docPrivate->defaultTextOption.flags() & QTextOption::AddSpaceForLineAndParagraphSeparators) {
-        QFontMetricsF fm(bl.charFormat().font());
-        extraMargin = QFixed::fromReal(fm.horizontalAdvance(QChar(QChar(0x21B5))));
-    }
-
-    const QFixed indent = this->blockIndent(blockFormat);
-    const QFixed totalLeftMargin = QFixed::fromReal(blockFormat.leftMargin()) + (dir == Qt::RightToLeft ? extraMargin : indent);
-    const QFixed totalRightMargin = QFixed::fromReal(blockFormat.rightMargin()) + (dir == Qt::RightToLeft ? indent : extraMargin);
+    QFixed totalLeftMargin, totalRightMargin;
+    blockMargins(bl, blockFormat, dir, &totalLeftMargin, &totalRightMargin);
 
     const QPointF oldPosition = tl->position();
     tl->setPosition(QPointF(layoutStruct->x_left.toReal(), layoutStruct->y.toReal()));
@@ -3472,19 +3515,7 @@ void QTextDocumentLayoutPrivate::layoutBlock(const QTextBlock &bl, int blockPosi
         || (layoutStruct->pageHeight != QFIXED_MAX && layoutStruct->absoluteY() + QFixed::fromReal(tl->boundingRect().height()) > layoutStruct->pageBottom)) {
 
         qCDebug(lcLayout) << "do layout";
-        QTextOption option = docPrivate->defaultTextOption;
-        option.setTextDirection(dir);
-        option.setTabs( blockFormat.tabPositions() );
-
-        Qt::Alignment align = docPrivate->defaultTextOption.alignment();
-        if (blockFormat.hasProperty(QTextFormat::BlockAlignment))
-            align = blockFormat.alignment();
-        option.setAlignment(QGuiApplicationPrivate::visualAlignment(dir, align)); // for paragraph that are RTL, alignment is auto-reversed;
-
-        if (blockFormat.nonBreakableLines() || document->pageSize().width() < 0) {
-            option.setWrapMode(QTextOption::ManualWrap);
-        }
-
+        QTextOption option = blockTextOption(blockFormat, dir);
         tl->setTextOption(option);
 
         const bool haveWordOrAnyWrapMode = (option.wrapMode() == QTextOption::WrapAtWordBoundaryOrAnywhere);
@@ -3495,13 +3526,24 @@ void QTextDocumentLayoutPrivate::layoutBlock(const QTextBlock &bl, int blockPosi
         const QFixed r = layoutStruct->x_right - totalRightMargin;
         QFixed bottom;
 
-        tl->beginLayout();
+        // Blocks prepared by breakLinesInParallel() only need to be positioned,
+        // unless they were broken for a different width or floats appeared since
+        bool prepared = false;
+        const auto preparedIt = preparedLayouts.find(tl);
+        if (preparedIt != preparedLayouts.end()) {
+            prepared = *preparedIt == qMin(layoutStruct->x_right, r) - qMax(layoutStruct->x_left, l)
+                    && data(layoutStruct->frame)->floats.isEmpty();
+            preparedLayouts.erase(preparedIt);
+        }
+        if (!prepared)
+            tl->beginLayout();
         bool firstLine = true;
-        while (1) {
-            QTextLine line = tl->createLine();
+        for (int lineNumber = 0; ; ++lineNumber) {
+            QTextLine line = prepared ? tl->lineAt(lineNumber) : tl->createLine();
             if (!line.isValid())
                 break;
-            line.setLeadingIncluded(true);
+            if (!prepared)
+                line.setLeadingIncluded(true);
 
             QFixed left, right;
             floatMargins(layoutStruct->y, layoutStruct, &left, &right);
@@ -3518,10 +3560,12 @@ void QTextDocumentLayoutPrivate::layoutBlock(const QTextBlock &bl, int blockPosi
             }
 //         qDebug() << "layout line y=" << currentYPos << "left=" << left << "right=" <<right;
 
-            if (fixedColumnWidth != -1)
-                line.setNumColumns(fixedColumnWidth, (right - left).toReal());
-            else
-                line.setLineWidth((right - left).toReal());
+            if (!prepared) {
+                if (fixedColumnWidth != -1)
+                    line.setNumColumns(fixedColumnWidth, (right - left).toReal());
+                else
+                    line.setLineWidth((right - left).toReal());
+            }
 
 //        qDebug() << "layoutBlock; layouting line with width" << right - left << "->textWidth" << line.textWidth();
             floatMargins(layoutStruct->y, layoutStruct, &left, &right);
@@ -3532,7 +3576,7 @@ void QTextDocumentLayoutPrivate::layoutBlock(const QTextBlock &bl, int blockPosi
             else
                 right -= text_indent;
 
-            if (fixedColumnWidth == -1 && QFixed::fromReal(line.naturalTextWidth()) > right-left) {
+            if (!prepared && fixedColumnWidth == -1 && QFixed::fromReal(line.naturalTextWidth()) > right-left) {
                 // float has been added in the meantime, redo
                 layoutStruct->pendingFloats.clear();
 
@@ -3595,7 +3639,8 @@ void QTextDocumentLayoutPrivate::layoutBlock(const QTextBlock &bl, int blockPosi
             layoutStruct->pendingFloats.clear();
         }
         layoutStruct->y = qMax(layoutStruct->y, bottom);
-        tl->endLayout();
+        if (!prepared)
+            tl->endLayout();
     } else {
         const int cnt = tl->lineCount();
         QFixed bottom;
@@ -3653,6 +3698,160 @@ void QTextDocumentLayoutPrivate::layoutBlock(const QTextBlock &bl, int blockPosi
     }
 }
 
+// Breaks the lines of a block the way layoutBlock() does when there are no floats
+// beside it, in which case they do not depend on where the block ends up.
+// This runs on a worker thread, so it shapes with copies of the fonts, and
+// leaves neither their engines nor glyphs from them behind in the layout.
+static void breakBlockLines(QTextLayout *tl, QTextOption option, QFixed left, QFixed right,
+                            QFixed textIndent, int fixedColumnWidth)
+{
+    const bool haveWordOrAnyWrapMode = (option.wrapMode() == QTextOption::WrapAtWordBoundaryOrAnywhere);
+
+    QTextEngine *engine = tl->engine();
+    engine->threadLocalFonts = true;
+    tl->beginLayout();
+    for (bool firstLine = true; ; firstLine = false) {
+        QTextLine line = tl->createLine();
+        if (!line.isValid())
+            break;
+        line.setLeadingIncluded(true);
+
+        QFixed width = right - left;
+        if (firstLine)
+            width -= textIndent;
+
+        if (fixedColumnWidth != -1) {
+            line.setNumColumns(fixedColumnWidth, width.toReal());
+            continue;
+        }
+
+        line.setLineWidth(width.toReal());
+        if (QFixed::fromReal(line.naturalTextWidth()) > width) {
+            // lines min width more than what we have
+            if (haveWordOrAnyWrapMode) {
+                option.setWrapMode(QTextOption::WrapAnywhere);
+                tl->setTextOption(option);
+            }
+            line.setLineWidth(qMax<qreal>(line.naturalTextWidth(), width.toReal()));
+            if (haveWordOrAnyWrapMode) {
+                option.setWrapMode(QTextOption::WordWrap);
+                tl->setTextOption(option);
+            }
+        }
+    }
+    tl->endLayout();
+    engine->freeMemory();
+    engine->resetFontEngineCache();
+    engine->threadLocalFonts = false;
+}
+
+/*
+    Breaks the lines of the blocks that the flow starting at \a it will lay
+    out on worker threads, leaving layoutBlock() only to position them.
+    This is only done if the lines of a block cannot depend on its position,
+    that is if there are no floats in the frame, and for blocks that cannot
+    call back into the document layout, that is without inline objects.
+*/
+void QTextDocumentLayoutPrivate::breakLinesInParallel(QTextFrame::Iterator it, const QTextLayoutStruct *layoutStruct,
+                                                      int layoutFrom, int layoutTo)
+{
+    Q_Q(QTextDocumentLayout);
+#if QT_CONFIG(thread)
+    const QThreadPool *threadPool = QThreadPool::globalInstance();
+    const int threadCount = threadPool ? threadPool->maxThreadCount() : 1;
+#else
+    const int threadCount = 1;
+#endif
+    // Fonts are resolved against the paint device, which may only be used on its own thread
+    if (threadCount < 2 || q->paintDevice())
+        return;
+
+    const QList<QTextFrame *> childFrames = layoutStruct->frame->childFrames();
+    for (QTextFrame *frame : childFrames) {
+        if (frame->frameFormat().position() != QTextFrameFormat::InFlow)
+            return;
+    }
+
+    // The lazy layout stops at the first check point after this position, but break
+    // enough blocks ahead to keep the threads busy; the next steps will use them.
+    // Nothing is done while enough blocks from an earlier step are left.
+    const int lastPosition = currentLazyLayoutPosition == -1
+            ? INT_MAX : currentLazyLayoutPosition + lazyLayoutStepSize;
+    const size_t minimumBlockCount = 64 * threadCount;
+    size_t preparedBlockCount = 0;
+
+    struct PreparedBlock {
+        QTextLayout *layout;
+        QTextOption option;
+        QFixed left;
+        QFixed right;
+        QFixed textIndent;
+    };
+    std::vector<PreparedBlock> blocks;
+    for (; !it.atEnd(); ++it) {
+        if (it.currentFrame())
+            continue;
+        const QTextBlock block = it.currentBlock();
+        const int blockPosition = block.position();
+        if (blockPosition > lastPosition && blocks.size() >= 2 * minimumBlockCount)
+            break;
+        if (preparedLayouts.contains(block.layout())) {
+            if (blocks.empty() && ++preparedBlockCount >= minimumBlockCount)
+                return;
+            continue;
+        }
+        if (!block.isVisible()
+            || !(layoutStruct->fullLayout || (blockPosition + block.length() > layoutFrom && blockPosition <= layoutTo))
+            || block.text().contains(QChar::ObjectReplacementCharacter)) {
+            continue;
+        }
+
+        const QTextBlockFormat blockFormat = block.blockFormat();
+        const Qt::LayoutDirection dir = block.textDirection();
+        PreparedBlock prepared;
+        prepared.layout = block.layout();
+        prepared.option = blockTextOption(blockFormat, dir);
+        QFixed leftMargin, rightMargin;
+        blockMargins(block, blockFormat, dir, &leftMargin, &rightMargin);
+        prepared.left = qMax(layoutStruct->x_left, layoutStruct->x_left + leftMargin);
+        prepared.right = qMin(layoutStruct->x_right, layoutStruct->x_right - rightMargin);
+        prepared.textIndent = QFixed::fromReal(blockFormat.textIndent());
+        prepared.layout->setTextOption(prepared.option);
+        // the font engines cached so far belong to this thread
+        prepared.layout->engine()->resetFontEngineCache();
+        blocks.push_back(prepared);
+    }
+
+    // Not less than 16 blocks per segment, or the threads cost more than they save.
+    // More segments than threads even out paragraphs of different lengths.
+    const int segmentCount = qMin(int(blocks.size()) / 16, 4 * threadCount);
+    if (segmentCount < 2)
+        return;
+
+    // QTextFormat::font() caches the font it builds, so build them all on this thread
+    // rather than on several at once; the workers then shape with copies of them.
+    // Small caps fonts are cached when first used, so leave documents that use them
+    // to the serial layout.
+    const QTextFormatCollection *collection = docPrivate->formatCollection();
+    for (const QTextFormat &format : collection->formats) {
+        if (format.isCharFormat() && format.toCharFormat().font().capitalization() == QFont::SmallCaps)
+            return;
+    }
+
+    qCDebug(lcLayout) << "breaking lines of" << blocks.size() << "blocks in" << segmentCount << "segments";
+    const int columns = fixedColumnWidth;
+    qt_parallelForSegments(int(blocks.size()), segmentCount, [&blocks, columns](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            const PreparedBlock &prepared = blocks[i];
+            breakBlockLines(prepared.layout, prepared.option, prepared.left, prepared.right,
+                            prepared.textIndent, columns);
+        }
+    });
+
+    for (const PreparedBlock &prepared : blocks)
+        preparedLayouts.insert(prepared.layout, prepared.right - prepared.left);
+}
+
 void QTextDocumentLayoutPrivate::floatMargins(const QFixed &y, const QTextLayoutStruct *layoutStruct,
                                               QFixed *left, QFixed *right) const
 {
@@ -3773,6 +3972,8 @@ void QTextDocumentLayout::documentChanged(int from, int oldLength, int length)
 {
     Q_D(QTextDocumentLayout);
 
+    d->preparedLayouts.clear();
+
     QTextBlock blockIt = document()->findBlock(from);
     QTextBlock endIt = document()->findBlock(qMax(0, from + length - 1));
     if (endIt.isValid())
@@ -3814,7 +4015,8 @@ void QTextDocumentLayout::documentChanged(int from, int oldLength, int length)
         updateRect = doLayout(from, oldLength, length);
     }
 
-    if (!d->layoutTimer.isActive() && d->currentLazyLayoutPosition != -1)
+    // with the on-demand layout, the rest is only laid out when it is asked for
+    if (!d->layoutTimer.isActive() && d->currentLazyLayoutPosition != -1 && !d->onDemandLayout)
         d->layoutTimer.start(10, this);
 
     d->insideDocumentChange = false;
@@ -3976,6 +4178,18 @@ QSizeF QTextDocumentLayout::dynamicDocumentSize() const
     return data(d->docPrivate->rootFrame())->size.toSizeF();
 }
 
+QSizeF QTextDocumentLayout::estimatedDocumentSize() const
+{
+    Q_D(const QTextDocumentLayout);
+    QSizeF size = dynamicDocumentSize();
+    const int position = d->currentLazyLayoutPosition;
+    if (position > 0) {
+        // assume that what is not laid out yet is as tall per character as what is
+        size.setHeight(size.height() * d->docPrivate->length() / position);
+    }
+    return size;
+}
+
 int QTextDocumentLayout::pageCount() const
 {
     Q_D(const QTextDocumentLayout);
@@ -4040,6 +4254,35 @@ void QTextDocumentLayout::setFixedColumnWidth(int width)
 {
     Q_D(QTextDocumentLayout);
     d->fixedColumnWidth = width;
+    d->preparedLayouts.clear();
+}
+
+void QTextDocumentLayout::setParallelLayoutEnabled(bool enable)
+{
+    Q_D(QTextDocumentLayout);
+    d->parallelLayout = enable;
+}
+
+bool QTextDocumentLayout::isParallelLayoutEnabled() const
+{
+    Q_D(const QTextDocumentLayout);
+    return d->parallelLayout;
+}
+
+void QTextDocumentLayout::setOnDemandLayoutEnabled(bool enable)
+{
+    Q_D(QTextDocumentLayout);
+    d->onDemandLayout = enable;
+    if (enable)
+        d->layoutTimer.stop();
+    else if (!d->layoutTimer.isActive() && d->currentLazyLayoutPosition != -1)
+        d->layoutTimer.start(10, this);
+}
+
+bool QTextDocumentLayout::isOnDemandLayoutEnabled() const
+{
+    Q_D(const QTextDocumentLayout);
+    return d->onDemandLayout;
 }
 
 QRectF QTextDocumentLayout::tableCellBoundingRect(QTextTable *table, const QTextTableCell &cell) const
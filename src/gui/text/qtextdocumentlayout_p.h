@@ -85,6 +85,17 @@ public:
     // internal, to support the ugly FixedColumnWidth wordwrap mode in QTextEdit
     void setFixedColumnWidth(int width);
 
+    // internal, breaks the lines of large documents on the global thread pool;
+    // also enabled by setting QT_PARALLEL_TEXT_LAYOUT=1 in the environment
+    void setParallelLayoutEnabled(bool enable);
+    bool isParallelLayoutEnabled() const;
+
+    // internal, lays out only as much of the document as is drawn or asked about,
+    // instead of finishing the layout in the background; also enabled by setting
+    // QT_ON_DEMAND_TEXT_LAYOUT=1 in the environment
+    void setOnDemandLayoutEnabled(bool enable);
+    bool isOnDemandLayoutEnabled() const;
+
     // internal for QTextEdit's NoWrap mode
     void setViewport(const QRectF &viewport);
 
@@ -97,6 +108,7 @@ public:
     int layoutStatus() const;
     int dynamicPageCount() const;
     QSizeF dynamicDocumentSize() const;
+    QSizeF estimatedDocumentSize() const;
     void ensureLayouted(qreal);
 
     qreal idealWidth() const;
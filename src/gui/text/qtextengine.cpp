@@ -47,6 +47,8 @@
 #include "qtextboundaryfinder.h"
 #include <QtCore/private/qunicodetables_p.h>
 #include "qvarlengtharray.h"
+#include "qcache.h"
+#include "qmutex.h"
 #include "qfont.h"
 #include "qfont_p.h"
 #include "qfontengine_p.h"
@@ -1359,6 +1361,180 @@ void QTextEngine::shapeLine(const QScriptLine &line)
 extern bool qt_useHarfbuzzNG(); // defined in qfontengine.cpp
 #endif
 
+namespace {
+
+struct QShapedTextCacheKey
+{
+    // Longer items rarely repeat, and would push many short ones out
+    enum { MaxLength = 1024 };
+    enum Flag {
+        RightToLeft = 0x1,
+        Kerning = 0x2,
+        LetterSpacing = 0x4,
+        DesignMetrics = 0x8
+    };
+
+    QString text;
+    quint64 fontEngine = 0;
+    uint script = 0;
+    uint flags = 0;
+
+    bool operator==(const QShapedTextCacheKey &other) const
+    {
+        return fontEngine == other.fontEngine && script == other.script
+                && flags == other.flags && text == other.text;
+    }
+};
+
+inline uint qHash(const QShapedTextCacheKey &key, uint seed = 0) noexcept
+{
+    using QT_PREPEND_NAMESPACE(qHash);
+    seed = qHash(key.text, seed);
+    seed = qHash(key.fontEngine, seed);
+    return qHash((key.script << 8) | key.flags, seed);
+}
+
+// The result of shaping an item, before letter and word spacing are applied
+struct QShapedTextCacheEntry
+{
+    QByteArray glyphData; // numGlyphs * QGlyphLayout::SpaceNeeded bytes
+    QVector<ushort> logClusters;
+    int numGlyphs = 0;
+    QFixed ascent;
+    QFixed descent;
+    QFixed leading;
+
+    QGlyphLayout glyphs() { return QGlyphLayout(glyphData.data(), numGlyphs); }
+};
+
+struct QShapedTextCacheData
+{
+    QMutex mutex;
+    QCache<QShapedTextCacheKey, QShapedTextCacheEntry> cache { 4 * 1024 * 1024 };
+    qint64 hits = 0;
+    qint64 misses = 0;
+};
+
+} // unnamed namespace
+
+Q_GLOBAL_STATIC(QShapedTextCacheData, shapedTextCache)
+
+static void copyGlyphLayout(const QGlyphLayout &destination, const QGlyphLayout &source, int num)
+{
+    memcpy(static_cast<void *>(destination.offsets), source.offsets, num * sizeof(QFixedPoint));
+    memcpy(destination.glyphs, source.glyphs, num * sizeof(glyph_t));
+    memcpy(static_cast<void *>(destination.advances), source.advances, num * sizeof(QFixed));
+    memcpy(static_cast<void *>(destination.justifications), source.justifications, num * sizeof(QGlyphJustification));
+    memcpy(destination.attributes, source.attributes, num * sizeof(QGlyphAttributes));
+}
+
+#if QT_CONFIG(harfbuzz)
+static bool qt_findShapedText(const QShapedTextCacheKey &key, const QTextEngine *engine, QScriptItem *si)
+{
+    QShapedTextCacheData *data = shapedTextCache();
+    if (!data)
+        return false;
+    QMutexLocker locker(&data->mutex);
+    if (data->cache.maxCost() == 0)
+        return false;
+    QShapedTextCacheEntry *entry = data->cache.object(key);
+    if (!entry) {
+        ++data->misses;
+        return false;
+    }
+    if (Q_UNLIKELY(!engine->ensureSpace(entry->numGlyphs)))
+        return false;
+    ++data->hits;
+
+    copyGlyphLayout(engine->availableGlyphs(si), entry->glyphs(), entry->numGlyphs);
+    memcpy(engine->logClusters(si), entry->logClusters.constData(), entry->logClusters.size() * sizeof(ushort));
+    si->ascent = qMax(si->ascent, entry->ascent);
+    si->descent = qMax(si->descent, entry->descent);
+    si->leading = qMax(si->leading, entry->leading);
+    si->num_glyphs = entry->numGlyphs;
+    return true;
+}
+
+static void qt_insertShapedText(const QShapedTextCacheKey &key, const QTextEngine *engine, const QScriptItem &si)
+{
+    QShapedTextCacheData *data = shapedTextCache();
+    if (!data)
+        return;
+
+    QShapedTextCacheEntry *entry = new QShapedTextCacheEntry;
+    entry->numGlyphs = si.num_glyphs;
+    entry->glyphData.resize(si.num_glyphs * QGlyphLayout::SpaceNeeded);
+    copyGlyphLayout(entry->glyphs(), engine->shapedGlyphs(&si), si.num_glyphs);
+    const ushort *logClusters = engine->logClusters(&si);
+    entry->logClusters = QVector<ushort>(logClusters, logClusters + key.text.size());
+    entry->ascent = si.ascent;
+    entry->descent = si.descent;
+    entry->leading = si.leading;
+    const int cost = int(sizeof(QShapedTextCacheEntry)) + entry->glyphData.size()
+            + (entry->logClusters.size() + key.text.size()) * int(sizeof(ushort));
+
+    QMutexLocker locker(&data->mutex);
+    data->cache.insert(key, entry, cost);
+}
+#endif
+
+/*!
+    \class QShapedTextCache
+    \internal
+
+    Process-wide cache of shaped text items, so that laying out the same
+    strings again, as item views and tables do when they repaint, skips
+    the shaper. Items are keyed by their text, font engine, script and the
+    options that affect shaping. The cache is bounded by maxCost(), in
+    bytes; a maximum cost of 0 disables it.
+*/
+
+int QShapedTextCache::maxCost()
+{
+    QShapedTextCacheData *data = shapedTextCache();
+    if (!data)
+        return 0;
+    QMutexLocker locker(&data->mutex);
+    return data->cache.maxCost();
+}
+
+void QShapedTextCache::setMaxCost(int bytes)
+{
+    if (QShapedTextCacheData *data = shapedTextCache()) {
+        QMutexLocker locker(&data->mutex);
+        data->cache.setMaxCost(bytes);
+    }
+}
+
+void QShapedTextCache::clear()
+{
+    if (QShapedTextCacheData *data = shapedTextCache()) {
+        QMutexLocker locker(&data->mutex);
+        data->cache.clear();
+    }
+}
+
+QShapedTextCache::Statistics QShapedTextCache::statistics()
+{
+    Statistics statistics;
+    if (QShapedTextCacheData *data = shapedTextCache()) {
+        QMutexLocker locker(&data->mutex);
+        statistics.hits = data->hits;
+        statistics.misses = data->misses;
+        statistics.count = data->cache.count();
+        statistics.cost = data->cache.totalCost();
+    }
+    return statistics;
+}
+
+void QShapedTextCache::resetStatistics()
+{
+    if (QShapedTextCacheData *data = shapedTextCache()) {
+        QMutexLocker locker(&data->mutex);
+        data->hits = data->misses = 0;
+    }
+}
+
 void QTextEngine::shapeText(int item) const
 {
     Q_ASSERT(item < layoutData->items.size());
@@ -1434,78 +1610,101 @@ void QTextEngine::shapeText(int item) const
             letterSpacing *= font.d->dpi / qt_defaultDpiY();
     }
 
-    // split up the item into parts that come from different font engines
-    // k * 3 entries, array[k] == index in string, array[k + 1] == index in glyphs, array[k + 2] == engine index
-    QVector<uint> itemBoundaries;
-    itemBoundaries.reserve(24);
-
-    QGlyphLayout initialGlyphs = availableGlyphs(&si);
-    int nGlyphs = initialGlyphs.numGlyphs;
-    if (fontEngine->type() == QFontEngine::Multi || !shapingEnabled) {
-        // ask the font engine to find out which glyphs (as an index in the specific font)
-        // to use for the text in one item.
-        QFontEngine::ShaperFlags shaperFlags =
-                shapingEnabled
-                    ? QFontEngine::GlyphIndicesOnly
-                    : QFontEngine::ShaperFlag(0);
-        if (!fontEngine->stringToCMap(reinterpret_cast<const QChar *>(string), itemLength, &initialGlyphs, &nGlyphs, shaperFlags))
-            Q_UNREACHABLE();
+#if QT_CONFIG(harfbuzz)
+    // Reuse the glyphs of an identical item that was shaped before
+    QShapedTextCacheKey cacheKey;
+    const bool cacheable = shapingEnabled
+            && itemLength <= QShapedTextCacheKey::MaxLength
+            && qt_useHarfbuzzNG();
+    bool shapedFromCache = false;
+    if (cacheable) {
+        cacheKey.text = QString(reinterpret_cast<const QChar *>(string), itemLength);
+        cacheKey.fontEngine = fontEngine->serialNumber;
+        cacheKey.script = si.analysis.script;
+        cacheKey.flags = (si.analysis.bidiLevel % 2 ? QShapedTextCacheKey::RightToLeft : 0)
+                | (kerningEnabled ? QShapedTextCacheKey::Kerning : 0)
+                | (letterSpacing != 0 ? QShapedTextCacheKey::LetterSpacing : 0)
+                | (option.useDesignMetrics() ? QShapedTextCacheKey::DesignMetrics : 0);
+        shapedFromCache = qt_findShapedText(cacheKey, this, &si);
     }
+#else
+    const bool shapedFromCache = false;
+#endif
+
+    if (!shapedFromCache) {
+        // split up the item into parts that come from different font engines
+        // k * 3 entries, array[k] == index in string, array[k + 1] == index in glyphs, array[k + 2] == engine index
+        QVector<uint> itemBoundaries;
+        itemBoundaries.reserve(24);
+
+        QGlyphLayout initialGlyphs = availableGlyphs(&si);
+        int nGlyphs = initialGlyphs.numGlyphs;
+        if (fontEngine->type() == QFontEngine::Multi || !shapingEnabled) {
+            // ask the font engine to find out which glyphs (as an index in the specific font)
+            // to use for the text in one item.
+            QFontEngine::ShaperFlags shaperFlags =
+                    shapingEnabled
+                        ? QFontEngine::GlyphIndicesOnly
+                        : QFontEngine::ShaperFlag(0);
+            if (!fontEngine->stringToCMap(reinterpret_cast<const QChar *>(string), itemLength, &initialGlyphs, &nGlyphs, shaperFlags))
+                Q_UNREACHABLE();
+        }
 
-    if (fontEngine->type() == QFontEngine::Multi) {
-        uint lastEngine = ~0u;
-        for (int i = 0, glyph_pos = 0; i < itemLength; ++i, ++glyph_pos) {
-            const uint engineIdx = initialGlyphs.glyphs[glyph_pos] >> 24;
-            if (lastEngine != engineIdx) {
-                itemBoundaries.append(i);
-                itemBoundaries.append(glyph_pos);
-                itemBoundaries.append(engineIdx);
-
-                if (engineIdx != 0) {
-                    QFontEngine *actualFontEngine = static_cast<QFontEngineMulti *>(fontEngine)->engine(engineIdx);
-                    si.ascent = qMax(actualFontEngine->ascent(), si.ascent);
-                    si.descent = qMax(actualFontEngine->descent(), si.descent);
-                    si.leading = qMax(actualFontEngine->leading(), si.leading);
+        if (fontEngine->type() == QFontEngine::Multi) {
+            uint lastEngine = ~0u;
+            for (int i = 0, glyph_pos = 0; i < itemLength; ++i, ++glyph_pos) {
+                const uint engineIdx = initialGlyphs.glyphs[glyph_pos] >> 24;
+                if (lastEngine != engineIdx) {
+                    itemBoundaries.append(i);
+                    itemBoundaries.append(glyph_pos);
+                    itemBoundaries.append(engineIdx);
+
+                    if (engineIdx != 0) {
+                        QFontEngine *actualFontEngine = static_cast<QFontEngineMulti *>(fontEngine)->engine(engineIdx);
+                        si.ascent = qMax(actualFontEngine->ascent(), si.ascent);
+                        si.descent = qMax(actualFontEngine->descent(), si.descent);
+                        si.leading = qMax(actualFontEngine->leading(), si.leading);
+                    }
+
+                    lastEngine = engineIdx;
                 }
 
-                lastEngine = engineIdx;
+                if (QChar::isHighSurrogate(string[i]) && i + 1 < itemLength && QChar::isLowSurrogate(string[i + 1]))
+                    ++i;
             }
-
-            if (QChar::isHighSurrogate(string[i]) && i + 1 < itemLength && QChar::isLowSurrogate(string[i + 1]))
-                ++i;
+        } else {
+            itemBoundaries.append(0);
+            itemBoundaries.append(0);
+            itemBoundaries.append(0);
         }
-    } else {
-        itemBoundaries.append(0);
-        itemBoundaries.append(0);
-        itemBoundaries.append(0);
-    }
 
-    if (Q_UNLIKELY(!shapingEnabled)) {
-        ushort *log_clusters = logClusters(&si);
+        if (Q_UNLIKELY(!shapingEnabled)) {
+            ushort *log_clusters = logClusters(&si);
 
-        int glyph_pos = 0;
-        for (int i = 0; i < itemLength; ++i, ++glyph_pos) {
-            log_clusters[i] = glyph_pos;
-            initialGlyphs.attributes[glyph_pos].clusterStart = true;
-            if (QChar::isHighSurrogate(string[i])
-                    && i + 1 < itemLength
-                    && QChar::isLowSurrogate(string[i + 1])) {
-                ++i;
+            int glyph_pos = 0;
+            for (int i = 0; i < itemLength; ++i, ++glyph_pos) {
                 log_clusters[i] = glyph_pos;
+                initialGlyphs.attributes[glyph_pos].clusterStart = true;
+                if (QChar::isHighSurrogate(string[i])
+                        && i + 1 < itemLength
+                        && QChar::isLowSurrogate(string[i + 1])) {
+                    ++i;
+                    log_clusters[i] = glyph_pos;
+                }
             }
-        }
 
-        si.num_glyphs = glyph_pos;
+            si.num_glyphs = glyph_pos;
 #if QT_CONFIG(harfbuzz)
-    } else if (Q_LIKELY(qt_useHarfbuzzNG())) {
-        si.num_glyphs = shapeTextWithHarfbuzzNG(si, string, itemLength, fontEngine, itemBoundaries, kerningEnabled, letterSpacing != 0);
+        } else if (Q_LIKELY(qt_useHarfbuzzNG())) {
+            si.num_glyphs = shapeTextWithHarfbuzzNG(si, string, itemLength, fontEngine, itemBoundaries, kerningEnabled, letterSpacing != 0);
 #endif
-    } else {
-        si.num_glyphs = shapeTextWithHarfbuzz(si, string, itemLength, fontEngine, itemBoundaries, kerningEnabled);
-    }
-    if (Q_UNLIKELY(si.num_glyphs == 0)) {
-        Q_UNREACHABLE(); // ### report shaping errors somehow
-        return;
+        } else {
+            si.num_glyphs = shapeTextWithHarfbuzz(si, string, itemLength, fontEngine, itemBoundaries, kerningEnabled);
+        }
+        if (Q_UNLIKELY(si.num_glyphs == 0)) {
+            Q_UNREACHABLE(); // ### report shaping errors somehow
+            return;
+        }
     }
 
 
@@ -1514,8 +1713,11 @@ void QTextEngine::shapeText(int item) const
     QGlyphLayout glyphs = shapedGlyphs(&si);
 
 #if QT_CONFIG(harfbuzz)
-    if (Q_LIKELY(qt_useHarfbuzzNG()))
+    if (Q_LIKELY(qt_useHarfbuzzNG()) && !shapedFromCache) {
         qt_getJustificationOpportunities(string, itemLength, si, glyphs, logClusters(&si));
+        if (cacheable)
+            qt_insertShapedText(cacheKey, this, si);
+    }
 #endif
 
     if (letterSpacing != 0) {
@@ -1916,6 +2118,7 @@ void QTextEngine::init(QTextEngine *e)
     e->forceJustification = false;
     e->visualMovement = false;
     e->delayDecorations = false;
+    e->threadLocalFonts = false;
 
     e->layoutData = nullptr;
 
@@ -2431,6 +2634,9 @@ QFont QTextEngine::font(const QScriptItem &si) const
     if (si.analysis.flags == QScriptAnalysis::SmallCaps)
         font = font.d->smallCapsFont();
 
+    if (threadLocalFonts)
+        font.d.detach();
+
     return font;
 }
 
@@ -2496,6 +2702,8 @@ QFontEngine *QTextEngine::fontEngine(const QScriptItem &si, QFixed *ascent, QFix
                 } else {
                     font = font.resolve(fnt);
                 }
+                if (threadLocalFonts)
+                    font.d.detach();
                 engine = font.d->engineForScript(script);
                 if (engine)
                     engine->ref.ref();
@@ -2527,6 +2735,8 @@ QFontEngine *QTextEngine::fontEngine(const QScriptItem &si, QFixed *ascent, QFix
             if (feCache.prevFontEngine && feCache.prevScript == script && feCache.prevPosition == -1)
                 engine = feCache.prevFontEngine;
             else {
+                if (threadLocalFonts)
+                    font.d.detach();
                 engine = font.d->engineForScript(script);
 
                 if (engine)
@@ -2793,10 +3003,12 @@ void QScriptLine::setDefaultHeight(QTextEngine *eng)
         QPaintDevice *pdev = eng->block.docHandle()->layout()->paintDevice();
         if (pdev)
             f = QFont(f, pdev);
-        e = f.d->engineForScript(QChar::Script_Common);
     } else {
-        e = eng->fnt.d->engineForScript(QChar::Script_Common);
+        f = eng->fnt;
     }
+    if (eng->threadLocalFonts)
+        f.d.detach();
+    e = f.d->engineForScript(QChar::Script_Common);
 
     QFixed other_ascent = e->ascent();
     QFixed other_descent = e->descent();
@@ -578,6 +578,8 @@ public:
     uint forceJustification : 1;
     uint visualMovement : 1;
     uint delayDecorations: 1;
+    // resolve fonts on private copies, whose engines come from the font cache of the current thread
+    uint threadLocalFonts : 1;
 #ifndef QT_NO_RAWFONT
     uint useRawFont : 1;
 #endif
@@ -669,6 +671,24 @@ private:
     int getClusterLength(unsigned short *logClusters, const QCharAttributes *attributes, int from, int to, int glyph_pos, int *start);
 };
 
+class Q_GUI_EXPORT QShapedTextCache
+{
+public:
+    struct Statistics {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        int count = 0;
+        int cost = 0;
+    };
+
+    static int maxCost();
+    static void setMaxCost(int bytes);
+    static void clear();
+
+    static Statistics statistics();
+    static void resetStatistics();
+};
+
 class Q_GUI_EXPORT QStackTextEngine : public QTextEngine {
 public:
     enum { MemSize = 256*40/sizeof(void *) };
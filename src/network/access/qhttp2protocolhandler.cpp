@@ -402,15 +402,14 @@ bool QHttp2ProtocolHandler::sendRequest()
             continue;
         }
 
-        if (newStream.data() && !sendDATA(newStream)) {
-            finishStreamWithError(newStream, QNetworkReply::UnknownNetworkError,
-                                  QLatin1String("failed to send DATA frame(s)"));
-            sendRST_STREAM(newStreamID, INTERNAL_ERROR);
-            markAsReset(newStreamID);
-            deleteActiveStream(newStreamID);
-        }
+        // The request bodies are sent once all HEADERS are out, so that
+        // they share the send window instead of going one after another.
+        if (newStream.data())
+            addToSuspended(newStream);
     }
 
+    resumeSuspendedStreams();
+
     m_channel->state = QHttpNetworkConnectionChannel::IdleState;
 
     return true;
@@ -495,7 +494,7 @@ bool QHttp2ProtocolHandler::sendHEADERS(Stream &stream)
     return frameWriter.writeHEADERS(*m_socket, maxFrameSize);
 }
 
-bool QHttp2ProtocolHandler::sendDATA(Stream &stream)
+bool QHttp2ProtocolHandler::sendDATA(Stream &stream, qint32 quota)
 {
     Q_ASSERT(maxFrameSize > frameHeaderSize);
     Q_ASSERT(m_socket);
@@ -507,7 +506,7 @@ bool QHttp2ProtocolHandler::sendDATA(Stream &stream)
     const auto replyPrivate = reply->d_func();
     Q_ASSERT(replyPrivate);
 
-    auto slot = std::min<qint32>(sessionSendWindowSize, stream.sendWindow);
+    auto slot = std::min<qint32>({sessionSendWindowSize, stream.sendWindow, quota});
     while (!stream.data()->atEnd() && slot) {
         qint64 chunkSize = 0;
         const uchar *src =
@@ -531,10 +530,11 @@ bool QHttp2ProtocolHandler::sendDATA(Stream &stream)
         stream.data()->advanceReadPointer(bytesWritten);
         stream.sendWindow -= bytesWritten;
         sessionSendWindowSize -= bytesWritten;
+        quota -= bytesWritten;
         replyPrivate->totallyUploadedData += bytesWritten;
         emit reply->dataSendProgress(replyPrivate->totallyUploadedData,
                                      request.contentLength());
-        slot = std::min(sessionSendWindowSize, stream.sendWindow);
+        slot = std::min({sessionSendWindowSize, stream.sendWindow, quota});
     }
 
     if (replyPrivate->totallyUploadedData == request.contentLength()) {
@@ -1308,10 +1308,12 @@ quint32 QHttp2ProtocolHandler::createNewStream(const HttpMessagePair &message, b
 void QHttp2ProtocolHandler::addToSuspended(Stream &stream)
 {
     qCDebug(QT_HTTP2) << "stream" << stream.streamID
-                      << "suspended by flow control";
+                      << "waiting to send DATA";
     const auto priority = stream.priority();
     Q_ASSERT(int(priority) >= 0 && int(priority) < 3);
-    suspendedStreams[priority].push_back(stream.streamID);
+    auto &queue = suspendedStreams[priority];
+    if (std::find(queue.begin(), queue.end(), stream.streamID) == queue.end())
+        queue.push_back(stream.streamID);
 }
 
 void QHttp2ProtocolHandler::markAsReset(quint32 streamID)
@@ -1401,21 +1403,38 @@ bool QHttp2ProtocolHandler::streamWasReset(quint32 streamID) const
 
 void QHttp2ProtocolHandler::resumeSuspendedStreams()
 {
+    // 5.3.2: streams share the resources in proportion to their weights.
+    // Each round, every stream that can send gets a part of the session
+    // window matching its weight, so that a large upload with a high
+    // priority slows down the others, but does not block them. Streams
+    // that still have data are queued again for the next round.
+    std::vector<quint32> round;
     while (sessionSendWindowSize > 0) {
-        const auto streamID = popStreamToResume();
-        if (!streamID)
+        round.clear();
+        qint64 totalWeight = 0;
+        for (auto streamID = popStreamToResume(); streamID; streamID = popStreamToResume()) {
+            round.push_back(streamID);
+            totalWeight += activeStreams[streamID].weight() + 1;
+        }
+        if (round.empty())
             return;
 
-        if (!activeStreams.contains(streamID))
-            continue;
+        // Not less than this per stream, to avoid tiny DATA frames.
+        const qint64 minimumShare = 1024;
+        const qint64 window = sessionSendWindowSize;
+        for (const quint32 streamID : round) {
+            if (!activeStreams.contains(streamID))
+                continue;
 
-        Stream &stream = activeStreams[streamID];
-        if (!sendDATA(stream)) {
-            finishStreamWithError(stream, QNetworkReply::UnknownNetworkError,
-                                  QLatin1String("failed to send DATA"));
-            sendRST_STREAM(streamID, INTERNAL_ERROR);
-            markAsReset(streamID);
-            deleteActiveStream(streamID);
+            Stream &stream = activeStreams[streamID];
+            const qint64 share = window * (stream.weight() + 1) / totalWeight;
+            if (!sendDATA(stream, qint32(std::max(share, minimumShare)))) {
+                finishStreamWithError(stream, QNetworkReply::UnknownNetworkError,
+                                      QLatin1String("failed to send DATA"));
+                sendRST_STREAM(streamID, INTERNAL_ERROR);
+                markAsReset(streamID);
+                deleteActiveStream(streamID);
+            }
         }
     }
 }
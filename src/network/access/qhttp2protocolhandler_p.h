@@ -109,7 +109,7 @@ private:
     bool sendClientPreface();
     bool sendSETTINGS_ACK();
     bool sendHEADERS(Stream &stream);
-    bool sendDATA(Stream &stream);
+    bool sendDATA(Stream &stream, qint32 quota = std::numeric_limits<qint32>::max());
     Q_INVOKABLE bool sendWINDOW_UPDATE(quint32 streamID, quint32 delta);
     bool sendRST_STREAM(quint32 streamID, quint32 errorCoder);
     bool sendGOAWAY(quint32 errorCode);
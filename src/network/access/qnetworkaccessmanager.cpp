@@ -78,6 +78,8 @@
 #include "qnetworkreplyhttpimpl_p.h"
 #endif
 
+#include "qcoreapplication.h"
+#include "qmutex.h"
 #include "qthread.h"
 
 #include <QHostInfo>
@@ -104,6 +106,54 @@ Q_GLOBAL_STATIC(QNetworkAccessFtpBackendFactory, ftpBackend)
 Q_GLOBAL_STATIC(QNetworkAccessDebugPipeBackendFactory, debugpipeBackend)
 #endif
 
+namespace {
+// The thread used by all managers that share their connections. The HTTP
+// connection cache is kept per thread, so requests from these managers
+// reuse each other's connections.
+struct QNetworkAccessSharedThread
+{
+    QMutex mutex;
+    QThread thread;
+
+    QNetworkAccessSharedThread()
+    {
+        thread.setObjectName(QStringLiteral("QNetworkAccessManager shared thread"));
+    }
+    ~QNetworkAccessSharedThread()
+    {
+        stop();
+    }
+
+    QThread *start();
+    void stop()
+    {
+        QMutexLocker locker(&mutex);
+        thread.quit();
+        // destroying a running QThread is fatal, so wait for as long as it takes
+        thread.wait();
+    }
+};
+}
+Q_GLOBAL_STATIC(QNetworkAccessSharedThread, sharedThread)
+
+// Stops the shared thread while the application, and with it the event
+// dispatcher, still exists. It is started again if a manager needs it later.
+static void stopSharedThread()
+{
+    if (sharedThread.exists())
+        sharedThread()->stop();
+}
+
+QThread *QNetworkAccessSharedThread::start()
+{
+    QMutexLocker locker(&mutex);
+    if (!thread.isRunning()) {
+        thread.start();
+        qAddPostRoutine(stopSharedThread);
+    }
+    return &thread;
+}
+
 #if defined(Q_OS_MACX)
 bool getProxyAuth(const QString& proxyHostname, const QString &scheme, QString& username, QString& password)
 {
@@ -1751,6 +1801,49 @@ void QNetworkAccessManager::setTransferTimeout(int timeout)
     d_func()->transferTimeout = timeout;
 }
 
+/*!
+    \since 6.0
+
+    Returns \c true if this manager shares its network connections with
+    other managers; otherwise returns \c false. Sharing is disabled by
+    default.
+
+    \sa setConnectionSharingEnabled()
+*/
+bool QNetworkAccessManager::isConnectionSharingEnabled() const
+{
+    return d_func()->connectionSharingEnabled;
+}
+
+/*!
+    \since 6.0
+
+    Enables connection sharing if \a enabled is \c true; otherwise
+    disables it. This affects requests sent after the call.
+
+    By default, each QNetworkAccessManager opens its own connections. All
+    managers that enable sharing, in any thread, use a common pool of
+    connections instead: a request reuses a connection to the same host,
+    port and proxy that another of these managers opened. This matters in
+    particular for HTTP/2, where one connection carries all concurrent
+    requests to an origin, and for encrypted connections, whose handshake
+    is expensive.
+
+    Managers that share connections also share the state attached to them,
+    such as the TLS configuration the connection was opened with and the
+    credentials it was authenticated with. Only enable sharing between
+    managers that act on behalf of the same user.
+
+    Shared connections are not closed by clearConnectionCache(); they are
+    closed when they have been idle for a while.
+
+    \sa isConnectionSharingEnabled(), QNetworkRequest::Http2AllowedAttribute
+*/
+void QNetworkAccessManager::setConnectionSharingEnabled(bool enabled)
+{
+    d_func()->connectionSharingEnabled = enabled;
+}
+
 void QNetworkAccessManagerPrivate::_q_replyFinished()
 {
     Q_Q(QNetworkAccessManager);
@@ -1966,6 +2059,8 @@ QNetworkAccessManagerPrivate::~QNetworkAccessManagerPrivate()
 
 QThread * QNetworkAccessManagerPrivate::createThread()
 {
+    if (connectionSharingEnabled)
+        return sharedThread()->start();
     if (!thread) {
         thread = new QThread;
         thread->setObjectName(QStringLiteral("QNetworkAccessManager thread"));
@@ -172,6 +172,9 @@ public:
     int transferTimeout() const;
     void setTransferTimeout(int timeout = QNetworkRequest::TransferTimeoutPreset);
 
+    bool isConnectionSharingEnabled() const;
+    void setConnectionSharingEnabled(bool enabled);
+
 Q_SIGNALS:
 #ifndef QT_NO_NETWORKPROXY
     void proxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator);
@@ -231,6 +231,8 @@ public:
 
     int transferTimeout = 0;
 
+    bool connectionSharingEnabled = false;
+
 #ifndef QT_NO_BEARERMANAGEMENT
     Q_AUTOTEST_EXPORT static const QWeakPointer<const QNetworkSession> getNetworkSession(const QNetworkAccessManager *manager);
 #endif
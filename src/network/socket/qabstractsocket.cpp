@@ -201,6 +201,18 @@
     \sa connectToHost(), disconnectFromHost(), abort()
 */
 
+/*!
+    \fn void QAbstractSocket::fileSent(QFile *file)
+    \since 6.0
+
+    This signal is emitted when a transfer started with sendFile() has
+    finished, that is, when the last byte of the requested range of
+    \a file has been written to the socket. If the same file was queued
+    several times, it is emitted once per call to sendFile().
+
+    \sa sendFile(), bytesWritten()
+*/
+
 /*!
     \fn void QAbstractSocket::error(QAbstractSocket::SocketError socketError)
 
@@ -569,6 +581,7 @@ QAbstractSocketPrivate::QAbstractSocketPrivate()
       readBufferMaxSize(0),
       isBuffered(false),
       hasPendingData(false),
+      isWritingBatch(false),
       connectTimer(nullptr),
       hostLookupId(-1),
       socketType(QAbstractSocket::UnknownSocketType),
@@ -599,6 +612,7 @@ void QAbstractSocketPrivate::resetSocketLayer()
 #endif
 
     hasPendingData = false;
+    pendingFiles.clear();
     if (socketEngine) {
         socketEngine->close();
         socketEngine->disconnect();
@@ -819,7 +833,9 @@ void QAbstractSocketPrivate::connectionNotification()
 
 /*! \internal
 
-    Writes one pending data block in the write buffer to the socket.
+    Writes pending data blocks in the write buffer to the socket. For TCP
+    sockets, several blocks are written with a single vectored write if
+    the socket engine supports it.
 
     It is usually invoked by canWriteNotification after one or more
     calls to write().
@@ -829,7 +845,7 @@ void QAbstractSocketPrivate::connectionNotification()
 bool QAbstractSocketPrivate::writeToSocket()
 {
     Q_Q(QAbstractSocket);
-    if (!socketEngine || !socketEngine->isValid() || (writeBuffer.isEmpty()
+    if (!socketEngine || !socketEngine->isValid() || (!hasPendingWrites()
         && socketEngine->bytesToWrite() == 0)) {
 #if defined (QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocketPrivate::writeToSocket() nothing to do: valid ? %s, writeBuffer.isEmpty() ? %s",
@@ -847,11 +863,39 @@ bool QAbstractSocketPrivate::writeToSocket()
         return false;
     }
 
-    qint64 nextSize = writeBuffer.nextDataBlockSize();
-    const char *ptr = writeBuffer.readPointer();
+    // Data written before a call to sendFile() goes out before the file,
+    // and data written after it only once the file has been sent.
+    if (!pendingFiles.isEmpty() && pendingFiles.constFirst().precedingBytes == 0)
+        return writeFileToSocket();
+    const qint64 writable = pendingFiles.isEmpty() ? writeBuffer.size()
+                                                   : pendingFiles.constFirst().precedingBytes;
+
+    qint64 written = 0;
+    if (socketType == QAbstractSocket::TcpSocket && !writeBuffer.isEmpty()) {
+        // Pass as many blocks of the write buffer as possible to the
+        // socket engine at once, so that it can use a vectored write.
+        constexpr int MaxWriteSegments = 16;
+        QAbstractSocketEngine::WriteSegment segments[MaxWriteSegments];
+        int segmentCount = 0;
+        qint64 gathered = 0;
+        qint64 length = 0;
+        while (segmentCount < MaxWriteSegments && gathered < writable) {
+            const char *ptr = writeBuffer.readPointerAtPosition(gathered, length);
+            if (!ptr)
+                break;
+            length = qMin(length, writable - gathered);
+            segments[segmentCount++] = { ptr, length };
+            gathered += length;
+        }
+        written = segmentCount == 1 ? socketEngine->write(segments[0].data, segments[0].size)
+                                    : socketEngine->writeSegments(segments, segmentCount);
+    } else {
+        qint64 nextSize = qMin(writeBuffer.nextDataBlockSize(), writable);
+        const char *ptr = writeBuffer.readPointer();
 
-    // Attempt to write it all in one chunk.
-    qint64 written = nextSize ? socketEngine->write(ptr, nextSize) : Q_INT64_C(0);
+        // Attempt to write it all in one chunk.
+        written = nextSize ? socketEngine->write(ptr, nextSize) : Q_INT64_C(0);
+    }
     if (written < 0) {
 #if defined (QABSTRACTSOCKET_DEBUG)
         qDebug() << "QAbstractSocketPrivate::writeToSocket() write error, aborting."
@@ -868,15 +912,24 @@ bool QAbstractSocketPrivate::writeToSocket()
            written);
 #endif
 
+    QPointer<QFile> sentFile;
     if (written > 0) {
         // Remove what we wrote so far.
         writeBuffer.free(written);
+        if (!pendingFiles.isEmpty()) {
+            PendingFile &pending = pendingFiles.first();
+            pending.precedingBytes -= written;
+            if (pending.precedingBytes == 0 && pending.remaining == 0)
+                sentFile = pendingFiles.takeFirst().file;
+        }
 
         // Emit notifications.
         emitBytesWritten(written);
+        if (sentFile)
+            emit q->fileSent(sentFile);
     }
 
-    if (writeBuffer.isEmpty() && socketEngine && !socketEngine->bytesToWrite())
+    if (!hasPendingWrites() && socketEngine && !socketEngine->bytesToWrite())
         socketEngine->setWriteNotificationEnabled(false);
     if (state == QAbstractSocket::ClosingState)
         q->disconnectFromHost();
@@ -884,6 +937,88 @@ bool QAbstractSocketPrivate::writeToSocket()
     return written > 0;
 }
 
+/*! \internal
+
+    Sends the next part of the first file queued by sendFile(). The socket
+    engine is asked to send it without copying; if it cannot, a chunk of
+    the file is read into the front of the write buffer and written from
+    there.
+
+    Emits bytesWritten(), and fileSent() once the whole file was sent.
+*/
+bool QAbstractSocketPrivate::writeFileToSocket()
+{
+    Q_Q(QAbstractSocket);
+    PendingFile &pending = pendingFiles.first();
+    QPointer<QFile> file = pending.file;
+    if (!file || !file->isOpen()) {
+        setErrorAndEmit(QAbstractSocket::UnknownSocketError,
+                        QAbstractSocket::tr("File was closed while being sent"));
+        q->abort();
+        return false;
+    }
+
+    // sendfile() cannot transfer more than about 2 GB at once anyway.
+    constexpr qint64 MaxFileChunk = Q_INT64_C(1) << 30;
+    qint64 written = 0;
+    if (pending.remaining > 0) {
+        written = file->handle() == -1 ? Q_INT64_C(-2)
+                  : socketEngine->sendFile(file->handle(), pending.offset,
+                                           qMin(pending.remaining, MaxFileChunk));
+    }
+
+    if (written == -2) {
+        QByteArray data;
+        if (file->seek(pending.offset))
+            data = file->read(qMin(pending.remaining, qint64(writeBufferChunkSize)));
+        if (data.isEmpty()) {
+            setErrorAndEmit(QAbstractSocket::UnknownSocketError,
+                            QAbstractSocket::tr("Unable to read file: %1").arg(file->errorString()));
+            q->abort();
+            return false;
+        }
+
+        memcpy(writeBuffer.reserveFront(data.size()), data.constData(), data.size());
+        pending.offset += data.size();
+        pending.remaining -= data.size();
+        pending.precedingBytes = data.size();
+        return writeToSocket();
+    }
+
+    if (written < 0) {
+#if defined (QABSTRACTSOCKET_DEBUG)
+        qDebug() << "QAbstractSocketPrivate::writeFileToSocket() write error, aborting."
+                 << socketEngine->errorString();
+#endif
+        setErrorAndEmit(socketEngine->error(), socketEngine->errorString());
+        q->abort();
+        return false;
+    }
+
+#if defined (QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::writeFileToSocket() %lld bytes sent to the network",
+           written);
+#endif
+
+    pending.offset += written;
+    pending.remaining -= written;
+    const bool finished = pending.remaining == 0;
+    if (finished)
+        pendingFiles.removeFirst();
+
+    if (written > 0)
+        emitBytesWritten(written);
+    if (finished && file)
+        emit q->fileSent(file);
+
+    if (!hasPendingWrites() && socketEngine && !socketEngine->bytesToWrite())
+        socketEngine->setWriteNotificationEnabled(false);
+    if (state == QAbstractSocket::ClosingState)
+        q->disconnectFromHost();
+
+    return written > 0 || finished;
+}
+
 /*! \internal
 
     Writes pending data in the write buffers to the socket. The function
@@ -894,7 +1029,7 @@ bool QAbstractSocketPrivate::flush()
 {
     bool dataWasWritten = false;
 
-    while (!allWriteBuffersEmpty() && writeToSocket())
+    while ((!allWriteBuffersEmpty() || !pendingFiles.isEmpty()) && writeToSocket())
         dataWasWritten = true;
 
     return dataWasWritten;
@@ -1791,7 +1926,10 @@ void QAbstractSocket::connectToHost(const QHostAddress &address, quint16 port,
 */
 qint64 QAbstractSocket::bytesToWrite() const
 {
-    const qint64 pendingBytes = QIODevice::bytesToWrite();
+    Q_D(const QAbstractSocket);
+    qint64 pendingBytes = QIODevice::bytesToWrite();
+    for (const QAbstractSocketPrivate::PendingFile &pending : d->pendingFiles)
+        pendingBytes += pending.remaining;
 #if defined(QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocket::bytesToWrite() == %lld", pendingBytes);
 #endif
@@ -2254,7 +2392,7 @@ bool QAbstractSocket::waitForReadyRead(int msecs)
 
         bool readyToRead = false;
         bool readyToWrite = false;
-        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, !d->writeBuffer.isEmpty(),
+        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, d->hasPendingWrites(),
                                                qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2306,7 +2444,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         return false;
     }
 
-    if (d->writeBuffer.isEmpty())
+    if (!d->hasPendingWrites())
         return false;
 
     QElapsedTimer stopWatch;
@@ -2323,7 +2461,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         bool readyToWrite = false;
         if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite,
                                   !d->readBufferMaxSize || d->buffer.size() < d->readBufferMaxSize,
-                                  !d->writeBuffer.isEmpty(),
+                                  d->hasPendingWrites(),
                                   qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForBytesWritten(%i) failed (%i, %s)",
@@ -2403,7 +2541,7 @@ bool QAbstractSocket::waitForDisconnected(int msecs)
         bool readyToRead = false;
         bool readyToWrite = false;
         if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, state() == ConnectedState,
-                                               !d->writeBuffer.isEmpty(),
+                                               d->hasPendingWrites(),
                                                qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2548,8 +2686,8 @@ qint64 QAbstractSocket::writeData(const char *data, qint64 size)
         return -1;
     }
 
-    if (!d->isBuffered && d->socketType == TcpSocket
-        && d->socketEngine && d->writeBuffer.isEmpty()) {
+    if (!d->isBuffered && d->socketType == TcpSocket && !d->isWritingBatch
+        && d->socketEngine && !d->hasPendingWrites()) {
         // This code is for the new Unbuffered QTcpSocket use case
         qint64 written = size ? d->socketEngine->write(data, size) : Q_INT64_C(0);
         if (written < 0) {
@@ -2603,6 +2741,102 @@ qint64 QAbstractSocket::writeData(const char *data, qint64 size)
     return written;
 }
 
+/*!
+    \since 6.0
+    \overload
+
+    Writes the contents of all byte arrays in \a buffers to the socket, in
+    order, as if write() had been called for each of them. Returns the
+    number of bytes that were written or buffered, or -1 if an error
+    occurred.
+
+    This is more efficient than separate calls to write() when sending many
+    small messages, such as the frames of a protocol: on an unbuffered
+    QTcpSocket, all buffers are sent with a single vectored write instead
+    of one system call each. On a buffered socket, the data is sent
+    together once control returns to the event loop, as usual.
+
+    \sa flush(), bytesToWrite()
+*/
+qint64 QAbstractSocket::write(const QByteArrayList &buffers)
+{
+    Q_D(QAbstractSocket);
+
+    // Unbuffered TCP sockets normally write directly to the socket engine;
+    // collect the data in the write buffer instead and send it at once.
+    const bool wasWritingBatch = d->isWritingBatch;
+    d->isWritingBatch = true;
+    qint64 totalWritten = 0;
+    for (const QByteArray &buffer : buffers) {
+        const qint64 written = QIODevice::write(buffer);
+        if (written < 0) {
+            totalWritten = -1;
+            break;
+        }
+        totalWritten += written;
+    }
+    d->isWritingBatch = wasWritingBatch;
+
+    if (!wasWritingBatch && !d->isBuffered && d->socketType == TcpSocket
+        && d->state == ConnectedState && d->socketEngine && !d->writeBuffer.isEmpty()) {
+        d->writeToSocket();
+    }
+    return totalWritten;
+}
+
+/*!
+    \since 6.0
+
+    Sends \a length bytes of \a file, starting at \a offset, over the
+    socket. If \a length is -1, the file is sent up to its end. Returns
+    \c true if the transfer was queued; otherwise returns \c false.
+
+    The transfer is asynchronous: the data is sent as the socket becomes
+    writable, in order with data passed to write() before and after this
+    call. bytesWritten() is emitted as usual, and fileSent() is emitted
+    once the whole range was sent. The file must stay open and must not
+    be read from until then.
+
+    On Linux, the kernel copies the file contents to the socket directly
+    with sendfile(), so that the data does not pass through the
+    application. On other platforms, and for files without a native
+    handle such as Qt resources, the data is read into the write buffer
+    in chunks instead.
+
+    Only connected TCP sockets using a native socket engine support this
+    function; it returns \c false for encrypted QSslSocket connections,
+    whose data must be encrypted first, and for sequential files.
+
+    \sa fileSent(), bytesToWrite()
+*/
+bool QAbstractSocket::sendFile(QFile *file, qint64 offset, qint64 length)
+{
+    Q_D(QAbstractSocket);
+    if (d->socketType != TcpSocket || !d->socketEngine || d->state != ConnectedState) {
+        qWarning("QAbstractSocket::sendFile: Socket is not a connected TCP socket");
+        return false;
+    }
+    if (!file || !file->isReadable() || file->isSequential()) {
+        qWarning("QAbstractSocket::sendFile: File is not open for reading");
+        return false;
+    }
+
+    const qint64 available = file->size() - offset;
+    if (length < 0)
+        length = available;
+    if (offset < 0 || length > available) {
+        qWarning("QAbstractSocket::sendFile: Range is outside of the file");
+        return false;
+    }
+
+    qint64 queuedBytes = 0;
+    for (const QAbstractSocketPrivate::PendingFile &pending : qAsConst(d->pendingFiles))
+        queuedBytes += pending.precedingBytes;
+    d->pendingFiles.append({ file, offset, length, d->writeBuffer.size() - queuedBytes });
+    d->socketEngine->setWriteNotificationEnabled(true);
+    return true;
+}
+
 /*!
     \since 4.1
 
@@ -2780,7 +3014,7 @@ void QAbstractSocket::disconnectFromHost()
 
         // Wait for pending data to be written.
         if (d->socketEngine && d->socketEngine->isValid() && (!d->allWriteBuffersEmpty()
-            || d->socketEngine->bytesToWrite() > 0)) {
+            || !d->pendingFiles.isEmpty() || d->socketEngine->bytesToWrite() > 0)) {
             d->socketEngine->setWriteNotificationEnabled(true);
 
 #if defined(QABSTRACTSOCKET_DEBUG)
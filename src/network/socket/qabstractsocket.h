@@ -41,6 +41,7 @@
 #define QABSTRACTSOCKET_H
 
 #include <QtNetwork/qtnetworkglobal.h>
+#include <QtCore/qbytearraylist.h>
 #include <QtCore/qiodevice.h>
 #include <QtCore/qobject.h>
 #ifndef QT_NO_DEBUG_STREAM
@@ -50,6 +51,7 @@
 QT_BEGIN_NAMESPACE
 
 
+class QFile;
 class QHostAddress;
 #ifndef QT_NO_NETWORKPROXY
 class QNetworkProxy;
@@ -188,6 +190,10 @@ public:
     bool atEnd() const override; // ### Qt6: remove me
     bool flush();
 
+    using QIODevice::write;
+    qint64 write(const QByteArrayList &buffers);
+    bool sendFile(QFile *file, qint64 offset = 0, qint64 length = -1);
+
     // for synchronous access
     virtual bool waitForConnected(int msecs = 30000);
     bool waitForReadyRead(int msecs = 30000) override;
@@ -207,6 +213,7 @@ Q_SIGNALS:
     void disconnected();
     void stateChanged(QAbstractSocket::SocketState);
     void error(QAbstractSocket::SocketError);
+    void fileSent(QFile *file);
 #ifndef QT_NO_NETWORKPROXY
     void proxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator);
 #endif
@@ -54,7 +54,9 @@
 #include <QtNetwork/private/qtnetworkglobal_p.h>
 #include "QtNetwork/qabstractsocket.h"
 #include "QtCore/qbytearray.h"
+#include "QtCore/qfile.h"
 #include "QtCore/qlist.h"
+#include "QtCore/qpointer.h"
 #include "QtCore/qtimer.h"
 #include "private/qiodevice_p.h"
 #include "private/qabstractsocketengine_p.h"
@@ -140,6 +142,7 @@ public:
     void fetchConnectionParameters();
     bool readFromSocket();
     virtual bool writeToSocket();
+    bool writeFileToSocket();
     void emitReadyRead(int channel = 0);
     void emitBytesWritten(qint64 bytes, int channel = 0);
 
@@ -149,6 +152,19 @@ public:
     qint64 readBufferMaxSize;
     bool isBuffered;
     bool hasPendingData;
+    bool isWritingBatch;
+
+    // Files queued by sendFile(), each sent after the precedingBytes of
+    // the write buffer that were written before it.
+    struct PendingFile
+    {
+        QPointer<QFile> file;
+        qint64 offset;
+        qint64 remaining;
+        qint64 precedingBytes;
+    };
+    QList<PendingFile> pendingFiles;
+    inline bool hasPendingWrites() const { return !writeBuffer.isEmpty() || !pendingFiles.isEmpty(); }
 
     QTimer *connectTimer;
 
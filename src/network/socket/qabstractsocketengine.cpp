@@ -132,6 +132,51 @@ QAbstractSocketEngine *QAbstractSocketEngine::createSocketEngine(qintptr socketD
     return new QNativeSocketEngine(parent);
 }
 
+/*!
+    \internal
+
+    Writes the \a count blocks in \a segments to the socket, in order, as
+    one stream of data. Returns the number of bytes written, or -1 if an
+    error occurred before anything could be written.
+
+    The default implementation calls write() for each segment and stops at
+    the first one that is not written completely. Engines that can send
+    several buffers with a single system call reimplement this function.
+*/
+qint64 QAbstractSocketEngine::writeSegments(const WriteSegment *segments, int count)
+{
+    qint64 totalWritten = 0;
+    for (int i = 0; i < count; ++i) {
+        const qint64 written = write(segments[i].data, segments[i].size);
+        if (written < 0)
+            return totalWritten > 0 ? totalWritten : written;
+        totalWritten += written;
+        if (written < segments[i].size)
+            break;
+    }
+    return totalWritten;
+}
+
+/*!
+    \internal
+
+    Sends up to \a length bytes of the file \a fileDescriptor, starting at
+    \a offset, directly to the socket without copying them through the
+    application. Returns the number of bytes sent, 0 if the socket cannot
+    accept more data right now, or -1 if an error occurred.
+
+    Returns -2 if the engine cannot send this file itself; the caller must
+    then read the data and pass it to write(). This is what the default
+    implementation does.
+*/
+qint64 QAbstractSocketEngine::sendFile(qintptr fileDescriptor, qint64 offset, qint64 length)
+{
+    Q_UNUSED(fileDescriptor);
+    Q_UNUSED(offset);
+    Q_UNUSED(length);
+    return -2;
+}
+
 QAbstractSocket::SocketError QAbstractSocketEngine::error() const
 {
     return d_func()->socketError;
@@ -121,6 +121,12 @@ public:
     };
     Q_DECLARE_FLAGS(PacketHeaderOptions, PacketHeaderOption)
 
+    struct WriteSegment
+    {
+        const char *data;
+        qint64 size;
+    };
+
     virtual bool initialize(QAbstractSocket::SocketType type, QAbstractSocket::NetworkLayerProtocol protocol = QAbstractSocket::IPv4Protocol) = 0;
 
     virtual bool initialize(qintptr socketDescriptor, QAbstractSocket::SocketState socketState = QAbstractSocket::ConnectedState) = 0;
@@ -140,6 +146,8 @@ public:
 
     virtual qint64 read(char *data, qint64 maxlen) = 0;
     virtual qint64 write(const char *data, qint64 len) = 0;
+    virtual qint64 writeSegments(const WriteSegment *segments, int count);
+    virtual qint64 sendFile(qintptr fileDescriptor, qint64 offset, qint64 length);
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -919,6 +919,42 @@ qint64 QNativeSocketEngine::write(const char *data, qint64 size)
 }
 
 
+/*!
+    Writes the \a count blocks in \a segments to the socket with as few
+    system calls as possible. Returns the number of bytes written, or -1
+    if an error occurred.
+*/
+qint64 QNativeSocketEngine::writeSegments(const WriteSegment *segments, int count)
+{
+#ifdef Q_OS_UNIX
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeSegments(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::writeSegments(), QAbstractSocket::ConnectedState, -1);
+    return d->nativeWrite(segments, count);
+#else
+    return QAbstractSocketEngine::writeSegments(segments, count);
+#endif
+}
+
+/*!
+    Sends up to \a length bytes of the file \a fileDescriptor, starting at
+    \a offset, to the socket. On Linux, the data is passed to the socket
+    by the kernel with sendfile(); elsewhere, and for files that sendfile()
+    cannot handle, -2 is returned and the caller copies the data.
+*/
+qint64 QNativeSocketEngine::sendFile(qintptr fileDescriptor, qint64 offset, qint64 length)
+{
+#ifdef Q_OS_LINUX
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::sendFile(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::sendFile(), QAbstractSocket::ConnectedState, -1);
+    Q_CHECK_TYPE(QNativeSocketEngine::sendFile(), QAbstractSocket::TcpSocket, -1);
+    return d->nativeSendFile(int(fileDescriptor), offset, length);
+#else
+    return QAbstractSocketEngine::sendFile(fileDescriptor, offset, length);
+#endif
+}
+
 qint64 QNativeSocketEngine::bytesToWrite() const
 {
     return 0;
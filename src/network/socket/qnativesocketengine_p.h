@@ -146,6 +146,8 @@ public:
 
     qint64 read(char *data, qint64 maxlen) override;
     qint64 write(const char *data, qint64 len) override;
+    qint64 writeSegments(const WriteSegment *segments, int count) override;
+    qint64 sendFile(qintptr fileDescriptor, qint64 offset, qint64 length) override;
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -279,6 +281,13 @@ public:
     qint64 nativeSendDatagram(const char *data, qint64 length, const QIpPacketHeader &header);
     qint64 nativeRead(char *data, qint64 maxLength);
     qint64 nativeWrite(const char *data, qint64 length);
+#ifdef Q_OS_UNIX
+    qint64 nativeWrite(const QAbstractSocketEngine::WriteSegment *segments, int count);
+    qint64 handleWriteResult(qint64 writtenBytes);
+#endif
+#ifdef Q_OS_LINUX
+    qint64 nativeSendFile(int fileDescriptor, qint64 offset, qint64 length);
+#endif
     int nativeSelect(int timeout, bool selectForRead) const;
     int nativeSelect(int timeout, bool checkRead, bool checkWrite,
                      bool *selectForRead, bool *selectForWrite) const;
@@ -1331,10 +1331,80 @@ void QNativeSocketEnginePrivate::nativeClose()
 
 qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
 {
-    Q_Q(QNativeSocketEngine);
-
     ssize_t writtenBytes;
     writtenBytes = qt_safe_write_nosignal(socketDescriptor, data, len);
+    writtenBytes = handleWriteResult(writtenBytes);
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeWrite(%p \"%s\", %llu) == %i",
+           data, qt_prettyDebug(data, qMin((int) len, 16),
+                                (int) len).data(), len, (int) writtenBytes);
+#endif
+
+    return qint64(writtenBytes);
+}
+
+/*
+    Sends all segments with a single sendmsg() call, so that a write buffer
+    made of several chunks costs one system call instead of one per chunk.
+*/
+qint64 QNativeSocketEnginePrivate::nativeWrite(const QAbstractSocketEngine::WriteSegment *segments,
+                                               int count)
+{
+    // POSIX guarantees that at least 16 buffers can be passed at once
+    // (_XOPEN_IOV_MAX); the rest is written by the next call.
+    QVarLengthArray<struct iovec, 16> vec(qMin(count, 16));
+    for (int i = 0; i < vec.size(); ++i) {
+        vec[i].iov_base = const_cast<char *>(segments[i].data);
+        vec[i].iov_len = size_t(segments[i].size);
+    }
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = vec.data();
+    msg.msg_iovlen = vec.size();
+
+    ssize_t writtenBytes = qt_safe_sendmsg(socketDescriptor, &msg, 0);
+    writtenBytes = handleWriteResult(writtenBytes);
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeWrite(%d segments) == %i",
+           int(vec.size()), (int) writtenBytes);
+#endif
+
+    return qint64(writtenBytes);
+}
+
+#ifdef Q_OS_LINUX
+/*
+    Lets the kernel copy the file data to the socket. Returns -2 if
+    sendfile() cannot be used for this file, or if the file ends before
+    \a length bytes, so that the caller falls back to reading it.
+*/
+qint64 QNativeSocketEnginePrivate::nativeSendFile(int fileDescriptor, qint64 offset, qint64 length)
+{
+    off_t fileOffset = off_t(offset);
+    ssize_t sentBytes = qt_safe_sendfile(socketDescriptor, fileDescriptor, &fileOffset, size_t(length));
+    if ((sentBytes < 0 && (errno == EINVAL || errno == ENOSYS)) || (sentBytes == 0 && length > 0))
+        return -2;
+    sentBytes = handleWriteResult(sentBytes);
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendFile(%d, %lld, %lld) == %i",
+           fileDescriptor, offset, length, (int) sentBytes);
+#endif
+
+    return qint64(sentBytes);
+}
+#endif
+
+/*
+    Translates errors of the write functions: returns 0 if the write would
+    block, -1 and sets the error otherwise.
+*/
+qint64 QNativeSocketEnginePrivate::handleWriteResult(qint64 writtenBytes)
+{
+    Q_Q(QNativeSocketEngine);
 
     if (writtenBytes < 0) {
         switch (errno) {
@@ -1354,14 +1424,7 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
             break;
         }
     }
-
-#if defined (QNATIVESOCKETENGINE_DEBUG)
-    qDebug("QNativeSocketEnginePrivate::nativeWrite(%p \"%s\", %llu) == %i",
-           data, qt_prettyDebug(data, qMin((int) len, 16),
-                                (int) len).data(), len, (int) writtenBytes);
-#endif
-
-    return qint64(writtenBytes);
+    return writtenBytes;
 }
 /*
 */
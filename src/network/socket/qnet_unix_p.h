@@ -57,6 +57,9 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#ifdef Q_OS_LINUX
+#  include <sys/sendfile.h>
+#endif
 
 #if defined(Q_OS_VXWORKS)
 #  include <sockLib.h>
@@ -171,7 +174,7 @@ static inline int qt_safe_ioctl(int sockfd, unsigned long request, T arg)
 #endif
 }
 
-static inline int qt_safe_sendmsg(int sockfd, const struct msghdr *msg, int flags)
+static inline ssize_t qt_safe_sendmsg(int sockfd, const struct msghdr *msg, int flags)
 {
 #ifdef MSG_NOSIGNAL
     flags |= MSG_NOSIGNAL;
@@ -179,11 +182,22 @@ static inline int qt_safe_sendmsg(int sockfd, const struct msghdr *msg, int flag
     qt_ignore_sigpipe();
 #endif
 
-    int ret;
+    ssize_t ret;
     EINTR_LOOP(ret, ::sendmsg(sockfd, msg, flags));
     return ret;
 }
 
+#ifdef Q_OS_LINUX
+static inline ssize_t qt_safe_sendfile(int sockfd, int filefd, off_t *offset, size_t count)
+{
+    qt_ignore_sigpipe();
+
+    ssize_t ret;
+    EINTR_LOOP(ret, ::sendfile(sockfd, filefd, offset, count));
+    return ret;
+}
+#endif
+
 static inline int qt_safe_recvmsg(int sockfd, struct msghdr *msg, int flags)
 {
     int ret;
@@ -46,7 +46,9 @@ QT_BEGIN_NAMESPACE
 class QAbstractEventDispatcher *QtGenericUnixDispatcher::createUnixEventDispatcher()
 {
 #if !defined(QT_NO_GLIB) && !defined(Q_OS_WIN)
-    if (qEnvironmentVariableIsEmpty("QT_NO_GLIB") && QEventDispatcherGlib::versionSupported())
+    if (qEnvironmentVariableIsEmpty("QT_NO_GLIB")
+        && qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL") <= 0
+        && QEventDispatcherGlib::versionSupported())
         return new QPAEventDispatcherGlib();
     else
 #endif
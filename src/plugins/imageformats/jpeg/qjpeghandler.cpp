@@ -112,6 +112,8 @@ struct my_jpeg_source_mgr : public jpeg_source_mgr {
     QIODevice *device;
     JOCTET buffer[max_buf];
     const QBuffer *memDevice;
+    qint64 bytesToSkip;
+    bool suspendable;
 
 public:
     my_jpeg_source_mgr(QIODevice *device);
@@ -131,6 +133,12 @@ static boolean qt_fill_input_buffer(j_decompress_ptr cinfo)
         src->next_input_byte = (const JOCTET *)(src->memDevice->data().constData() + src->memDevice->pos());
         num_read = src->memDevice->data().size() - src->memDevice->pos();
         src->device->seek(src->memDevice->data().size());
+    } else if (src->suspendable) {
+        // Suspend until the device has more data; qt_resume_input() keeps
+        // the bytes libjpeg backs up to. A closed device, or a full buffer
+        // that cannot make progress, gets a fake EOI like at the end of file.
+        if (src->device->isOpen() && src->bytes_in_buffer < size_t(max_buf))
+            return FALSE;
     } else {
         src->next_input_byte = src->buffer;
         num_read = src->device->read((char*)src->buffer, max_buf);
@@ -157,7 +165,12 @@ static void qt_skip_input_data(j_decompress_ptr cinfo, long num_bytes)
      * it doesn't work on pipes.  Not clear that being smart is worth
      * any trouble anyway --- large skips are infrequent.
      */
-    if (num_bytes > 0) {
+    if (num_bytes > 0 && src->suspendable && num_bytes > (long) src->bytes_in_buffer) {
+        // Skip the rest when the data arrives
+        src->bytesToSkip += num_bytes - (long) src->bytes_in_buffer;
+        src->next_input_byte += src->bytes_in_buffer;
+        src->bytes_in_buffer = 0;
+    } else if (num_bytes > 0) {
         while (num_bytes > (long) src->bytes_in_buffer) {  // Should not happen in case of memDevice
             num_bytes -= (long) src->bytes_in_buffer;
             (void) qt_fill_input_buffer(cinfo);
@@ -190,6 +203,34 @@ inline my_jpeg_source_mgr::my_jpeg_source_mgr(QIODevice *device)
     memDevice = qobject_cast<QBuffer *>(device);
     bytes_in_buffer = 0;
     next_input_byte = buffer;
+    bytesToSkip = 0;
+    suspendable = false;
+}
+
+/*
+ * Moves the data libjpeg has not consumed yet to the front of the buffer
+ * and appends what the device has available. Returns false if no
+ * progress was made, in which case decoding has to wait for more data.
+ */
+static bool qt_resume_input(my_jpeg_source_mgr *src)
+{
+    if (src->bytesToSkip > 0) {
+        const qint64 skipped = src->device->skip(src->bytesToSkip);
+        if (skipped <= 0)
+            return false;
+        src->bytesToSkip -= skipped;
+        return true;
+    }
+
+    const size_t kept = src->bytes_in_buffer;
+    if (kept && src->next_input_byte != src->buffer)
+        memmove(src->buffer, src->next_input_byte, kept);
+    src->next_input_byte = src->buffer;
+    const qint64 num_read = src->device->read((char *)src->buffer + kept, max_buf - kept);
+    if (num_read <= 0)
+        return false;
+    src->bytes_in_buffer = kept + num_read;
+    return true;
 }
 
 
@@ -246,6 +287,37 @@ static bool ensureValidImage(QImage *dest, struct jpeg_decompress_struct *info,
     return !dest->isNull();
 }
 
+static inline void copy_jpeg_scanline(uchar *out, const uchar *in, int width,
+                                      j_decompress_ptr info, Rgb888ToRgb32Converter converter)
+{
+    if (info->output_components == 3) {
+        converter((QRgb *)out, in, width);
+    } else if (info->out_color_space == JCS_CMYK) {
+        // Convert CMYK->RGB.
+        QRgb *rgb = (QRgb *)out;
+        for (int i = 0; i < width; ++i) {
+            int k = in[3];
+            *rgb++ = qRgb(k * in[0] / 255, k * in[1] / 255,
+                          k * in[2] / 255);
+            in += 4;
+        }
+    } else if (info->output_components == 1) {
+        // Grayscale.
+        memcpy(out, in, width);
+    }
+}
+
+static void read_jpeg_density(QImage *outImage, j_decompress_ptr info)
+{
+    if (info->density_unit == 1) {
+        outImage->setDotsPerMeterX(int(100. * info->X_density / 2.54));
+        outImage->setDotsPerMeterY(int(100. * info->Y_density / 2.54));
+    } else if (info->density_unit == 2) {
+        outImage->setDotsPerMeterX(int(100. * info->X_density));
+        outImage->setDotsPerMeterY(int(100. * info->Y_density));
+    }
+}
+
 static bool read_jpeg_image(QImage *outImage,
                             QSize scaledSize, QRect scaledClipRect,
                             QRect clipRect, int quality,
@@ -296,39 +368,37 @@ static bool read_jpeg_image(QImage *outImage,
         // Determine the scale factor to pass to libjpeg for quick downscaling.
         if (!scaledSize.isEmpty() && info->image_width && info->image_height) {
             if (clipRect.isEmpty()) {
-                double f = qMin(double(info->image_width) / scaledSize.width(),
-                                double(info->image_height) / scaledSize.height());
-
                 // libjpeg supports M/8 scaling with M=[1,16]. All downscaling factors
                 // are a speed improvement, but upscaling during decode is slower.
-                info->scale_num   = qBound(1, qCeil(8/f), 8);
+                // Pick the smallest one that decodes at least scaledSize, so
+                // that sizes libjpeg can decode at need no further scaling.
+                const qint64 width = info->image_width;
+                const qint64 height = info->image_height;
+                int scale = 1;
+                while (scale < 8 &&
+                       ((width * scale + 7) / 8 < scaledSize.width() ||
+                        (height * scale + 7) / 8 < scaledSize.height())) {
+                    ++scale;
+                }
+                info->scale_num   = scale;
                 info->scale_denom = 8;
             } else {
-                info->scale_denom = qMin(clipRect.width() / scaledSize.width(),
-                                         clipRect.height() / scaledSize.height());
-
-                // Only scale by powers of two when clipping so we can
-                // keep the exact pixel boundaries
-                if (info->scale_denom < 2)
-                    info->scale_denom = 1;
-                else if (info->scale_denom < 4)
-                    info->scale_denom = 2;
-                else if (info->scale_denom < 8)
-                    info->scale_denom = 4;
-                else
-                    info->scale_denom = 8;
-                info->scale_num = 1;
+                int scale = 1;
 
                 // Correct the scale factor so that we clip accurately.
                 // It is recommended that the clip rectangle be aligned
                 // on an 8-pixel boundary for best performance.
-                while (info->scale_denom > 1 &&
-                       ((clipRect.x() % info->scale_denom) != 0 ||
-                        (clipRect.y() % info->scale_denom) != 0 ||
-                        (clipRect.width() % info->scale_denom) != 0 ||
-                        (clipRect.height() % info->scale_denom) != 0)) {
-                    info->scale_denom /= 2;
+                while (scale < 8 &&
+                       (clipRect.width() * scale < scaledSize.width() * 8 ||
+                        clipRect.height() * scale < scaledSize.height() * 8 ||
+                        (clipRect.x() * scale % 8) != 0 ||
+                        (clipRect.y() * scale % 8) != 0 ||
+                        (clipRect.width() * scale % 8) != 0 ||
+                        (clipRect.height() * scale % 8) != 0)) {
+                    ++scale;
                 }
+                info->scale_num = scale;
+                info->scale_denom = 8;
             }
         }
 
@@ -350,10 +420,12 @@ static bool read_jpeg_image(QImage *outImage,
         } else {
             // The scale factor was corrected above to ensure that
             // we don't miss pixels when we scale the clip rectangle.
-            clip = QRect(clipRect.x() / int(info->scale_denom),
-                         clipRect.y() / int(info->scale_denom),
-                         clipRect.width() / int(info->scale_denom),
-                         clipRect.height() / int(info->scale_denom));
+            const int num = int(info->scale_num);
+            const int denom = int(info->scale_denom);
+            clip = QRect(clipRect.x() * num / denom,
+                         clipRect.y() * num / denom,
+                         clipRect.width() * num / denom,
+                         clipRect.height() * num / denom);
             clip = clip.intersected(imageRect);
         }
 
@@ -377,6 +449,26 @@ static bool read_jpeg_image(QImage *outImage,
 
             (void) jpeg_start_decompress(info);
 
+            int xoffset = 0;
+#if defined(LIBJPEG_TURBO_VERSION_NUMBER) && LIBJPEG_TURBO_VERSION_NUMBER >= 1005000
+            // Only decode the iMCU columns covering the clip region, and skip
+            // the lines above it without upsampling or color converting them.
+            // The crop is a pixel wider on each side, so that fancy upsampling
+            // sees the same neighbors as when decoding the whole width. The
+            // merged upsampler used without fancy upsampling cannot skip lines.
+            // Other libjpeg versions decode everything and copy the clip region.
+            if (clip != imageRect && info->do_fancy_upsampling) {
+                const int cropLeft = qMax(0, clip.x() - 1);
+                const int cropRight = qMin(imageRect.right(), clip.right() + 1);
+                JDIMENSION cropX = cropLeft;
+                JDIMENSION cropWidth = cropRight - cropLeft + 1;
+                jpeg_crop_scanline(info, &cropX, &cropWidth);
+                xoffset = int(cropX);
+                if (clip.y() > 0)
+                    (void) jpeg_skip_scanlines(info, clip.y());
+            }
+#endif
+
             while (info->output_scanline < info->output_height) {
                 int y = int(info->output_scanline) - clip.y();
                 if (y >= clip.height())
@@ -387,25 +479,8 @@ static bool read_jpeg_image(QImage *outImage,
                 if (y < 0)
                     continue;   // Haven't reached the starting line yet.
 
-                if (info->output_components == 3) {
-                    uchar *in = rows[0] + clip.x() * 3;
-                    QRgb *out = (QRgb*)outImage->scanLine(y);
-                    converter(out, in, clip.width());
-                } else if (info->out_color_space == JCS_CMYK) {
-                    // Convert CMYK->RGB.
-                    uchar *in = rows[0] + clip.x() * 4;
-                    QRgb *out = (QRgb*)outImage->scanLine(y);
-                    for (int i = 0; i < clip.width(); ++i) {
-                        int k = in[3];
-                        *out++ = qRgb(k * in[0] / 255, k * in[1] / 255,
-                                      k * in[2] / 255);
-                        in += 4;
-                    }
-                } else if (info->output_components == 1) {
-                    // Grayscale.
-                    memcpy(outImage->scanLine(y),
-                           rows[0] + clip.x(), clip.width());
-                }
+                copy_jpeg_scanline(outImage->scanLine(y), rows[0] + (clip.x() - xoffset) * info->output_components,
+                                   clip.width(), info, converter);
             }
         } else {
             // Load unclipped grayscale data directly into the QImage.
@@ -419,13 +494,7 @@ static bool read_jpeg_image(QImage *outImage,
         if (info->output_scanline == info->output_height)
             (void) jpeg_finish_decompress(info);
 
-        if (info->density_unit == 1) {
-            outImage->setDotsPerMeterX(int(100. * info->X_density / 2.54));
-            outImage->setDotsPerMeterY(int(100. * info->Y_density / 2.54));
-        } else if (info->density_unit == 2) {
-            outImage->setDotsPerMeterX(int(100. * info->X_density));
-            outImage->setDotsPerMeterY(int(100. * info->Y_density));
-        }
+        read_jpeg_density(outImage, info);
 
         if (scaledSize.isValid() && scaledSize != clip.size()) {
             *outImage = outImage->scaled(scaledSize, Qt::IgnoreAspectRatio, quality >= HIGH_QUALITY_THRESHOLD ? Qt::SmoothTransformation : Qt::FastTransformation);
@@ -745,14 +814,17 @@ class QJpegHandlerPrivate
 public:
     enum State {
         Ready,
+        ReadingHeader,
         ReadHeader,
+        ReadingScanLines,
         ReadingEnd,
         Error
     };
 
     QJpegHandlerPrivate(QJpegHandler *qq)
         : quality(75), transformation(QImageIOHandler::TransformationNone), iod_src(nullptr),
-          rgb888ToRgb32ConverterPtr(qt_convert_rgb888_to_rgb32), state(Ready), optimize(false), progressive(false), q(qq)
+          scanLineBuffer(nullptr), rgb888ToRgb32ConverterPtr(qt_convert_rgb888_to_rgb32), state(Ready),
+          optimize(false), progressive(false), progressiveRead(false), decompressStarted(false), q(qq)
     {}
 
     ~QJpegHandlerPrivate()
@@ -767,6 +839,8 @@ public:
 
     bool readJpegHeader(QIODevice*);
     bool read(QImage *image);
+    int readScanLines(QImage *image, int maxLines);
+    void setMetaData(QImage *image) const;
 
     int quality;
     QImageIOHandler::Transformations transformation;
@@ -782,6 +856,7 @@ public:
     struct jpeg_decompress_struct info;
     struct my_jpeg_source_mgr * iod_src;
     struct my_error_mgr err;
+    JSAMPARRAY scanLineBuffer;
 
     Rgb888ToRgb32Converter rgb888ToRgb32ConverterPtr;
 
@@ -789,6 +864,8 @@ public:
 
     bool optimize;
     bool progressive;
+    bool progressiveRead;
+    bool decompressStarted;
 
     QJpegHandler *q;
 };
@@ -929,6 +1006,8 @@ bool QJpegHandlerPrivate::readJpegHeader(QIODevice *device)
     {
         state = Error;
         iod_src = new my_jpeg_source_mgr(device);
+        // Only progressive reads wait for a sequential device to deliver more data
+        iod_src->suspendable = progressiveRead && device->isSequential();
 
         info.err = jpeg_std_error(&err);
         err.error_exit = my_error_exit;
@@ -941,8 +1020,21 @@ bool QJpegHandlerPrivate::readJpegHeader(QIODevice *device)
             jpeg_save_markers(&info, JPEG_COM, 0xFFFF);
             jpeg_save_markers(&info, JPEG_APP0 + 1, 0xFFFF); // Exif uses APP1 marker
             jpeg_save_markers(&info, JPEG_APP0 + 2, 0xFFFF); // ICC uses APP2 marker
+        }
+        else
+        {
+            return false;
+        }
+        state = ReadingHeader;
+    }
 
-            (void) jpeg_read_header(&info, TRUE);
+    if (state == ReadingHeader)
+    {
+        if (!setjmp(err.setjmp_buffer)) {
+            while (jpeg_read_header(&info, TRUE) == JPEG_SUSPENDED) {
+                if (!qt_resume_input(iod_src))
+                    return false;
+            }
 
             int width = 0;
             int height = 0;
@@ -992,6 +1084,7 @@ bool QJpegHandlerPrivate::readJpegHeader(QIODevice *device)
         }
         else
         {
+            state = Error;
             return false;
         }
     }
@@ -1000,21 +1093,29 @@ bool QJpegHandlerPrivate::readJpegHeader(QIODevice *device)
     return true;
 }
 
+void QJpegHandlerPrivate::setMetaData(QImage *image) const
+{
+    for (int i = 0; i < readTexts.size()-1; i+=2)
+        image->setText(readTexts.at(i), readTexts.at(i+1));
+
+    if (!iccProfile.isEmpty())
+        image->setColorSpace(QColorSpace::fromIccProfile(iccProfile));
+}
+
 bool QJpegHandlerPrivate::read(QImage *image)
 {
-    if(state == Ready)
+    progressiveRead = false;
+    if (iod_src)
+        iod_src->suspendable = false;
+
+    if(state == Ready || state == ReadingHeader)
         readJpegHeader(q->device());
 
     if(state == ReadHeader)
     {
         bool success = read_jpeg_image(image, scaledSize, scaledClipRect, clipRect, quality, rgb888ToRgb32ConverterPtr, &info, &err);
         if (success) {
-            for (int i = 0; i < readTexts.size()-1; i+=2)
-                image->setText(readTexts.at(i), readTexts.at(i+1));
-
-            if (!iccProfile.isEmpty())
-                image->setColorSpace(QColorSpace::fromIccProfile(iccProfile));
-
+            setMetaData(image);
             state = ReadingEnd;
             return true;
         }
@@ -1025,6 +1126,91 @@ bool QJpegHandlerPrivate::read(QImage *image)
     return false;
 }
 
+/*!
+    \internal
+
+    Decodes up to \a maxLines scanlines straight into \a image, returning
+    early when a sequential device runs out of data.
+*/
+int QJpegHandlerPrivate::readScanLines(QImage *image, int maxLines)
+{
+    if (state == Ready || state == ReadingHeader) {
+        progressiveRead = true;
+        if (!readJpegHeader(q->device()))
+            return state == Error ? -1 : 0;
+    }
+
+    if (state == ReadHeader) {
+        // Scaling and clipping need the whole image
+        if (!scaledSize.isEmpty() || !scaledClipRect.isEmpty() || !clipRect.isEmpty())
+            return read(image) ? image->height() : -1;
+
+        if (!setjmp(err.setjmp_buffer)) {
+            // If high quality not required, use fast decompression
+            if (quality >= 0 && quality < HIGH_QUALITY_THRESHOLD) {
+                info.dct_method = JDCT_IFAST;
+                info.do_fancy_upsampling = FALSE;
+            }
+
+            (void) jpeg_calc_output_dimensions(&info);
+            if (!ensureValidImage(image, &info, QSize(info.output_width, info.output_height)))
+                longjmp(err.setjmp_buffer, 1);
+
+            // Grayscale is decoded straight into the image, anything else
+            // goes through a row owned by the jpeg library.
+            if (info.output_components != 1) {
+                scanLineBuffer = (info.mem->alloc_sarray)((j_common_ptr)&info, JPOOL_IMAGE,
+                                                          info.output_width * info.output_components, 1);
+            }
+            state = ReadingScanLines;
+        } else {
+            state = Error;
+            return -1;
+        }
+    }
+
+    if (state != ReadingScanLines)
+        return -1;
+
+    if (!setjmp(err.setjmp_buffer)) {
+        // Multi-scan images are buffered completely before the first scanline
+        while (!decompressStarted) {
+            decompressStarted = jpeg_start_decompress(&info);
+            if (!decompressStarted && !qt_resume_input(iod_src))
+                return 0;
+        }
+
+        const int height = int(info.output_height);
+        const int end = maxLines < 0 ? height : int(qMin<qint64>(height, qint64(info.output_scanline) + maxLines));
+        while (int(info.output_scanline) < end) {
+            const int y = int(info.output_scanline);
+            JSAMPROW row = scanLineBuffer ? scanLineBuffer[0] : image->scanLine(y);
+            if (jpeg_read_scanlines(&info, &row, 1) != 1) {
+                if (qt_resume_input(iod_src))
+                    continue;
+                return y;
+            }
+            if (scanLineBuffer)
+                copy_jpeg_scanline(image->scanLine(y), row, image->width(), &info, rgb888ToRgb32ConverterPtr);
+        }
+        if (int(info.output_scanline) < height)
+            return int(info.output_scanline);
+
+        // Nothing after the last scanline affects the image, so don't
+        // wait for the EOI marker on a sequential device.
+        if (!iod_src->suspendable)
+            (void) jpeg_finish_decompress(&info);
+
+        read_jpeg_density(image, &info);
+        setMetaData(image);
+        state = ReadingEnd;
+        return height;
+    }
+
+    state = Error;
+    return -1;
+}
+
 Q_GUI_EXPORT void QT_FASTCALL qt_convert_rgb888_to_rgb32_neon(quint32 *dst, const uchar *src, int len);
 Q_GUI_EXPORT void QT_FASTCALL qt_convert_rgb888_to_rgb32_ssse3(quint32 *dst, const uchar *src, int len);
 extern "C" void qt_convert_rgb888_to_rgb32_mips_dspr2_asm(quint32 *dst, const uchar *src, int len);
@@ -1089,6 +1275,22 @@ bool QJpegHandler::read(QImage *image)
     return d->read(image);
 }
 
+int QJpegHandler::readScanLines(QImage *image, int maxLines)
+{
+    // all scanlines are decoded; whatever still arrives doesn't matter
+    if (d->state == QJpegHandlerPrivate::ReadingEnd && d->progressiveRead)
+        return image->height();
+    if (d->state == QJpegHandlerPrivate::Ready && !canRead(device())) {
+        // Wait for the SOI marker to arrive
+        if (device() && device()->isSequential() && device()->isOpen() && device()->bytesAvailable() < 2)
+            return 0;
+        return -1;
+    }
+    if (!canRead())
+        return -1;
+    return d->readScanLines(image, maxLines);
+}
+
 extern void qt_imageTransform(QImage &src, QImageIOHandler::Transformations orient);
 
 bool QJpegHandler::write(const QImage &image)
@@ -1113,7 +1315,8 @@ bool QJpegHandler::supportsOption(ImageOption option) const
         || option == ImageFormat
         || option == OptimizedWrite
         || option == ProgressiveScanWrite
-        || option == ImageTransformation;
+        || option == ImageTransformation
+        || option == ProgressiveReading;
 }
 
 QVariant QJpegHandler::option(ImageOption option) const
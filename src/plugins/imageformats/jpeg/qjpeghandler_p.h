@@ -66,6 +66,7 @@ public:
 
     bool canRead() const override;
     bool read(QImage *image) override;
+    int readScanLines(QImage *image, int maxLines) override;
     bool write(const QImage &image) override;
 
 #if QT_DEPRECATED_SINCE(5, 13)
@@ -148,7 +148,9 @@ bool QXcbGlibEventDispatcher::processEvents(QEventLoop::ProcessEventsFlags flags
 QAbstractEventDispatcher *QXcbEventDispatcher::createEventDispatcher(QXcbConnection *connection)
 {
 #if QT_CONFIG(glib)
-    if (qEnvironmentVariableIsEmpty("QT_NO_GLIB") && QEventDispatcherGlib::versionSupported()) {
+    if (qEnvironmentVariableIsEmpty("QT_NO_GLIB")
+        && qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL") <= 0
+        && QEventDispatcherGlib::versionSupported()) {
         qCDebug(lcQpaXcb, "using glib dispatcher");
         return new QXcbGlibEventDispatcher(connection);
     } else
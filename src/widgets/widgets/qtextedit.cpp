@@ -282,11 +282,8 @@ static QSize documentSize(QWidgetTextControl *control)
     QSize docSize;
 
     if (QTextDocumentLayout *tlayout = qobject_cast<QTextDocumentLayout *>(layout)) {
-        docSize = tlayout->dynamicDocumentSize().toSize();
-        int percentageDone = tlayout->layoutStatus();
         // extrapolate height
-        if (percentageDone > 0)
-            docSize.setHeight(docSize.height() * 100 / percentageDone);
+        docSize = tlayout->estimatedDocumentSize().toSize();
     } else {
         docSize = layout->documentSize().toSize();
     }
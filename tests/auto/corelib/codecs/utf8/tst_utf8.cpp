@@ -29,7 +29,9 @@
 #include <QtTest/QtTest>
 
 #include <qtextcodec.h>
+#include <QCborValue>
 #include <QScopedPointer>
+#include <QtEndian>
 
 static const char utf8bom[] = "\xEF\xBB\xBF";
 
@@ -61,6 +63,11 @@ private slots:
 
     void nonCharacters_data();
     void nonCharacters();
+
+    void longText_data();
+    void longText();
+    void invalidInLongText_data();
+    void invalidInLongText();
 };
 
 void tst_Utf8::initTestCase()
@@ -273,5 +280,126 @@ void tst_Utf8::nonCharacters()
         qWarning("System codec reports failure when it shouldn't. Should report bug upstream.");
 }
 
+static QByteArray encodeUtf8(const QVector<uint> &ucs4)
+{
+    QByteArray result;
+    for (uint u : ucs4) {
+        if (u < 0x80) {
+            result += char(u);
+        } else if (u < 0x800) {
+            result += char(0xc0 | (u >> 6));
+            result += char(0x80 | (u & 0x3f));
+        } else if (u < 0x10000) {
+            result += char(0xe0 | (u >> 12));
+            result += char(0x80 | ((u >> 6) & 0x3f));
+            result += char(0x80 | (u & 0x3f));
+        } else {
+            result += char(0xf0 | (u >> 18));
+            result += char(0x80 | ((u >> 12) & 0x3f));
+            result += char(0x80 | ((u >> 6) & 0x3f));
+            result += char(0x80 | (u & 0x3f));
+        }
+    }
+    return result;
+}
+
+// QCborValue checks text strings with the same code as QString uses
+static bool isValidUtf8(const QByteArray &utf8)
+{
+    char header[5] = { char(0x7a) }; // text string with a 32-bit length
+    qToBigEndian<quint32>(utf8.size(), header + 1);
+    QCborParserError error;
+    QCborValue::fromCbor(QByteArray(header, sizeof(header)) + utf8, &error);
+    return error.error == QCborError::NoError;
+}
+
+void tst_Utf8::longText_data()
+{
+    QTest::addColumn<QVector<uint>>("ucs4");
+
+    // Long enough for the vectorized code paths, with the characters of each
+    // row at every offset from the start of a block
+    auto addRow = [](const char *name, const QVector<uint> &characters) {
+        QVector<uint> ucs4;
+        for (int i = 0; i < 200; ++i) {
+            ucs4 += characters.mid(i % characters.size());
+            ucs4 += characters.mid(0, i % characters.size());
+            for (int j = 0; j < i % 5; ++j)
+                ucs4 += 'a' + j;
+        }
+        QTest::newRow(name) << ucs4;
+    };
+    addRow("latin1", { 'G', 'r', 0xfc, 0xdf, 'e', ' ', 0xe0, ' ', 't', 'o', 'u', 's', 0xa0, 0xff, 0x80 });
+    addRow("greek", { 0x391, 0x3bb, 0x3c6, 0x3b1, 0x3b2, 0x3b7, 0x3c4, 0x3bf, ' ', 0x3c9 });
+    addRow("cyrillic", { 0x410, 0x431, 0x432, 0x433, 0x434, 0x435, ' ', 0x44f, 0x7ff });
+    addRow("cjk", { 0x4e2d, 0x6587, 0x3002, 0x65e5, 0x672c, 0x8a9e, 0x800, 0xffff, 0xfffd, 0xe000 });
+    addRow("mixed", { 'a', 0xe9, 0x20ac, 0x3b1, 0x4e2d, ' ', 0x5d0, 0x627, '.', 0xd7ff, 0xfb01 });
+    addRow("supplementary", { 0x1f600, 'a', 0x4e2d, 0x10000, 0xe9, 0x10ffff, 0x20000 });
+}
+
+void tst_Utf8::longText()
+{
+    QFETCH(QVector<uint>, ucs4);
+
+    const QByteArray utf8 = encodeUtf8(ucs4);
+    const QString utf16 = QString::fromUcs4(ucs4.constData(), ucs4.size());
+    QCOMPARE(to8Bit(utf16), utf8);
+    QCOMPARE(from8Bit(utf8), utf16);
+    QVERIFY(isValidUtf8(utf8));
+
+    // and from every offset, with the codec keeping state across the pieces
+    const QScopedPointer<QTextDecoder> decoder(codec->makeDecoder());
+    const QScopedPointer<QTextEncoder> encoder(codec->makeEncoder());
+    QString decoded;
+    QByteArray encoded;
+    for (int i = 0; i < 64; ++i) {
+        if ((utf8.at(i) & 0xc0) != 0x80) {
+            const QString tail = from8Bit(utf8.mid(i));
+            QCOMPARE(tail, utf16.right(tail.size()));
+        }
+        decoded += decoder->toUnicode(utf8.mid(i * 37, 37));
+        encoded += encoder->fromUnicode(utf16.mid(i * 41, 41));
+    }
+    decoded += decoder->toUnicode(utf8.mid(64 * 37));
+    encoded += encoder->fromUnicode(utf16.mid(64 * 41));
+    QVERIFY(!decoder->hasFailure());
+    QVERIFY(!encoder->hasFailure());
+    QCOMPARE(decoded, utf16);
+    if (encoded.startsWith(utf8bom))
+        encoded = encoded.mid(int(strlen(utf8bom)));
+    QCOMPARE(encoded, utf8);
+}
+
+void tst_Utf8::invalidInLongText_data()
+{
+    QTest::addColumn<QByteArray>("utf8");
+
+    extern void loadInvalidUtf8Rows();
+    loadInvalidUtf8Rows();
+}
+
+void tst_Utf8::invalidInLongText()
+{
+    QFETCH(QByteArray, utf8);
+    QFETCH_GLOBAL(bool, useLocale);
+    if (useLocale)
+        QSKIP("Only our own decoder is tested here");
+
+    // An invalid sequence in the middle of valid text is decoded the same as on its own,
+    // wherever it falls in the blocks of the vectorized code
+    const QByteArray text = QString::fromUcs4(U"Gr\u00fc\u00dfe \u03b1\u03b2\u03b3 \u4e2d\u6587 \u0430\u0431\u0432 ").toUtf8();
+    const QString invalid = from8Bit(utf8 + 'X');
+    const QByteArray after = text.repeated(2);
+    for (int prefix = 0; prefix < 40; ++prefix) {
+        // end the text before on a character boundary
+        if ((after.at(prefix) & 0xc0) == 0x80)
+            continue;
+        const QByteArray before = after.left(prefix);
+        const QByteArray whole = before + utf8 + 'X' + after;
+        QCOMPARE(from8Bit(whole), from8Bit(before) + invalid + from8Bit(after));
+        QVERIFY(!isValidUtf8(whole));
+    }
+}
+
 QTEST_MAIN(tst_Utf8)
 #include "tst_utf8.moc"
@@ -59,6 +59,8 @@ private slots:
     void skip();
     void skipAfterPeek_data();
     void skipAfterPeek();
+    void readChunk_data();
+    void readChunk();
 
     void transaction_data();
     void transaction();
@@ -722,6 +724,72 @@ void tst_QIODevice::skipAfterPeek()
     QCOMPARE(readSoFar, data.size());
 }
 
+void tst_QIODevice::readChunk_data()
+{
+    QTest::addColumn<bool>("sequential");
+    QTest::addColumn<QByteArray>("data");
+
+    QByteArray bigData;
+    bigData.reserve(100000);
+    for (int i = 0; i < 100000; ++i)
+        bigData.append(char('a' + i % 26));
+
+    QTest::newRow("sequential/small") << true << QByteArray("Hello world!");
+    QTest::newRow("sequential/big") << true << bigData;
+    QTest::newRow("random-access/small") << false << QByteArray("Hello world!");
+    QTest::newRow("random-access/big") << false << bigData;
+}
+
+// Test that readChunk() returns all data, with and without a size limit,
+// and interoperates with the copying read functions
+void tst_QIODevice::readChunk()
+{
+    QFETCH(bool, sequential);
+    QFETCH(QByteArray, data);
+
+    QScopedPointer<QIODevice> dev(sequential ? (QIODevice *) new SequentialReadBuffer(&data)
+                                             : (QIODevice *) new QBuffer(&data));
+    QVERIFY(dev->open(QIODevice::ReadOnly));
+
+    char c;
+    QVERIFY(dev->getChar(&c));
+    QByteArray result(1, c);
+    QCOMPARE(dev->peek(4), data.mid(1, 4));
+
+    forever {
+        const QByteArray chunk = dev->readChunk();
+        if (chunk.isEmpty())
+            break;
+        QVERIFY(chunk.size() <= qMax(data.size(), 16384));
+        result += chunk;
+        if (!sequential)
+            QCOMPARE(dev->pos(), qint64(result.size()));
+
+        // alternate with limited and copying reads
+        const QByteArray limited = dev->readChunk(100);
+        QVERIFY(limited.size() <= 100);
+        result += limited;
+        result += dev->read(10);
+    }
+    QCOMPARE(result.size(), data.size());
+    QCOMPARE(result, data);
+    QVERIFY(dev->atEnd());
+
+    // in a transaction, the data must stay in the device
+    if (sequential) {
+        QByteArray moreData("more data");
+        dev.reset(new SequentialReadBuffer(&moreData));
+        QVERIFY(dev->open(QIODevice::ReadOnly));
+    } else {
+        QVERIFY(dev->seek(0));
+    }
+    const QByteArray expected = sequential ? QByteArray("more data") : data;
+    dev->startTransaction();
+    QCOMPARE(dev->readChunk(), expected.left(qMin(expected.size(), 16384)));
+    dev->rollbackTransaction();
+    QCOMPARE(dev->readAll(), expected);
+}
+
 void tst_QIODevice::transaction_data()
 {
     QTest::addColumn<bool>("sequential");
@@ -45,9 +45,7 @@
 # include <QProcess>
 #endif
 #include "qobject.h"
-#ifdef QT_BUILD_INTERNAL
 #include <private/qobject_p.h>
-#endif
 
 #include <math.h>
 
@@ -154,6 +152,8 @@ private slots:
     void nullReceiver();
     void functorReferencesConnection();
     void disconnectDisconnects();
+    void queuedCallsWhileMovingThreads();
+    void pooledEvents();
 };
 
 struct QObjectCreatedOnShutdown
@@ -7592,6 +7592,125 @@ void tst_QObject::disconnectDisconnects()
     QCOMPARE(count, 3); // + δ
 }
 
+void tst_QObject::queuedCallsWhileMovingThreads()
+{
+    const int senderCount = 4;
+    const int count = 2000;
+
+    MoveToThreadThread threads[2];
+    threads[0].start();
+    threads[1].start();
+
+    SenderObject sender;
+    QObject *receiver = new QObject;
+    receiver->moveToThread(&threads[0]);
+    QAtomicInt received = 0;
+    connect(&sender, &SenderObject::signal1, receiver, [&] {
+        // hop to the other thread every now and then, while the calls keep coming
+        const int i = received.fetchAndAddRelaxed(1) + 1;
+        if (i % 50 == 0)
+            receiver->moveToThread(&threads[(i / 50) % 2]);
+    }, Qt::QueuedConnection);
+
+    QList<QThread *> senders;
+    for (int i = 0; i < senderCount; ++i) {
+        senders.append(QThread::create([&sender] {
+            for (int i = 0; i < count; ++i)
+                emit sender.signal1();
+        }));
+        senders.last()->start();
+    }
+    for (QThread *thread : qAsConst(senders))
+        QVERIFY(thread->wait());
+    qDeleteAll(senders);
+
+    // every call arrives exactly once, wherever the receiver was when it was posted
+    QTRY_COMPARE(received.loadRelaxed(), senderCount * count);
+    QTest::qWait(10);
+    QCOMPARE(received.loadRelaxed(), senderCount * count);
+
+    QThread *mainThread = QThread::currentThread();
+    QMetaObject::invokeMethod(receiver, [receiver, mainThread] {
+        receiver->moveToThread(mainThread);
+    }, Qt::BlockingQueuedConnection);
+    delete receiver;
+
+    for (MoveToThreadThread &thread : threads) {
+        thread.quit();
+        QVERIFY(thread.wait());
+    }
+}
+
+class LargeMetaCallEvent : public QAbstractMetaCallEvent
+{
+public:
+    explicit LargeMetaCallEvent(bool *called)
+        : QAbstractMetaCallEvent(nullptr, -1), called(called)
+    {
+        memset(payload, 0x55, sizeof(payload));
+    }
+
+    void placeMetaCall(QObject *) override
+    {
+        *called = payload[0] == 0x55 && payload[sizeof(payload) - 1] == 0x55;
+    }
+
+private:
+    bool *called;
+    char payload[2 * QEventPool::SlotSize];
+};
+
+void tst_QObject::pooledEvents()
+{
+    const QEventPool::Statistics before = QEventPool::statistics();
+    const int count = 1000;
+
+    // queued calls allocated in one thread and freed in another
+    int received = 0;
+    QString lastText;
+    {
+        SenderObject sender;
+        QObject receiver;
+        connect(&sender, &SenderObject::signal7, &receiver,
+                [&](int i, const QString &text) {
+                    QCOMPARE(i, received);
+                    lastText = text;
+                    ++received;
+                }, Qt::QueuedConnection);
+
+        QScopedPointer<QThread> thread(QThread::create([&sender] {
+            for (int i = 0; i < count; ++i)
+                emit sender.signal7(i, QString::number(i));
+        }));
+        thread->start();
+        QVERIFY(thread->wait());
+        QTRY_COMPARE(received, count);
+        QCOMPARE(lastText, QString::number(count - 1));
+    }
+
+    // deferred deletes allocated and freed in the same thread
+    QVector<QPointer<QObject>> objects;
+    for (int i = 0; i < count; ++i) {
+        objects.append(new QObject);
+        objects.last()->deleteLater();
+    }
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    for (const QPointer<QObject> &object : qAsConst(objects))
+        QVERIFY(object.isNull());
+
+    // events larger than a pool slot
+    bool called = false;
+    QObject target;
+    QCoreApplication::postEvent(&target, new LargeMetaCallEvent(&called));
+    QCoreApplication::sendPostedEvents(&target, QEvent::MetaCall);
+    QVERIFY(called);
+
+    const QEventPool::Statistics after = QEventPool::statistics();
+    QVERIFY(after.allocations + after.heapAllocations
+            >= before.allocations + before.heapAllocations + 2 * count + 1);
+    QVERIFY(after.heapAllocations > before.heapAllocations);
+}
+
 // Test for QtPrivate::HasQ_OBJECT_Macro
 Q_STATIC_ASSERT(QtPrivate::HasQ_OBJECT_Macro<tst_QObject>::Value);
 Q_STATIC_ASSERT(!QtPrivate::HasQ_OBJECT_Macro<SiblingDeleter>::Value);
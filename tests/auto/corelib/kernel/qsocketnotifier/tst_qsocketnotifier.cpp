@@ -33,6 +33,9 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QTimer>
 #include <QtCore/QSocketNotifier>
+#include <QtCore/QScopeGuard>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QThread>
 #include <QtNetwork/QTcpServer>
 #include <QtNetwork/QTcpSocket>
 #include <QtNetwork/QUdpSocket>
@@ -61,6 +64,9 @@ private slots:
     void mixingWithTimers();
 #ifdef Q_OS_UNIX
     void posixSockets();
+#endif
+#ifdef Q_OS_LINUX
+    void epollDispatcher();
 #endif
     void asyncMultipleDatagram();
 
@@ -325,6 +331,80 @@ void tst_QSocketNotifier::posixSockets()
 }
 #endif
 
+#ifdef Q_OS_LINUX
+void tst_QSocketNotifier::epollDispatcher()
+{
+    // the variable is read when a thread creates its event dispatcher
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+    auto restoreEnvironment = qScopeGuard([] { qunsetenv("QT_EVENT_DISPATCHER_EPOLL"); });
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+
+    QByteArray dispatcherClass;
+    int readCounts[5] = {};
+    int writeCount = 0;
+    int fileCount = 0;
+
+    QScopedPointer<QThread> thread(QThread::create([&] {
+        dispatcherClass = QThread::currentThread()->eventDispatcher()->metaObject()->className();
+
+        int fds[2];
+        if (::pipe(fds) == -1)
+            return;
+
+        {
+            int reads = 0;
+            QSocketNotifier reader(fds[0], QSocketNotifier::Read);
+            QObject::connect(&reader, &QSocketNotifier::activated, [&] { ++reads; });
+
+            char c = 0;
+            auto step = [&](int index) {
+                QCoreApplication::processEvents();
+                readCounts[index] = reads;
+            };
+
+            step(0);                            // nothing to read yet
+            qt_safe_write(fds[1], &c, 1);
+            step(1);                            // one activation
+            step(2);                            // still readable: level-triggered
+            (void) qt_safe_read(fds[0], &c, 1);
+            step(3);                            // drained
+
+            reader.setEnabled(false);
+            qt_safe_write(fds[1], &c, 1);
+            QCoreApplication::processEvents();
+            reader.setEnabled(true);
+            step(4);                            // re-registered while readable
+
+            // a second notifier type on another descriptor
+            QSocketNotifier writer(fds[1], QSocketNotifier::Write);
+            QObject::connect(&writer, &QSocketNotifier::activated, [&] { ++writeCount; });
+            QCoreApplication::processEvents();
+
+            // regular files cannot be added to an epoll set, but still work
+            QSocketNotifier fileNotifier(file.handle(), QSocketNotifier::Read);
+            QObject::connect(&fileNotifier, &QSocketNotifier::activated, [&] { ++fileCount; });
+            QCoreApplication::processEvents();
+        }
+
+        qt_safe_close(fds[0]);
+        qt_safe_close(fds[1]);
+    }));
+    thread->start();
+    QVERIFY(thread->wait(30000));
+
+    QCOMPARE(dispatcherClass, QByteArray("QEventDispatcherUNIX"));
+    QCOMPARE(readCounts[0], 0);
+    QCOMPARE(readCounts[1], 1);
+    QCOMPARE(readCounts[2], 2);
+    QCOMPARE(readCounts[3], 2);
+    QCOMPARE(readCounts[4], 3);
+    QVERIFY(writeCount > 0);
+    QVERIFY(fileCount > 0);
+}
+#endif
+
 void tst_QSocketNotifier::async_readDatagramSlot()
 {
     char buf[1];
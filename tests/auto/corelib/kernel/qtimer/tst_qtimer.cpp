@@ -84,6 +84,7 @@ private slots:
     void timerOrder_data();
     void timerOrderBackgroundThread();
     void timerOrderBackgroundThread_data() { timerOrder_data(); }
+    void manyTimersOrder();
 
     void dontBlockEvents();
     void postedEventsShouldNotStarveTimers();
@@ -1126,6 +1127,51 @@ void tst_QTimer::timerOrderBackgroundThread()
 #endif
 }
 
+class TimerOrderRecorder : public QObject
+{
+public:
+    QVector<int> fired;
+
+protected:
+    void timerEvent(QTimerEvent *e) override
+    {
+        killTimer(e->timerId());
+        fired.append(e->timerId());
+    }
+};
+
+void tst_QTimer::manyTimersOrder()
+{
+    // Groups of timers with widely spaced intervals, started in shuffled
+    // order. Each group must fire after the previous one, and the timers
+    // of a group in the order they were started.
+    const int groups = 10;
+    const int perGroup = 50;
+    TimerOrderRecorder recorder;
+    QVector<QVector<int>> expected(groups);
+    for (int i = 0; i < groups * perGroup; ++i) {
+        const int group = (i * 7) % groups;
+        const int id = recorder.startTimer(group * 20, Qt::PreciseTimer);
+        QVERIFY(id > 0);
+        expected[group].append(id);
+    }
+
+    // stopping timers in the middle of the set must not disturb the others
+    for (auto &ids : expected) {
+        for (int i = ids.size() - 1; i >= 0; i -= 3) {
+            recorder.killTimer(ids.at(i));
+            ids.removeAt(i);
+        }
+    }
+
+    QVector<int> expectedOrder;
+    for (const auto &ids : qAsConst(expected))
+        expectedOrder += ids;
+
+    QTRY_COMPARE(recorder.fired.size(), expectedOrder.size());
+    QCOMPARE(recorder.fired, expectedOrder);
+}
+
 struct StaticSingleShotUser
 {
     StaticSingleShotUser()
@@ -0,0 +1,368 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/qbuffer.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qjsonstreamreader.h>
+
+class tst_QJsonStreamReader : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void tokens_data();
+    void tokens();
+    void tokensIncremental_data() { tokens_data(); }
+    void tokensIncremental();
+    void strings_data();
+    void strings();
+    void numbers_data();
+    void numbers();
+    void newlineDelimited();
+    void readValue_data();
+    void readValue();
+    void readValueIncremental_data() { readValue_data(); }
+    void readValueIncremental();
+    void skipValue();
+    void device();
+    void errors_data();
+    void errors();
+};
+
+typedef QJsonStreamReader R;
+
+static QString tokenString(const QJsonStreamReader &reader)
+{
+    const QMetaEnum me = QMetaEnum::fromType<QJsonStreamReader::TokenType>();
+    QString result = QString::fromLatin1(me.valueToKey(reader.tokenType()));
+    switch (reader.tokenType()) {
+    case R::Name:
+    case R::String:
+        return result + QLatin1Char(':') + reader.text();
+    case R::Number:
+        return result + QLatin1Char(':') + QString::number(reader.toDouble());
+    case R::Bool:
+        return result + QLatin1String(reader.toBool() ? ":true" : ":false");
+    default:
+        return result;
+    }
+}
+
+static QString tokenList(QJsonStreamReader &reader)
+{
+    QStringList result;
+    while (!reader.atEnd()) {
+        if (reader.readNext() != QJsonStreamReader::NoToken)
+            result << tokenString(reader);
+    }
+    return result.join(QLatin1Char(' '));
+}
+
+void tst_QJsonStreamReader::tokens_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("empty-array") << QByteArray("[]") << "StartArray EndArray";
+    QTest::newRow("empty-object") << QByteArray(" { } ") << "StartObject EndObject";
+    QTest::newRow("scalars")
+            << QByteArray("[true, false, null, 1, \"a\"]")
+            << "StartArray Bool:true Bool:false Null Number:1 String:a EndArray";
+    QTest::newRow("object")
+            << QByteArray("{\"a\": 1, \"b\": [2, {\"c\": null}]}")
+            << "StartObject Name:a Number:1 Name:b StartArray Number:2 StartObject Name:c Null "
+               "EndObject EndArray EndObject";
+    QTest::newRow("top-level-number") << QByteArray("42") << "Number:42";
+    QTest::newRow("top-level-string") << QByteArray("\"x\"") << "String:x";
+    QTest::newRow("multiple-top-level")
+            << QByteArray("{}\n[1]\n\"s\"\n")
+            << "StartObject EndObject StartArray Number:1 EndArray String:s";
+}
+
+void tst_QJsonStreamReader::tokens()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QString, expected);
+
+    QJsonStreamReader reader(data);
+    QCOMPARE(tokenList(reader), expected);
+    QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+    QVERIFY(reader.atEnd());
+    QCOMPARE(reader.depth(), 0);
+}
+
+void tst_QJsonStreamReader::tokensIncremental()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QString, expected);
+
+    // feed one byte at a time; the reader has to resume in the middle of
+    // every kind of token. The trailing newline terminates a top-level
+    // number, which otherwise could continue with the next chunk.
+    data += '\n';
+    QJsonStreamReader reader;
+    QStringList result;
+    for (char c : qAsConst(data)) {
+        reader.addData(&c, 1);
+        while (reader.readNext() != QJsonStreamReader::NoToken && !reader.hasError())
+            result << tokenString(reader);
+        QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+    }
+    QCOMPARE(result.join(QLatin1Char(' ')), expected);
+}
+
+void tst_QJsonStreamReader::strings_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("empty") << QByteArray("\"\"") << QString();
+    QTest::newRow("ascii") << QByteArray("\"hello\"") << QString("hello");
+    QTest::newRow("escapes") << QByteArray("\"a\\\"b\\\\c\\/d\\n\\t\"") << QString("a\"b\\c/d\n\t");
+    QTest::newRow("unicode-escape") << QByteArray("\"\\u00e9\\u4e2d\"")
+                                    << QString::fromUtf8("\xc3\xa9\xe4\xb8\xad");
+    QTest::newRow("surrogates") << QByteArray("\"\\ud83d\\ude00\"")
+                                << QString::fromUtf8("\xf0\x9f\x98\x80");
+    QTest::newRow("utf8") << QByteArray("\"\xc3\xa9t\xc3\xa9\"") << QString::fromUtf8("\xc3\xa9t\xc3\xa9");
+    QTest::newRow("utf8-and-escape") << QByteArray("\"\xc3\xa9\\n\"") << QString::fromUtf8("\xc3\xa9\n");
+}
+
+void tst_QJsonStreamReader::strings()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QString, expected);
+
+    QJsonStreamReader reader(data);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.text(), expected);
+
+    QJsonStreamReader incremental;
+    for (char c : qAsConst(data)) {
+        incremental.addData(&c, 1);
+        if (incremental.readNext() == QJsonStreamReader::String)
+            break;
+    }
+    QCOMPARE(incremental.tokenType(), QJsonStreamReader::String);
+    QCOMPARE(incremental.text(), expected);
+}
+
+void tst_QJsonStreamReader::numbers_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<bool>("isInteger");
+    QTest::addColumn<qint64>("integer");
+    QTest::addColumn<double>("value");
+
+    QTest::newRow("zero") << QByteArray("0") << true << Q_INT64_C(0) << 0.;
+    QTest::newRow("negative") << QByteArray("-17") << true << Q_INT64_C(-17) << -17.;
+    QTest::newRow("large") << QByteArray("9007199254740993") << true
+                           << Q_INT64_C(9007199254740993) << 9007199254740992.;
+    QTest::newRow("fraction") << QByteArray("1.5") << false << Q_INT64_C(0) << 1.5;
+    QTest::newRow("exponent") << QByteArray("-2.5e-3") << false << Q_INT64_C(0) << -0.0025;
+    QTest::newRow("integral-exponent") << QByteArray("2.5E3") << true << Q_INT64_C(2500) << 2500.;
+}
+
+void tst_QJsonStreamReader::numbers()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(bool, isInteger);
+    QFETCH(qint64, integer);
+    QFETCH(double, value);
+
+    QJsonStreamReader reader('[' + data + ']');
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.isInteger(), isInteger);
+    QCOMPARE(reader.toDouble(), value);
+    if (isInteger)
+        QCOMPARE(reader.toInteger(), integer);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+}
+
+void tst_QJsonStreamReader::newlineDelimited()
+{
+    QByteArray data;
+    for (int i = 0; i < 1000; ++i)
+        data += "{\"id\":" + QByteArray::number(i) + ",\"tags\":[\"a\",\"b\"]}\n";
+
+    // alternate between reading records token by token and as a whole
+    QJsonStreamReader reader(data);
+    int count = 0;
+    while (reader.readNext() == QJsonStreamReader::StartObject) {
+        if (count % 2) {
+            const QJsonObject record = reader.readValue().toObject();
+            QCOMPARE(record.value("id").toInt(), count);
+            QCOMPARE(record.value("tags").toArray().size(), 2);
+        } else {
+            QCOMPARE(reader.depth(), 1);
+            QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+            QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+            QCOMPARE(reader.toInteger(), qint64(count));
+            QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+            QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+            QVERIFY(reader.skipValue());
+            QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+        }
+        QCOMPARE(reader.depth(), 0);
+        ++count;
+    }
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.hasError());
+    QCOMPARE(count, 1000);
+}
+
+void tst_QJsonStreamReader::readValue_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QTest::newRow("array") << QByteArray("[1, \"two\", [3.5], {\"four\": null}, true]");
+    QTest::newRow("object")
+            << QByteArray("{\"a\": {\"b\": {\"c\": [1, 2, 3]}}, \"d\": \"\\u00e9\", \"e\": false}");
+    QTest::newRow("empty-containers") << QByteArray("[[], {}, [{}]]");
+}
+
+void tst_QJsonStreamReader::readValue()
+{
+    QFETCH(QByteArray, data);
+    const QJsonDocument expected = QJsonDocument::fromJson(data);
+    QVERIFY(!expected.isNull());
+
+    QJsonStreamReader reader(data);
+    reader.readNext();
+    QJsonValue v = reader.readValue();
+    QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+    if (expected.isArray())
+        QCOMPARE(v.toArray(), expected.array());
+    else
+        QCOMPARE(v.toObject(), expected.object());
+    QCOMPARE(reader.depth(), 0);
+}
+
+void tst_QJsonStreamReader::readValueIncremental()
+{
+    QFETCH(QByteArray, data);
+    const QJsonDocument expected = QJsonDocument::fromJson(data);
+
+    QJsonStreamReader reader;
+    QJsonValue v = QJsonValue::Undefined;
+    bool started = false;
+    for (char c : qAsConst(data)) {
+        reader.addData(&c, 1);
+        if (!started) {
+            started = reader.readNext() != QJsonStreamReader::NoToken;
+            if (!started)
+                continue;
+        }
+        v = reader.readValue();
+        QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+        if (!v.isUndefined())
+            break;
+    }
+    if (expected.isArray())
+        QCOMPARE(v.toArray(), expected.array());
+    else
+        QCOMPARE(v.toObject(), expected.object());
+}
+
+void tst_QJsonStreamReader::skipValue()
+{
+    QJsonStreamReader reader(QByteArray("[{\"a\": [1, 2, {\"b\": \"]\"}]}, 7]"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QVERIFY(reader.skipValue());
+    QCOMPARE(reader.depth(), 1);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(), qint64(7));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+}
+
+void tst_QJsonStreamReader::device()
+{
+    QByteArray data;
+    for (int i = 0; i < 20000; ++i)
+        data += "[" + QByteArray::number(i) + ",\"" + QByteArray(i % 50, 'x') + "\"]\n";
+
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.device(), &buffer);
+
+    int count = 0;
+    while (reader.readNext() == QJsonStreamReader::StartArray) {
+        const QJsonArray a = reader.readValue().toArray();
+        QCOMPARE(a.at(0).toInt(), count);
+        QCOMPARE(a.at(1).toString().size(), count % 50);
+        ++count;
+    }
+    QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+    QCOMPARE(count, 20000);
+    QCOMPARE(reader.currentOffset(), qint64(data.size()));
+}
+
+void tst_QJsonStreamReader::errors_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<int>("error");
+
+    QTest::newRow("missing-comma") << QByteArray("[1 2]") << int(QJsonParseError::MissingValueSeparator);
+    QTest::newRow("missing-colon") << QByteArray("{\"a\" 1}") << int(QJsonParseError::MissingNameSeparator);
+    QTest::newRow("unterminated-array") << QByteArray("[1, 2") << int(QJsonParseError::UnterminatedArray);
+    QTest::newRow("unterminated-object") << QByteArray("{\"a\": 1") << int(QJsonParseError::UnterminatedObject);
+    QTest::newRow("unterminated-string") << QByteArray("[\"abc") << int(QJsonParseError::UnterminatedString);
+    QTest::newRow("bad-literal") << QByteArray("[tru]") << int(QJsonParseError::IllegalValue);
+    QTest::newRow("bad-number") << QByteArray("[01]") << int(QJsonParseError::MissingValueSeparator);
+    QTest::newRow("bad-escape") << QByteArray("[\"\\u12\"]") << int(QJsonParseError::IllegalEscapeSequence);
+    QTest::newRow("huge-number") << QByteArray("[1e400]") << int(QJsonParseError::IllegalNumber);
+    QTest::newRow("trailing-comma") << QByteArray("[1,]") << int(QJsonParseError::IllegalValue);
+    QTest::newRow("mismatched") << QByteArray("[1}") << int(QJsonParseError::UnterminatedArray);
+    QTest::newRow("name-not-string") << QByteArray("{1: 2}") << int(QJsonParseError::UnterminatedObject);
+    QTest::newRow("deep") << QByteArray(2000, '[') << int(QJsonParseError::DeepNesting);
+}
+
+void tst_QJsonStreamReader::errors()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(int, error);
+
+    QJsonStreamReader reader(data);
+    tokenList(reader);
+    QVERIFY(reader.hasError());
+    QCOMPARE(int(reader.error()), error);
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::Invalid);
+    QVERIFY(!reader.errorString().isEmpty());
+
+    // errors are sticky
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+}
+
+QTEST_MAIN(tst_QJsonStreamReader)
+#include "tst_qjsonstreamreader.moc"
@@ -0,0 +1,215 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/qbuffer.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qjsonstreamwriter.h>
+
+class tst_QJsonStreamWriter : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void scalars();
+    void strings_data();
+    void strings();
+    void containers();
+    void writeValue_data();
+    void writeValue();
+    void writeValueIndented_data() { writeValue_data(); }
+    void writeValueIndented();
+    void newlineDelimited();
+    void device();
+};
+
+void tst_QJsonStreamWriter::scalars()
+{
+    QByteArray output;
+    {
+        QJsonStreamWriter writer(&output);
+        writer.writeStartArray();
+        writer.writeInteger(-42);
+        writer.writeDouble(1.5);
+        writer.writeDouble(qInf());
+        writer.writeBool(true);
+        writer.writeBool(false);
+        writer.writeNull();
+        writer.writeString(QLatin1String("x"));
+        writer.writeEndArray();
+        QCOMPARE(writer.depth(), 0);
+        QVERIFY(!writer.hasError());
+    }
+    QCOMPARE(output, QByteArray("[-42,1.5,null,true,false,null,\"x\"]\n"));
+}
+
+void tst_QJsonStreamWriter::strings_data()
+{
+    QTest::addColumn<QString>("string");
+
+    QTest::newRow("empty") << QString();
+    QTest::newRow("ascii") << QString("hello world");
+    QTest::newRow("escapes") << QString("quote\" backslash\\ newline\n tab\t nul") + QChar(0);
+    QTest::newRow("latin1") << QString::fromUtf8("caf\xc3\xa9");
+    QTest::newRow("bmp") << QString::fromUtf8("\xe4\xb8\xad\xe6\x96\x87");
+    QTest::newRow("surrogates") << QString::fromUtf8("\xf0\x9f\x98\x80");
+}
+
+void tst_QJsonStreamWriter::strings()
+{
+    QFETCH(QString, string);
+
+    QByteArray output;
+    {
+        QJsonStreamWriter writer(&output);
+        writer.writeStartObject();
+        writer.writeName(string);
+        writer.writeString(string);
+        writer.writeEndObject();
+    }
+
+    QJsonObject expected;
+    expected.insert(string, string);
+    QCOMPARE(output, QJsonDocument(expected).toJson(QJsonDocument::Compact) + '\n');
+}
+
+void tst_QJsonStreamWriter::containers()
+{
+    QByteArray output;
+    QJsonStreamWriter writer(&output);
+    writer.writeStartObject();
+    QCOMPARE(writer.depth(), 1);
+    writer.writeName(u"a");
+    writer.writeStartArray();
+    QCOMPARE(writer.depth(), 2);
+    writer.writeStartObject();
+    writer.writeEndObject();
+    writer.writeStartArray();
+    writer.writeEndArray();
+    writer.writeEndArray();
+    writer.writeName(QLatin1String("b"));
+    writer.writeInteger(1);
+    writer.writeEndObject();
+    QCOMPARE(writer.depth(), 0);
+    QCOMPARE(output, QByteArray("{\"a\":[{},[]],\"b\":1}\n"));
+}
+
+void tst_QJsonStreamWriter::writeValue_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("array") << QByteArray("[1, \"two\", [3.5, -4], {\"four\": null}, true]");
+    QTest::newRow("object")
+            << QByteArray("{\"a\": {\"b\": {\"c\": [1, 2, 3]}}, \"d\": \"\\u00e9\\n\", \"e\": false}");
+    QTest::newRow("empty-containers") << QByteArray("[[], {}, [{}], {\"x\": []}]");
+}
+
+void tst_QJsonStreamWriter::writeValue()
+{
+    QFETCH(QByteArray, json);
+    const QJsonDocument doc = QJsonDocument::fromJson(json);
+    QVERIFY(!doc.isNull());
+
+    QByteArray output;
+    {
+        QJsonStreamWriter writer(&output);
+        writer.writeValue(doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(doc.object()));
+    }
+    QCOMPARE(output, doc.toJson(QJsonDocument::Compact) + '\n');
+}
+
+void tst_QJsonStreamWriter::writeValueIndented()
+{
+    QFETCH(QByteArray, json);
+    const QJsonDocument doc = QJsonDocument::fromJson(json);
+
+    QByteArray output;
+    {
+        QJsonStreamWriter writer(&output);
+        writer.setFormat(QJsonDocument::Indented);
+        QCOMPARE(writer.format(), QJsonDocument::Indented);
+        writer.writeValue(doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(doc.object()));
+    }
+    QCOMPARE(output, doc.toJson(QJsonDocument::Indented));
+}
+
+void tst_QJsonStreamWriter::newlineDelimited()
+{
+    QByteArray output;
+    {
+        QJsonStreamWriter writer(&output);
+        for (int i = 0; i < 3; ++i) {
+            writer.writeStartObject();
+            writer.writeName(u"id");
+            writer.writeInteger(i);
+            writer.writeEndObject();
+        }
+        writer.writeString(u"done");
+    }
+    QCOMPARE(output, QByteArray("{\"id\":0}\n{\"id\":1}\n{\"id\":2}\n\"done\"\n"));
+}
+
+void tst_QJsonStreamWriter::device()
+{
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QJsonStreamWriter writer(&buffer);
+    QCOMPARE(writer.device(), &buffer);
+
+    writer.writeStartArray();
+    writer.writeInteger(1);
+    // output is buffered until the top-level value is complete
+    QVERIFY(writer.flush());
+    QCOMPARE(buffer.data(), QByteArray("[1"));
+
+    for (int i = 0; i < 10000; ++i)
+        writer.writeString(QLatin1String("0123456789"));
+    // large values are written out while they are being produced
+    QVERIFY(buffer.data().size() > 16 * 1024);
+
+    writer.writeEndArray();
+    QVERIFY(!writer.hasError());
+
+    const QJsonDocument doc = QJsonDocument::fromJson(buffer.data());
+    QVERIFY(doc.isArray());
+    QCOMPARE(doc.array().size(), 10001);
+    QVERIFY(buffer.data().endsWith("]\n"));
+
+    // a device that cannot be written to
+    QBuffer readOnly;
+    QVERIFY(readOnly.open(QIODevice::ReadOnly));
+    writer.setDevice(&readOnly);
+    writer.writeNull();
+    QVERIFY(!writer.flush());
+    QVERIFY(writer.hasError());
+}
+
+QTEST_MAIN(tst_QJsonStreamWriter)
+#include "tst_qjsonstreamwriter.moc"
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qmultimatcher
+QT = core testlib
+SOURCES = tst_qmultimatcher.cpp
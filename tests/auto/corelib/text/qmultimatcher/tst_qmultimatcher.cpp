@@ -0,0 +1,279 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <qbytearraymatcher.h>
+#include <qmultimatcher.h>
+#include <qstringmatcher.h>
+
+class tst_QMultiMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void defaults();
+    void byteArrayIndexIn_data();
+    void byteArrayIndexIn();
+    void stringIndexIn_data();
+    void stringIndexIn();
+    void surrogatePairs();
+    void setCaseSensitivity();
+    void copyAndAssign();
+    void compareWithSingleMatchers_data();
+    void compareWithSingleMatchers();
+};
+
+void tst_QMultiMatcher::defaults()
+{
+    int patternIndex = 42;
+    QMultiByteArrayMatcher byteMatcher;
+    QCOMPARE(byteMatcher.caseSensitivity(), Qt::CaseSensitive);
+    QVERIFY(byteMatcher.patterns().isEmpty());
+    QCOMPARE(byteMatcher.indexIn(QByteArray("foo"), 0, &patternIndex), -1);
+    QCOMPARE(patternIndex, -1);
+
+    patternIndex = 42;
+    QMultiStringMatcher stringMatcher;
+    QCOMPARE(stringMatcher.caseSensitivity(), Qt::CaseSensitive);
+    QVERIFY(stringMatcher.patterns().isEmpty());
+    QCOMPARE(stringMatcher.indexIn(u"foo", 0, &patternIndex), qsizetype(-1));
+    QCOMPARE(patternIndex, -1);
+}
+
+void tst_QMultiMatcher::byteArrayIndexIn_data()
+{
+    QTest::addColumn<QList<QByteArray>>("patterns");
+    QTest::addColumn<bool>("caseInsensitive");
+    QTest::addColumn<QByteArray>("haystack");
+    QTest::addColumn<int>("from");
+    QTest::addColumn<int>("expectedIndex");
+    QTest::addColumn<int>("expectedPattern");
+
+    const QList<QByteArray> keywords = { "error", "warning", "fatal" };
+    QTest::newRow("first") << keywords << false << QByteArray("a warning, then an error") << 0 << 2 << 1;
+    QTest::newRow("from") << keywords << false << QByteArray("a warning, then an error") << 3 << 19 << 0;
+    QTest::newRow("negative-from") << keywords << false << QByteArray("fatal") << -5 << 0 << 2;
+    QTest::newRow("from-past-end") << keywords << false << QByteArray("fatal") << 6 << -1 << -1;
+    QTest::newRow("none") << keywords << false << QByteArray("all is well") << 0 << -1 << -1;
+    QTest::newRow("case") << keywords << false << QByteArray("FATAL Error") << 0 << -1 << -1;
+    QTest::newRow("nocase") << keywords << true << QByteArray("FATAL Error") << 0 << 0 << 2;
+    QTest::newRow("nocase-non-ascii") << QList<QByteArray>{ "\xc3\xa9t\xc3\xa9" } << true
+                                      << QByteArray("\xc3\x89T\xc3\x89 \xc3\xa9T\xc3\xa9") << 0 << 6 << 0;
+
+    // the leftmost match wins even if it ends after a shorter one
+    QTest::newRow("leftmost") << QList<QByteArray>{ "bc", "abcd" } << false << QByteArray("xabcd") << 0 << 1 << 1;
+    QTest::newRow("leftmost-partial") << QList<QByteArray>{ "bc", "abcd" } << false << QByteArray("xabce") << 0 << 2 << 0;
+    QTest::newRow("longest") << QList<QByteArray>{ "ab", "abc", "a" } << false << QByteArray("xabc") << 0 << 1 << 1;
+    QTest::newRow("suffix") << QList<QByteArray>{ "he", "she", "his", "hers" } << false << QByteArray("ushers") << 0 << 1 << 1;
+    QTest::newRow("duplicate") << QList<QByteArray>{ "foo", "foo" } << false << QByteArray("foo") << 0 << 0 << 0;
+    QTest::newRow("empty") << QList<QByteArray>{ "bar", QByteArray() } << false << QByteArray("foobar") << 2 << 2 << 1;
+    QTest::newRow("empty-longer") << QList<QByteArray>{ QByteArray(), "bar" } << false << QByteArray("foobar") << 3 << 3 << 1;
+    QTest::newRow("empty-at-end") << QList<QByteArray>{ QByteArray() } << false << QByteArray("foo") << 3 << 3 << 0;
+}
+
+void tst_QMultiMatcher::byteArrayIndexIn()
+{
+    QFETCH(QList<QByteArray>, patterns);
+    QFETCH(bool, caseInsensitive);
+    QFETCH(QByteArray, haystack);
+    QFETCH(int, from);
+    QFETCH(int, expectedIndex);
+    QFETCH(int, expectedPattern);
+
+    QMultiByteArrayMatcher matcher(patterns, caseInsensitive ? Qt::CaseInsensitive : Qt::CaseSensitive);
+    QCOMPARE(matcher.patterns(), patterns);
+
+    int patternIndex = 42;
+    QCOMPARE(matcher.indexIn(haystack, from, &patternIndex), expectedIndex);
+    QCOMPARE(patternIndex, expectedPattern);
+    QCOMPARE(matcher.indexIn(haystack.constData(), haystack.size(), from), expectedIndex);
+}
+
+void tst_QMultiMatcher::stringIndexIn_data()
+{
+    QTest::addColumn<QStringList>("patterns");
+    QTest::addColumn<bool>("caseInsensitive");
+    QTest::addColumn<QString>("haystack");
+    QTest::addColumn<int>("from");
+    QTest::addColumn<int>("expectedIndex");
+    QTest::addColumn<int>("expectedPattern");
+
+    const QStringList keywords = { QStringLiteral("Fehler"), QStringLiteral("Warnung"), QStringLiteral("grüße") };
+    QTest::newRow("first") << keywords << false << QStringLiteral("eine Warnung, dann ein Fehler") << 0 << 5 << 1;
+    QTest::newRow("from") << keywords << false << QStringLiteral("eine Warnung, dann ein Fehler") << 6 << 23 << 0;
+    QTest::newRow("none") << keywords << false << QStringLiteral("alles gut") << 0 << -1 << -1;
+    QTest::newRow("case") << keywords << false << QStringLiteral("FEHLER") << 0 << -1 << -1;
+    QTest::newRow("nocase") << keywords << true << QStringLiteral("FEHLER") << 0 << 0 << 0;
+    QTest::newRow("nocase-latin1") << keywords << true << QStringLiteral("GRÜßE") << 0 << 0 << 2;
+    // MICRO SIGN folds to GREEK SMALL LETTER MU, KELVIN SIGN to 'k'
+    QTest::newRow("nocase-micro") << QStringList{ QStringLiteral("μs") } << true << QStringLiteral("10 µS") << 0 << 3 << 0;
+    QTest::newRow("nocase-kelvin") << QStringList{ QStringLiteral("300k") } << true << QStringLiteral("300K") << 0 << 0 << 0;
+    QTest::newRow("leftmost") << QStringList{ QStringLiteral("bc"), QStringLiteral("abcd") } << false << QStringLiteral("xabcd") << 0 << 1 << 1;
+    QTest::newRow("empty") << QStringList{ QString() } << false << QStringLiteral("foo") << 1 << 1 << 0;
+}
+
+void tst_QMultiMatcher::stringIndexIn()
+{
+    QFETCH(QStringList, patterns);
+    QFETCH(bool, caseInsensitive);
+    QFETCH(QString, haystack);
+    QFETCH(int, from);
+    QFETCH(int, expectedIndex);
+    QFETCH(int, expectedPattern);
+
+    QMultiStringMatcher matcher(patterns, caseInsensitive ? Qt::CaseInsensitive : Qt::CaseSensitive);
+    QCOMPARE(matcher.patterns(), patterns);
+
+    int patternIndex = 42;
+    QCOMPARE(matcher.indexIn(haystack, from, &patternIndex), qsizetype(expectedIndex));
+    QCOMPARE(patternIndex, expectedPattern);
+}
+
+void tst_QMultiMatcher::surrogatePairs()
+{
+    // DESERET CAPITAL LETTER LONG I and DESERET SMALL LETTER LONG I
+    const QString upper = QString::fromUcs4(U"\U00010400");
+    const QString lower = QString::fromUcs4(U"\U00010428");
+    const QString haystack = QLatin1String("x") + upper + QLatin1String("y");
+
+    QMultiStringMatcher matcher({ lower + QLatin1String("y") });
+    QCOMPARE(matcher.indexIn(haystack), qsizetype(-1));
+    matcher.setCaseSensitivity(Qt::CaseInsensitive);
+    QCOMPARE(matcher.indexIn(haystack), qsizetype(1));
+}
+
+void tst_QMultiMatcher::setCaseSensitivity()
+{
+    QMultiByteArrayMatcher matcher({ "abc" });
+    QCOMPARE(matcher.indexIn(QByteArray("xABC")), -1);
+    matcher.setCaseSensitivity(Qt::CaseInsensitive);
+    QCOMPARE(matcher.caseSensitivity(), Qt::CaseInsensitive);
+    QCOMPARE(matcher.indexIn(QByteArray("xABC")), 1);
+    matcher.setPatterns({ "BC", "xyz" });
+    QCOMPARE(matcher.indexIn(QByteArray("xabc")), 2);
+    QCOMPARE(matcher.indexIn(QByteArray("xXyZ")), 1);
+}
+
+void tst_QMultiMatcher::copyAndAssign()
+{
+    QMultiByteArrayMatcher matcher({ "foo" });
+    QMultiByteArrayMatcher copy(matcher);
+    copy.setPatterns({ "bar" });
+    QCOMPARE(matcher.indexIn(QByteArray("barfoo")), 3);
+    QCOMPARE(copy.indexIn(QByteArray("barfoo")), 0);
+    matcher = copy;
+    QCOMPARE(matcher.indexIn(QByteArray("foobar")), 3);
+
+    QMultiStringMatcher stringMatcher({ QStringLiteral("foo") });
+    QMultiStringMatcher stringCopy;
+    stringCopy = stringMatcher;
+    stringMatcher.setCaseSensitivity(Qt::CaseInsensitive);
+    QCOMPARE(stringMatcher.indexIn(u"FOO"), qsizetype(0));
+    QCOMPARE(stringCopy.indexIn(u"FOO"), qsizetype(-1));
+}
+
+void tst_QMultiMatcher::compareWithSingleMatchers_data()
+{
+    QTest::addColumn<bool>("caseInsensitive");
+
+    QTest::newRow("case-sensitive") << false;
+    QTest::newRow("case-insensitive") << true;
+}
+
+// Finds the leftmost-longest match by running one single-pattern matcher per pattern.
+template <typename Matcher, typename Haystack>
+static int referenceIndexIn(const QVector<Matcher> &matchers, const Haystack &haystack,
+                            int from, int *patternIndex)
+{
+    int best = -1;
+    int bestLength = -1;
+    *patternIndex = -1;
+    for (int i = 0; i < matchers.size(); ++i) {
+        const int index = matchers.at(i).indexIn(haystack, from);
+        const int length = matchers.at(i).pattern().size();
+        if (index >= 0 && (best < 0 || index < best || (index == best && length > bestLength))) {
+            best = index;
+            bestLength = length;
+            *patternIndex = i;
+        }
+    }
+    return best;
+}
+
+void tst_QMultiMatcher::compareWithSingleMatchers()
+{
+    QFETCH(bool, caseInsensitive);
+    const Qt::CaseSensitivity cs = caseInsensitive ? Qt::CaseInsensitive : Qt::CaseSensitive;
+
+    // a small alphabet makes for plenty of overlapping matches
+    QRandomGenerator rng(4242);
+    const auto randomText = [&rng](int length) {
+        QByteArray text(length, Qt::Uninitialized);
+        for (char &c : text)
+            c = "abcABC"[rng.bounded(6)];
+        return text;
+    };
+
+    for (int round = 0; round < 50; ++round) {
+        QList<QByteArray> patterns;
+        const int patternCount = 1 + rng.bounded(12);
+        for (int i = 0; i < patternCount; ++i)
+            patterns.append(randomText(1 + rng.bounded(5)));
+        const QByteArray haystack = randomText(200);
+
+        // QByteArrayMatcher is always case-sensitive, so fold the input instead
+        QVector<QByteArrayMatcher> byteMatchers;
+        for (const QByteArray &pattern : qAsConst(patterns))
+            byteMatchers.append(QByteArrayMatcher(caseInsensitive ? pattern.toLower() : pattern));
+        const QByteArray foldedHaystack = caseInsensitive ? haystack.toLower() : haystack;
+
+        QVector<QStringMatcher> stringMatchers;
+        QStringList stringPatterns;
+        for (const QByteArray &pattern : qAsConst(patterns)) {
+            stringPatterns.append(QString::fromLatin1(pattern));
+            stringMatchers.append(QStringMatcher(stringPatterns.constLast(), cs));
+        }
+        const QString stringHaystack = QString::fromLatin1(haystack);
+
+        const QMultiByteArrayMatcher byteMatcher(patterns, cs);
+        const QMultiStringMatcher stringMatcher(stringPatterns, cs);
+        for (int from = 0; from <= haystack.size(); from += 7) {
+            int expectedPattern, actualPattern;
+            const int expected = referenceIndexIn(byteMatchers, foldedHaystack, from, &expectedPattern);
+            QCOMPARE(byteMatcher.indexIn(haystack, from, &actualPattern), expected);
+            QCOMPARE(actualPattern, expectedPattern);
+
+            QCOMPARE(referenceIndexIn(stringMatchers, stringHaystack, from, &expectedPattern), expected);
+            QCOMPARE(stringMatcher.indexIn(stringHaystack, from, &actualPattern), qsizetype(expected));
+            QCOMPARE(actualPattern, expectedPattern);
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QMultiMatcher)
+#include "tst_qmultimatcher.moc"
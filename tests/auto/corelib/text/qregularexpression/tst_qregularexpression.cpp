@@ -37,6 +37,10 @@
 #include <qregularexpression.h>
 #include <qthread.h>
 
+#ifdef QT_BUILD_INTERNAL
+#include <private/qregularexpression_p.h>
+#endif
+
 Q_DECLARE_METATYPE(QRegularExpression::PatternOptions)
 Q_DECLARE_METATYPE(QRegularExpression::MatchType)
 Q_DECLARE_METATYPE(QRegularExpression::MatchOptions)
@@ -61,6 +65,8 @@ private slots:
     void partialMatch();
     void globalMatch_data();
     void globalMatch();
+    void forEachMatch_data();
+    void forEachMatch();
     void serialize_data();
     void serialize();
     void operatoreq_data();
@@ -71,6 +77,8 @@ private slots:
     void captureNames();
     void pcreJitStackUsage_data();
     void pcreJitStackUsage();
+    void pcreJitStackSize();
+    void sharedCompiledPatterns();
     void regularExpressionMatch_data();
     void regularExpressionMatch();
     void JOptionUsage_data();
@@ -1423,6 +1431,47 @@ void tst_QRegularExpression::globalMatch()
                                                matchList);
 }
 
+void tst_QRegularExpression::forEachMatch_data()
+{
+    globalMatch_data();
+}
+
+void tst_QRegularExpression::forEachMatch()
+{
+    QFETCH(QRegularExpression, regexp);
+    QFETCH(QString, subject);
+    QFETCH(int, offset);
+    QFETCH(QRegularExpression::MatchType, matchType);
+    QFETCH(QRegularExpression::MatchOptions, matchOptions);
+
+    // forEachMatch() always starts at the beginning and does normal matching
+    if (offset != 0 || matchType != QRegularExpression::NormalMatch)
+        return;
+
+    QVector<QPair<qsizetype, qsizetype>> expected;
+    QRegularExpressionMatchIterator iterator = regexp.globalMatch(subject, 0, matchType, matchOptions);
+    while (iterator.hasNext()) {
+        const QRegularExpressionMatch match = iterator.next();
+        if (match.hasMatch())
+            expected.append(qMakePair(qsizetype(match.capturedStart()), qsizetype(match.capturedEnd())));
+    }
+
+    QVector<QPair<qsizetype, qsizetype>> ranges;
+    const qsizetype count = regexp.forEachMatch(subject, [&](qsizetype start, qsizetype end) {
+        ranges.append(qMakePair(start, end));
+    }, matchOptions);
+    QCOMPARE(count, ranges.size());
+    QCOMPARE(ranges, expected);
+
+    // a view into a larger string
+    const QString padded = QLatin1String("\n") + subject + QLatin1String("\n");
+    ranges.clear();
+    regexp.forEachMatch(QStringView(padded).mid(1, subject.size()), [&](qsizetype start, qsizetype end) {
+        ranges.append(qMakePair(start, end));
+    }, matchOptions);
+    QCOMPARE(ranges, expected);
+}
+
 void tst_QRegularExpression::serialize_data()
 {
     provideRegularExpressions();
@@ -1651,6 +1700,74 @@ void tst_QRegularExpression::pcreJitStackUsage()
     }
 }
 
+void tst_QRegularExpression::pcreJitStackSize()
+{
+#ifndef QT_BUILD_INTERNAL
+    QSKIP("Needs QT_BUILD_INTERNAL");
+#else
+    const int startSize = QRegularExpressionJitStack::startSize();
+    const int maxSize = QRegularExpressionJitStack::maxSize();
+
+    // every repetition of the group needs its own backtracking frame
+    const QRegularExpression re(QStringLiteral("^(?:(a)|b)*$"));
+    const QString subject(200000, QLatin1Char('a'));
+
+    QRegularExpressionJitStack::setSize(32 * 1024, 64 * 1024 * 1024);
+    QCOMPARE(QRegularExpressionJitStack::startSize(), 32 * 1024);
+    QCOMPARE(QRegularExpressionJitStack::maxSize(), 64 * 1024 * 1024);
+    QVERIFY(re.match(subject).hasMatch());
+
+    QRegularExpressionJitStack::setSize(startSize, maxSize);
+#endif
+}
+
+void tst_QRegularExpression::sharedCompiledPatterns()
+{
+    // expressions with the same pattern and options share the compiled
+    // pattern, but must behave as if they did not
+    const QString pattern = QStringLiteral("(?<word>[a-z]+)");
+    QRegularExpression re1(pattern);
+    QRegularExpression re2(pattern, QRegularExpression::CaseInsensitiveOption);
+    re1.optimize();
+    re2.optimize();
+
+    QCOMPARE(QRegularExpression(pattern).match("ABC def").captured("word"), QStringLiteral("def"));
+    QCOMPARE(re1.match("ABC def").captured("word"), QStringLiteral("def"));
+    QCOMPARE(re2.match("ABC def").captured("word"), QStringLiteral("ABC"));
+    QCOMPARE(re1.namedCaptureGroups(), QStringList() << QString() << QStringLiteral("word"));
+
+    re1.setPattern(QStringLiteral("[a-z"));
+    QVERIFY(!re1.isValid());
+    const QRegularExpression invalid(QStringLiteral("[a-z"));
+    QVERIFY(!invalid.isValid());
+    QCOMPARE(invalid.patternErrorOffset(), re1.patternErrorOffset());
+    QCOMPARE(invalid.errorString(), re1.errorString());
+    re1.setPattern(pattern);
+    QVERIFY(re1.isValid());
+    QCOMPARE(re1.match("ABC def").captured("word"), QStringLiteral("def"));
+
+    // the warning about (?J) is given for each expression that uses it
+    const QString jPattern = QStringLiteral("(?J)(?<a>x)|(?<a>y)");
+    const QString warningMessage = QStringLiteral("QRegularExpressionPrivate::getPatternInfo(): the pattern '%1'\n    is using the (?J) option; duplicate capturing group names are not supported by Qt");
+    for (int i = 0; i < 2; ++i) {
+        QTest::ignoreMessage(QtWarningMsg, qPrintable(warningMessage.arg(jPattern)));
+        QVERIFY(QRegularExpression(jPattern).isValid());
+    }
+
+#ifdef QT_BUILD_INTERNAL
+    const qint64 hits = QRegularExpressionCache::hits();
+    QVERIFY(QRegularExpression(pattern).isValid());
+    QCOMPARE(QRegularExpressionCache::hits(), hits + 1);
+
+    const int maxCost = QRegularExpressionCache::maxCost();
+    QRegularExpressionCache::setMaxCost(0);
+    QVERIFY(QRegularExpression(pattern).isValid());
+    QCOMPARE(QRegularExpressionCache::hits(), hits + 1);
+    QRegularExpressionCache::setMaxCost(maxCost);
+    QCOMPARE(QRegularExpressionCache::maxCost(), maxCost);
+#endif
+}
+
 void tst_QRegularExpression::regularExpressionMatch_data()
 {
     QTest::addColumn<QString>("pattern");
@@ -9,6 +9,7 @@ SUBDIRS = \
     qcollator \
     qlatin1string \
     qlocale \
+    qmultimatcher \
     qregexp \
     qregularexpression \
     qstring \
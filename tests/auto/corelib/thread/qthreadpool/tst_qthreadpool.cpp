@@ -29,6 +29,7 @@
 #include <QtTest/QtTest>
 #include <qelapsedtimer.h>
 #include <qthreadpool.h>
+#include <private/qthreadpool_p.h>
 #include <qstring.h>
 #include <qmutex.h>
 
@@ -102,6 +103,9 @@ private slots:
     void stressTest();
     void takeAllAndIncreaseMaxThreadCount();
     void waitForDoneAfterTake();
+    void workStealing();
+    void workStealingTryTake();
+    void workStealingContendedMutex();
 
 private:
     QMutex m_functionTestMutex;
@@ -1348,5 +1352,166 @@ void tst_QThreadPool::waitForDoneAfterTake()
 
 }
 
+void tst_QThreadPool::workStealing()
+{
+    class TreeTask : public QRunnable
+    {
+    public:
+        TreeTask(QThreadPool *pool, QAtomicInt *count, int depth)
+            : pool(pool), count(count), depth(depth)
+        { }
+
+        void run() override
+        {
+            count->ref();
+            if (depth > 0) {
+                pool->start(new TreeTask(pool, count, depth - 1));
+                pool->start(new TreeTask(pool, count, depth - 1));
+            }
+        }
+
+    private:
+        QThreadPool *pool;
+        QAtomicInt *count;
+        int depth;
+    };
+
+    // blocks its thread until another thread has run one of the runnables
+    // it queued locally
+    class BlockingSpawner : public QRunnable
+    {
+    public:
+        BlockingSpawner(QThreadPool *pool) : pool(pool) { setAutoDelete(false); }
+
+        void run() override
+        {
+            for (int i = 0; i < 4; ++i) {
+                pool->start(createTask(emptyFunct));
+                pool->start(new Releaser(&semaphore));
+            }
+            stolen = semaphore.tryAcquire(1, 10000);
+        }
+
+        bool stolen = false;
+
+    private:
+        class Releaser : public QRunnable
+        {
+        public:
+            Releaser(QSemaphore *semaphore) : semaphore(semaphore) { }
+            void run() override { semaphore->release(); }
+            QSemaphore *semaphore;
+        };
+
+        QThreadPool *pool;
+        QSemaphore semaphore;
+    };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    QVERIFY(!pool.isWorkStealingEnabled());
+    pool.setWorkStealingEnabled(true);
+    QVERIFY(pool.isWorkStealingEnabled());
+
+    QAtomicInt count;
+    const int depth = 12;
+    pool.start(new TreeTask(&pool, &count, depth));
+    QVERIFY(pool.waitForDone(60000));
+    QCOMPARE(count.loadRelaxed(), (2 << depth) - 1);
+
+    BlockingSpawner spawner(&pool);
+    pool.start(&spawner);
+    QVERIFY(pool.waitForDone(60000));
+    QVERIFY(spawner.stolen);
+}
+
+void tst_QThreadPool::workStealingTryTake()
+{
+    class Task : public QRunnable
+    {
+    public:
+        Task(QThreadPool *pool) : pool(pool) { }
+
+        void run() override
+        {
+            // not deleted unless taken, as it may still run otherwise
+            CountingRunnable *local = new CountingRunnable;
+            local->setAutoDelete(false);
+            pool->start(local);
+            taken = pool->tryTake(local);
+            if (taken)
+                delete local;
+        }
+
+        QThreadPool *pool;
+        bool taken = false;
+    };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(1); // nobody to hand the local runnable to
+    pool.setWorkStealingEnabled(true);
+
+    Task *task = new Task(&pool);
+    task->setAutoDelete(false);
+    pool.start(task);
+    QVERIFY(pool.waitForDone(60000));
+    QVERIFY(task->taken);
+    delete task;
+}
+
+void tst_QThreadPool::workStealingContendedMutex()
+{
+    // waits for a runnable it queued locally, which only another thread can run
+    class Parent : public QRunnable
+    {
+    public:
+        Parent(QThreadPool *pool) : pool(pool) { setAutoDelete(false); }
+
+        void run() override
+        {
+            running.release();
+            poolLocked.acquire();
+            pool->start(new Child(&semaphore));
+            childRan = semaphore.tryAcquire(1, 10000);
+        }
+
+        QSemaphore running;
+        QSemaphore poolLocked;
+        bool childRan = false;
+
+    private:
+        class Child : public QRunnable
+        {
+        public:
+            Child(QSemaphore *semaphore) : semaphore(semaphore) { }
+            void run() override { semaphore->release(); }
+            QSemaphore *semaphore;
+        };
+
+        QThreadPool *pool;
+        QSemaphore semaphore;
+    };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(2);
+    pool.setWorkStealingEnabled(true);
+    QMutex *poolMutex = &static_cast<QThreadPoolPrivate *>(QObjectPrivate::get(&pool))->mutex;
+
+    // the first round has to start a second thread, later ones wake it up
+    for (int i = 0; i < 3; ++i) {
+        Parent parent(&pool);
+        pool.start(&parent);
+        QVERIFY(parent.running.tryAcquire(1, 10000));
+        {
+            // hold the pool's mutex while the parent queues its child
+            QMutexLocker locker(poolMutex);
+            parent.poolLocked.release();
+            QThread::msleep(50);
+        }
+        QVERIFY(pool.waitForDone(60000));
+        QVERIFY(parent.childRan);
+    }
+}
+
 QTEST_MAIN(tst_QThreadPool);
 #include "tst_qthreadpool.moc"
@@ -0,0 +1,271 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <private/qflathash_p.h>
+#include <qhash.h>
+#include <qrandom.h>
+#include <qstring.h>
+
+#include <algorithm>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void constructing();
+    void insertion();
+    void removal();
+    void extraction();
+    void iterators();
+    void rehash();
+    void collidingHashes();
+    void randomOperations();
+    void implicitSharing();
+};
+
+void tst_QFlatHash::constructing()
+{
+    using Hash = QFlatHash<int, QString>;
+    Hash empty;
+    QVERIFY(empty.isEmpty());
+    QCOMPARE(empty.size(), Hash::size_type(0));
+    QCOMPARE(empty.bucketCount(), Hash::size_type(0));
+    QVERIFY(!empty.contains(1));
+    QCOMPARE(empty.value(1), QString());
+    QCOMPARE(empty.value(1, QLatin1String("default")), QLatin1String("default"));
+    QVERIFY(empty.find(1) == empty.end());
+    QVERIFY(empty.begin() == empty.end());
+
+    Hash h = { { 1, QLatin1String("one") }, { 2, QLatin1String("two") } };
+    QCOMPARE(h.size(), Hash::size_type(2));
+    QCOMPARE(h.value(1), QLatin1String("one"));
+    QCOMPARE(h.value(2), QLatin1String("two"));
+
+    Hash reserved;
+    reserved.reserve(1000);
+    QVERIFY(reserved.isEmpty());
+    QVERIFY(reserved.bucketCount() >= 1000);
+    const auto buckets = reserved.bucketCount();
+    for (int i = 0; i < 1000; ++i)
+        reserved.insert(i, QString::number(i));
+    QCOMPARE(reserved.bucketCount(), buckets);
+}
+
+void tst_QFlatHash::insertion()
+{
+    QFlatHash<QString, int> h;
+    h.insert(QLatin1String("foo"), 1);
+    h.insert(QLatin1String("bar"), 2);
+    QCOMPARE(h.size(), 2);
+    QCOMPARE(h.value(QLatin1String("foo")), 1);
+
+    auto it = h.insert(QLatin1String("foo"), 3);
+    QCOMPARE(h.size(), 2);
+    QCOMPARE(it.key(), QLatin1String("foo"));
+    QCOMPARE(*it, 3);
+    QCOMPARE(h.value(QLatin1String("foo")), 3);
+
+    h[QLatin1String("baz")] = 4;
+    h[QLatin1String("bar")] += 10;
+    QCOMPARE(h.size(), 3);
+    QCOMPARE(h.value(QLatin1String("baz")), 4);
+    QCOMPARE(h.value(QLatin1String("bar")), 12);
+
+    const auto &ch = h;
+    QCOMPARE(ch[QLatin1String("qux")], 0);
+    QCOMPARE(h.size(), 3);
+}
+
+void tst_QFlatHash::removal()
+{
+    QFlatHash<int, int> h;
+    for (int i = 0; i < 100; ++i)
+        h.insert(i, i * 2);
+    QVERIFY(!h.remove(100));
+    for (int i = 0; i < 100; i += 2)
+        QVERIFY(h.remove(i));
+    QCOMPARE(h.size(), 50);
+    for (int i = 0; i < 100; ++i) {
+        QCOMPARE(h.contains(i), i % 2 == 1);
+        if (i % 2)
+            QCOMPARE(h.value(i), i * 2);
+    }
+    h.clear();
+    QVERIFY(h.isEmpty());
+    QVERIFY(!h.contains(1));
+    h.insert(1, 1);
+    QCOMPARE(h.value(1), 1);
+}
+
+void tst_QFlatHash::extraction()
+{
+    QFlatHash<int, QString> h = { { 1, QLatin1String("one") }, { 2, QLatin1String("two") } };
+    QCOMPARE(h.take(1), QLatin1String("one"));
+    QCOMPARE(h.take(1), QString());
+    QCOMPARE(h.size(), 1);
+    QCOMPARE(h.keys(), QVector<int>{ 2 });
+    QCOMPARE(h.values(), QVector<QString>{ QLatin1String("two") });
+}
+
+void tst_QFlatHash::iterators()
+{
+    QFlatHash<int, int> h;
+    for (int i = 0; i < 10; ++i)
+        h.insert(i, i);
+
+    // entries are kept in insertion order until something is removed
+    int expected = 0;
+    for (auto it = h.cbegin(); it != h.cend(); ++it, ++expected) {
+        QCOMPARE(it.key(), expected);
+        QCOMPARE(it.value(), expected);
+    }
+    QCOMPARE(expected, 10);
+
+    for (auto it = h.begin(); it != h.end(); ++it)
+        *it *= 10;
+    QCOMPARE(h.value(7), 70);
+
+    auto it = h.find(3);
+    QVERIFY(it != h.end());
+    QCOMPARE(it.key(), 3);
+    it = h.erase(it);
+    // the last entry moved into the erased position
+    QCOMPARE(it.key(), 9);
+    QCOMPARE(h.size(), 9);
+    QVERIFY(!h.contains(3));
+    QCOMPARE(h.value(9), 90);
+
+    int sum = 0;
+    for (int v : qAsConst(h))
+        sum += v;
+    QCOMPARE(sum, 450 - 30);
+
+    // erasing everything through iterators
+    for (auto it = h.begin(); it != h.end(); )
+        it = h.erase(it);
+    QVERIFY(h.isEmpty());
+}
+
+void tst_QFlatHash::rehash()
+{
+    QFlatHash<int, int> h;
+    const int count = 100000;
+    for (int i = 0; i < count; ++i)
+        h.insert(i, -i);
+    QCOMPARE(h.size(), count);
+    QVERIFY(h.bucketCount() >= count);
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(h.value(i, 1), -i);
+    QVERIFY(!h.contains(count));
+
+    // churn: repeatedly removing and inserting must not grow the table
+    // without bound, deleted buckets are reclaimed on rehash
+    const auto buckets = h.bucketCount();
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < count; i += 3)
+            QVERIFY(h.remove(i));
+        for (int i = 0; i < count; i += 3)
+            h.insert(i, -i);
+    }
+    QCOMPARE(h.size(), count);
+    QCOMPARE(h.bucketCount(), buckets);
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(h.value(i, 1), -i);
+}
+
+struct BadKey
+{
+    int v;
+    bool operator==(const BadKey &o) const { return v == o.v; }
+};
+uint qHash(const BadKey &, uint seed = 0) { return seed; }
+
+void tst_QFlatHash::collidingHashes()
+{
+    // all keys share one hash value, so every lookup has to walk every
+    // group that was ever filled
+    QFlatHash<BadKey, int> h;
+    for (int i = 0; i < 100; ++i)
+        h.insert(BadKey{ i }, i);
+    QCOMPARE(h.size(), 100);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(h.value(BadKey{ i }, -1), i);
+    for (int i = 0; i < 100; i += 2)
+        QVERIFY(h.remove(BadKey{ i }));
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(h.value(BadKey{ i }, -1), i % 2 ? i : -1);
+}
+
+void tst_QFlatHash::randomOperations()
+{
+    QRandomGenerator rng(42);
+    QFlatHash<quint32, quint32> h;
+    QHash<quint32, quint32> reference;
+    for (int i = 0; i < 200000; ++i) {
+        const quint32 key = rng.bounded(5000);
+        switch (rng.bounded(3)) {
+        case 0:
+            h.insert(key, quint32(i));
+            reference.insert(key, quint32(i));
+            break;
+        case 1:
+            QCOMPARE(h.remove(key), reference.remove(key) != 0);
+            break;
+        case 2:
+            QCOMPARE(h.value(key, 0xffffffff), reference.value(key, 0xffffffff));
+            break;
+        }
+    }
+    QCOMPARE(h.size(), reference.size());
+    for (auto it = h.cbegin(); it != h.cend(); ++it)
+        QCOMPARE(it.value(), reference.value(it.key()));
+}
+
+void tst_QFlatHash::implicitSharing()
+{
+    QFlatHash<int, int> h = { { 1, 1 }, { 2, 2 } };
+    QFlatHash<int, int> copy = h;
+    copy.insert(3, 3);
+    copy.remove(1);
+    QCOMPARE(h.size(), 2);
+    QVERIFY(h.contains(1));
+    QVERIFY(!h.contains(3));
+    QCOMPARE(copy.size(), 2);
+    QVERIFY(!copy.contains(1));
+    QVERIFY(copy.contains(3));
+
+    QFlatHash<int, int> moved = std::move(copy);
+    QCOMPARE(moved.size(), 2);
+    copy.insert(4, 4);
+    QCOMPARE(copy.value(4), 4);
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
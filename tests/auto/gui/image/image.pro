@@ -4,6 +4,7 @@ SUBDIRS=\
    qicoimageformat \
    qpixmap \
    qpixmapcache \
+   qimagecache \
    qimage \
    qimageiohandler \
    qimagewriter \
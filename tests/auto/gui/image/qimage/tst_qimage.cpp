@@ -34,11 +34,13 @@
 #include <qlist.h>
 #include <qmatrix.h>
 #include <qrandom.h>
+#include <qthreadpool.h>
 #include <stdio.h>
 
 #include <qpainter.h>
 #include <private/qimage_p.h>
 #include <private/qdrawhelper_p.h>
+#include <private/qsimd_p.h>
 
 #ifdef Q_OS_DARWIN
 #include <CoreGraphics/CoreGraphics.h>
@@ -125,6 +127,12 @@ private slots:
 
     void smoothScaleBig();
     void smoothScaleAlpha();
+    void smoothScaleThreaded_data();
+    void smoothScaleThreaded();
+    void smoothScaleAvx2_data();
+    void smoothScaleAvx2();
+    void convertToFormatThreaded_data();
+    void convertToFormatThreaded();
 
     void transformed_data();
     void transformed();
@@ -1922,6 +1930,133 @@ void tst_QImage::smoothScaleBig()
     QCOMPARE(wideScaled.pixel(0, 0), QRgb(0x0));
 }
 
+static QImage randomImage(int width, int height, QImage::Format format)
+{
+    QImage image(width, height, QImage::Format_ARGB32);
+    QRandomGenerator random(width * height);
+    for (int y = 0; y < height; ++y)
+        random.fillRange(reinterpret_cast<quint32 *>(image.scanLine(y)), width);
+    return image.convertToFormat(format);
+}
+
+// Runs function once with only one thread, and once with four threads.
+template <typename Function>
+static void compareThreadedToSerial(Function function)
+{
+    QThreadPool *threadPool = QThreadPool::globalInstance();
+    const int maxThreadCount = threadPool->maxThreadCount();
+    threadPool->setMaxThreadCount(1);
+    const QImage serial = function();
+    threadPool->setMaxThreadCount(4);
+    const QImage threaded = function();
+    threadPool->setMaxThreadCount(maxThreadCount);
+    QCOMPARE(threaded, serial);
+}
+
+void tst_QImage::smoothScaleThreaded_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+    QTest::addColumn<QSize>("size");
+
+    QTest::newRow("ARGB32_Premultiplied, down") << QImage::Format_ARGB32_Premultiplied << QSize(251, 171);
+    QTest::newRow("ARGB32_Premultiplied, up") << QImage::Format_ARGB32_Premultiplied << QSize(2011, 1437);
+    QTest::newRow("RGB32, down x, up y") << QImage::Format_RGB32 << QSize(500, 1500);
+    QTest::newRow("RGB32, up x, down y") << QImage::Format_RGB32 << QSize(1500, 500);
+    QTest::newRow("RGBA64_Premultiplied, down") << QImage::Format_RGBA64_Premultiplied << QSize(333, 222);
+}
+
+void tst_QImage::smoothScaleThreaded()
+{
+    QFETCH(QImage::Format, format);
+    QFETCH(QSize, size);
+
+    const QImage image = randomImage(1031, 977, format);
+    compareThreadedToSerial([&] {
+        return image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    });
+}
+
+void tst_QImage::smoothScaleAvx2_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+    QTest::addColumn<QSize>("size");
+
+    const QImage::Format formats[] = {
+        QImage::Format_ARGB32,
+        QImage::Format_RGB32,
+        QImage::Format_RGBA64
+    };
+    for (QImage::Format format : formats) {
+        const QString name = formatToString(format);
+        // odd widths leave a single pixel after the pairs done at once
+        QTest::newRow(qPrintable(name + ", down")) << format << QSize(67, 45);
+        QTest::newRow(qPrintable(name + ", up")) << format << QSize(203, 191);
+        QTest::newRow(qPrintable(name + ", down x, up y")) << format << QSize(45, 191);
+        QTest::newRow(qPrintable(name + ", up x, down y")) << format << QSize(203, 45);
+    }
+}
+
+void tst_QImage::smoothScaleAvx2()
+{
+#if !defined(QT_COMPILER_SUPPORTS_AVX2) || !defined(Q_ATOMIC_INT64_IS_SUPPORTED)
+    QSKIP("This test requires AVX2 support in the compiler and 64-bit atomics");
+#else
+    QFETCH(QImage::Format, format);
+    QFETCH(QSize, size);
+
+    if (!qCpuHasFeature(ArchHaswell))
+        QSKIP("This test requires a CPU with AVX2");
+    if (qCompilerCpuFeatures & CpuFeatureAVX2)
+        QSKIP("AVX2 cannot be disabled at run time in this build");
+
+    const QImage image = randomImage(101, 97, format);
+    const QImage avx2 = image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+    // Same as running with QT_NO_CPU_FEATURE=avx2
+    const quint64 features = qt_cpu_features[0].loadRelaxed();
+    qt_cpu_features[0].storeRelaxed(features & ~CpuFeatureAVX2);
+    const QImage generic = image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    qt_cpu_features[0].storeRelaxed(features);
+
+    QCOMPARE(avx2, generic);
+#endif
+}
+
+void tst_QImage::convertToFormatThreaded_data()
+{
+    QTest::addColumn<QImage::Format>("sourceFormat");
+    QTest::addColumn<QImage::Format>("format");
+    QTest::addColumn<Qt::ImageConversionFlags>("flags");
+
+    QTest::newRow("ARGB32 -> RGB888")
+            << QImage::Format_ARGB32 << QImage::Format_RGB888 << Qt::ImageConversionFlags(Qt::AutoColor);
+    QTest::newRow("ARGB32 -> RGB16, dithered")
+            << QImage::Format_ARGB32 << QImage::Format_RGB16
+            << Qt::ImageConversionFlags(Qt::PreferDither | Qt::OrderedDither);
+    QTest::newRow("A2BGR30_Premultiplied -> RGBA64")
+            << QImage::Format_A2BGR30_Premultiplied << QImage::Format_RGBA64 << Qt::ImageConversionFlags(Qt::AutoColor);
+    QTest::newRow("RGB16 -> ARGB4444_Premultiplied, in place")
+            << QImage::Format_RGB16 << QImage::Format_ARGB4444_Premultiplied << Qt::ImageConversionFlags(Qt::AutoColor);
+    QTest::newRow("ARGB32 -> ARGB6666_Premultiplied, in place")
+            << QImage::Format_ARGB32 << QImage::Format_ARGB6666_Premultiplied << Qt::ImageConversionFlags(Qt::AutoColor);
+}
+
+void tst_QImage::convertToFormatThreaded()
+{
+    QFETCH(QImage::Format, sourceFormat);
+    QFETCH(QImage::Format, format);
+    QFETCH(Qt::ImageConversionFlags, flags);
+
+    const QImage image = randomImage(1031, 977, sourceFormat);
+    compareThreadedToSerial([&] {
+        return image.convertToFormat(format, flags);
+    });
+    compareThreadedToSerial([&] {
+        QImage copy = image.copy();
+        return std::move(copy).convertToFormat(format, flags);
+    });
+}
+
 void tst_QImage::smoothScaleAlpha()
 {
     QImage src(128, 128, QImage::Format_ARGB32_Premultiplied);
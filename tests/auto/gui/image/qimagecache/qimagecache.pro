@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qimagecache
+QT += gui testlib
+SOURCES  += tst_qimagecache.cpp
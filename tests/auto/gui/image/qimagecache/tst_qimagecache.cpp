@@ -0,0 +1,279 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qimagecache.h>
+#include <qthread.h>
+
+class tst_QImageCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void maxBytes();
+    void insertAndFind();
+    void replace();
+    void remove();
+    void clear();
+    void evictsWithinBudget();
+    void foundImagesSurviveScan();
+    void setMaxBytesTrims();
+    void statistics();
+    void oversizedInsert();
+    void concurrentAccess();
+    void globalInstance();
+};
+
+static QImage testImage(int value, int side = 16)
+{
+    QImage image(side, side, QImage::Format_ARGB32);
+    image.fill(value);
+    return image;
+}
+
+static const qint64 imageBytes = 16 * 16 * 4;
+
+void tst_QImageCache::maxBytes()
+{
+    QImageCache cache;
+    QCOMPARE(cache.maxBytes(), qint64(64 * 1024 * 1024));
+    cache.setMaxBytes(1234);
+    QCOMPARE(cache.maxBytes(), qint64(1234));
+
+    QImageCache small(100);
+    QCOMPARE(small.maxBytes(), qint64(100));
+}
+
+void tst_QImageCache::insertAndFind()
+{
+    QImageCache cache;
+    QImage image;
+    QVERIFY(!cache.find(QStringLiteral("a"), &image));
+    QVERIFY(image.isNull());
+
+    const QImage a = testImage(1);
+    QVERIFY(cache.insert(QStringLiteral("a"), a));
+    QVERIFY(cache.find(QStringLiteral("a"), &image));
+    QCOMPARE(image, a);
+    QCOMPARE(image.cacheKey(), a.cacheKey());
+    QVERIFY(cache.find(QStringLiteral("a"), nullptr));
+    QVERIFY(!cache.find(QStringLiteral("b"), &image));
+    QCOMPARE(image, a);
+}
+
+void tst_QImageCache::replace()
+{
+    QImageCache cache;
+    QVERIFY(cache.insert(QStringLiteral("a"), testImage(1)));
+    QVERIFY(cache.insert(QStringLiteral("a"), testImage(2, 32)));
+
+    QImage image;
+    QVERIFY(cache.find(QStringLiteral("a"), &image));
+    QCOMPARE(image, testImage(2, 32));
+
+    const QImageCache::Statistics statistics = cache.statistics();
+    QCOMPARE(statistics.count, 1);
+    QCOMPARE(statistics.bytes, qint64(32 * 32 * 4));
+}
+
+void tst_QImageCache::remove()
+{
+    QImageCache cache;
+    QVERIFY(cache.insert(QStringLiteral("a"), testImage(1)));
+    QVERIFY(cache.insert(QStringLiteral("b"), testImage(2)));
+    QVERIFY(cache.remove(QStringLiteral("a")));
+    QVERIFY(!cache.remove(QStringLiteral("a")));
+    QVERIFY(!cache.find(QStringLiteral("a"), nullptr));
+    QVERIFY(cache.find(QStringLiteral("b"), nullptr));
+    QCOMPARE(cache.statistics().bytes, imageBytes);
+}
+
+void tst_QImageCache::clear()
+{
+    QImageCache cache;
+    for (int i = 0; i < 100; ++i)
+        QVERIFY(cache.insert(QString::number(i), testImage(i)));
+    QCOMPARE(cache.statistics().count, 100);
+    cache.clear();
+    QCOMPARE(cache.statistics().count, 0);
+    QCOMPARE(cache.statistics().bytes, qint64(0));
+    for (int i = 0; i < 100; ++i)
+        QVERIFY(!cache.find(QString::number(i), nullptr));
+
+    // Still usable after clearing
+    QVERIFY(cache.insert(QStringLiteral("a"), testImage(1)));
+    QVERIFY(cache.find(QStringLiteral("a"), nullptr));
+}
+
+void tst_QImageCache::evictsWithinBudget()
+{
+    QImageCache cache(10 * imageBytes);
+    for (int i = 0; i < 100; ++i) {
+        QVERIFY(cache.insert(QString::number(i), testImage(i)));
+        QVERIFY(cache.statistics().bytes <= cache.maxBytes());
+    }
+    const QImageCache::Statistics statistics = cache.statistics();
+    QCOMPARE(statistics.count, 10);
+    QCOMPARE(statistics.evictions, qint64(90));
+
+    // The image just inserted is never the one evicted
+    QVERIFY(cache.find(QString::number(99), nullptr));
+}
+
+void tst_QImageCache::foundImagesSurviveScan()
+{
+    QImageCache cache(10 * imageBytes);
+    QVERIFY(cache.insert(QStringLiteral("hot"), testImage(1)));
+    QVERIFY(cache.find(QStringLiteral("hot"), nullptr));
+
+    // A scan over many images that are used only once does not evict
+    // an image that is in use.
+    for (int i = 0; i < 1000; ++i)
+        QVERIFY(cache.insert(QString::number(i), testImage(i)));
+    QVERIFY(cache.find(QStringLiteral("hot"), nullptr));
+}
+
+void tst_QImageCache::setMaxBytesTrims()
+{
+    QImageCache cache(100 * imageBytes);
+    for (int i = 0; i < 50; ++i)
+        QVERIFY(cache.insert(QString::number(i), testImage(i)));
+    QCOMPARE(cache.statistics().count, 50);
+
+    cache.setMaxBytes(5 * imageBytes);
+    QImageCache::Statistics statistics = cache.statistics();
+    QCOMPARE(statistics.count, 5);
+    QCOMPARE(statistics.bytes, 5 * imageBytes);
+    QCOMPARE(statistics.evictions, qint64(45));
+
+    cache.setMaxBytes(0);
+    statistics = cache.statistics();
+    QCOMPARE(statistics.count, 0);
+    QCOMPARE(statistics.bytes, qint64(0));
+}
+
+void tst_QImageCache::statistics()
+{
+    QImageCache cache(3 * imageBytes);
+    QImageCache::Statistics statistics = cache.statistics();
+    QCOMPARE(statistics.hits, qint64(0));
+    QCOMPARE(statistics.misses, qint64(0));
+    QCOMPARE(statistics.insertions, qint64(0));
+    QCOMPARE(statistics.evictions, qint64(0));
+    QCOMPARE(statistics.bytes, qint64(0));
+    QCOMPARE(statistics.count, 0);
+
+    for (int i = 0; i < 4; ++i)
+        QVERIFY(cache.insert(QString::number(i), testImage(i)));
+    QVERIFY(cache.find(QStringLiteral("3"), nullptr));
+    QVERIFY(cache.find(QStringLiteral("3"), nullptr));
+    QVERIFY(!cache.find(QStringLiteral("x"), nullptr));
+
+    statistics = cache.statistics();
+    QCOMPARE(statistics.hits, qint64(2));
+    QCOMPARE(statistics.misses, qint64(1));
+    QCOMPARE(statistics.insertions, qint64(4));
+    QCOMPARE(statistics.evictions, qint64(1));
+    QCOMPARE(statistics.bytes, 3 * imageBytes);
+    QCOMPARE(statistics.count, 3);
+
+    cache.resetStatistics();
+    statistics = cache.statistics();
+    QCOMPARE(statistics.hits, qint64(0));
+    QCOMPARE(statistics.misses, qint64(0));
+    QCOMPARE(statistics.insertions, qint64(0));
+    QCOMPARE(statistics.evictions, qint64(0));
+    // The contents are not statistics
+    QCOMPARE(statistics.bytes, 3 * imageBytes);
+    QCOMPARE(statistics.count, 3);
+}
+
+void tst_QImageCache::oversizedInsert()
+{
+    QImageCache cache(2 * imageBytes);
+    QVERIFY(cache.insert(QStringLiteral("a"), testImage(1)));
+    QVERIFY(cache.insert(QStringLiteral("b"), testImage(2)));
+
+    // Like QCache, an image that cannot fit replaces nothing but the
+    // image it would replace.
+    QVERIFY(!cache.insert(QStringLiteral("a"), testImage(1, 64)));
+    QVERIFY(!cache.find(QStringLiteral("a"), nullptr));
+    QVERIFY(cache.find(QStringLiteral("b"), nullptr));
+    QCOMPARE(cache.statistics().evictions, qint64(0));
+}
+
+void tst_QImageCache::concurrentAccess()
+{
+    const int threadCount = 8;
+    const int iterations = 2000;
+    const int keyCount = 200;
+    QImageCache cache(50 * imageBytes);
+
+    std::vector<std::unique_ptr<QThread>> threads;
+    QAtomicInt mismatches;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back(QThread::create([&cache, &mismatches, t] {
+            for (int i = 0; i < iterations; ++i) {
+                const int k = (i * 7 + t * 13) % keyCount;
+                const QString key = QString::number(k);
+                QImage image;
+                if (cache.find(key, &image)) {
+                    if (image.pixel(0, 0) != uint(k) || image.pixel(15, 15) != uint(k))
+                        mismatches.ref();
+                } else {
+                    cache.insert(key, testImage(k));
+                }
+                if (i % 97 == 0)
+                    cache.remove(key);
+            }
+        }));
+        threads.back()->start();
+    }
+    for (auto &thread : threads)
+        QVERIFY(thread->wait());
+
+    QCOMPARE(mismatches.loadRelaxed(), 0);
+    const QImageCache::Statistics statistics = cache.statistics();
+    QCOMPARE(statistics.hits + statistics.misses, qint64(threadCount * iterations));
+    QVERIFY(statistics.bytes <= cache.maxBytes());
+    QCOMPARE(statistics.bytes, statistics.count * imageBytes);
+}
+
+void tst_QImageCache::globalInstance()
+{
+    QImageCache *cache = QImageCache::globalInstance();
+    QVERIFY(cache);
+    QCOMPARE(QImageCache::globalInstance(), cache);
+    QVERIFY(cache->insert(QStringLiteral("tst_QImageCache"), testImage(1)));
+    QVERIFY(cache->find(QStringLiteral("tst_QImageCache"), nullptr));
+    QVERIFY(cache->remove(QStringLiteral("tst_QImageCache")));
+}
+
+QTEST_MAIN(tst_QImageCache)
+#include "tst_qimagecache.moc"
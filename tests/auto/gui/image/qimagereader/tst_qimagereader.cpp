@@ -82,6 +82,8 @@ private slots:
     void readImage_data();
     void readImage();
     void jpegRgbCmyk();
+    void jpegClipRect_data();
+    void jpegClipRect();
 
     void setScaledSize_data();
     void setScaledSize();
@@ -171,6 +173,15 @@ private slots:
     void devicePixelRatio_data();
     void devicePixelRatio();
 
+    void readIntoCallerBuffer_data();
+    void readIntoCallerBuffer();
+
+    void readScanLines_data();
+    void readScanLines();
+
+    void readScanLinesFromSequentialDevice_data();
+    void readScanLinesFromSequentialDevice();
+
 private:
     QString prefix;
     QTemporaryDir m_temporaryDir;
@@ -341,6 +352,63 @@ void tst_QImageReader::jpegRgbCmyk()
     }
 }
 
+void tst_QImageReader::jpegClipRect_data()
+{
+    QTest::addColumn<bool>("progressive");
+    QTest::addColumn<QRect>("clipRect");
+    QTest::addColumn<QSize>("scaledSize");
+
+    // The clip rect is decoded without the columns and lines around it
+    for (bool progressive : {false, true}) {
+        const char *kind = progressive ? "multi-scan" : "baseline";
+        QTest::addRow("%s, top-left", kind) << progressive << QRect(0, 0, 31, 17) << QSize();
+        QTest::addRow("%s, aligned", kind) << progressive << QRect(64, 32, 128, 96) << QSize();
+        QTest::addRow("%s, unaligned", kind) << progressive << QRect(37, 51, 101, 73) << QSize();
+        QTest::addRow("%s, column", kind) << progressive << QRect(255, 1, 1, 190) << QSize();
+        QTest::addRow("%s, bottom-right", kind) << progressive << QRect(200, 150, 59, 45) << QSize();
+        QTest::addRow("%s, scaled 3/8", kind) << progressive << QRect(64, 32, 128, 96) << QSize(48, 36);
+        QTest::addRow("%s, scaled 1/4", kind) << progressive << QRect(16, 8, 96, 64) << QSize(24, 16);
+    }
+}
+
+void tst_QImageReader::jpegClipRect()
+{
+    QFETCH(bool, progressive);
+    QFETCH(QRect, clipRect);
+    QFETCH(QSize, scaledSize);
+
+    SKIP_IF_UNSUPPORTED("jpeg");
+
+    QImage source(259, 195, QImage::Format_RGB32);
+    for (int y = 0; y < source.height(); ++y) {
+        for (int x = 0; x < source.width(); ++x)
+            source.setPixel(x, y, qRgb(x * 255 / source.width(), (x ^ y) & 0xff, (x * y) & 0xff));
+    }
+    QByteArray data;
+    QBuffer writeBuffer(&data);
+    QImageWriter writer(&writeBuffer, "jpeg");
+    writer.setProgressiveScanWrite(progressive);
+    QVERIFY(writer.write(source));
+
+    QBuffer buffer(&data);
+    QImageReader reader(&buffer);
+    reader.setClipRect(clipRect);
+    reader.setScaledSize(scaledSize);
+    const QImage image = reader.read();
+
+    // Scaling to a multiple of 1/8 in the DCT domain keeps the clip rect exact
+    QBuffer fullBuffer(&data);
+    QImageReader fullReader(&fullBuffer);
+    if (scaledSize.isValid()) {
+        const int num = 8 * scaledSize.width() / clipRect.width();
+        fullReader.setScaledSize(QSize((source.width() * num + 7) / 8, (source.height() * num + 7) / 8));
+        clipRect = QRect(clipRect.topLeft() * num / 8, scaledSize);
+    }
+    const QImage expected = fullReader.read().copy(clipRect);
+    QVERIFY(!expected.isNull());
+    QCOMPARE(image, expected);
+}
+
 void tst_QImageReader::setScaledSize_data()
 {
     QTest::addColumn<QString>("fileName");
@@ -2041,5 +2109,186 @@ void tst_QImageReader::devicePixelRatio()
     QCOMPARE(img.devicePixelRatio(), dpr);
 }
 
+void tst_QImageReader::readIntoCallerBuffer_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<QByteArray>("format");
+    QTest::addColumn<bool>("scanLines");
+
+    QTest::newRow("jpeg") << QString("YCbCr_rgb.jpg") << QByteArray("jpeg") << false;
+    QTest::newRow("jpeg-gray") << QString("beavis.jpg") << QByteArray("jpeg") << false;
+    QTest::newRow("jpeg, scanlines") << QString("YCbCr_rgb.jpg") << QByteArray("jpeg") << true;
+    QTest::newRow("png") << QString("kollada.png") << QByteArray("png") << false;
+    QTest::newRow("png, scanlines") << QString("kollada.png") << QByteArray("png") << true;
+}
+
+void tst_QImageReader::readIntoCallerBuffer()
+{
+    QFETCH(QString, fileName);
+    QFETCH(QByteArray, format);
+    QFETCH(bool, scanLines);
+
+    SKIP_IF_UNSUPPORTED(format);
+
+    const QImage expected = QImageReader(prefix + fileName).read();
+    QVERIFY(!expected.isNull());
+
+    QByteArray pool(expected.sizeInBytes(), '\0');
+    uchar *bits = reinterpret_cast<uchar *>(pool.data());
+    QImage image(bits, expected.width(), expected.height(), expected.bytesPerLine(), expected.format());
+    if (expected.format() == QImage::Format_Indexed8)
+        image.setColorTable(expected.colorTable());
+
+    QImageReader reader(prefix + fileName);
+    if (scanLines)
+        QCOMPARE(reader.readScanLines(&image), expected.height());
+    else
+        QVERIFY(reader.read(&image));
+    QCOMPARE(image.constBits(), bits);
+    QCOMPARE(image, expected);
+}
+
+void tst_QImageReader::readScanLines_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<QByteArray>("format");
+    QTest::addColumn<bool>("progressive");
+
+    QTest::newRow("jpeg-rgb") << QString("YCbCr_rgb.jpg") << QByteArray("jpeg") << true;
+    QTest::newRow("jpeg-cmyk") << QString("YCbCr_cmyk.jpg") << QByteArray("jpeg") << true;
+    QTest::newRow("jpeg-gray") << QString("beavis.jpg") << QByteArray("jpeg") << true;
+    QTest::newRow("jpeg-text") << QString("txts.jpg") << QByteArray("jpeg") << true;
+    QTest::newRow("jpeg-no_eoi") << QString("qtbug13653-no_eoi.jpg") << QByteArray("jpeg") << true;
+    QTest::newRow("png") << QString("kollada.png") << QByteArray("png") << false;
+}
+
+void tst_QImageReader::readScanLines()
+{
+    QFETCH(QString, fileName);
+    QFETCH(QByteArray, format);
+    QFETCH(bool, progressive);
+
+    SKIP_IF_UNSUPPORTED(format);
+
+    QImageReader expectedReader(prefix + fileName);
+    const QImage expected = expectedReader.read();
+    QVERIFY(!expected.isNull());
+
+    QImageReader reader(prefix + fileName);
+    QCOMPARE(reader.supportsOption(QImageIOHandler::ProgressiveReading), progressive);
+
+    const int batch = 7;
+    QImage image;
+    int lines = 0;
+    int calls = 0;
+    do {
+        const int previous = lines;
+        lines = reader.readScanLines(&image, batch);
+        QVERIFY2(lines >= 0, qPrintable(reader.errorString()));
+        if (progressive)
+            QCOMPARE(lines, qMin(previous + batch, expected.height()));
+        ++calls;
+    } while (lines < image.height());
+
+    QCOMPARE(calls, progressive ? (expected.height() + batch - 1) / batch : 1);
+    QCOMPARE(image, expected);
+    QCOMPARE(image.text(), expected.text());
+    QCOMPARE(image.dotsPerMeterX(), expected.dotsPerMeterX());
+
+    // the image has been read, which is not an error
+    QCOMPARE(reader.readScanLines(&image, batch), expected.height());
+    QCOMPARE(reader.readScanLines(&image), expected.height());
+}
+
+// A sequential device that only has the data fed to it so far
+class TrickleDevice : public QIODevice
+{
+public:
+    TrickleDevice() { open(QIODevice::ReadOnly); }
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override { return pending.size() + QIODevice::bytesAvailable(); }
+    void feed(const QByteArray &data) { pending += data; }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        const qint64 n = qMin<qint64>(maxSize, pending.size());
+        memcpy(data, pending.constData(), n);
+        pending.remove(0, n);
+        return n;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    QByteArray pending;
+};
+
+void tst_QImageReader::readScanLinesFromSequentialDevice_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QByteArray>("format");
+    QTest::addColumn<bool>("multiScan");
+
+    if (!QImageReader::supportedImageFormats().contains("jpeg"))
+        QSKIP("\"jpeg\" images are not supported");
+
+    QFile file(prefix + QLatin1String("YCbCr_rgb.jpg"));
+    QVERIFY2(file.open(QIODevice::ReadOnly), msgFileOpenReadFailed(file).constData());
+    QTest::newRow("jpeg") << file.readAll() << QByteArray("jpeg") << false;
+
+    QImage source(prefix + QLatin1String("kollada.png"));
+    QVERIFY(!source.isNull());
+    for (bool progressive : {false, true}) {
+        QByteArray data;
+        QBuffer buffer(&data);
+        QImageWriter writer(&buffer, "jpeg");
+        writer.setText(QLatin1String("Test"), QLatin1String("Text"));
+        writer.setProgressiveScanWrite(progressive);
+        QVERIFY(writer.write(source));
+        QTest::newRow(progressive ? "written, multi-scan" : "written, baseline") << data << QByteArray("jpeg") << progressive;
+    }
+}
+
+void tst_QImageReader::readScanLinesFromSequentialDevice()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QByteArray, format);
+    QFETCH(bool, multiScan);
+
+    QBuffer buffer(&data);
+    const QImage expected = QImageReader(&buffer, format).read();
+    QVERIFY(!expected.isNull());
+
+    TrickleDevice device;
+    QImageReader reader(&device, format);
+    QImage image;
+    int lines = 0;
+    int linesBeforeLastChunk = -1;
+    const int chunkSize = 97;
+    for (int i = 0; i < data.size(); i += chunkSize) {
+        if (i + chunkSize >= data.size())
+            linesBeforeLastChunk = lines;
+        device.feed(data.mid(i, chunkSize));
+        const int previous = lines;
+        lines = reader.readScanLines(&image);
+        QVERIFY2(lines >= 0, qPrintable(reader.errorString()));
+        QVERIFY(lines >= previous);
+    }
+
+    QCOMPARE(lines, expected.height());
+    QCOMPARE(image, expected);
+    QCOMPARE(image.text(), expected.text());
+    // all scans of a multi-scan image are needed for the first scanline
+    if (!multiScan)
+        QVERIFY(linesBeforeLastChunk > 0);
+
+    // neither data following the image nor calls without new data are errors
+    device.feed(QByteArray(16, '\0'));
+    QCOMPARE(reader.readScanLines(&image), expected.height());
+    QCOMPARE(reader.readScanLines(&image), expected.height());
+    QCOMPARE(image, expected);
+}
+
 QTEST_MAIN(tst_QImageReader)
 #include "tst_qimagereader.moc"
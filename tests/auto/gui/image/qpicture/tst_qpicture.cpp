@@ -35,6 +35,7 @@
 #include <qpaintengine.h>
 #include <qguiapplication.h>
 #include <qscreen.h>
+#include <qthreadpool.h>
 #include <limits.h>
 
 #ifndef QT_NO_PICTURE
@@ -55,6 +56,8 @@ private slots:
     void save_restore();
     void boundaryValues_data();
     void boundaryValues();
+    void playParallel_data();
+    void playParallel();
 };
 
 tst_QPicture::tst_QPicture()
@@ -292,6 +295,95 @@ void tst_QPicture::boundaryValues()
     painter.end();
 }
 
+static void paintScene(QPainter *p, const QSize &size)
+{
+    p->setRenderHint(QPainter::Antialiasing);
+    p->fillRect(QRect(QPoint(0, 0), size), Qt::white);
+
+    QLinearGradient gradient(0, 0, size.width(), size.height());
+    gradient.setColorAt(0, QColor(255, 0, 0, 200));
+    gradient.setColorAt(1, QColor(0, 0, 255, 120));
+    p->setBrush(gradient);
+    p->setPen(QPen(Qt::black, 3.5, Qt::DashLine));
+    for (int i = 0; i < 16; ++i) {
+        p->drawEllipse(QRectF(i * size.width() / 20.0, i * size.height() / 17.0,
+                              size.width() / 3.3, size.height() / 4.1));
+    }
+
+    QPainterPath path;
+    path.moveTo(0, size.height());
+    path.cubicTo(size.width() / 3, 0, size.width() * 2 / 3, size.height(), size.width(), 0);
+    p->setBrush(Qt::NoBrush);
+    p->setPen(QPen(Qt::darkGreen, 7.3));
+    p->drawPath(path);
+
+    p->save();
+    p->setClipRect(QRect(size.width() / 4, size.height() / 4, size.width() / 2, size.height() / 2));
+    p->rotate(7);
+    QImage checker(16, 16, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < checker.height(); ++y)
+        for (int x = 0; x < checker.width(); ++x)
+            checker.setPixel(x, y, ((x ^ y) & 4) ? 0xff00ff00 : 0x80800000);
+    p->drawImage(QRectF(size.width() / 3, size.height() / 3, size.width() / 3, size.height() / 3),
+                 checker);
+    p->restore();
+
+    p->setPen(Qt::black);
+    p->drawText(QRect(QPoint(0, 0), size), Qt::AlignCenter, QStringLiteral("QPicture"));
+}
+
+void tst_QPicture::playParallel_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+    QTest::addColumn<qreal>("devicePixelRatio");
+
+    QTest::newRow("ARGB32_Premultiplied") << QImage::Format_ARGB32_Premultiplied << qreal(1);
+    QTest::newRow("RGB32") << QImage::Format_RGB32 << qreal(1);
+    QTest::newRow("RGB16") << QImage::Format_RGB16 << qreal(1);
+    QTest::newRow("Grayscale8") << QImage::Format_Grayscale8 << qreal(1);
+    QTest::newRow("RGBA64") << QImage::Format_RGBA64 << qreal(1);
+    QTest::newRow("ARGB32_Premultiplied@2x") << QImage::Format_ARGB32_Premultiplied << qreal(2);
+    QTest::newRow("ARGB32_Premultiplied@1.5x") << QImage::Format_ARGB32_Premultiplied << qreal(1.5);
+}
+
+void tst_QPicture::playParallel()
+{
+    QFETCH(QImage::Format, format);
+    QFETCH(qreal, devicePixelRatio);
+
+    // Large enough for several bands.
+    const QSize size(1200, 1100);
+    QPicture picture;
+    {
+        QPainter painter(&picture);
+        paintScene(&painter, size / devicePixelRatio);
+    }
+
+    QImage expected(size, format);
+    expected.fill(Qt::gray);
+    expected.setDevicePixelRatio(devicePixelRatio);
+    {
+        QPainter painter(&expected);
+        QVERIFY(picture.play(&painter));
+    }
+
+    // Make sure the bands are used even on a single core.
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int maxThreadCount = pool->maxThreadCount();
+    pool->setMaxThreadCount(4);
+    QImage parallel(size, format);
+    parallel.fill(Qt::gray);
+    parallel.setDevicePixelRatio(devicePixelRatio);
+    const bool ok = picture.playParallel(&parallel);
+    pool->setMaxThreadCount(maxThreadCount);
+    QVERIFY(ok);
+    QCOMPARE(parallel, expected);
+
+    QPicture empty;
+    QVERIFY(empty.playParallel(&parallel));
+    QVERIFY(!picture.playParallel(nullptr));
+}
+
 QTEST_MAIN(tst_QPicture)
 #include "tst_qpicture.moc"
 
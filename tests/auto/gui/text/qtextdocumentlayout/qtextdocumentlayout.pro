@@ -1,6 +1,6 @@
 CONFIG += testcase
 TARGET = tst_qtextdocumentlayout
-QT += testlib
+QT += testlib gui-private
 qtHaveModule(widgets): QT += widgets
 SOURCES += tst_qtextdocumentlayout.cpp
 
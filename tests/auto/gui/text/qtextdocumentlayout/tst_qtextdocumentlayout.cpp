@@ -34,6 +34,8 @@
 #include <qdebug.h>
 #include <qpainter.h>
 #include <qtexttable.h>
+#include <qthreadpool.h>
+#include <private/qtextdocumentlayout_p.h>
 #ifndef QT_NO_WIDGETS
 #include <qtextedit.h>
 #include <qscrollbar.h>
@@ -60,6 +62,9 @@ private slots:
     void blockVisibility();
 
     void largeImage();
+    void parallelLayout_data();
+    void parallelLayout();
+    void onDemandLayout();
 
 private:
     QTextDocument *doc;
@@ -407,5 +412,153 @@ void tst_QTextDocumentLayout::largeImage()
      }
 }
 
+void tst_QTextDocumentLayout::parallelLayout_data()
+{
+    QTest::addColumn<QString>("html");
+    QTest::addColumn<QSizeF>("pageSize");
+    QTest::addColumn<QSizeF>("newPageSize");
+
+    const QString lorem = QStringLiteral("Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+                                         "eiusmod tempor incididunt ut labore et dolore magna aliqua. ");
+    QString plain;
+    for (int i = 0; i < 400; ++i)
+        plain += QStringLiteral("<p>%1: %2</p>").arg(i).arg(lorem.left(i * 7 % lorem.size()).repeated(i % 4 + 1));
+    QTest::newRow("plain") << plain << QSizeF(300, -1) << QSizeF();
+    QTest::newRow("pages") << plain << QSizeF(300, 200) << QSizeF();
+    // Lines broken ahead of the lazy layout must not be used for the new width
+    QTest::newRow("resized") << plain << QSizeF(300, -1) << QSizeF(220, -1);
+
+    QString formatted;
+    for (int i = 0; i < 100; ++i) {
+        formatted += QStringLiteral("<p style=\"margin-left: %1px; text-indent: %2px\" align=\"%3\">%4 <b>bold</b> <i>%5</i></p>")
+                .arg(i % 5 * 10).arg(i % 3 * 15 - 10)
+                .arg(i % 4 == 0 ? "left" : i % 4 == 1 ? "center" : i % 4 == 2 ? "right" : "justify")
+                .arg(lorem, lorem.left(i % 50));
+        formatted += QString::fromUtf8("<p dir=\"rtl\">\xd7\xa9\xd7\x9c\xd7\x95\xd7\x9d \xd7\xa2\xd7\x95\xd7\x9c\xd7\x9d %1</p>").arg(i);
+        formatted += QStringLiteral("<ul><li>%1</li></ul>").arg(lorem.left(i % 80));
+        formatted += QStringLiteral("<p>%1</p>").arg(QString(i % 7 + 30, QLatin1Char('W')));
+    }
+    QTest::newRow("formatted") << formatted << QSizeF(300, -1) << QSizeF();
+
+    const QString table = QStringLiteral("<table border=1><tr><td>%1</td><td>%1</td></tr></table>").arg(lorem);
+    QTest::newRow("table") << (plain.left(plain.size() / 2) + table + plain.mid(plain.size() / 2))
+                           << QSizeF(300, -1) << QSizeF();
+
+    // Floats make the widths of lines depend on their position; all is laid out serially
+    QTest::newRow("float") << (QStringLiteral("<table align=left width=100 height=300><tr><td>float</td></tr></table>") + plain)
+                           << QSizeF(300, -1) << QSizeF();
+}
+
+void tst_QTextDocumentLayout::parallelLayout()
+{
+    QFETCH(QString, html);
+    QFETCH(QSizeF, pageSize);
+    QFETCH(QSizeF, newPageSize);
+
+    const int maxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+    QThreadPool::globalInstance()->setMaxThreadCount(4);
+
+    auto layoutDocument = [&](QTextDocument *document, bool parallel) {
+        // The layout reads the environment when it is created
+        if (parallel)
+            qputenv("QT_PARALLEL_TEXT_LAYOUT", "1");
+        document->documentLayout();
+        qunsetenv("QT_PARALLEL_TEXT_LAYOUT");
+        document->setPageSize(pageSize);
+        document->setHtml(html);
+        document->size();
+        if (newPageSize.width() > 0) {
+            document->setPageSize(newPageSize);
+            document->size();
+        }
+    };
+
+    QTextDocument serial;
+    layoutDocument(&serial, false);
+    QTextDocument parallel;
+    layoutDocument(&parallel, true);
+
+    QThreadPool::globalInstance()->setMaxThreadCount(maxThreadCount);
+
+    QCOMPARE(parallel.size(), serial.size());
+    QCOMPARE(parallel.pageCount(), serial.pageCount());
+    QCOMPARE(parallel.blockCount(), serial.blockCount());
+    for (QTextBlock a = serial.begin(), b = parallel.begin(); a.isValid(); a = a.next(), b = b.next()) {
+        const QTextLayout *expected = a.layout();
+        const QTextLayout *actual = b.layout();
+        QCOMPARE(actual->position(), expected->position());
+        QCOMPARE(actual->lineCount(), expected->lineCount());
+        for (int i = 0; i < expected->lineCount(); ++i) {
+            const QTextLine expectedLine = expected->lineAt(i);
+            const QTextLine actualLine = actual->lineAt(i);
+            QCOMPARE(actualLine.textStart(), expectedLine.textStart());
+            QCOMPARE(actualLine.textLength(), expectedLine.textLength());
+            QCOMPARE(actualLine.rect(), expectedLine.rect());
+        }
+    }
+
+    // The lines are drawn with glyphs shaped on this thread
+    auto drawDocument = [](QTextDocument *document) {
+        QImage image(document->size().toSize(), QImage::Format_RGB32);
+        image.fill(Qt::white);
+        QPainter painter(&image);
+        document->drawContents(&painter);
+        return image;
+    };
+    QCOMPARE(drawDocument(&parallel), drawDocument(&serial));
+}
+
+void tst_QTextDocumentLayout::onDemandLayout()
+{
+    QString text;
+    for (int i = 0; i < 2000; ++i)
+        text += QString::number(i) + QStringLiteral(": Lorem ipsum dolor sit amet, consectetur adipiscing elit\n");
+
+    QTextDocument serial;
+    serial.setPlainText(text);
+    serial.setTextWidth(300);
+
+    QTextDocument document;
+    QTextDocumentLayout *layout = new QTextDocumentLayout(&document);
+    layout->setOnDemandLayoutEnabled(true);
+    document.setDocumentLayout(layout);
+    document.setPlainText(text);
+    document.setTextWidth(300);
+
+    // Nothing beyond the first step is laid out in the background
+    QTest::qWait(100);
+    QVERIFY(layout->layoutStatus() < 10);
+    const QTextBlock lastBlock = document.lastBlock().previous();
+    QCOMPARE(lastBlock.layout()->lineCount(), 0);
+
+    // The height of the rest is estimated
+    const qreal height = serial.size().height();
+    QVERIFY(layout->dynamicDocumentSize().height() < height / 10);
+    QVERIFY(qAbs(layout->estimatedDocumentSize().height() - height) < height / 10);
+
+    // Asking for a block lays out the document up to it
+    const QTextBlock middleBlock = document.findBlockByNumber(1000);
+    QCOMPARE(layout->blockBoundingRect(middleBlock),
+             serial.documentLayout()->blockBoundingRect(serial.findBlockByNumber(1000)));
+    QVERIFY(layout->layoutStatus() < 100);
+    QCOMPARE(lastBlock.layout()->lineCount(), 0);
+
+    // And hit testing lays it out up to the point
+    const QPointF point(10, height - 5);
+    QCOMPARE(layout->hitTest(point, Qt::FuzzyHit), serial.documentLayout()->hitTest(point, Qt::FuzzyHit));
+    QCOMPARE(layout->layoutStatus(), 100);
+    QCOMPARE(layout->dynamicDocumentSize(), serial.size());
+    QCOMPARE(layout->estimatedDocumentSize(), serial.size());
+
+    // Without it, the layout finishes in the background
+    QTextDocument background;
+    background.setPlainText(text);
+    background.setTextWidth(300);
+    QTextDocumentLayout *backgroundLayout = qobject_cast<QTextDocumentLayout *>(background.documentLayout());
+    QVERIFY(backgroundLayout);
+    QVERIFY(backgroundLayout->layoutStatus() < 100);
+    QTRY_COMPARE(backgroundLayout->layoutStatus(), 100);
+}
+
 QTEST_MAIN(tst_QTextDocumentLayout)
 #include "tst_qtextdocumentlayout.moc"
@@ -140,6 +140,8 @@ private slots:
     void showLineAndParagraphSeparatorsCrash();
     void koreanWordWrap();
     void tooManyDirectionalCharctersCrash_qtbug77819();
+    void shapedTextCache_data();
+    void shapedTextCache();
 
 private:
     QFont testFont;
@@ -2352,5 +2354,64 @@ void tst_QTextLayout::tooManyDirectionalCharctersCrash_qtbug77819()
     tl.endLayout();
 }
 
+void tst_QTextLayout::shapedTextCache_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<qreal>("letterSpacing");
+    QTest::addColumn<bool>("kerning");
+
+    QTest::newRow("latin") << QString::fromLatin1("Name: AVA office fluff") << 0.0 << true;
+    QTest::newRow("no kerning") << QString::fromLatin1("Name: AVA office fluff") << 0.0 << false;
+    QTest::newRow("letter spacing") << QString::fromLatin1("Name: AVA office fluff") << 2.0 << true;
+    QTest::newRow("hebrew") << QString::fromUtf8("\xd7\xa9\xd7\x9c\xd7\x95\xd7\x9d \xd7\xa2\xd7\x95\xd7\x9c\xd7\x9d") << 0.0 << true;
+    QTest::newRow("mixed") << QString::fromUtf8("abc \xd8\xb3\xd9\x84\xd8\xa7\xd9\x85 def") << 0.0 << true;
+    QTest::newRow("surrogates") << QString::fromUtf8("a\xf0\x9f\x98\x80b\xf0\x90\x8d\x88") << 0.0 << true;
+    QTest::newRow("separators") << (QLatin1String("first") + QChar(QChar::LineSeparator) + QLatin1String("second\tthird")) << 0.0 << true;
+}
+
+void tst_QTextLayout::shapedTextCache()
+{
+    QFETCH(QString, text);
+    QFETCH(qreal, letterSpacing);
+    QFETCH(bool, kerning);
+
+    QFont font;
+    font.setLetterSpacing(QFont::AbsoluteSpacing, letterSpacing);
+    font.setKerning(kerning);
+
+    auto layoutGlyphs = [&]() {
+        QTextLayout layout(text, font);
+        layout.beginLayout();
+        while (layout.createLine().isValid()) { }
+        layout.endLayout();
+        return layout.glyphRuns();
+    };
+
+    const int maxCost = QShapedTextCache::maxCost();
+    QShapedTextCache::setMaxCost(0);
+    const QList<QGlyphRun> uncached = layoutGlyphs();
+    QShapedTextCache::setMaxCost(maxCost);
+    QVERIFY(maxCost > 0);
+
+    QShapedTextCache::clear();
+    QShapedTextCache::resetStatistics();
+    QCOMPARE(layoutGlyphs(), uncached);
+    const QShapedTextCache::Statistics first = QShapedTextCache::statistics();
+    QVERIFY(first.misses > 0);
+    QVERIFY(first.count > 0);
+
+    // The second layout takes all of its glyphs from the cache
+    QCOMPARE(layoutGlyphs(), uncached);
+    const QShapedTextCache::Statistics second = QShapedTextCache::statistics();
+    QVERIFY(second.hits >= first.hits + first.misses);
+    QCOMPARE(second.misses, first.misses);
+    QCOMPARE(second.count, first.count);
+
+    // A different font is not served from the cache
+    font.setPixelSize(font.pixelSize() + 3);
+    layoutGlyphs();
+    QVERIFY(QShapedTextCache::statistics().misses > second.misses);
+}
+
 QTEST_MAIN(tst_QTextLayout)
 #include "tst_qtextlayout.moc"
@@ -133,6 +133,11 @@ void Http2Server::redirectOpenStream(quint16 port)
     targetPort = port;
 }
 
+void Http2Server::setSessionReceiveWindowSize(quint32 size)
+{
+    requestedSessionWindowSize = size;
+}
+
 bool Http2Server::isClearText() const
 {
     return connectionType == H2Type::h2c || connectionType == H2Type::h2cDirect;
@@ -175,7 +180,8 @@ void Http2Server::sendServerSettings()
     }
     writer.write(*socket);
     // Now, let's update our peer on a session recv window size:
-    const quint32 updatedSize = 10 * streamRecvWindowSize;
+    const quint32 updatedSize = requestedSessionWindowSize ? requestedSessionWindowSize
+                                                           : 10 * streamRecvWindowSize;
     if (sessionRecvWindowSize < updatedSize) {
         const quint32 delta = updatedSize - sessionRecvWindowSize;
         sessionRecvWindowSize = updatedSize;
@@ -724,6 +730,8 @@ void Http2Server::handleDATA()
 
     sessionCurrRecvWindow -= payloadSize;
 
+    emit receivedDATAFrame(streamID, streamWeights[streamID], payloadSize);
+
     if (sessionCurrRecvWindow < sessionRecvWindowSize / 2) {
         // This is some quite naive and trivial logic on when to update.
 
@@ -934,6 +942,7 @@ void Http2Server::processRequest()
 
     // Actually, if needed, we can do a comparison here.
     activeRequests[streamID] = decoder.decodedHeader();
+    streamWeights[streamID] = w;
     if (headersFrame.flags().testFlag(FrameFlag::END_STREAM))
         emit receivedRequest(streamID);
 
@@ -88,6 +88,7 @@ public:
     void setResponseBody(const QByteArray &body);
     void emulateGOAWAY(int timeout);
     void redirectOpenStream(quint16 targetPort);
+    void setSessionReceiveWindowSize(quint32 size);
 
     bool isClearText() const;
 
@@ -127,6 +128,7 @@ Q_SIGNALS:
     void decompressionFailed(quint32 streamID);
     void receivedRequest(quint32 streamID);
     void receivedData(quint32 streamID);
+    void receivedDATAFrame(quint32 streamID, uchar weight, quint32 payloadSize);
     void windowUpdate(quint32 streamID);
     void sendingData();
 
@@ -164,6 +166,8 @@ private:
     FrameSequence continuedRequest;
 
     std::map<quint32, quint32> streamWindows;
+    // Weights from the PRIORITY part of HEADERS, reported with DATA frames.
+    std::map<quint32, uchar> streamWeights;
 
     HPack::Decoder decoder{HPack::FieldLookupTable::DefaultSize};
     HPack::Encoder encoder{HPack::FieldLookupTable::DefaultSize, true};
@@ -184,6 +188,9 @@ private:
     quint32 sessionCurrRecvWindow = sessionRecvWindowSize;
     // This we potentially update only once (sendServerSettings).
     quint32 streamRecvWindowSize = Http2::defaultSessionWindowSize;
+    // If non-zero, the session window to announce instead of a multiple
+    // of the stream window.
+    quint32 requestedSessionWindowSize = 0;
 
     QByteArray responseBody;
     bool pushPromiseEnabled = false;
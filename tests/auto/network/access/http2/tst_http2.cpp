@@ -103,6 +103,7 @@ private slots:
     void multipleRequests();
     void flowControlClientSide();
     void flowControlServerSide();
+    void weightedUploads();
     void pushPromise();
     void goaway_data();
     void goaway();
@@ -402,6 +403,80 @@ void tst_Http2::flowControlServerSide()
     QVERIFY(serverGotSettingsACK);
 }
 
+void tst_Http2::weightedUploads()
+{
+    // Two uploads with different priorities are limited by the session
+    // send window only. The client has to share the window between them
+    // according to their weights, instead of finishing one of them first.
+    clearHTTP2State();
+
+    serverPort = 0;
+    nRequests = 2;
+
+    // Direct clear text: no TLS needed, and unlike the protocol upgrade
+    // both requests are sent as HTTP/2 streams with weights.
+    const H2Type connectionType = H2Type::h2cDirect;
+    // Stream windows larger than the uploads, and the session window at its
+    // initial size: only the session window limits the client.
+    const RawSettings serverSettings = {{Http2::Settings::MAX_CONCURRENT_STREAMS_ID, 100},
+                                        {Http2::Settings::INITIAL_WINDOW_SIZE_ID, Http2::maxSessionReceiveWindowSize}};
+    ServerPtr srv(newServer(serverSettings, connectionType));
+    srv->setSessionReceiveWindowSize(Http2::defaultSessionWindowSize);
+
+    // DATA bytes received, by the stream weight the client sent.
+    QMap<uchar, quint64> receivedBytes;
+    QMap<uchar, quint64> receivedWhenFirstFinished;
+    std::map<quint32, uchar> weights;
+    connect(srv.data(), &Http2Server::receivedDATAFrame, this,
+            [&](quint32 streamID, uchar weight, quint32 payloadSize) {
+        weights[streamID] = weight;
+        receivedBytes[weight] += payloadSize;
+    });
+    connect(srv.data(), &Http2Server::receivedData, this, [&](quint32 streamID) {
+        if (receivedWhenFirstFinished.isEmpty()) {
+            QCOMPARE(weights[streamID], uchar(255));
+            receivedWhenFirstFinished = receivedBytes;
+        }
+    });
+
+    QMetaObject::invokeMethod(srv.data(), "startServer", Qt::QueuedConnection);
+
+    runEventLoop();
+    QVERIFY(serverPort != 0);
+
+    // Much larger than the session window.
+    const QByteArray payload(int(Http2::defaultSessionWindowSize * 20), 'x');
+    for (const auto priority : {QNetworkRequest::HighPriority, QNetworkRequest::NormalPriority}) {
+        auto url = requestUrl(connectionType);
+        url.setPath(QString("/stream%1.html").arg(int(priority)));
+
+        QNetworkRequest request(url);
+        request.setAttribute(QNetworkRequest::Http2DirectAttribute, QVariant(true));
+        request.setHeader(QNetworkRequest::ContentTypeHeader, QVariant("text/plain"));
+        request.setPriority(priority);
+
+        auto reply = manager->post(request, payload);
+        connect(reply, &QNetworkReply::finished, this, &tst_Http2::replyFinished);
+    }
+
+    runEventLoop(120000);
+    STOP_ON_FAILURE
+
+    QVERIFY(nRequests == 0);
+    QVERIFY(prefaceOK);
+    QVERIFY(serverGotSettingsACK);
+
+    QCOMPARE(receivedBytes.value(255), quint64(payload.size()));
+    QCOMPARE(receivedBytes.value(127), quint64(payload.size()));
+
+    // The weights are 256 and 128 (the value in the frame plus one), so the
+    // normal priority upload is about half done when the other one finishes.
+    QCOMPARE(receivedWhenFirstFinished.value(255), quint64(payload.size()));
+    const quint64 normalProgress = receivedWhenFirstFinished.value(127);
+    QVERIFY2(normalProgress > payload.size() * 0.4 && normalProgress < payload.size() * 0.6,
+             QByteArray::number(normalProgress));
+}
+
 void tst_Http2::pushPromise()
 {
     // We will first send some request, the server should reply and also emulate
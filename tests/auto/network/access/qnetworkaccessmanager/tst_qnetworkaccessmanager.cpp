@@ -30,6 +30,8 @@
 
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
 #ifndef QT_NO_BEARERMANAGEMENT
 #include <QtNetwork/QNetworkConfigurationManager>
 #endif
@@ -50,6 +52,8 @@ public:
 private slots:
     void networkAccessible();
     void alwaysCacheRequest();
+    void connectionSharing_data();
+    void connectionSharing();
 };
 
 tst_QNetworkAccessManager::tst_QNetworkAccessManager()
@@ -138,5 +142,48 @@ void tst_QNetworkAccessManager::alwaysCacheRequest()
     delete reply;
 }
 
+void tst_QNetworkAccessManager::connectionSharing_data()
+{
+    QTest::addColumn<bool>("sharing");
+    QTest::addColumn<int>("expectedConnections");
+    QTest::newRow("separate") << false << 2;
+    QTest::newRow("shared") << true << 1;
+}
+
+void tst_QNetworkAccessManager::connectionSharing()
+{
+    QFETCH(bool, sharing);
+    QFETCH(int, expectedConnections);
+
+    // A keep-alive HTTP server that counts the connections it accepts
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    int connections = 0;
+    connect(&server, &QTcpServer::newConnection, [&server, &connections] {
+        QTcpSocket *socket = server.nextPendingConnection();
+        ++connections;
+        connect(socket, &QTcpSocket::readyRead, [socket] {
+            if (socket->readAll().endsWith("\r\n\r\n"))
+                socket->write("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok");
+        });
+    });
+
+    QNetworkAccessManager first;
+    QNetworkAccessManager second;
+    QVERIFY(!first.isConnectionSharingEnabled());
+    first.setConnectionSharingEnabled(sharing);
+    second.setConnectionSharingEnabled(sharing);
+    QCOMPARE(second.isConnectionSharingEnabled(), sharing);
+
+    const QUrl url(QLatin1String("http://127.0.0.1:") + QString::number(server.serverPort()));
+    for (QNetworkAccessManager *manager : { &first, &second }) {
+        QScopedPointer<QNetworkReply> reply(manager->get(QNetworkRequest(url)));
+        QTRY_VERIFY(reply->isFinished());
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QCOMPARE(reply->readAll(), QByteArray("ok"));
+    }
+    QCOMPARE(connections, expectedConnections);
+}
+
 QTEST_MAIN(tst_QNetworkAccessManager)
 #include "tst_qnetworkaccessmanager.moc"
@@ -65,6 +65,7 @@
 #include <QSslSocket>
 #endif
 #include <QTextStream>
+#include <QTemporaryFile>
 #include <QThread>
 #include <QElapsedTimer>
 #include <QTimer>
@@ -197,6 +198,10 @@ private slots:
 
     void setSocketOption();
     void clientSendDataOnDelayedDisconnect();
+    void writeBufferList_data();
+    void writeBufferList();
+    void sendFile_data();
+    void sendFile();
     void serverDisconnectWithBuffered();
     void socketDiscardDataInWriteMode();
     void writeOnReadBufferOverflow();
@@ -3067,6 +3072,135 @@ void tst_QTcpSocket::clientSendDataOnDelayedDisconnect()
     delete socket;
 }
 
+void tst_QTcpSocket::writeBufferList_data()
+{
+    QTest::addColumn<bool>("unbuffered");
+    QTest::newRow("buffered") << false;
+    QTest::newRow("unbuffered") << true;
+}
+
+// Test that a list of buffers and a write buffer made of many chunks
+// arrive complete and in order
+void tst_QTcpSocket::writeBufferList()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+    QFETCH(bool, unbuffered);
+
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QTcpSocket *socket = newSocket();
+    socket->connectToHost(server.serverAddress(), server.serverPort(),
+                          unbuffered ? QIODevice::ReadWrite | QIODevice::Unbuffered
+                                     : QIODevice::ReadWrite);
+    QVERIFY(socket->waitForConnected(5000));
+    QVERIFY(server.waitForNewConnection(5000));
+    QTcpSocket *newConnection = server.nextPendingConnection();
+    QVERIFY(newConnection != nullptr);
+
+    QByteArray expected;
+    QByteArrayList frames;
+    for (int i = 0; i < 100; ++i) {
+        frames << QByteArray::number(i) + ':' + QByteArray(i, 'a' + i % 26) + '\n';
+        expected += frames.last();
+    }
+    QCOMPARE(socket->write(frames), qint64(expected.size()));
+
+    // more than one chunk of the write buffer
+    for (int i = 0; i < 10; ++i) {
+        const QByteArray block(20000, char('0' + i));
+        QCOMPARE(socket->write(block), qint64(block.size()));
+        expected += block;
+    }
+    QCOMPARE(socket->write(QByteArrayList()), qint64(0));
+
+    QByteArray received;
+    QElapsedTimer timer;
+    timer.start();
+    while (received.size() < expected.size() && timer.elapsed() < 10000) {
+        socket->waitForBytesWritten(10);
+        newConnection->waitForReadyRead(10);
+        received += newConnection->readAll();
+    }
+    QCOMPARE(received.size(), expected.size());
+    QCOMPARE(received, expected);
+
+    delete socket;
+}
+
+void tst_QTcpSocket::sendFile_data()
+{
+    QTest::addColumn<bool>("unbuffered");
+    QTest::newRow("buffered") << false;
+    QTest::newRow("unbuffered") << true;
+}
+
+// Test that file ranges are sent in order with data written around them
+void tst_QTcpSocket::sendFile()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+    QFETCH(bool, unbuffered);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QByteArray contents;
+    for (int i = 0; i < 50000; ++i)
+        contents += QByteArray::number(i) + '\n';
+    QCOMPARE(file.write(contents), qint64(contents.size()));
+    QVERIFY(file.flush());
+
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QTcpSocket *socket = newSocket();
+    QTest::ignoreMessage(QtWarningMsg, "QAbstractSocket::sendFile: Socket is not a connected TCP socket");
+    QVERIFY(!socket->sendFile(&file));
+    socket->connectToHost(server.serverAddress(), server.serverPort(),
+                          unbuffered ? QIODevice::ReadWrite | QIODevice::Unbuffered
+                                     : QIODevice::ReadWrite);
+    QVERIFY(socket->waitForConnected(5000));
+    QVERIFY(server.waitForNewConnection(5000));
+    QTcpSocket *newConnection = server.nextPendingConnection();
+    QVERIFY(newConnection != nullptr);
+
+    QList<QFile *> sentFiles;
+    connect(socket, &QAbstractSocket::fileSent, [&sentFiles](QFile *sent) { sentFiles << sent; });
+    QTest::ignoreMessage(QtWarningMsg, "QAbstractSocket::sendFile: Range is outside of the file");
+    QVERIFY(!socket->sendFile(&file, contents.size() - 10, 20));
+
+    QByteArray expected = "header\n";
+    QCOMPARE(socket->write(expected), qint64(expected.size()));
+    QVERIFY(socket->sendFile(&file));
+    expected += contents;
+    QCOMPARE(socket->write("middle\n"), qint64(7));
+    expected += "middle\n";
+    QVERIFY(socket->sendFile(&file, 100, 1000));
+    expected += contents.mid(100, 1000);
+    QVERIFY(socket->sendFile(&file, 0, 0));
+    QCOMPARE(socket->write("trailer\n"), qint64(8));
+    expected += "trailer\n";
+    QVERIFY(socket->bytesToWrite() > contents.size() + 1000);
+
+    QByteArray received;
+    QElapsedTimer timer;
+    timer.start();
+    while (received.size() < expected.size() && timer.elapsed() < 10000) {
+        socket->waitForBytesWritten(10);
+        newConnection->waitForReadyRead(10);
+        received += newConnection->readAll();
+    }
+    QCOMPARE(received.size(), expected.size());
+    QCOMPARE(received, expected);
+    QCOMPARE(socket->bytesToWrite(), qint64(0));
+    QCOMPARE(sentFiles, QList<QFile *>({ &file, &file, &file }));
+
+    delete socket;
+}
+
 // Test buffered socket being properly closed on remote disconnect
 void tst_QTcpSocket::serverDisconnectWithBuffered()
 {
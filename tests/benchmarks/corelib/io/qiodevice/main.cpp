@@ -41,6 +41,8 @@ private slots:
     void read_old_data() { read_data(); }
     void peekAndRead();
     void peekAndRead_data() { read_data(); }
+    void forward_data();
+    void forward();
     //void read_new();
     //void read_new_data() { read_data(); }
 private:
@@ -119,6 +121,58 @@ void tst_qiodevice::peekAndRead()
     }
 }
 
+// A sequential device producing data in blocks, like a socket does
+class BlockDevice : public QIODevice
+{
+public:
+    BlockDevice(qint64 size) : remaining(size), block(16384, 'x') {}
+    bool isSequential() const override { return true; }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        const qint64 n = qMin(qMin(maxSize, remaining), qint64(block.size()));
+        memcpy(data, block.constData(), n);
+        remaining -= n;
+        return n;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    qint64 remaining;
+    QByteArray block;
+};
+
+void tst_qiodevice::forward_data()
+{
+    QTest::addColumn<bool>("useReadChunk");
+    QTest::newRow("read") << false;
+    QTest::newRow("readChunk") << true;
+}
+
+void tst_qiodevice::forward()
+{
+    QFETCH(bool, useReadChunk);
+    const qint64 size = 64 * 1024 * 1024;
+
+    QBENCHMARK {
+        BlockDevice device(size);
+        device.open(QIODevice::ReadOnly);
+        qint64 total = 0;
+        forever {
+            // make sure the data is in the device's buffer, as for a socket
+            char c;
+            if (!device.getChar(&c))
+                break;
+            device.ungetChar(c);
+            const QByteArray block = useReadChunk ? device.readChunk()
+                                                  : device.read(device.bytesAvailable());
+            total += block.size();
+        }
+        QCOMPARE(total, size);
+    }
+}
+
 QTEST_MAIN(tst_qiodevice)
 
 #include "main.moc"
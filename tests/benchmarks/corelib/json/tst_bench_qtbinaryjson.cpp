@@ -28,6 +28,7 @@
 
 #include <QtTest>
 #include <qjsondocument.h>
+#include <qjsonarray.h>
 #include <qjsonobject.h>
 
 class BenchmarkQtBinaryJson: public QObject
@@ -45,6 +46,8 @@ private Q_SLOTS:
     void parseNumbers();
     void parseJson();
     void parseJsonToVariant();
+    void parseThroughput_data();
+    void parseThroughput();
 
     void toByteArray();
     void fromByteArray();
@@ -120,6 +123,51 @@ void BenchmarkQtBinaryJson::parseJsonToVariant()
     }
 }
 
+void BenchmarkQtBinaryJson::parseThroughput_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    // about 8 MB per document, in shapes that stress different parts of
+    // the parser
+    const int records = 40000;
+    QJsonArray array;
+    for (int i = 0; i < records; ++i) {
+        QJsonObject record;
+        record.insert(QLatin1String("id"), i);
+        record.insert(QLatin1String("name"), QString::fromLatin1("record number %1 of the feed").arg(i));
+        record.insert(QLatin1String("description"),
+                      QLatin1String("A longer plain text value, as commonly found in feeds, "
+                                    "that contains no escapes and only ASCII characters."));
+        record.insert(QLatin1String("active"), i % 2 == 0);
+        array.append(record);
+    }
+    const QJsonDocument doc(array);
+    QTest::newRow("compact") << doc.toJson(QJsonDocument::Compact);
+    QTest::newRow("indented") << doc.toJson(QJsonDocument::Indented);
+
+    QJsonArray escaped;
+    QJsonArray utf8;
+    for (int i = 0; i < records; ++i) {
+        escaped.append(QString::fromLatin1("line %1\n\t\"quoted\" text with a \\ backslash "
+                                           "and enough plain characters around it").arg(i));
+        utf8.append(QString::fromUtf8("Zeile %1: Gr\xc3\xb6\xc3\x9f" "e, \xc3\x9c" "bersetzung, "
+                                      "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e and plain ASCII text").arg(i));
+    }
+    QTest::newRow("escaped-strings") << QJsonDocument(escaped).toJson(QJsonDocument::Compact);
+    QTest::newRow("utf8-strings") << QJsonDocument(utf8).toJson(QJsonDocument::Compact);
+}
+
+void BenchmarkQtBinaryJson::parseThroughput()
+{
+    QFETCH(QByteArray, json);
+
+    QBENCHMARK {
+        QJsonParseError error;
+        QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+    }
+}
+
 void BenchmarkQtBinaryJson::toByteArray()
 {
     // Example: send information over a datastream to another process
@@ -6,8 +6,13 @@ SUBDIRS = \
         qobject \
         qvariant \
         qcoreapplication \
+        qsocketnotifier \
+        qtimer \
         qtimer_vs_qmetaobject
 
+!unix: SUBDIRS -= \
+    qsocketnotifier
+
 !qtHaveModule(widgets): SUBDIRS -= \
     qmetaobject \
     qobject
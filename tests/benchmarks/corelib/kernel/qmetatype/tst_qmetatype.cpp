@@ -28,6 +28,10 @@
 
 #include <qtest.h>
 #include <QtCore/qmetatype.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qvariant.h>
+
+#include <functional>
 
 class tst_QMetaType : public QObject
 {
@@ -65,6 +69,15 @@ private slots:
     void constructInPlaceCopy();
     void constructInPlaceCopyStaticLess_data();
     void constructInPlaceCopyStaticLess();
+
+    void variantCustomConcurrently_data() { threadCount_data(); }
+    void variantCustomConcurrently();
+    void queuedSignalConcurrently_data() { threadCount_data(); }
+    void queuedSignalConcurrently();
+
+private:
+    void threadCount_data();
+    void runConcurrently(int threadCount, const std::function<void()> &work);
 };
 
 tst_QMetaType::tst_QMetaType()
@@ -319,5 +332,101 @@ void tst_QMetaType::constructInPlaceCopyStaticLess()
     qFreeAligned(storage);
 }
 
+void tst_QMetaType::threadCount_data()
+{
+    QTest::addColumn<int>("threadCount");
+    for (int threadCount : {1, 2, 4, 8}) {
+        QTest::addRow("%d thread%s", threadCount, threadCount == 1 ? "" : "s")
+                << threadCount;
+    }
+}
+
+namespace {
+class WorkerThread : public QThread
+{
+public:
+    explicit WorkerThread(const std::function<void()> &work) : work(work) {}
+    void run() override { work(); }
+private:
+    std::function<void()> work;
+};
+}
+
+// Each thread does the same amount of work, so the time only stays the same
+// with more threads if they don't get in each other's way
+void tst_QMetaType::runConcurrently(int threadCount, const std::function<void()> &work)
+{
+    std::vector<std::unique_ptr<WorkerThread>> threads;
+    for (int i = 0; i < threadCount; ++i)
+        threads.emplace_back(new WorkerThread(work));
+    for (const auto &thread : threads)
+        thread->start();
+    for (const auto &thread : threads)
+        thread->wait();
+}
+
+static double bigClassToDouble(const BigClass &big)
+{
+    return big.n;
+}
+
+void tst_QMetaType::variantCustomConcurrently()
+{
+    QFETCH(int, threadCount);
+    if (!QMetaType::hasRegisteredConverterFunction<BigClass, double>())
+        QMetaType::registerConverter<BigClass, double>(bigClassToDouble);
+
+    QBENCHMARK {
+        runConcurrently(threadCount, [] {
+            const QVariant big = QVariant::fromValue(BigClass{1, 2, 3, 4, 5, 6});
+            for (int i = 0; i < 20000; ++i) {
+                QVariant copy(big.userType(), big.constData());
+                if (copy.value<double>() != 1)
+                    qFatal("conversion failed");
+            }
+        });
+    }
+}
+
+namespace {
+class Sender : public QObject
+{
+    Q_OBJECT
+signals:
+    void send(const BigClass &big);
+};
+
+class Receiver : public QObject
+{
+    Q_OBJECT
+public slots:
+    void receive(const BigClass &big) { sum += big.n; }
+public:
+    double sum = 0;
+};
+}
+
+void tst_QMetaType::queuedSignalConcurrently()
+{
+    QFETCH(int, threadCount);
+    qRegisterMetaType<BigClass>();
+
+    QBENCHMARK {
+        runConcurrently(threadCount, [] {
+            Sender sender;
+            Receiver receiver;
+            QObject::connect(&sender, &Sender::send, &receiver, &Receiver::receive,
+                             Qt::QueuedConnection);
+            for (int i = 0; i < 100; ++i) {
+                for (int j = 0; j < 100; ++j)
+                    emit sender.send(BigClass{1, 2, 3, 4, 5, 6});
+                QCoreApplication::sendPostedEvents(&receiver);
+            }
+            if (receiver.sum != 100 * 100)
+                qFatal("lost queued calls");
+        });
+    }
+}
+
 QTEST_MAIN(tst_QMetaType)
 #include "tst_qmetatype.moc"
@@ -51,6 +51,8 @@ private slots:
     void connect_disconnect_benchmark_data();
     void connect_disconnect_benchmark();
     void receiver_destroyed_benchmark();
+    void queued_signal_throughput_data();
+    void queued_signal_throughput();
 
     void stdAllocator();
 };
@@ -305,6 +307,64 @@ void QObjectBenchmark::receiver_destroyed_benchmark()
     }
 }
 
+void QObjectBenchmark::queued_signal_throughput_data()
+{
+    QTest::addColumn<int>("producers");
+    QTest::addColumn<int>("burst");
+    for (int producers : {1, 2, 4, 8}) {
+        for (int burst : {1, 64, 1024}) {
+            QTest::addRow("%d producer(s), burst %d", producers, burst)
+                    << producers << burst;
+        }
+    }
+}
+
+void QObjectBenchmark::queued_signal_throughput()
+{
+    QFETCH(int, producers);
+    QFETCH(int, burst);
+    const int total = 64 * 1024;
+    const int perProducer = total / producers;
+
+    QThread receiverThread;
+    QObject receiver;
+    receiver.moveToThread(&receiverThread);
+    receiverThread.start();
+
+    QAtomicInt received;
+    QList<Object *> senders;
+    for (int i = 0; i < producers; ++i) {
+        senders.append(new Object);
+        QObject::connect(senders.last(), &Object::signal0, &receiver,
+                         [&received] { received.ref(); }, Qt::QueuedConnection);
+    }
+
+    QBENCHMARK {
+        received.storeRelaxed(0);
+        QList<QThread *> threads;
+        for (Object *sender : qAsConst(senders)) {
+            threads.append(QThread::create([sender, perProducer, burst] {
+                for (int emitted = 0; emitted < perProducer; ) {
+                    for (int i = 0; i < burst && emitted < perProducer; ++i, ++emitted)
+                        emit sender->signal0();
+                    QThread::yieldCurrentThread();
+                }
+            }));
+        }
+        for (QThread *thread : qAsConst(threads))
+            thread->start();
+        for (QThread *thread : qAsConst(threads))
+            thread->wait();
+        while (received.loadAcquire() < perProducer * producers)
+            QThread::yieldCurrentThread();
+        qDeleteAll(threads);
+    }
+
+    qDeleteAll(senders);
+    receiverThread.quit();
+    receiverThread.wait();
+}
+
 QTEST_MAIN(QObjectBenchmark)
 
 #include "main.moc"
@@ -0,0 +1,109 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qscopeguard.h>
+#include <QtCore/qsocketnotifier.h>
+#include <QtCore/qvector.h>
+#include <QtTest/QtTest>
+
+#include <memory>
+#include <vector>
+
+#include <errno.h>
+#include <unistd.h>
+
+/*
+    Measures the cost of one event dispatcher wakeup as a function of the
+    number of enabled socket notifiers, with only one of them becoming ready.
+
+    The dispatcher backend is chosen when the event dispatcher is created, so
+    compare backends by running this benchmark once with QT_NO_GLIB=1 (the
+    poll()-based dispatcher) and once with QT_EVENT_DISPATCHER_EPOLL=1.
+*/
+class tst_QSocketNotifier : public QObject
+{
+    Q_OBJECT
+private slots:
+    void wakeup_data();
+    void wakeup();
+};
+
+void tst_QSocketNotifier::wakeup_data()
+{
+    QTest::addColumn<int>("notifierCount");
+
+    for (int count : { 1, 10, 100, 1000, 5000, 10000 })
+        QTest::addRow("%d", count) << count;
+}
+
+void tst_QSocketNotifier::wakeup()
+{
+    QFETCH(int, notifierCount);
+
+    QVector<int> fds;
+    std::vector<std::unique_ptr<QSocketNotifier>> notifiers;
+    auto cleanup = qScopeGuard([&] {
+        notifiers.clear();
+        for (int fd : qAsConst(fds))
+            ::close(fd);
+    });
+
+    fds.reserve(2 * notifierCount);
+    notifiers.reserve(notifierCount);
+    for (int i = 0; i < notifierCount; ++i) {
+        int pipefds[2];
+        if (::pipe(pipefds) == -1)
+            QSKIP(qPrintable(QString::fromLatin1("Cannot create %1 pipes: %2")
+                             .arg(notifierCount).arg(qt_error_string(errno))));
+        fds << pipefds[0] << pipefds[1];
+        notifiers.emplace_back(new QSocketNotifier(pipefds[0], QSocketNotifier::Read));
+    }
+
+    // only the last pipe ever becomes readable; its slot drains it again
+    const int readFd = fds.at(fds.size() - 2);
+    const int writeFd = fds.last();
+    int activations = 0;
+    connect(notifiers.back().get(), &QSocketNotifier::activated, this, [&] {
+        char c;
+        if (::read(readFd, &c, 1) == 1)
+            ++activations;
+    });
+
+    QBENCHMARK {
+        const char c = 0;
+        QCOMPARE(::write(writeFd, &c, 1), ssize_t(1));
+        QCoreApplication::processEvents();
+    }
+
+    QVERIFY(activations > 0);
+}
+
+QTEST_GUILESS_MAIN(tst_QSocketNotifier)
+
+#include "tst_qsocketnotifier.moc"
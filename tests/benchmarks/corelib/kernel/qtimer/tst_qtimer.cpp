@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/qbasictimer.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qobject.h>
+#include <QtTest/QtTest>
+
+#include <vector>
+
+/*
+    Timer churn: a large number of long-running timers (think per-connection
+    idle timeouts) exist while a few of them are restarted, registered or
+    stopped over and over.
+*/
+class tst_QTimer : public QObject
+{
+    Q_OBJECT
+private slots:
+    void restart_data();
+    void restart();
+    void startStopAll_data();
+    void startStopAll();
+    void fireWithManyIdle_data();
+    void fireWithManyIdle();
+};
+
+class TimerObject : public QObject
+{
+public:
+    int fired = 0;
+
+protected:
+    void timerEvent(QTimerEvent *) override { ++fired; }
+};
+
+static void addTimerRows()
+{
+    QTest::addColumn<int>("timerCount");
+    QTest::addColumn<Qt::TimerType>("timerType");
+
+    for (int count : { 100, 1000, 10000, 50000 }) {
+        QTest::addRow("precise-%d", count) << count << Qt::PreciseTimer;
+        QTest::addRow("coarse-%d", count) << count << Qt::CoarseTimer;
+        QTest::addRow("verycoarse-%d", count) << count << Qt::VeryCoarseTimer;
+    }
+}
+
+void tst_QTimer::restart_data()
+{
+    addTimerRows();
+}
+
+// Restarting a QBasicTimer unregisters and registers it again
+void tst_QTimer::restart()
+{
+    QFETCH(int, timerCount);
+    QFETCH(Qt::TimerType, timerType);
+
+    TimerObject object;
+    std::vector<QBasicTimer> timers(timerCount);
+    for (int i = 0; i < timerCount; ++i)
+        timers[i].start(30000 + i, timerType, &object);
+
+    int i = 0;
+    QBENCHMARK {
+        timers[i].start(30000 + i, timerType, &object);
+        if (++i == timerCount)
+            i = 0;
+    }
+
+    QCOMPARE(object.fired, 0);
+}
+
+void tst_QTimer::startStopAll_data()
+{
+    addTimerRows();
+}
+
+void tst_QTimer::startStopAll()
+{
+    QFETCH(int, timerCount);
+    QFETCH(Qt::TimerType, timerType);
+
+    TimerObject object;
+    std::vector<QBasicTimer> timers(timerCount);
+    QBENCHMARK {
+        for (int i = 0; i < timerCount; ++i)
+            timers[i].start(30000 + i, timerType, &object);
+        for (int i = 0; i < timerCount; ++i)
+            timers[i].stop();
+    }
+
+    QCOMPARE(object.fired, 0);
+}
+
+void tst_QTimer::fireWithManyIdle_data()
+{
+    addTimerRows();
+}
+
+// One zero-interval timer fires on every event loop iteration while all the
+// others stay idle
+void tst_QTimer::fireWithManyIdle()
+{
+    QFETCH(int, timerCount);
+    QFETCH(Qt::TimerType, timerType);
+
+    TimerObject idle;
+    std::vector<QBasicTimer> timers(timerCount);
+    for (int i = 0; i < timerCount; ++i)
+        timers[i].start(30000 + i, timerType, &idle);
+
+    TimerObject busy;
+    QBasicTimer busyTimer;
+    busyTimer.start(0, Qt::PreciseTimer, &busy);
+
+    QBENCHMARK {
+        QCoreApplication::processEvents();
+    }
+
+    QVERIFY(busy.fired > 0);
+    QCOMPARE(idle.fired, 0);
+}
+
+QTEST_GUILESS_MAIN(tst_QTimer)
+
+#include "tst_qtimer.moc"
@@ -0,0 +1,189 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QByteArrayMatcher>
+#include <QMultiByteArrayMatcher>
+#include <QMultiStringMatcher>
+#include <QRandomGenerator>
+#include <QStringMatcher>
+#include <qtest.h>
+
+class tst_QMultiMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void byteArray_data();
+    void byteArray();
+    void string_data();
+    void string();
+
+private:
+    void setupData();
+};
+
+// Builds log-like lines and a keyword list of which roughly one line in
+// twenty contains a member.
+static void makeLogData(int keywordCount, QList<QByteArray> *keywords, QList<QByteArray> *lines)
+{
+    QRandomGenerator rng(keywordCount);
+    const auto word = [&rng](int minLength, int maxLength) {
+        QByteArray w(minLength + rng.bounded(maxLength - minLength + 1), Qt::Uninitialized);
+        for (char &c : w)
+            c = char('a' + rng.bounded(26));
+        return w;
+    };
+
+    keywords->clear();
+    for (int i = 0; i < keywordCount; ++i)
+        keywords->append(word(6, 12));
+
+    lines->clear();
+    for (int i = 0; i < 5000; ++i) {
+        QByteArray line = "2020-03-14 15:09:26.535 [worker-" + QByteArray::number(i % 8) + "] ";
+        while (line.size() < 120)
+            line += word(2, 9) + ' ';
+        if (rng.bounded(20) == 0)
+            line.insert(30 + rng.bounded(80), keywords->at(rng.bounded(keywordCount)));
+        lines->append(line);
+    }
+}
+
+void tst_QMultiMatcher::setupData()
+{
+    QTest::addColumn<int>("keywordCount");
+    QTest::addColumn<bool>("multi");
+
+    for (int keywordCount : { 10, 100, 500 }) {
+        QTest::addRow("%d keywords, QByteArrayMatcher loop", keywordCount) << keywordCount << false;
+        QTest::addRow("%d keywords, multi-pattern", keywordCount) << keywordCount << true;
+    }
+}
+
+void tst_QMultiMatcher::byteArray_data()
+{
+    setupData();
+}
+
+void tst_QMultiMatcher::byteArray()
+{
+    QFETCH(int, keywordCount);
+    QFETCH(bool, multi);
+
+    QList<QByteArray> keywords, lines;
+    makeLogData(keywordCount, &keywords, &lines);
+
+    int matches = 0;
+    if (multi) {
+        const QMultiByteArrayMatcher matcher(keywords);
+        QBENCHMARK {
+            matches = 0;
+            for (const QByteArray &line : qAsConst(lines))
+                matches += matcher.indexIn(line) >= 0;
+        }
+    } else {
+        QVector<QByteArrayMatcher> matchers;
+        for (const QByteArray &keyword : qAsConst(keywords))
+            matchers.append(QByteArrayMatcher(keyword));
+        QBENCHMARK {
+            matches = 0;
+            for (const QByteArray &line : qAsConst(lines)) {
+                for (const QByteArrayMatcher &matcher : qAsConst(matchers)) {
+                    if (matcher.indexIn(line) >= 0) {
+                        ++matches;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    QVERIFY(matches > 0);
+}
+
+void tst_QMultiMatcher::string_data()
+{
+    QTest::addColumn<int>("keywordCount");
+    QTest::addColumn<bool>("multi");
+    QTest::addColumn<bool>("caseInsensitive");
+
+    for (int keywordCount : { 10, 100, 500 }) {
+        for (bool caseInsensitive : { false, true }) {
+            const char *cs = caseInsensitive ? "case-insensitive" : "case-sensitive";
+            QTest::addRow("%d keywords, %s, QStringMatcher loop", keywordCount, cs)
+                    << keywordCount << false << caseInsensitive;
+            QTest::addRow("%d keywords, %s, multi-pattern", keywordCount, cs)
+                    << keywordCount << true << caseInsensitive;
+        }
+    }
+}
+
+void tst_QMultiMatcher::string()
+{
+    QFETCH(int, keywordCount);
+    QFETCH(bool, multi);
+    QFETCH(bool, caseInsensitive);
+    const Qt::CaseSensitivity cs = caseInsensitive ? Qt::CaseInsensitive : Qt::CaseSensitive;
+
+    QList<QByteArray> keywordData, lineData;
+    makeLogData(keywordCount, &keywordData, &lineData);
+    QStringList keywords, lines;
+    for (const QByteArray &keyword : qAsConst(keywordData))
+        keywords.append(QString::fromLatin1(keyword));
+    for (const QByteArray &line : qAsConst(lineData))
+        lines.append(QString::fromLatin1(line));
+
+    int matches = 0;
+    if (multi) {
+        const QMultiStringMatcher matcher(keywords, cs);
+        QBENCHMARK {
+            matches = 0;
+            for (const QString &line : qAsConst(lines))
+                matches += matcher.indexIn(line) >= 0;
+        }
+    } else {
+        QVector<QStringMatcher> matchers;
+        for (const QString &keyword : qAsConst(keywords))
+            matchers.append(QStringMatcher(keyword, cs));
+        QBENCHMARK {
+            matches = 0;
+            for (const QString &line : qAsConst(lines)) {
+                for (const QStringMatcher &matcher : qAsConst(matchers)) {
+                    if (matcher.indexIn(line) >= 0) {
+                        ++matches;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    QVERIFY(matches > 0);
+}
+
+QTEST_APPLESS_MAIN(tst_QMultiMatcher)
+
+#include "main.moc"
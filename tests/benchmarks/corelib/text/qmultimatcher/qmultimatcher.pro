@@ -0,0 +1,4 @@
+TARGET = tst_bench_qmultimatcher
+QT -= gui
+QT += testlib
+SOURCES += main.cpp
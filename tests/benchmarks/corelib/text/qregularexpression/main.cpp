@@ -0,0 +1,113 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QRegularExpression>
+#include <QString>
+#include <qtest.h>
+#include <private/qregularexpression_p.h>
+
+class tst_QRegularExpression : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void temporaryExpression_data();
+    void temporaryExpression();
+    void scanBuffer_data();
+    void scanBuffer();
+};
+
+void tst_QRegularExpression::temporaryExpression_data()
+{
+    QTest::addColumn<bool>("cached");
+    QTest::newRow("uncached") << false;
+    QTest::newRow("cached") << true;
+}
+
+void tst_QRegularExpression::temporaryExpression()
+{
+    QFETCH(bool, cached);
+
+    const int maxCost = QRegularExpressionCache::maxCost();
+    QRegularExpressionCache::setMaxCost(cached ? maxCost : 0);
+    const QString pattern = QStringLiteral("^(\\d{4})-(\\d{2})-(\\d{2})T(\\d{2}):(\\d{2})");
+    const QString subject = QStringLiteral("2020-03-14T15:09:26");
+
+    QBENCHMARK {
+        QRegularExpression re(pattern);
+        QVERIFY(re.match(subject).hasMatch());
+    }
+
+    QRegularExpressionCache::setMaxCost(maxCost);
+}
+
+void tst_QRegularExpression::scanBuffer_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<bool>("useForEachMatch");
+
+    for (const char *pattern : { "\\w+", "\\d+\\.\\d+", "error" }) {
+        QTest::addRow("%s, globalMatch", pattern) << QString::fromLatin1(pattern) << false;
+        QTest::addRow("%s, forEachMatch", pattern) << QString::fromLatin1(pattern) << true;
+    }
+}
+
+void tst_QRegularExpression::scanBuffer()
+{
+    QFETCH(QString, pattern);
+    QFETCH(bool, useForEachMatch);
+
+    // about 1 MB of log-like text
+    QString buffer;
+    for (int i = 0; i < 16 * 1024; ++i) {
+        buffer += QString::number(i) + QLatin1String(".5 worker: ")
+                + QLatin1String(i % 16 ? "request handled in 12 ms\n" : "error while handling request\n");
+    }
+
+    const QRegularExpression re(pattern);
+    re.optimize();
+    int count = 0;
+
+    QBENCHMARK {
+        count = 0;
+        if (useForEachMatch) {
+            count = int(re.forEachMatch(buffer, [](qsizetype, qsizetype) {}));
+        } else {
+            QRegularExpressionMatchIterator iterator = re.globalMatch(buffer);
+            while (iterator.hasNext()) {
+                iterator.next();
+                ++count;
+            }
+        }
+    }
+    QVERIFY(count > 0);
+}
+
+QTEST_APPLESS_MAIN(tst_QRegularExpression)
+
+#include "main.moc"
@@ -0,0 +1,4 @@
+TARGET = tst_bench_qregularexpression
+QT -= gui
+QT += core-private testlib
+SOURCES += main.cpp
@@ -49,7 +49,17 @@ private slots:
     void toCaseFolded_data();
     void toCaseFolded();
 
+    void fromUtf8_data() { codec_data_impl(); }
+    void fromUtf8();
+    void toUtf8_data() { codec_data_impl(); }
+    void toUtf8();
+    void fromLatin1_data() { codec_data_impl(); }
+    void fromLatin1();
+    void toLatin1_data() { codec_data_impl(); }
+    void toLatin1();
+
 private:
+    void codec_data_impl();
     void section_data_impl(bool includeRegExOnly = true);
     template <typename RX> void section_impl();
 };
@@ -188,6 +198,84 @@ void tst_QString::toCaseFolded()
     }
 }
 
+static QString repeatedText(const char32_t *sample, int size)
+{
+    const QString pattern = QString::fromUcs4(sample);
+    QString result;
+    result.reserve(size + pattern.size());
+    while (result.size() < size)
+        result += pattern;
+    result.truncate(size);
+    if (result.back().isHighSurrogate())
+        result.chop(1);
+    return result;
+}
+
+void tst_QString::codec_data_impl()
+{
+    QTest::addColumn<QString>("s");
+
+    // about 64k characters of each, so that the bulk of the work is in the inner loops
+    const int size = 64 * 1024;
+    QTest::newRow("ascii")
+            << repeatedText(U"The quick brown fox jumps over the lazy dog. ", size);
+    QTest::newRow("latin1")
+            << repeatedText(U"Zwölf Boxkämpfer jagen Viktor quer über den großen Sylter Deich. ", size);
+    QTest::newRow("greek")
+            << repeatedText(U"Ξεσκεπάζω την ψυχοφθόρα βδελυγμία. ", size);
+    QTest::newRow("cyrillic")
+            << repeatedText(U"Съешь же ещё этих мягких французских булок, да выпей чаю. ", size);
+    QTest::newRow("cjk")
+            << repeatedText(U"いろはにほへとちりぬるを、我能吞下玻璃而不伤身体。", size);
+    QTest::newRow("mixed")
+            << repeatedText(U"Qt <span>Ελληνικά</span> и русский, 日本語 and English. ", size);
+    QTest::newRow("emoji")
+            << repeatedText(U"Have a nice day \U0001F600\U0001F44D \U0001F30D! ", size);
+}
+
+void tst_QString::fromUtf8()
+{
+    QFETCH(QString, s);
+    const QByteArray utf8 = s.toUtf8();
+
+    QBENCHMARK {
+        QString result = QString::fromUtf8(utf8);
+        Q_UNUSED(result);
+    }
+}
+
+void tst_QString::toUtf8()
+{
+    QFETCH(QString, s);
+
+    QBENCHMARK {
+        QByteArray result = s.toUtf8();
+        Q_UNUSED(result);
+    }
+}
+
+void tst_QString::fromLatin1()
+{
+    QFETCH(QString, s);
+    // characters outside Latin 1 become '?', which is fine for this purpose
+    const QByteArray latin1 = s.toLatin1();
+
+    QBENCHMARK {
+        QString result = QString::fromLatin1(latin1);
+        Q_UNUSED(result);
+    }
+}
+
+void tst_QString::toLatin1()
+{
+    QFETCH(QString, s);
+
+    QBENCHMARK {
+        QByteArray result = s.toLatin1();
+        Q_UNUSED(result);
+    }
+}
+
 QTEST_APPLESS_MAIN(tst_QString)
 
 #include "main.moc"
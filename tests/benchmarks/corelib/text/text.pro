@@ -3,6 +3,8 @@ SUBDIRS = \
         qbytearray \
         qchar \
         qlocale \
+        qmultimatcher \
+        qregularexpression \
         qstringbuilder \
         qstringlist
 
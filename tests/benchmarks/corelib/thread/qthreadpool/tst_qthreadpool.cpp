@@ -40,6 +40,10 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void startFromWorkers_data();
+    void startFromWorkers();
+    void forkJoin_data();
+    void forkJoin();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -75,5 +79,99 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+class SpawningRunnable : public QRunnable
+{
+public:
+    SpawningRunnable(QThreadPool *pool, int depth)
+        : pool(pool), depth(depth)
+    { }
+
+    void run() override
+    {
+        if (depth > 0) {
+            pool->start(new SpawningRunnable(pool, depth - 1));
+            pool->start(new SpawningRunnable(pool, depth - 1));
+        }
+    }
+
+private:
+    QThreadPool *pool;
+    int depth;
+};
+
+void tst_QThreadPool::startFromWorkers_data()
+{
+    QTest::addColumn<bool>("workStealing");
+    QTest::addColumn<int>("threadCount");
+
+    const int idealThreadCount = QThread::idealThreadCount();
+    for (int threadCount : { 1, 4, 16, 64 }) {
+        if (threadCount > 1 && threadCount > 4 * idealThreadCount)
+            break;
+        QTest::addRow("shared-queue-%d", threadCount) << false << threadCount;
+        QTest::addRow("work-stealing-%d", threadCount) << true << threadCount;
+    }
+}
+
+// Every runnable starts two more from its worker thread, so all threads
+// compete for the pool's queue (about 260k tiny runnables per iteration)
+void tst_QThreadPool::startFromWorkers()
+{
+    QFETCH(bool, workStealing);
+    QFETCH(int, threadCount);
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    threadPool.setWorkStealingEnabled(workStealing);
+    QBENCHMARK {
+        threadPool.start(new SpawningRunnable(&threadPool, 17));
+        threadPool.waitForDone();
+    }
+}
+
+class ForkJoinRunnable : public QRunnable
+{
+public:
+    ForkJoinRunnable(QThreadPool *pool, int begin, int end)
+        : pool(pool), begin(begin), end(end)
+    { }
+
+    void run() override
+    {
+        while (end - begin > 1) {
+            const int middle = begin + (end - begin) / 2;
+            pool->start(new ForkJoinRunnable(pool, middle, end));
+            end = middle;
+        }
+    }
+
+private:
+    QThreadPool *pool;
+    int begin;
+    int end;
+};
+
+void tst_QThreadPool::forkJoin_data()
+{
+    startFromWorkers_data();
+}
+
+// Every runnable starts one half of its range and splits the other half
+// itself, like a parallel loop does. Idle threads steal the started halves,
+// so most of them are started on an empty local queue.
+void tst_QThreadPool::forkJoin()
+{
+    QFETCH(bool, workStealing);
+    QFETCH(int, threadCount);
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    threadPool.setWorkStealingEnabled(workStealing);
+    QBENCHMARK {
+        threadPool.start(new ForkJoinRunnable(&threadPool, 0, 1 << 18));
+        threadPool.waitForDone();
+    }
+}
+
 QTEST_MAIN(tst_QThreadPool)
 #include "tst_qthreadpool.moc"
@@ -0,0 +1,205 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QHash>
+#include <QMap>
+#include <QRandomGenerator>
+#include <QString>
+#include <QTest>
+#include <QVector>
+
+#include <private/qflathash_p.h>
+
+/*
+  Compares QFlatHash against QHash and QMap for the basic operations, with
+  integer keys from 1000 up to ten million entries and string keys up to a
+  million entries. Keys are random so that neither the hashed containers
+  nor QMap profit from sequential insertion.
+*/
+
+enum ContainerType { FlatHash, Hash, Map };
+enum Operation { Insert, Lookup, LookupMiss, Iterate, RemoveReinsert };
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insert_data() { populate(); }
+    void insert() { run(Insert); }
+    void lookup_data() { populate(); }
+    void lookup() { run(Lookup); }
+    void lookupMiss_data() { populate(); }
+    void lookupMiss() { run(LookupMiss); }
+    void iterate_data() { populate(); }
+    void iterate() { run(Iterate); }
+    void removeReinsert_data() { populate(); }
+    void removeReinsert() { run(RemoveReinsert); }
+
+private:
+    void populate();
+    void run(Operation op);
+};
+
+void tst_QFlatHash::populate()
+{
+    QTest::addColumn<int>("container");
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("stringKeys");
+
+    static const struct {
+        ContainerType type;
+        const char *name;
+    } containers[] = {
+        { FlatHash, "QFlatHash" },
+        { Hash, "QHash" },
+        { Map, "QMap" },
+    };
+
+    for (int size : { 1000, 10000, 100000, 1000000, 10000000 }) {
+        for (bool stringKeys : { false, true }) {
+            if (stringKeys && size > 1000000)
+                continue;
+            for (const auto &c : containers) {
+                QTest::addRow("%s-%s-%d", c.name, stringKeys ? "string" : "int", size)
+                        << int(c.type) << size << stringKeys;
+            }
+        }
+    }
+}
+
+static QVector<quint64> makeIntKeys(int size, quint32 seed)
+{
+    QRandomGenerator rng(seed);
+    QVector<quint64> keys;
+    keys.reserve(size);
+    for (int i = 0; i < size; ++i)
+        keys.append(rng.generate64());
+    return keys;
+}
+
+static QVector<QString> makeStringKeys(int size, quint32 seed)
+{
+    QRandomGenerator rng(seed);
+    QVector<QString> keys;
+    keys.reserve(size);
+    for (int i = 0; i < size; ++i)
+        keys.append(QLatin1String("key-") + QString::number(rng.generate64(), 36));
+    return keys;
+}
+
+template <template <typename, typename> class Container, typename Key>
+static void benchmark(Operation op, const QVector<Key> &keys, const QVector<Key> &missingKeys)
+{
+    Container<Key, int> c;
+    if (op != Insert) {
+        for (int i = 0; i < keys.size(); ++i)
+            c.insert(keys.at(i), i);
+    }
+
+    qint64 sum = 0;
+    switch (op) {
+    case Insert:
+        QBENCHMARK {
+            Container<Key, int> fresh;
+            for (int i = 0; i < keys.size(); ++i)
+                fresh.insert(keys.at(i), i);
+            sum += fresh.size();
+        }
+        break;
+    case Lookup:
+        QBENCHMARK {
+            for (const Key &key : keys)
+                sum += c.value(key);
+        }
+        break;
+    case LookupMiss:
+        QBENCHMARK {
+            for (const Key &key : missingKeys)
+                sum += c.value(key, 1);
+        }
+        break;
+    case Iterate:
+        QBENCHMARK {
+            for (auto it = c.cbegin(), end = c.cend(); it != end; ++it)
+                sum += it.value();
+        }
+        break;
+    case RemoveReinsert:
+        // the container is restored by each iteration; subtract the insert
+        // result to get the cost of removal alone
+        QBENCHMARK {
+            for (const Key &key : keys)
+                c.remove(key);
+            for (int i = 0; i < keys.size(); ++i)
+                c.insert(keys.at(i), i);
+        }
+        sum = c.size();
+        break;
+    }
+    QVERIFY(sum != 0);
+}
+
+template <typename Key>
+static void benchmark(ContainerType type, Operation op, const QVector<Key> &keys,
+                      const QVector<Key> &missingKeys)
+{
+    switch (type) {
+    case FlatHash:
+        benchmark<QFlatHash>(op, keys, missingKeys);
+        break;
+    case Hash:
+        benchmark<QHash>(op, keys, missingKeys);
+        break;
+    case Map:
+        benchmark<QMap>(op, keys, missingKeys);
+        break;
+    }
+}
+
+void tst_QFlatHash::run(Operation op)
+{
+    QFETCH(int, container);
+    QFETCH(int, size);
+    QFETCH(bool, stringKeys);
+
+    const ContainerType type = ContainerType(container);
+    // collisions among the random keys are astronomically unlikely, and
+    // would only make the containers slightly smaller than requested
+    if (stringKeys) {
+        const QVector<QString> keys = makeStringKeys(size, 1);
+        benchmark(type, op, keys, op == LookupMiss ? makeStringKeys(size, 2) : QVector<QString>());
+    } else {
+        const QVector<quint64> keys = makeIntKeys(size, 1);
+        benchmark(type, op, keys, op == LookupMiss ? makeIntKeys(size, 2) : QVector<quint64>());
+    }
+}
+
+QTEST_MAIN(tst_QFlatHash)
+
+#include "main.moc"
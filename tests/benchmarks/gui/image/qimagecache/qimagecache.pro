@@ -0,0 +1,5 @@
+TARGET = tst_bench_qimagecache
+TEMPLATE = app
+QT += testlib
+
+SOURCES += tst_qimagecache.cpp
@@ -0,0 +1,144 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QImageCache>
+#include <QPixmapCache>
+#include <QThread>
+
+class tst_QImageCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insert();
+    void find_data();
+    void find();
+    void findPixmapCache();
+    void threadedFindOrInsert_data();
+    void threadedFindOrInsert();
+};
+
+static const int keyCount = 1000;
+
+static QStringList keys()
+{
+    QStringList keys;
+    keys.reserve(keyCount);
+    for (int i = 0; i < keyCount; ++i)
+        keys.append(QStringLiteral("image-%1").arg(i));
+    return keys;
+}
+
+void tst_QImageCache::insert()
+{
+    const QStringList keys = ::keys();
+    const QImage image(32, 32, QImage::Format_ARGB32);
+    QImageCache cache(100 * image.sizeInBytes());
+    QBENCHMARK {
+        for (const QString &key : keys)
+            cache.insert(key, image);
+    }
+}
+
+void tst_QImageCache::find_data()
+{
+    QTest::addColumn<bool>("hit");
+    QTest::newRow("hit") << true;
+    QTest::newRow("miss") << false;
+}
+
+void tst_QImageCache::find()
+{
+    QFETCH(bool, hit);
+    const QStringList keys = ::keys();
+    QImageCache cache;
+    if (hit) {
+        const QImage image(32, 32, QImage::Format_ARGB32);
+        for (const QString &key : keys)
+            cache.insert(key, image);
+    }
+    QImage image;
+    QBENCHMARK {
+        for (const QString &key : keys)
+            cache.find(key, &image);
+    }
+}
+
+// For comparison with find()
+void tst_QImageCache::findPixmapCache()
+{
+    const QStringList keys = ::keys();
+    QPixmapCache::setCacheLimit(64 * 1024);
+    const QPixmap pixmap(32, 32);
+    for (const QString &key : keys)
+        QPixmapCache::insert(key, pixmap);
+    QPixmap found;
+    QBENCHMARK {
+        for (const QString &key : keys)
+            QPixmapCache::find(key, &found);
+    }
+    QPixmapCache::clear();
+}
+
+void tst_QImageCache::threadedFindOrInsert_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("8 threads") << 8;
+}
+
+void tst_QImageCache::threadedFindOrInsert()
+{
+    QFETCH(int, threadCount);
+    const QStringList keys = ::keys();
+    const QImage image(32, 32, QImage::Format_ARGB32);
+    // Room for half of the images, so that there are misses and evictions
+    QImageCache cache(keyCount / 2 * image.sizeInBytes());
+
+    QBENCHMARK {
+        std::vector<std::unique_ptr<QThread>> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back(QThread::create([&, t] {
+                for (int i = 0; i < 4 * keyCount; ++i) {
+                    const QString &key = keys.at((i * 31 + t * 97) % keyCount);
+                    QImage found;
+                    if (!cache.find(key, &found))
+                        cache.insert(key, image);
+                }
+            }));
+            threads.back()->start();
+        }
+        for (auto &thread : threads)
+            thread->wait();
+    }
+}
+
+QTEST_MAIN(tst_QImageCache)
+#include "tst_qimagecache.moc"
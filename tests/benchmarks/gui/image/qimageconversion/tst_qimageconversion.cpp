@@ -28,6 +28,7 @@
 
 #include <qtest.h>
 #include <QImage>
+#include <QThreadPool>
 
 Q_DECLARE_METATYPE(QImage::Format)
 
@@ -56,6 +57,9 @@ private slots:
     void convertGenericInplace_data();
     void convertGenericInplace();
 
+    void convertGenericThreaded_data();
+    void convertGenericThreaded();
+
 private:
     QImage generateImageRgb888(int width, int height);
     QImage generateImageRgb16(int width, int height);
@@ -388,6 +392,41 @@ void tst_QImageConversion::convertGenericInplace()
     }
 }
 
+void tst_QImageConversion::convertGenericThreaded_data()
+{
+    QTest::addColumn<QImage>("inputImage");
+    QTest::addColumn<QImage::Format>("outputFormat");
+    QTest::addColumn<int>("threadCount");
+
+    // A 52 megapixel image.
+    QImage argb32 = generateImageArgb32(8832, 5888);
+
+    for (int threadCount : {1, 2, 4, 8}) {
+        QTest::addRow("argb32 -> rgb888, %d threads", threadCount)
+                << argb32 << QImage::Format_RGB888 << threadCount;
+        QTest::addRow("argb32 -> rgba64pm, %d threads", threadCount)
+                << argb32 << QImage::Format_RGBA64_Premultiplied << threadCount;
+    }
+}
+
+void tst_QImageConversion::convertGenericThreaded()
+{
+    QFETCH(QImage, inputImage);
+    QFETCH(QImage::Format, outputFormat);
+    QFETCH(int, threadCount);
+
+    QThreadPool *threadPool = QThreadPool::globalInstance();
+    const int maxThreadCount = threadPool->maxThreadCount();
+    threadPool->setMaxThreadCount(threadCount);
+
+    QBENCHMARK {
+        QImage output = inputImage.convertToFormat(outputFormat);
+        output.constBits();
+    }
+
+    threadPool->setMaxThreadCount(maxThreadCount);
+}
+
 /*
  Fill a RGB888 image with "random" pixel values.
  */
@@ -37,6 +37,10 @@
 #include <QSet>
 #include <QTimer>
 
+#ifdef Q_OS_LINUX
+#include <QTextStream>
+#endif
+
 typedef QMap<QString, QString> QStringMap;
 typedef QList<int> QIntList;
 Q_DECLARE_METATYPE(QStringMap)
@@ -68,9 +72,23 @@ private slots:
     void setScaledClipRect_data();
     void setScaledClipRect();
 
+    void readLargeJpeg_data();
+    void readLargeJpeg();
+
+    void jpegPreview_data();
+    void jpegPreview();
+
+    void peakMemory_data();
+    void peakMemory();
+
 private:
+    enum DecodeMode { NewImage, PooledImage, PooledScanLines };
+    static void decode(QByteArray *data, DecodeMode mode, QImage *pool);
+    QByteArray largeJpeg();
+
     QList< QPair<QString, QByteArray> > images; // filename, format
     QString prefix;
+    QByteArray largeJpegData;
 };
 
 tst_QImageReader::tst_QImageReader()
@@ -222,5 +240,157 @@ void tst_QImageReader::setScaledClipRect()
     }
 }
 
+QByteArray tst_QImageReader::largeJpeg()
+{
+    if (largeJpegData.isEmpty()) {
+        // 12 megapixels, like a camera picture
+        QImage image(4000, 3000, QImage::Format_RGB32);
+        for (int y = 0; y < image.height(); ++y) {
+            QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+            for (int x = 0; x < image.width(); ++x)
+                line[x] = qRgb(x * 255 / image.width(), y * 255 / image.height(), (x ^ y) & 0xff);
+        }
+        QBuffer buffer(&largeJpegData);
+        QImageWriter writer(&buffer, "jpeg");
+        writer.setQuality(90);
+        writer.write(image);
+    }
+    return largeJpegData;
+}
+
+void tst_QImageReader::decode(QByteArray *data, DecodeMode mode, QImage *pool)
+{
+    QBuffer buffer(data);
+    QImageReader reader(&buffer, "jpeg");
+    switch (mode) {
+    case NewImage: {
+        const QImage image = reader.read();
+        QVERIFY(!image.isNull());
+        break;
+    }
+    case PooledImage:
+        QVERIFY(reader.read(pool));
+        break;
+    case PooledScanLines: {
+        int lines = 0;
+        do {
+            lines = reader.readScanLines(pool, 64);
+            QVERIFY(lines >= 0);
+        } while (lines < pool->height());
+        break;
+    }
+    }
+}
+
+void tst_QImageReader::readLargeJpeg_data()
+{
+    QTest::addColumn<int>("mode");
+
+    QTest::newRow("read()") << int(NewImage);
+    QTest::newRow("read(&pooled)") << int(PooledImage);
+    QTest::newRow("readScanLines(&pooled)") << int(PooledScanLines);
+}
+
+void tst_QImageReader::readLargeJpeg()
+{
+#if defined QTEST_HAVE_JPEG
+    QFETCH(int, mode);
+
+    QByteArray data = largeJpeg();
+    QImage pool(4000, 3000, QImage::Format_RGB32);
+
+    QBENCHMARK {
+        decode(&data, DecodeMode(mode), &pool);
+    }
+#else
+    QSKIP("jpeg support is not enabled");
+#endif
+}
+
+void tst_QImageReader::jpegPreview_data()
+{
+    QTest::addColumn<QSize>("scaledSize");
+    QTest::addColumn<QRect>("clipRect");
+
+    QTest::newRow("full size") << QSize() << QRect();
+    QTest::newRow("thumbnail 1/8") << QSize(500, 375) << QRect();
+    QTest::newRow("preview 1/3") << QSize(1333, 1000) << QRect();
+    QTest::newRow("clip center") << QSize() << QRect(1744, 1244, 512, 512);
+    QTest::newRow("clip bottom-right") << QSize() << QRect(3488, 2488, 512, 512);
+    QTest::newRow("clip and scale 1/4") << QSize(256, 256) << QRect(1744, 1240, 1024, 1024);
+}
+
+void tst_QImageReader::jpegPreview()
+{
+#if defined QTEST_HAVE_JPEG
+    QFETCH(QSize, scaledSize);
+    QFETCH(QRect, clipRect);
+
+    QByteArray data = largeJpeg();
+
+    QBENCHMARK {
+        QBuffer buffer(&data);
+        QImageReader reader(&buffer, "jpeg");
+        reader.setScaledSize(scaledSize);
+        reader.setClipRect(clipRect);
+        const QImage image = reader.read();
+        QVERIFY(!image.isNull());
+    }
+#else
+    QSKIP("jpeg support is not enabled");
+#endif
+}
+
+#ifdef Q_OS_LINUX
+// The peak resident set size of the process
+static qint64 peakResidentBytes()
+{
+    QFile status(QStringLiteral("/proc/self/status"));
+    if (!status.open(QIODevice::ReadOnly | QIODevice::Text))
+        return -1;
+    QTextStream stream(&status);
+    QString line;
+    while (stream.readLineInto(&line)) {
+        if (line.startsWith(QLatin1String("VmHWM:")))
+            return line.mid(6).remove(QLatin1String("kB")).trimmed().toLongLong() * 1024;
+    }
+    return -1;
+}
+
+static bool resetPeakResidentBytes()
+{
+    QFile clearRefs(QStringLiteral("/proc/self/clear_refs"));
+    return clearRefs.open(QIODevice::WriteOnly) && clearRefs.write("5") == 1;
+}
+#endif
+
+void tst_QImageReader::peakMemory_data()
+{
+    readLargeJpeg_data();
+}
+
+void tst_QImageReader::peakMemory()
+{
+#if defined QTEST_HAVE_JPEG && defined Q_OS_LINUX
+    QFETCH(int, mode);
+
+    QByteArray data = largeJpeg();
+    QImage pool(4000, 3000, QImage::Format_RGB32);
+    pool.fill(Qt::black);
+
+    // Measures what decoding adds on top of the pooled buffer and the file data
+    if (!resetPeakResidentBytes())
+        QSKIP("Cannot reset the peak resident set size");
+    const qint64 before = peakResidentBytes();
+    decode(&data, DecodeMode(mode), &pool);
+    const qint64 after = peakResidentBytes();
+    QVERIFY(before > 0 && after >= before);
+
+    QTest::setBenchmarkResult(after - before, QTest::BytesAllocated);
+#else
+    QSKIP("Peak memory is only measured for jpeg images on Linux");
+#endif
+}
+
 QTEST_MAIN(tst_QImageReader)
 #include "tst_qimagereader.moc"
@@ -28,6 +28,7 @@
 
 #include <qtest.h>
 #include <QImage>
+#include <QThreadPool>
 
 class tst_QImageScale : public QObject
 {
@@ -39,6 +40,15 @@ private slots:
     void scaleArgb32pm_data();
     void scaleArgb32pm();
 
+    void scaleRgba64pm_data();
+    void scaleRgba64pm();
+
+    void downscale_data();
+    void downscale();
+
+    void scaleThreaded_data();
+    void scaleThreaded();
+
 private:
     QImage generateImageRgb32(int width, int height);
     QImage generateImageArgb32(int width, int height);
@@ -100,6 +110,113 @@ void tst_QImageScale::scaleArgb32pm()
     }
 }
 
+void tst_QImageScale::scaleRgba64pm_data()
+{
+    QTest::addColumn<QImage>("inputImage");
+    QTest::addColumn<QSize>("outputSize");
+
+    QImage image = generateImageArgb32(1000, 1000).convertToFormat(QImage::Format_RGBA64_Premultiplied);
+    QTest::newRow("1000x1000 -> 2000x2000") << image << QSize(2000, 2000);
+    QTest::newRow("1000x1000 -> 2000x1000") << image << QSize(2000, 1000);
+    QTest::newRow("1000x1000 -> 1000x2000") << image << QSize(1000, 2000);
+    QTest::newRow("1000x1000 -> 2000x500") << image << QSize(2000, 500);
+    QTest::newRow("1000x1000 -> 500x2000") << image << QSize(500, 2000);
+    QTest::newRow("1000x1000 -> 500x500") << image << QSize(500, 500);
+    QTest::newRow("1000x1000 -> 200x200") << image << QSize(200, 200);
+}
+
+void tst_QImageScale::scaleRgba64pm()
+{
+    QFETCH(QImage, inputImage);
+    QFETCH(QSize, outputSize);
+
+    QBENCHMARK {
+        volatile QImage output = inputImage.scaled(outputSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        (void)output;
+    }
+}
+
+/*
+ Thumbnails of a 12 megapixel photo, at the ratios typically used by image viewers.
+ */
+void tst_QImageScale::downscale_data()
+{
+    QTest::addColumn<QImage>("inputImage");
+    QTest::addColumn<QSize>("outputSize");
+
+    const QImage photo = generateImageArgb32(4000, 3000);
+    const QImage::Format formats[] = {
+        QImage::Format_RGB32,
+        QImage::Format_ARGB32_Premultiplied,
+        QImage::Format_RGBA64_Premultiplied
+    };
+    const char *formatNames[] = { "RGB32", "ARGB32pm", "RGBA64pm" };
+    const QSize sizes[] = {
+        QSize(2000, 1500),
+        QSize(1333, 1000),
+        QSize(1000, 750),
+        QSize(500, 375),
+        QSize(256, 192),
+        QSize(160, 120),
+        QSize(4000, 750),
+        QSize(1000, 3000)
+    };
+    for (int i = 0; i < 3; ++i) {
+        const QImage image = photo.convertToFormat(formats[i]);
+        for (const QSize &size : sizes) {
+            QTest::addRow("%s 4000x3000 -> %dx%d", formatNames[i], size.width(), size.height())
+                    << image << size;
+        }
+    }
+}
+
+void tst_QImageScale::downscale()
+{
+    QFETCH(QImage, inputImage);
+    QFETCH(QSize, outputSize);
+
+    QBENCHMARK {
+        volatile QImage output = inputImage.scaled(outputSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        (void)output;
+    }
+}
+
+void tst_QImageScale::scaleThreaded_data()
+{
+    QTest::addColumn<QImage>("inputImage");
+    QTest::addColumn<QSize>("outputSize");
+    QTest::addColumn<int>("threadCount");
+
+    // A 52 megapixel photo.
+    const QImage photo = generateImageArgb32(8832, 5888).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    for (int threadCount : {1, 2, 4, 8}) {
+        QTest::addRow("8832x5888 -> 2208x1472, %d threads", threadCount)
+                << photo << QSize(2208, 1472) << threadCount;
+        QTest::addRow("8832x5888 -> 256x171, %d threads", threadCount)
+                << photo << QSize(256, 171) << threadCount;
+        QTest::addRow("8832x5888 -> 12000x8000, %d threads", threadCount)
+                << photo << QSize(12000, 8000) << threadCount;
+    }
+}
+
+void tst_QImageScale::scaleThreaded()
+{
+    QFETCH(QImage, inputImage);
+    QFETCH(QSize, outputSize);
+    QFETCH(int, threadCount);
+
+    QThreadPool *threadPool = QThreadPool::globalInstance();
+    const int maxThreadCount = threadPool->maxThreadCount();
+    threadPool->setMaxThreadCount(threadCount);
+
+    QBENCHMARK {
+        volatile QImage output = inputImage.scaled(outputSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        (void)output;
+    }
+
+    threadPool->setMaxThreadCount(maxThreadCount);
+}
+
 /*
  Fill a RGB32 image with "random" pixel values.
  */
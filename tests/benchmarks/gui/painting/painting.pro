@@ -3,6 +3,7 @@ SUBDIRS = \
         drawtexture \
         qcolor \
         qpainter \
+        qpicture \
         qregion \
         qtransform \
         qtbench \
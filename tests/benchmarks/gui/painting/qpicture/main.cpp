@@ -0,0 +1,146 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+// This file contains benchmarks for playing back QPictures on large images.
+
+#include <QDebug>
+#include <qtest.h>
+#include <QImage>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPicture>
+#include <QThreadPool>
+
+class tst_qpicture : public QObject
+{
+    Q_OBJECT
+private slots:
+    void paint_data();
+    void paint();
+    void play_data();
+    void play();
+    void playParallel_data();
+    void playParallel();
+};
+
+static void paintScene(QPainter *p, const QSize &size)
+{
+    p->setRenderHint(QPainter::Antialiasing);
+    p->fillRect(QRect(QPoint(0, 0), size), Qt::white);
+
+    QLinearGradient gradient(0, 0, size.width(), size.height());
+    gradient.setColorAt(0, QColor(255, 0, 0, 200));
+    gradient.setColorAt(1, QColor(0, 0, 255, 120));
+    p->setPen(QPen(Qt::black, 3));
+    for (int i = 0; i < 64; ++i) {
+        p->setBrush(i % 2 ? QBrush(gradient) : QBrush(QColor(0, 128, 0, 100)));
+        p->drawEllipse(QRectF((i % 8) * size.width() / 9.0, (i / 8) * size.height() / 9.0,
+                              size.width() / 4.0, size.height() / 4.0));
+    }
+
+    QPainterPath path;
+    path.moveTo(0, size.height());
+    for (int i = 0; i < 8; ++i) {
+        path.cubicTo(size.width() * (i + 0.3) / 8, 0, size.width() * (i + 0.6) / 8, size.height(),
+                     size.width() * (i + 1) / 8, size.height() / 2);
+    }
+    p->setBrush(Qt::NoBrush);
+    p->setPen(QPen(Qt::darkBlue, 9, Qt::DashLine));
+    p->drawPath(path);
+}
+
+static void addRows()
+{
+    QTest::addColumn<QSize>("size");
+
+    QTest::newRow("3840x2160") << QSize(3840, 2160);
+    QTest::newRow("7680x4320") << QSize(7680, 4320);
+}
+
+void tst_qpicture::paint_data()
+{
+    addRows();
+}
+
+void tst_qpicture::paint()
+{
+    QFETCH(QSize, size);
+
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    QBENCHMARK {
+        QPainter painter(&image);
+        paintScene(&painter, size);
+    }
+}
+
+void tst_qpicture::play_data()
+{
+    addRows();
+}
+
+void tst_qpicture::play()
+{
+    QFETCH(QSize, size);
+
+    QPicture picture;
+    {
+        QPainter painter(&picture);
+        paintScene(&painter, size);
+    }
+
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    QBENCHMARK {
+        QPainter painter(&image);
+        picture.play(&painter);
+    }
+}
+
+void tst_qpicture::playParallel_data()
+{
+    addRows();
+}
+
+void tst_qpicture::playParallel()
+{
+    QFETCH(QSize, size);
+
+    QPicture picture;
+    {
+        QPainter painter(&picture);
+        paintScene(&painter, size);
+    }
+
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    QBENCHMARK {
+        picture.playParallel(&image);
+    }
+}
+
+QTEST_MAIN(tst_qpicture)
+
+#include "main.moc"
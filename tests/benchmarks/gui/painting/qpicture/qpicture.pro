@@ -0,0 +1,5 @@
+TEMPLATE = app
+TARGET = tst_bench_qpicture
+QT += testlib
+CONFIG += release
+SOURCES += main.cpp
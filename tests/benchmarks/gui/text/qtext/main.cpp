@@ -36,6 +36,7 @@
 #include <QPainter>
 #include <QBuffer>
 #include <qtest.h>
+#include <private/qtextengine_p.h>
 
 Q_DECLARE_METATYPE(QVector<QTextLayout::FormatRange>)
 
@@ -54,6 +55,8 @@ private slots:
 
     void shaping_data();
     void shaping();
+    void shapedTextCache_data();
+    void shapedTextCache();
 
     void odfWriting_empty();
     void odfWriting_text();
@@ -149,6 +152,39 @@ void tst_QText::shaping()
     }
 }
 
+void tst_QText::shapedTextCache_data()
+{
+    QTest::addColumn<bool>("cached");
+    QTest::newRow("uncached") << false;
+    QTest::newRow("cached") << true;
+}
+
+// Lays out the same few labels over and over, like the cells of a table view
+void tst_QText::shapedTextCache()
+{
+    QFETCH(bool, cached);
+
+    QStringList labels;
+    for (int i = 0; i < 20; ++i)
+        labels << QStringLiteral("Item %1").arg(i) << QStringLiteral("Pending") << QStringLiteral("Completed");
+
+    const int maxCost = QShapedTextCache::maxCost();
+    QShapedTextCache::setMaxCost(cached ? maxCost : 0);
+    QShapedTextCache::clear();
+    QShapedTextCache::resetStatistics();
+
+    QBENCHMARK {
+        for (const QString &label : qAsConst(labels)) {
+            QTextLayout layout(label);
+            layout.beginLayout();
+            layout.createLine();
+            layout.endLayout();
+        }
+    }
+
+    QShapedTextCache::setMaxCost(maxCost);
+}
+
 void tst_QText::odfWriting_empty()
 {
     QVERIFY(QTextDocumentWriter::supportedDocumentFormats().contains("ODF")); // odf compiled in
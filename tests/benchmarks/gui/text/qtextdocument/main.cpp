@@ -28,14 +28,19 @@
 
 #include <QDebug>
 #include <QTextDocument>
+#include <QThreadPool>
 #include <qtest.h>
 
+#include <private/qtextdocumentlayout_p.h>
+
 class tst_QTextDocument : public QObject
 {
     Q_OBJECT
 private slots:
     void mightBeRichText_data();
     void mightBeRichText();
+    void layout_data();
+    void layout();
 };
 
 void tst_QTextDocument::mightBeRichText_data()
@@ -66,6 +71,43 @@ void tst_QTextDocument::mightBeRichText()
     }
 }
 
+void tst_QTextDocument::layout_data()
+{
+    QTest::addColumn<int>("paragraphs");
+    QTest::addColumn<bool>("parallel");
+    for (int paragraphs : {1000, 20000}) {
+        QTest::addRow("%d-serial", paragraphs) << paragraphs << false;
+        QTest::addRow("%d-parallel", paragraphs) << paragraphs << true;
+    }
+}
+
+void tst_QTextDocument::layout()
+{
+    QFETCH(int, paragraphs);
+    QFETCH(bool, parallel);
+
+    if (parallel && QThreadPool::globalInstance()->maxThreadCount() < 2)
+        QSKIP("The parallel layout needs more than one thread");
+
+    const QString lorem = QStringLiteral("Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+                                         "eiusmod tempor incididunt ut labore et dolore magna aliqua. ");
+    QString text;
+    for (int i = 0; i < paragraphs; ++i)
+        text += lorem.repeated(i % 5 + 1) + QLatin1Char('\n');
+
+    QTextDocument document;
+    QTextDocumentLayout *layout = new QTextDocumentLayout(&document);
+    layout->setParallelLayoutEnabled(parallel);
+    document.setDocumentLayout(layout);
+    document.setPlainText(text);
+    document.setTextWidth(400);
+
+    QBENCHMARK {
+        document.markContentsDirty(0, document.characterCount());
+        document.size();
+    }
+}
+
 QTEST_MAIN(tst_QTextDocument)
 
 #include "main.moc"